@@ -0,0 +1,160 @@
+#include <cstring>
+#include <iostream>
+#include <iomanip> // std::setw
+#include <string>
+#include <vector>
+
+
+#include <chrono>
+// convenience for std::chrono
+namespace chronoz = std::chrono;
+typedef chronoz::steady_clock       clockz;
+typedef clockz::time_point          timepointz;
+
+typedef std::ratio<1,1000>          ratio_milli;
+typedef chronoz::duration<double,ratio_milli>
+                                    duration_t;
+// <--
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/BufferAllocator.hpp>
+#include <SF/string.hpp>
+
+
+RCF_BEGIN(I_Sink, "I_Sink")
+    RCF_METHOD_R1(std::size_t, swallow, const std::string &)
+RCF_END(I_Sink)
+
+class Sink
+{
+public:
+    std::size_t swallow(const std::string & s)
+    {
+        return s.size();
+    }
+};
+
+
+// Allocates a block, touches every page, and releases it. Repeated allocations of the same size are where a
+// caching allocator avoids faulting in fresh pages.
+double benchAllocate(RCF::BufferAllocator & allocator, std::size_t bytes, int rounds)
+{
+    timepointz t0 = clockz::now();
+    for (int r=0; r<rounds; ++r)
+    {
+        std::size_t capacity = 0;
+        char * pch = allocator.allocate(bytes, capacity);
+        for (std::size_t i=0; i<bytes; i += 4096)
+        {
+            pch[i] = char(r);
+        }
+        allocator.deallocate(pch, capacity);
+    }
+    return duration_t(clockz::now() - t0).count() / rounds;
+}
+
+// Grows a block in 1 MB steps up to the given size, as a message buffer does while a message is written.
+double benchGrow(RCF::BufferAllocator & allocator, std::size_t bytes, int rounds)
+{
+    const std::size_t Step = 1024*1024;
+
+    timepointz t0 = clockz::now();
+    for (int r=0; r<rounds; ++r)
+    {
+        std::size_t capacity = 0;
+        char * pch = allocator.allocate(Step, capacity);
+        memset(pch, r, Step);
+        for (std::size_t size = 2*Step; size <= bytes; size += Step)
+        {
+            if (size > capacity)
+            {
+                pch = allocator.reallocate(pch, capacity, size, capacity);
+            }
+            memset(pch + size - Step, r, Step);
+        }
+        allocator.deallocate(pch, capacity);
+    }
+    return duration_t(clockz::now() - t0).count() / rounds;
+}
+
+// Sends a message of the given size to a server and back, with the given allocator for all message buffers.
+double benchRemote(int port, std::size_t bytes, int rounds)
+{
+    RcfClient<I_Sink> client( RCF::TcpEndpoint("127.0.0.1", port) );
+    client.getClientStub().getTransport().setMaxIncomingMessageLength(1024*1024*1024);
+    client.getClientStub().setRemoteCallTimeoutMs(600*1000);
+
+    std::string payload(bytes, 'x');
+    client.swallow(payload);
+
+    timepointz t0 = clockz::now();
+    for (int r=0; r<rounds; ++r)
+    {
+        payload[r % bytes] = char(r);
+        if (client.swallow(payload) != bytes)
+        {
+            std::cout << "size mismatch" << std::endl;
+            return 0;
+        }
+    }
+    return duration_t(clockz::now() - t0).count() / rounds;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int rounds = 5;
+    if (argc > 1) rounds = atoi(argv[1]);
+
+    RCF::RcfInit rcfInit;
+
+    Sink sink;
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.getServerTransport().setMaxIncomingMessageLength(1024*1024*1024);
+    server.bind<I_Sink>(sink);
+    server.start();
+    int port = server.getIpServerTransport().getPort();
+
+    RCF::BufferAllocatorPtr heapPtr( new RCF::HeapBufferAllocator() );
+    RCF::BufferAllocatorPtr sizeClassPtr( new RCF::SizeClassBufferAllocator() );
+
+    struct Allocator
+    {
+        const char *                name;
+        RCF::BufferAllocatorPtr     allocatorPtr;
+    };
+
+    std::vector<Allocator> allocators;
+    allocators.push_back( Allocator{ "heap", heapPtr } );
+    allocators.push_back( Allocator{ "size class", sizeClassPtr } );
+
+    std::cout << rounds << " rounds, ms per round" << std::endl;
+    std::cout << std::setw(12) << "MB"
+              << std::setw(16) << "allocator"
+              << std::setw(16) << "allocate"
+              << std::setw(16) << "grow"
+              << std::setw(16) << "remote call"
+              << std::endl;
+
+    for (std::size_t mb : { 10, 50, 100, 500 })
+    {
+        std::size_t bytes = mb*1024*1024;
+        for (const Allocator & allocator : allocators)
+        {
+            RCF::setDefaultBufferAllocator(allocator.allocatorPtr);
+
+            std::cout << std::setw(12) << mb
+                      << std::setw(16) << allocator.name
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(16) << benchAllocate(*allocator.allocatorPtr, bytes, rounds)
+                      << std::setw(16) << benchGrow(*allocator.allocatorPtr, bytes, rounds)
+                      << std::setw(16) << benchRemote(port, bytes, rounds)
+                      << std::endl;
+        }
+    }
+
+    RCF::setDefaultBufferAllocator(heapPtr);
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <cstring>
+#include <iostream>
+#include <iomanip> // std::setw
+#include <vector>
+
+
+#include <chrono>
+// convenience for std::chrono
+namespace chronoz = std::chrono;
+typedef chronoz::steady_clock       clockz;
+typedef clockz::time_point          timepointz;
+
+typedef std::ratio<1>               ratio_identity;
+typedef chronoz::duration<double,ratio_identity>
+                                    duration_t;
+// <--
+
+
+#include <RCF/ByteOrdering.hpp>
+
+
+// The byte reversal RCF used before the vectorized kernels, as a baseline.
+void reverseBytewise(void *buffer, int width, int count)
+{
+    char *chBuffer = static_cast<char *>(buffer);
+    for (int i=0; i<count; i++)
+    {
+        for (int j=0;j<width/2;j++)
+        {
+            char temp = chBuffer[i*width + j];
+            chBuffer[i*width + j] = chBuffer[i*width + width - j - 1];
+            chBuffer[i*width + width - j - 1] = temp;
+        }
+    }
+}
+
+
+// Converts the buffer size into MB/s.
+double throughput(size_t bytes, int rounds, duration_t d)
+{
+    return double(bytes) * rounds / d.count() / (1024*1024);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t bytes = 64*1024*1024;
+    int rounds = 10;
+    if (argc > 1) bytes = size_t(atoi(argv[1])) * 1024*1024;
+    if (argc > 2) rounds = atoi(argv[2]);
+
+    std::vector<char> src(bytes);
+    std::vector<char> dest(bytes);
+    for (size_t i=0; i<bytes; ++i) src[i] = char(i*31 + 7);
+
+    std::cout << "buffer " << bytes/(1024*1024) << " MB, " << rounds << " rounds" << std::endl;
+    std::cout << std::setw(8) << "width"
+              << std::setw(16) << "bytewise MB/s"
+              << std::setw(16) << "in place MB/s"
+              << std::setw(16) << "copy MB/s"
+              << std::endl;
+
+    const int widths[] = { 2, 4, 8 };
+    for (int width : widths)
+    {
+        int count = int(bytes / width);
+
+        timepointz t0 = clockz::now();
+        for (int r=0; r<rounds; ++r) reverseBytewise(&dest[0], width, count);
+
+        timepointz t1 = clockz::now();
+        for (int r=0; r<rounds; ++r) RCF::reverseByteOrder(&dest[0], width, count);
+
+        // memcpy() followed by an in place reversal is what the SF vector serializer used to do.
+        timepointz t2 = clockz::now();
+        for (int r=0; r<rounds; ++r) RCF::reverseByteOrder(&dest[0], &src[0], width, count);
+
+        timepointz t3 = clockz::now();
+
+        std::cout << std::setw(8) << width
+                  << std::setw(16) << std::fixed << std::setprecision(0) << throughput(bytes, rounds, t1 - t0)
+                  << std::setw(16) << throughput(bytes, rounds, t2 - t1)
+                  << std::setw(16) << throughput(bytes, rounds, t3 - t2)
+                  << std::endl;
+
+        // Each kernel ran an even number of times in place, so a final copying pass must match the source.
+        RCF::reverseByteOrder(&dest[0], &src[0], width, count);
+        RCF::reverseByteOrder(&dest[0], width, count);
+        if (memcmp(&dest[0], &src[0], bytes) != 0)
+        {
+            std::cout << "mismatch at width " << width << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
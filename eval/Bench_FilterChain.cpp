@@ -0,0 +1,223 @@
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <iomanip> // std::setw
+#include <string>
+#include <vector>
+
+
+#include <chrono>
+// convenience for std::chrono
+namespace chronoz = std::chrono;
+typedef chronoz::steady_clock       clockz;
+typedef clockz::time_point          timepointz;
+
+typedef std::ratio<1>               ratio_identity;
+typedef chronoz::duration<double,ratio_identity>
+                                    duration_t;
+// <--
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/CompressionFilter.hpp>
+#include <RCF/ZlibCompressionFilter.hpp>
+#include <SF/string.hpp>
+
+
+RCF_BEGIN(I_Echo, "I_Echo")
+    RCF_METHOD_R1(std::string, echo, const std::string &)
+RCF_END(I_Echo)
+
+class Echo
+{
+public:
+    std::string echo(const std::string & s)
+    {
+        return s;
+    }
+};
+
+
+// A filter stacking to measure. Each call to createFilters() returns a fresh set of filters.
+struct Stacking
+{
+    const char *                                    name;
+    std::function<std::vector<RCF::FilterPtr>()>    createFilters;
+};
+
+std::vector<Stacking> getStackings()
+{
+    std::vector<Stacking> stackings;
+
+    stackings.push_back( Stacking{ "none", []()
+    {
+        return std::vector<RCF::FilterPtr>();
+    } } );
+
+    stackings.push_back( Stacking{ "zlib stream", []()
+    {
+        return std::vector<RCF::FilterPtr>(1, std::make_shared<RCF::ZlibStatefulCompressionFilter>());
+    } } );
+
+    stackings.push_back( Stacking{ "zlib block", []()
+    {
+        return std::vector<RCF::FilterPtr>(1, std::make_shared<RCF::CompressionFilter>(RCF::createZlibCompressionCodec(), true));
+    } } );
+
+    stackings.push_back( Stacking{ "lz4", []()
+    {
+        return std::vector<RCF::FilterPtr>(1, std::make_shared<RCF::Lz4CompressionFilter>(true));
+    } } );
+
+    stackings.push_back( Stacking{ "lz4 stateless", []()
+    {
+        return std::vector<RCF::FilterPtr>(1, std::make_shared<RCF::Lz4CompressionFilter>(false));
+    } } );
+
+    return stackings;
+}
+
+// Log-like payload, compressible but not trivially so.
+std::string makePayload(std::size_t bytes)
+{
+    static const char * words[] = { "remote ", "call ", "framework ", "filter ", "buffer ", "copy ", "0x3f ", "\n" };
+    std::string s;
+    s.reserve(bytes + 16);
+    std::uint32_t x = 12345;
+    while (s.size() < bytes)
+    {
+        x = x*1103515245 + 12345;
+        s += words[(x >> 16) % 8];
+    }
+    s.resize(bytes);
+    return s;
+}
+
+// Converts the payload size into MB/s.
+double throughput(std::size_t bytes, int rounds, duration_t d)
+{
+    return double(bytes) * rounds / d.count() / (1024*1024);
+}
+
+
+// Runs a payload through filterData() and unfilterData(), without any transport.
+double benchInMemory(const Stacking & stacking, const std::string & payload, int rounds)
+{
+    std::vector<RCF::FilterPtr> writeFilters = stacking.createFilters();
+    std::vector<RCF::FilterPtr> readFilters = stacking.createFilters();
+    RCF::connectFilters(writeFilters);
+    RCF::connectFilters(readFilters);
+
+    std::vector<char> buffer(payload.begin(), payload.end());
+    std::vector<RCF::ByteBuffer> unfiltered(1, RCF::ByteBuffer(&buffer[0], buffer.size()));
+    std::vector<RCF::ByteBuffer> filtered;
+    std::vector<char> wire;
+    RCF::ByteBuffer result;
+
+    timepointz t0 = clockz::now();
+    for (int r=0; r<rounds; ++r)
+    {
+        RCF::filterData(unfiltered, filtered, writeFilters);
+
+        wire.resize(RCF::lengthByteBuffers(filtered));
+        RCF::copyByteBuffers(filtered, &wire[0]);
+
+        RCF::unfilterData(RCF::ByteBuffer(&wire[0], wire.size()), result, payload.size(), readFilters);
+        if (result.getLength() != payload.size() || memcmp(result.getPtr(), payload.data(), payload.size()) != 0)
+        {
+            std::cout << "mismatch in " << stacking.name << std::endl;
+            return 0;
+        }
+    }
+    timepointz t1 = clockz::now();
+
+    return throughput(payload.size(), rounds, duration_t(t1 - t0));
+}
+
+// Times an echo call through the given endpoint and transport filters.
+double benchRemote(const RCF::Endpoint & endpoint, const Stacking & stacking, const std::string & payload, int rounds)
+{
+    try
+    {
+        RcfClient<I_Echo> client(endpoint);
+        client.getClientStub().getTransport().setMaxIncomingMessageLength(1024*1024*1024);
+        std::vector<RCF::FilterPtr> filters = stacking.createFilters();
+        if (!filters.empty())
+        {
+            client.getClientStub().requestTransportFilters(filters);
+        }
+        client.echo(payload);
+
+        timepointz t0 = clockz::now();
+        for (int r=0; r<rounds; ++r)
+        {
+            if (std::string(client.echo(payload)) != payload)
+            {
+                std::cout << "mismatch in " << stacking.name << std::endl;
+                return 0;
+            }
+        }
+        timepointz t1 = clockz::now();
+
+        // Payload goes both ways.
+        return throughput(2*payload.size(), rounds, duration_t(t1 - t0));
+    }
+    catch (const RCF::Exception & e)
+    {
+        std::cout << std::endl << stacking.name << ": " << e.getErrorMessage() << std::endl;
+        return 0;
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    std::size_t bytes = 512*1024;
+    int rounds = 20;
+    if (argc > 1) bytes = std::size_t(atoi(argv[1])) * 1024;
+    if (argc > 2) rounds = atoi(argv[2]);
+
+    RCF::RcfInit rcfInit;
+
+    Echo echo;
+    RCF::RcfServer server;
+    RCF::ServerTransport & tcpTransport = server.addEndpoint( RCF::TcpEndpoint("127.0.0.1", 0) );
+    RCF::ServerTransport & httpTransport = server.addEndpoint( RCF::HttpEndpoint("127.0.0.1", 0) );
+    tcpTransport.setMaxIncomingMessageLength(1024*1024*1024);
+    httpTransport.setMaxIncomingMessageLength(1024*1024*1024);
+    server.bind<I_Echo>(echo);
+    server.start();
+
+    int tcpPort = dynamic_cast<RCF::IpServerTransport &>(tcpTransport).getPort();
+    int httpPort = dynamic_cast<RCF::IpServerTransport &>(httpTransport).getPort();
+
+    std::string payload = makePayload(bytes);
+
+    std::cout << "payload " << bytes/1024 << " KB, " << rounds << " rounds" << std::endl;
+    std::cout << std::setw(16) << "filters"
+              << std::setw(16) << "memory MB/s"
+              << std::setw(16) << "tcp MB/s"
+              << std::setw(16) << "http MB/s"
+              << std::endl;
+
+    std::vector<Stacking> stackings = getStackings();
+    for (const Stacking & stacking : stackings)
+    {
+        std::cout << std::setw(16) << stacking.name << std::fixed << std::setprecision(1);
+
+        if (stacking.createFilters().empty())
+        {
+            std::cout << std::setw(16) << "-";
+        }
+        else
+        {
+            std::cout << std::setw(16) << benchInMemory(stacking, payload, rounds);
+        }
+
+        std::cout << std::setw(16) << benchRemote(RCF::TcpEndpoint("127.0.0.1", tcpPort), stacking, payload, rounds)
+                  << std::setw(16) << benchRemote(RCF::HttpEndpoint("127.0.0.1", httpPort), stacking, payload, rounds)
+                  << std::endl;
+    }
+
+    return 0;
+}
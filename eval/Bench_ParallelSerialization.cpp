@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip> // std::setw
+#include <string>
+#include <vector>
+
+
+#include <chrono>
+// convenience for std::chrono
+namespace chronoz = std::chrono;
+typedef chronoz::steady_clock       clockz;
+typedef clockz::time_point          timepointz;
+
+typedef std::ratio<1,1000>          ratio_milli;
+typedef chronoz::duration<double,ratio_milli>
+                                    duration_t;
+// <--
+
+
+#include <RCF/RCF.hpp>
+#include <SF/vector.hpp>
+#include <SF/string.hpp>
+
+
+struct Point
+{
+    double      x;
+    double      y;
+    std::string name;
+
+    void serialize(SF::Archive & ar)
+    {
+        ar & x & y & name;
+    }
+};
+
+typedef std::vector<Point> Points;
+
+RCF_BEGIN(I_Geometry, "I_Geometry")
+    RCF_METHOD_R3(std::size_t, merge, const Points &, const Points &, const Points &)
+RCF_END(I_Geometry)
+
+class Geometry
+{
+public:
+    std::size_t merge(const Points & a, const Points & b, const Points & c)
+    {
+        return a.size() + b.size() + c.size();
+    }
+};
+
+
+// Times a three argument remote call, with and without parallel serialization of the arguments.
+int main(int argc, char *argv[])
+{
+    std::size_t count = 500*1000;
+    int rounds = 5;
+    if (argc > 1) count = std::size_t(atoi(argv[1])) * 1000;
+    if (argc > 2) rounds = atoi(argv[2]);
+
+    RCF::RcfInit rcfInit;
+
+    Geometry geometry;
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.bind<I_Geometry>(geometry);
+    server.getServerTransport().setMaxIncomingMessageLength(1024*1024*1024);
+    server.start();
+
+    RcfClient<I_Geometry> client( RCF::TcpEndpoint("127.0.0.1", server.getIpServerTransport().getPort()) );
+    client.getClientStub().getTransport().setMaxIncomingMessageLength(1024*1024*1024);
+
+    Points points(count);
+    for (std::size_t i=0; i<count; ++i)
+    {
+        points[i].x = double(i);
+        points[i].y = double(2*i);
+        points[i].name = "point " + std::to_string(i);
+    }
+
+    std::cout << "points per argument " << count << ", " << rounds << " rounds, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::setw(16) << "threshold"
+              << std::setw(16) << "ms per call"
+              << std::endl;
+
+    const std::uint32_t thresholds[] = { 0, 1024*1024, 64*1024 };
+    for (std::uint32_t threshold : thresholds)
+    {
+        client.getClientStub().setParallelSerializationThreshold(threshold);
+        client.merge(points, points, points);
+
+        timepointz t0 = clockz::now();
+        for (int r=0; r<rounds; ++r)
+        {
+            if (client.merge(points, points, points) != 3*count)
+            {
+                std::cout << "mismatch at threshold " << threshold << std::endl;
+                return 1;
+            }
+        }
+        timepointz t1 = clockz::now();
+
+        std::cout << std::setw(16) << threshold
+                  << std::setw(16) << std::fixed << std::setprecision(1) << duration_t(t1 - t0).count() / rounds
+                  << std::endl;
+    }
+
+    return 0;
+}
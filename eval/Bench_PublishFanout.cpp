@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <iomanip> // std::setw
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#include <chrono>
+// convenience for std::chrono
+namespace chronoz = std::chrono;
+typedef chronoz::steady_clock       clockz;
+typedef clockz::time_point          timepointz;
+
+typedef std::ratio<1,1000>          ratio_milli;
+typedef chronoz::duration<double,ratio_milli>
+                                    duration_t;
+// <--
+
+
+#include <RCF/RCF.hpp>
+#include <SF/string.hpp>
+
+
+RCF_BEGIN(I_Tick, "I_Tick")
+    RCF_METHOD_V1(void, tick, const std::string &)
+RCF_END(I_Tick)
+
+class Tick
+{
+public:
+    Tick(int sleepMs) : mSleepMs(sleepMs), mCount(0)
+    {
+    }
+
+    void tick(const std::string &)
+    {
+        ++mCount;
+        if (mSleepMs)
+        {
+            std::this_thread::sleep_for(chronoz::milliseconds(mSleepMs));
+        }
+    }
+
+    int                 mSleepMs;
+    std::atomic<int>    mCount;
+};
+
+
+// Publishes messages to a set of fast subscribers and one slow subscriber, and times the publish calls.
+void benchFanout(int subscribers, RCF::SlowSubscriberPolicy policy, std::size_t bytes, int messages)
+{
+    RCF::RcfServer pubServer( RCF::TcpEndpoint("127.0.0.1", 0) );
+    pubServer.start();
+    int port = pubServer.getIpServerTransport().getPort();
+
+    RCF::PublisherParms parms;
+    parms.setSubscriberQueueLength(100);
+    parms.setSlowSubscriberPolicy(policy);
+    std::shared_ptr< RCF::Publisher<I_Tick> > pubPtr = pubServer.createPublisher<I_Tick>(parms);
+
+    // The slow subscriber gets its own server, so it doesn't hold up the other subscribers' dispatch thread.
+    RCF::RcfServer fastServer( RCF::TcpEndpoint(-1) );
+    RCF::RcfServer slowServer( RCF::TcpEndpoint(-1) );
+    fastServer.start();
+    slowServer.start();
+
+    std::vector< std::unique_ptr<Tick> > ticks;
+    std::vector<RCF::SubscriptionPtr> subs;
+    for (int i=0; i<subscribers; ++i)
+    {
+        bool slow = (i == subscribers - 1);
+        ticks.emplace_back( new Tick(slow ? 100 : 0) );
+        RCF::RcfServer & subServer = slow ? slowServer : fastServer;
+        subs.push_back( subServer.createSubscription<I_Tick>(*ticks.back(), RCF::TcpEndpoint("127.0.0.1", port)) );
+    }
+
+    while (pubPtr->getSubscriberCount() < std::size_t(subscribers))
+    {
+        pubPtr->publish().tick("");
+        std::this_thread::sleep_for(chronoz::milliseconds(10));
+    }
+
+    std::string payload(bytes, 'x');
+    double totalMs = 0;
+    double maxMs = 0;
+    for (int i=0; i<messages; ++i)
+    {
+        timepointz t0 = clockz::now();
+        pubPtr->publish().tick(payload);
+        double ms = duration_t(clockz::now() - t0).count();
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+
+        // Pace the publisher so that the fast subscribers can keep up.
+        std::this_thread::sleep_for(chronoz::microseconds(500));
+    }
+
+    std::cout << std::setw(12) << subscribers
+              << std::setw(16) << (policy == RCF::Ssp_Disconnect ? "disconnect" : policy == RCF::Ssp_Conflate ? "conflate" : "drop oldest")
+              << std::fixed << std::setprecision(3)
+              << std::setw(16) << totalMs / messages
+              << std::setw(16) << maxMs
+              << std::setw(16) << pubPtr->getSubscriberCount()
+              << std::endl;
+
+    pubPtr->close();
+}
+
+
+int main(int argc, char *argv[])
+{
+    std::size_t bytes = 16*1024;
+    int messages = 500;
+    if (argc > 1) bytes = std::size_t(atoi(argv[1])) * 1024;
+    if (argc > 2) messages = atoi(argv[2]);
+
+    RCF::RcfInit rcfInit;
+
+    std::cout << "payload " << bytes/1024 << " KB, " << messages << " messages, one slow subscriber" << std::endl;
+    std::cout << std::setw(12) << "subscribers"
+              << std::setw(16) << "policy"
+              << std::setw(16) << "avg ms/publish"
+              << std::setw(16) << "max ms/publish"
+              << std::setw(16) << "remaining"
+              << std::endl;
+
+    for (int subscribers : { 2, 8, 32 })
+    {
+        benchFanout(subscribers, RCF::Ssp_Disconnect, bytes, messages);
+        benchFanout(subscribers, RCF::Ssp_DropOldest, bytes, messages);
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <atomic>
+#include <iostream>
+#include <iomanip> // std::setw
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#include <chrono>
+// convenience for std::chrono
+namespace chronoz = std::chrono;
+typedef chronoz::steady_clock       clockz;
+typedef clockz::time_point          timepointz;
+
+typedef std::ratio<1,1000000>       ratio_micro;
+typedef chronoz::duration<double,ratio_micro>
+                                    duration_t;
+// <--
+
+
+#include <RCF/RCF.hpp>
+#include <SF/string.hpp>
+
+
+RCF_BEGIN(I_Reading, "I_Reading")
+    RCF_METHOD_V1(void, reading, const std::string &)
+RCF_END(I_Reading)
+
+class Reading
+{
+public:
+    Reading() : mCount(0)
+    {
+    }
+
+    void reading(const std::string &)
+    {
+        ++mCount;
+    }
+
+    std::atomic<int>    mCount;
+};
+
+
+// Each subscriber filters on the hardware id it owns. Publishes messages addressed to one hardware id at a time, and
+// compares with broadcasting the same messages to every subscriber.
+void benchRouting(int subscribers, std::size_t bytes, int messages)
+{
+    RCF::RcfServer pubServer( RCF::TcpEndpoint("127.0.0.1", 0) );
+    pubServer.start();
+    int port = pubServer.getIpServerTransport().getPort();
+
+    std::shared_ptr< RCF::Publisher<I_Reading> > pubPtr = pubServer.createPublisher<I_Reading>();
+
+    RCF::RcfServer subServer( RCF::TcpEndpoint(-1) );
+    subServer.start();
+
+    std::vector< std::unique_ptr<Reading> > readings;
+    std::vector<RCF::SubscriptionPtr> subs;
+    for (int i=0; i<subscribers; ++i)
+    {
+        RCF::SubscriptionFilter filter;
+        filter.addKey(1000 + i);
+
+        RCF::SubscriptionParms parms;
+        parms.setPublisherEndpoint( RCF::TcpEndpoint("127.0.0.1", port) );
+        parms.setFilter(filter);
+
+        readings.emplace_back( new Reading() );
+        subs.push_back( subServer.createSubscription<I_Reading>(*readings.back(), parms) );
+    }
+
+    // New subscribers are picked up when publishing. Key 0 has no subscribers.
+    while (pubPtr->getSubscriberCount() < std::size_t(subscribers))
+    {
+        pubPtr->publishToKey(0).reading("");
+        std::this_thread::sleep_for(chronoz::milliseconds(10));
+    }
+
+    std::string payload(bytes, 'x');
+
+    // Routing table is built on the first routed publish.
+    pubPtr->publishToKey(1000).reading(payload);
+
+    timepointz t0 = clockz::now();
+    for (int i=0; i<messages; ++i)
+    {
+        pubPtr->publishToKey(1000 + i % subscribers).reading(payload);
+    }
+    timepointz t1 = clockz::now();
+
+    // Pace the broadcasts, so that subscriber queues don't overflow.
+    double broadcastUs = 0;
+    int broadcasts = messages / subscribers + 1;
+    for (int i=0; i<broadcasts; ++i)
+    {
+        timepointz b0 = clockz::now();
+        pubPtr->publish().reading(payload);
+        broadcastUs += duration_t(clockz::now() - b0).count();
+        std::this_thread::sleep_for(chronoz::milliseconds(1));
+    }
+
+    std::cout << std::setw(12) << subscribers
+              << std::fixed << std::setprecision(2)
+              << std::setw(16) << duration_t(t1 - t0).count() / messages
+              << std::setw(16) << broadcastUs / broadcasts
+              << std::setw(16) << pubPtr->getSubscriberCount()
+              << std::endl;
+
+    pubPtr->close();
+}
+
+
+int main(int argc, char *argv[])
+{
+    std::size_t bytes = 256;
+    int messages = 20000;
+    if (argc > 1) bytes = std::size_t(atoi(argv[1]));
+    if (argc > 2) messages = atoi(argv[2]);
+
+    RCF::RcfInit rcfInit;
+
+    std::cout << "payload " << bytes << " bytes, " << messages << " routed messages" << std::endl;
+    std::cout << std::setw(12) << "subscribers"
+              << std::setw(16) << "us/routed"
+              << std::setw(16) << "us/broadcast"
+              << std::setw(16) << "remaining"
+              << std::endl;
+
+    for (int subscribers : { 4, 32, 256 })
+    {
+        benchRouting(subscribers, bytes, messages);
+    }
+
+    return 0;
+}
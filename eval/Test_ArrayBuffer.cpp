@@ -0,0 +1,282 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/ArrayBuffer.hpp>
+#include <RCF/SerializationProtocol.hpp>
+#include <SF/string.hpp>
+#include <SF/vector.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+RCF_BEGIN(I_Arrays, "I_Arrays")
+    RCF_METHOD_R2(double, sum, const std::string &, const RCF::ArrayBuffer<double> &)
+    RCF_METHOD_R2(double, sumVector, const std::string &, const std::vector<double> &)
+    RCF_METHOD_R2(RCF::ArrayBuffer<std::int64_t>, echo, const std::string &, const RCF::ArrayBuffer<std::int64_t> &)
+RCF_END(I_Arrays)
+
+class Arrays
+{
+public:
+
+    // Returns -1 if the received array is not aligned for its element type.
+    double sum(const std::string &, const RCF::ArrayBuffer<double> & arr)
+    {
+        if (reinterpret_cast<std::uintptr_t>(arr.data()) % alignof(double) != 0)
+        {
+            return -1;
+        }
+        double total = 0;
+        for (double d : arr)
+        {
+            total += d;
+        }
+        return total;
+    }
+
+    double sumVector(const std::string &, const std::vector<double> & vec)
+    {
+        double total = 0;
+        for (double d : vec)
+        {
+            total += d;
+        }
+        return total;
+    }
+
+    RCF::ArrayBuffer<std::int64_t> echo(const std::string &, const RCF::ArrayBuffer<std::int64_t> & arr)
+    {
+        return arr;
+    }
+};
+
+bool isAligned(const void * pv, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(pv) % alignment == 0;
+}
+
+bool isWithin(const void * pv, const RCF::ByteBuffer & byteBuffer)
+{
+    const char * pch = static_cast<const char *>(pv);
+    return pch >= byteBuffer.getPtr() && pch < byteBuffer.getPtr() + byteBuffer.getLength();
+}
+
+// Serializes a string followed by an array, into a single contiguous buffer.
+RCF::ByteBuffer writeMessage(const std::string & pad, const RCF::ArrayBuffer<double> & arr)
+{
+    RCF::SerializationProtocolOut out;
+    out.reset(RCF::Sp_SfBinary, 0, RCF::ByteBuffer(), RCF::getRuntimeVersion(), 0, false);
+    out.write(pad);
+    out.write(arr);
+
+    std::vector<RCF::ByteBuffer> byteBuffers;
+    out.extractByteBuffers(byteBuffers);
+
+    RCF::ByteBuffer message(RCF::lengthByteBuffers(byteBuffers));
+    RCF::copyByteBuffers(byteBuffers, message.getPtr());
+    return message;
+}
+
+// Deserializing an ArrayBuffer refers directly into the receive buffer when the elements are aligned, and
+// otherwise copies them into an aligned buffer.
+void testReceiveInPlace()
+{
+    RCF::ArrayBuffer<double> arr(1000);
+    for (std::size_t i=0; i<arr.size(); ++i)
+    {
+        arr[i] = double(i) + 0.25;
+    }
+
+    int inPlace = 0;
+    int copied = 0;
+    for (std::size_t padLen = 0; padLen < 8; ++padLen)
+    {
+        RCF::ByteBuffer message = writeMessage(std::string(padLen, 'p'), arr);
+
+        RCF::SerializationProtocolIn in;
+        in.reset(message, RCF::Sp_SfBinary, RCF::getRuntimeVersion(), 0, false);
+
+        std::string pad;
+        RCF::ArrayBuffer<double> received;
+        in.read(pad);
+        in.read(received);
+
+        CHECK(pad.size() == padLen);
+        CHECK(received.size() == arr.size());
+        CHECK(received.toVector() == arr.toVector());
+        CHECK(isAligned(received.data(), alignof(double)));
+
+        if (isWithin(received.data(), message))
+        {
+            ++inPlace;
+        }
+        else
+        {
+            ++copied;
+        }
+    }
+
+    // Eight consecutive pad lengths put the elements at every offset modulo 8, so both paths are taken.
+    if (RCF::machineOrderEqualsNetworkOrder())
+    {
+        CHECK(inPlace > 0);
+    }
+    CHECK(copied > 0);
+}
+
+// The received array stays valid after the receive buffer is reset.
+void testReceiveOwnership()
+{
+    RCF::ArrayBuffer<double> arr(16);
+    for (std::size_t i=0; i<arr.size(); ++i)
+    {
+        arr[i] = double(i);
+    }
+
+    RCF::ArrayBuffer<double> received;
+    {
+        RCF::SerializationProtocolIn in;
+        in.reset(writeMessage("", arr), RCF::Sp_SfBinary, RCF::getRuntimeVersion(), 0, false);
+        std::string pad;
+        in.read(pad);
+        in.read(received);
+        in.clearByteBuffer();
+    }
+    CHECK(received.toVector() == arr.toVector());
+}
+
+void testExtractSlice()
+{
+    RCF::ByteBuffer message(64);
+    for (std::size_t i=0; i<message.getLength(); ++i)
+    {
+        message.getPtr()[i] = char(i);
+    }
+
+    RCF::SerializationProtocolIn in;
+    in.reset(message, RCF::Sp_SfBinary, RCF::getRuntimeVersion(), 0, false);
+
+    // Slices refer into the message, at consecutive offsets.
+    RCF::ByteBuffer first;
+    RCF::ByteBuffer second;
+    in.extractSlice(first, 10);
+    in.extractSlice(second, 5);
+    CHECK(first.getPtr() == message.getPtr());
+    CHECK(first.getLength() == 10);
+    CHECK(second.getPtr() == message.getPtr() + 10);
+    CHECK(second.getLength() == 5);
+    CHECK(second.getPtr()[0] == 10);
+    CHECK(in.getRemainingArchiveLength() == 64 - 15);
+
+    // A zero length slice is empty, and does not move the read position.
+    RCF::ByteBuffer empty = first;
+    in.extractSlice(empty, 0);
+    CHECK(empty.isEmpty());
+    CHECK(in.getRemainingArchiveLength() == 64 - 15);
+
+    // The rest of the message.
+    RCF::ByteBuffer rest;
+    in.extractSlice(rest, 64 - 15);
+    CHECK(rest.getPtr() == message.getPtr() + 15);
+    CHECK(rest.getPtr()[rest.getLength() - 1] == 63);
+    CHECK(in.getRemainingArchiveLength() == 0);
+}
+
+void testRemote()
+{
+    Arrays arrays;
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.bind<I_Arrays>(arrays);
+    server.start();
+    int port = server.getIpServerTransport().getPort();
+
+    RcfClient<I_Arrays> client( RCF::TcpEndpoint("127.0.0.1", port) );
+
+    RCF::ArrayBuffer<double> arr(5000);
+    double expected = 0;
+    for (std::size_t i=0; i<arr.size(); ++i)
+    {
+        arr[i] = double(i) * 0.5;
+        expected += arr[i];
+    }
+
+    RCF::ArrayBuffer<std::int64_t> ints(3000);
+    for (std::size_t i=0; i<ints.size(); ++i)
+    {
+        ints[i] = (std::int64_t(i) << 33) - std::int64_t(i);
+    }
+
+    // Vary the position of the array within the message, so the server sees both aligned and misaligned arrays.
+    for (std::size_t padLen = 0; padLen < 8; ++padLen)
+    {
+        std::string pad(padLen, 'p');
+
+        CHECK(client.sum(pad, arr) == expected);
+
+        // std::vector<T> and ArrayBuffer<T> are interchangeable on the wire.
+        CHECK(client.sumVector(pad, arr.toVector()) == expected);
+
+        RCF::ArrayBuffer<std::int64_t> echoed = client.echo(pad, ints);
+        CHECK(isAligned(echoed.data(), alignof(std::int64_t)));
+        CHECK(echoed.toVector() == ints.toVector());
+    }
+
+    // Empty arrays.
+    CHECK(client.sum("", RCF::ArrayBuffer<double>()) == 0);
+    RCF::ArrayBuffer<std::int64_t> echoed = client.echo("", RCF::ArrayBuffer<std::int64_t>());
+    CHECK(echoed.empty());
+}
+
+void testResize()
+{
+    RCF::ArrayBuffer<int> arr(4);
+    for (std::size_t i=0; i<arr.size(); ++i)
+    {
+        arr[i] = int(i);
+    }
+    RCF::ArrayBuffer<int> copy = arr;
+
+    arr.resize(8);
+    CHECK(arr.size() == 8);
+    CHECK(arr[3] == 3);
+
+    // Resizing allocates a new buffer, and leaves other references to the old one unchanged.
+    CHECK(copy.size() == 4);
+    CHECK(copy.data() != arr.data());
+
+    arr.resize(2);
+    CHECK(arr.toVector() == std::vector<int>({0, 1}));
+}
+
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    testReceiveInPlace();
+    testReceiveOwnership();
+    testExtractSlice();
+    testRemote();
+    testResize();
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,347 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/FileStream.hpp>
+#include <RCF/FileTransferInterface.hpp>
+#include <SF/string.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+#if RCF_FEATURE_FILETRANSFER==1
+
+namespace fs = std::filesystem;
+
+RCF_BEGIN(I_Uploads, "I_Uploads")
+    RCF_METHOD_R1(std::string, getUploadPath, const std::string &)
+RCF_END(I_Uploads)
+
+class Uploads
+{
+public:
+    std::string getUploadPath(const std::string & uploadId)
+    {
+        return RCF::getCurrentRcfSession().getUploadPath(uploadId).u8string();
+    }
+};
+
+std::string readFile(const fs::path & path)
+{
+    std::ifstream fin(path, std::ios::binary);
+    return std::string( std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>() );
+}
+
+void writeFile(const fs::path & path, const std::string & data)
+{
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    fout.write(data.data(), data.size());
+}
+
+std::string makeData(std::size_t size, unsigned int seed)
+{
+    std::mt19937 gen(seed);
+    std::string data(size, 0);
+    for ( char & ch : data )
+    {
+        ch = char(gen());
+    }
+    return data;
+}
+
+// A copy of the data with a few bytes changed, a block inserted, and a block removed.
+std::string makeEdited(const std::string & data)
+{
+    std::string edited = data;
+    for ( std::size_t i=0; i<100; ++i )
+    {
+        edited[edited.size()/2 + i] ^= 0x55;
+    }
+    edited.insert(edited.size()/4, std::string(1000, 'a'));
+    edited.erase(3*edited.size()/4, 3333);
+    edited += "tail";
+    return edited;
+}
+
+const std::size_t FileSize = 4*1024*1024;
+
+// An upload server, and the bytes it received for the most recent upload.
+class Fixture
+{
+public:
+    Fixture(const fs::path & testDir, int runtimeVersion) :
+        mServer( RCF::TcpEndpoint("127.0.0.1", 0) ),
+        mBytesReceived(0),
+        mCorruptBasis(false)
+    {
+        mUploadDir = testDir / ("uploads" + std::to_string(runtimeVersion));
+        fs::create_directories(mUploadDir);
+
+        mServer.setRuntimeVersion(runtimeVersion);
+        mServer.setUploadDirectory(mUploadDir);
+        mServer.setUploadProgressCallback([&](RCF::RcfSession & session, RCF::FileUploadInfo &)
+        {
+            mBytesReceived = session.getTotalBytesReceived();
+
+            // Called once the basis hashes have been sent, so the delta upload won't match.
+            if ( mCorruptBasis )
+            {
+                mCorruptBasis = false;
+                std::fstream f(mBasisPath, std::ios::in | std::ios::out | std::ios::binary);
+                f.seekp(FileSize/8);
+                f.write("XXXXXXXX", 8);
+            }
+        });
+        mServer.setUploadBasisCallback([&](RCF::RcfSession &, const std::string & basisId) -> RCF::Path
+        {
+            if ( basisId == "corrupt" )
+            {
+                mCorruptBasis = true;
+                return mBasisPath;
+            }
+            if ( basisId == "unrelated" )
+            {
+                return mBasisPath;
+            }
+            try
+            {
+                return mServer.getUploadPath(basisId);
+            }
+            catch ( const RCF::Exception & )
+            {
+                return RCF::Path();
+            }
+        });
+        mServer.bind<I_Uploads>(mUploads);
+        mServer.start();
+    }
+
+    // Uploads over a new connection, and returns the contents of the uploaded file.
+    std::string upload(const fs::path & filePath, const std::string & basisId, int clientRuntimeVersion = RCF::getRuntimeVersion())
+    {
+        RcfClient<I_Uploads> client( RCF::TcpEndpoint("127.0.0.1", mServer.getIpServerTransport().getPort()) );
+        client.getClientStub().setRuntimeVersion(clientRuntimeVersion);
+
+        RCF::FileTransferOptions options;
+        options.mDeltaBasisId = basisId;
+
+        mBytesReceived = 0;
+        std::string uploadId;
+        client.getClientStub().uploadFile(uploadId, filePath, &options);
+        mUploadId = uploadId;
+        std::string uploadPath = client.getUploadPath(uploadId);
+        return readFile(uploadPath);
+    }
+
+    RCF::RcfServer      mServer;
+    Uploads             mUploads;
+    fs::path            mUploadDir;
+    fs::path            mBasisPath;
+    std::uint64_t       mBytesReceived;
+    bool                mCorruptBasis;
+    std::string         mUploadId;
+};
+
+// Only the changed parts of the file are sent.
+void testDelta(const fs::path & testDir)
+{
+    Fixture fixture(testDir, RCF::getRuntimeVersion());
+
+    std::string original = makeData(FileSize, 1);
+    std::string edited = makeEdited(original);
+    writeFile(testDir / "original.bin", original);
+    writeFile(testDir / "edited.bin", edited);
+
+    CHECK(fixture.upload(testDir / "original.bin", "") == original);
+    CHECK(fixture.mBytesReceived > FileSize);
+    std::string basisId = fixture.mUploadId;
+
+    CHECK(fixture.upload(testDir / "edited.bin", basisId) == edited);
+    CHECK(fixture.mBytesReceived < FileSize/8);
+
+    // Files shorter than a block, and empty files.
+    writeFile(testDir / "short.bin", "short");
+    CHECK(fixture.upload(testDir / "short.bin", basisId) == "short");
+    writeFile(testDir / "empty.bin", "");
+    CHECK(fixture.upload(testDir / "empty.bin", basisId) == "");
+
+    // Unknown basis ids, and basis files with nothing in common, upload the whole file.
+    CHECK(fixture.upload(testDir / "edited.bin", "00000000-0000-0000-0000-000000000000") == edited);
+    CHECK(fixture.mBytesReceived > edited.size());
+
+    fixture.mBasisPath = testDir / "unrelated.bin";
+    writeFile(fixture.mBasisPath, makeData(FileSize, 2));
+    CHECK(fixture.upload(testDir / "edited.bin", "unrelated") == edited);
+    CHECK(fixture.mBytesReceived > edited.size());
+}
+
+// If the basis file changes while the upload is in progress, the server detects that the reconstructed file doesn't
+// match, and the client uploads the whole file instead.
+void testMismatchedBasis(const fs::path & testDir)
+{
+    Fixture fixture(testDir, RCF::getRuntimeVersion());
+
+    std::string original = makeData(FileSize, 3);
+    std::string edited = makeEdited(original);
+    writeFile(testDir / "edited.bin", edited);
+
+    fixture.mBasisPath = testDir / "basis.bin";
+    writeFile(fixture.mBasisPath, original);
+    CHECK(fixture.upload(testDir / "edited.bin", "corrupt") == edited);
+    CHECK(!fixture.mCorruptBasis);
+    CHECK(fixture.mBytesReceived > edited.size());
+}
+
+// Copies from outside the basis file are rejected without writing anything, so the upload can carry on.
+void testBasisRange(const fs::path & testDir)
+{
+    Fixture fixture(testDir, RCF::getRuntimeVersion());
+
+    std::string original = makeData(FileSize, 4);
+    writeFile(testDir / "original.bin", original);
+    std::string basisId;
+    fixture.upload(testDir / "original.bin", "");
+    basisId = fixture.mUploadId;
+
+    RCF::RcfClient<RCF::I_FileTransferService> client( RCF::TcpEndpoint("127.0.0.1", fixture.mServer.getIpServerTransport().getPort()) );
+
+    RCF::FileManifest manifest(testDir / "original.bin");
+    std::string uploadId;
+    RCF::FileBlockHashes basisHashes;
+    std::uint32_t maxMessageLength = 0;
+    std::uint32_t bps = 0;
+    client.BeginDeltaUpload(manifest, basisId, uploadId, basisHashes, maxMessageLength, bps);
+    CHECK(basisHashes.mFileSize == FileSize);
+
+    std::vector< std::pair<std::uint64_t, std::uint32_t> > badRanges =
+    {
+        { FileSize - 10, 100 },
+        { FileSize, 1 },
+        { FileSize + 1000, 10 },
+        { std::uint64_t(-1), 10 },
+    };
+
+    for ( auto & badRange : badRanges )
+    {
+        RCF::FileChunk chunk;
+        chunk.mOffset = 0;
+        chunk.mBasisOffset = badRange.first;
+        chunk.mBasisLength = badRange.second;
+
+        int errorId = 0;
+        try
+        {
+            client.UploadDeltaChunks(uploadId, std::vector<RCF::FileChunk>(1, chunk), bps);
+        }
+        catch ( const RCF::RemoteException & e )
+        {
+            errorId = e.getErrorId();
+        }
+        CHECK(errorId == RCF::RcfError_FileRead_Id);
+    }
+
+    // Copy all but the tail from the basis, and send the tail.
+    const std::size_t TailSize = 64*1024;
+
+    RCF::FileChunk copyChunk;
+    copyChunk.mOffset = 0;
+    copyChunk.mBasisOffset = 0;
+    copyChunk.mBasisLength = FileSize - TailSize;
+
+    RCF::FileChunk dataChunk;
+    dataChunk.mOffset = FileSize - TailSize;
+    dataChunk.mData = RCF::ByteBuffer(TailSize);
+    memcpy(dataChunk.mData.getPtr(), original.data() + FileSize - TailSize, TailSize);
+
+    std::vector<RCF::FileChunk> chunks;
+    chunks.push_back(copyChunk);
+    chunks.push_back(dataChunk);
+    client.UploadDeltaChunks(uploadId, chunks, bps);
+
+    RCF::FileBlockHashes fileHashes;
+    fileHashes.compute(testDir / "original.bin", basisHashes.mBlockSize);
+    client.EndDeltaUpload(uploadId, fileHashes.getFileHash());
+
+    CHECK(readFile( fixture.mServer.getUploadPath(uploadId) ) == original);
+}
+
+// Delta uploads need runtime version 19. Below that, the whole file is uploaded, whether the client is limited to
+// the older version up front, or the server negotiates it down.
+void testRuntimeVersion(const fs::path & testDir)
+{
+    std::string original = makeData(FileSize, 5);
+    std::string edited = makeEdited(original);
+    writeFile(testDir / "original.bin", original);
+    writeFile(testDir / "edited.bin", edited);
+
+    {
+        Fixture fixture(testDir, RCF::getRuntimeVersion());
+        fixture.upload(testDir / "original.bin", "");
+        std::string basisId = fixture.mUploadId;
+
+        CHECK(fixture.upload(testDir / "edited.bin", basisId, 18) == edited);
+        CHECK(fixture.mBytesReceived > edited.size());
+
+        CHECK(fixture.upload(testDir / "edited.bin", basisId, 19) == edited);
+        CHECK(fixture.mBytesReceived < FileSize/8);
+    }
+
+    {
+        Fixture fixture(testDir, 18);
+        fixture.upload(testDir / "original.bin", "");
+        std::string basisId = fixture.mUploadId;
+
+        CHECK(fixture.upload(testDir / "edited.bin", basisId) == edited);
+        CHECK(fixture.mBytesReceived > edited.size());
+    }
+}
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    fs::path testDir = fs::temp_directory_path() / "Test_DeltaUpload";
+    fs::remove_all(testDir);
+    fs::create_directories(testDir);
+
+    testDelta(testDir);
+    testMismatchedBasis(testDir);
+    testBasisRange(testDir);
+    testRuntimeVersion(testDir);
+
+    fs::remove_all(testDir);
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
+
+#else
+
+int main()
+{
+    std::cout << "File transfers are not enabled in this build (RCF_FEATURE_FILETRANSFER)." << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,645 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/ByteOrdering.hpp>
+#include <RCF/CompressionFilter.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+const std::size_t MaxFrameLength = RCF::CompressionFilter::MaxFrameLength;
+
+std::string makeText(std::size_t length, unsigned int seed)
+{
+    static const char * words[] = { "alpha ", "beta ", "gamma ", "delta ", "remote ", "call ", "framework ", "\n" };
+
+    std::mt19937 rng(seed);
+    std::string text;
+    while (text.size() < length)
+    {
+        text += words[rng() % 8];
+    }
+    text.resize(length);
+    return text;
+}
+
+std::string makeRandom(std::size_t length, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::string data(length, 0);
+    for (char & ch : data)
+    {
+        ch = char(rng());
+    }
+    return data;
+}
+
+//------------------------------------------------------------------------------
+// Hand built LZ4 blocks.
+
+void appendLength(std::string & block, std::size_t length)
+{
+    while (length >= 255)
+    {
+        block += char(255);
+        length -= 255;
+    }
+    block += char(length);
+}
+
+// Appends a sequence of literals followed by a match. A matchLength of zero writes the final sequence of a block.
+void appendSequence(std::string & block, const std::string & literals, std::size_t offset, std::size_t matchLength)
+{
+    std::size_t literalNibble = literals.size() < 15 ? literals.size() : 15;
+    std::size_t matchNibble = 0;
+    if (matchLength > 0)
+    {
+        matchNibble = matchLength - 4 < 15 ? matchLength - 4 : 15;
+    }
+
+    block += char((literalNibble << 4) | matchNibble);
+    if (literalNibble == 15)
+    {
+        appendLength(block, literals.size() - 15);
+    }
+    block += literals;
+
+    if (matchLength > 0)
+    {
+        block += char(offset & 0xFF);
+        block += char(offset >> 8);
+        if (matchNibble == 15)
+        {
+            appendLength(block, matchLength - 4 - 15);
+        }
+    }
+}
+
+// Decompresses block into destLength bytes preceded by history. Returns the error id if decompression fails.
+int decompress(const std::string & block, std::size_t destLength, std::string & out, const std::string & history = "")
+{
+    std::vector<char> buffer(history.size() + destLength + 1, 'x');
+    memcpy(buffer.data(), history.data(), history.size());
+
+    RCF::Lz4CompressionCodec codec;
+    try
+    {
+        codec.decompress(block.data(), block.size(), buffer.data() + history.size(), destLength, history.size());
+    }
+    catch (const RCF::Exception & e)
+    {
+        return e.getErrorId();
+    }
+
+    // The byte after the output is never written.
+    CHECK(buffer.back() == 'x');
+
+    out.assign(buffer.data() + history.size(), destLength);
+    return 0;
+}
+
+bool decompressFails(const std::string & block, std::size_t destLength, const std::string & history = "")
+{
+    std::string out;
+    return decompress(block, destLength, out, history) == RCF::RcfError_CompressedData_Id;
+}
+
+void testTruncated()
+{
+    std::string block;
+    appendSequence(block, "abcd", 4, 20);
+    appendSequence(block, "tail!", 0, 0);
+
+    std::string out;
+    CHECK(decompress(block, 29, out) == 0);
+    CHECK(out == "abcdabcdabcdabcdabcdabcdtail!");
+
+    // Every proper prefix of the block is rejected.
+    for (std::size_t length = 0; length < block.size(); ++length)
+    {
+        CHECK(decompressFails(block.substr(0, length), 29));
+    }
+
+    // Literal length extension missing.
+    CHECK(decompressFails(std::string(1, char(0xF0)), 20));
+
+    // Match length extension missing.
+    CHECK(decompressFails(std::string("\x1F" "a" "\x01\x00", 4), 20));
+
+    // More literals than input.
+    CHECK(decompressFails(std::string("\x50" "ab", 3), 5));
+
+    // Literals longer than the output.
+    std::string literals;
+    appendSequence(literals, "abcdef", 0, 0);
+    CHECK(decompressFails(literals, 5));
+
+    // Output not filled.
+    CHECK(decompressFails(literals, 7));
+
+    // Match longer than the output.
+    CHECK(decompressFails(block, 23));
+}
+
+void testOffsets()
+{
+    std::string block;
+    appendSequence(block, "a", 0, 4);
+    appendSequence(block, "", 0, 0);
+    CHECK(decompressFails(block, 5));
+
+    // Offset reaching back before the start of the output.
+    block.clear();
+    appendSequence(block, "a", 2, 4);
+    appendSequence(block, "", 0, 0);
+    CHECK(decompressFails(block, 5));
+
+    // With a byte of history, the same offset is valid.
+    std::string out;
+    CHECK(decompress(block, 5, out, "h") == 0);
+    CHECK(out == "ahaha");
+
+    // But not with an offset beyond the history.
+    block.clear();
+    appendSequence(block, "a", 3, 4);
+    appendSequence(block, "", 0, 0);
+    CHECK(decompressFails(block, 5, "h"));
+
+    // Largest offset, into 64 KB of history.
+    std::string history = makeRandom(65535, 1);
+    block.clear();
+    appendSequence(block, "", 65535, 100);
+    appendSequence(block, "", 0, 0);
+    CHECK(decompress(block, 100, out, history) == 0);
+    CHECK(out == history.substr(0, 100));
+}
+
+// Overlapping matches repeat the last offset bytes. Offsets from 8 up take the 8 byte copy path, unless the match
+// runs too close to the end of the output.
+void testOverlappingMatches()
+{
+    for (std::size_t offset = 1; offset <= 17; ++offset)
+    {
+        for (std::size_t matchLength : { 4, 5, 7, 8, 9, 15, 19, 20, 37, 300 })
+        {
+            for (std::size_t tailLength : { 0, 1, 5, 16 })
+            {
+                std::string literals = makeText(offset, unsigned(offset));
+                std::string tail = makeRandom(tailLength, unsigned(matchLength));
+
+                std::string block;
+                appendSequence(block, literals, offset, matchLength);
+                appendSequence(block, tail, 0, 0);
+
+                std::string expected = literals;
+                for (std::size_t i=0; i<matchLength; ++i)
+                {
+                    expected += expected[expected.size() - offset];
+                }
+                expected += tail;
+
+                std::string out;
+                CHECK(decompress(block, expected.size(), out) == 0);
+                CHECK(out == expected);
+            }
+        }
+    }
+}
+
+void testCodecRoundTrip()
+{
+    std::vector<std::string> inputs = {
+        "",
+        "a",
+        std::string(1000, 'z'),
+        makeText(13, 1),
+        makeText(100*1000, 2),
+        makeRandom(100*1000, 3),
+        makeText(MaxFrameLength, 4) };
+
+    // Short repeating patterns, which compress to overlapping matches.
+    for (std::size_t period = 1; period <= 8; ++period)
+    {
+        std::string pattern = makeRandom(period, unsigned(period));
+        std::string input;
+        while (input.size() < 5000)
+        {
+            input += pattern;
+        }
+        inputs.push_back(input);
+    }
+
+    RCF::Lz4CompressionCodec codec;
+    for (const std::string & input : inputs)
+    {
+        std::vector<char> compressed(codec.getMaxCompressedLength(input.size()));
+        std::size_t compressedLength = codec.compress(input.data(), input.size(), 0, compressed.data(), compressed.size());
+        CHECK(compressedLength > 0);
+
+        std::string out;
+        CHECK(decompress(std::string(compressed.data(), compressedLength), input.size(), out) == 0);
+        CHECK(out == input);
+    }
+
+    // A frame that repeats its history compresses to a few bytes, and decompresses against the same history.
+    std::string window = makeRandom(20000, 5) + makeRandom(20000, 5);
+    const char * pFrame = window.data() + 20000;
+    std::vector<char> compressed(codec.getMaxCompressedLength(20000));
+    std::size_t compressedLength = codec.compress(pFrame, 20000, 20000, compressed.data(), compressed.size());
+    CHECK(0 < compressedLength && compressedLength < 200);
+
+    std::string out;
+    std::string block(compressed.data(), compressedLength);
+    CHECK(decompress(block, 20000, out, window.substr(0, 20000)) == 0);
+    CHECK(out == window.substr(20000));
+    CHECK(decompressFails(block, 20000));
+}
+
+//------------------------------------------------------------------------------
+// CompressionFilter, between test filters standing in for the transport.
+
+// Takes the place of the transport on the write side, accepting at most mMaxWrite bytes per write. Also stands in
+// for the filter above, to receive the write completion.
+class WriteSink : public RCF::IdentityFilter
+{
+public:
+    WriteSink(std::size_t maxWrite) : mMaxWrite(maxWrite), mCompleted(0)
+    {
+    }
+
+    void write(const std::vector<RCF::ByteBuffer> & byteBuffers)
+    {
+        std::vector<RCF::ByteBuffer> slicedBuffers;
+        RCF::sliceByteBuffers(slicedBuffers, byteBuffers, 0, mMaxWrite);
+        std::size_t length = RCF::lengthByteBuffers(slicedBuffers);
+        for (const RCF::ByteBuffer & byteBuffer : slicedBuffers)
+        {
+            mData.append(byteBuffer.getPtr(), byteBuffer.getLength());
+        }
+        getPreFilter().onWriteCompleted(length);
+    }
+
+    void onWriteCompleted(std::size_t bytesTransferred)
+    {
+        mCompleted = bytesTransferred;
+    }
+
+    std::size_t     mMaxWrite;
+    std::size_t     mCompleted;
+    std::string     mData;
+};
+
+// Takes the place of the transport on the read side, returning at most mMaxRead bytes per read.
+class ReadSource : public RCF::IdentityFilter
+{
+public:
+    ReadSource(const std::string & data, std::size_t maxRead) : mData(data), mPos(0), mMaxRead(maxRead)
+    {
+    }
+
+    void read(const RCF::ByteBuffer &, std::size_t bytesRequested)
+    {
+        std::size_t length = RCF_MIN(RCF_MIN(bytesRequested, mMaxRead), mData.size() - mPos);
+        if (length == 0)
+        {
+            // No more data. The read doesn't complete.
+            return;
+        }
+
+        RCF::ByteBuffer byteBuffer(length);
+        memcpy(byteBuffer.getPtr(), mData.data() + mPos, length);
+        mPos += length;
+        getPreFilter().onReadCompleted(byteBuffer);
+    }
+
+    std::string     mData;
+    std::size_t     mPos;
+    std::size_t     mMaxRead;
+};
+
+class ReadSink : public RCF::IdentityFilter
+{
+public:
+    ReadSink() : mCompleted(false)
+    {
+    }
+
+    void onReadCompleted(const RCF::ByteBuffer & byteBuffer)
+    {
+        mByteBuffer = byteBuffer;
+        mCompleted = true;
+    }
+
+    bool                mCompleted;
+    RCF::ByteBuffer     mByteBuffer;
+};
+
+std::string compressMessage(RCF::CompressionFilter & filter, const std::string & message, std::size_t maxWrite)
+{
+    WriteSink sink(maxWrite);
+    filter.setPreFilter(sink);
+    filter.setPostFilter(sink);
+    sink.setPreFilter(filter);
+
+    // Pass the message in several buffers.
+    std::vector<RCF::ByteBuffer> byteBuffers;
+    for (std::size_t pos = 0; pos < message.size(); pos += 300*1000)
+    {
+        std::size_t length = RCF_MIN(message.size() - pos, std::size_t(300*1000));
+        RCF::ByteBuffer byteBuffer(length);
+        memcpy(byteBuffer.getPtr(), message.data() + pos, length);
+        byteBuffers.push_back(byteBuffer);
+    }
+    // CompressionFilter implements the Filter interface privately.
+    static_cast<RCF::Filter &>(filter).write(byteBuffers);
+    CHECK(sink.mCompleted == message.size());
+    return sink.mData;
+}
+
+// Reads messageLength bytes from the compressed data, into a buffer of our own, or into buffers returned by the
+// filter. Returns the error id if decompression fails, or -1 if the compressed data runs out.
+int decompressMessage(
+    RCF::CompressionFilter &    filter,
+    const std::string &         compressed,
+    std::size_t                 messageLength,
+    std::size_t                 maxRead,
+    bool                        useOwnBuffer,
+    std::string &               message)
+{
+    ReadSink sink;
+    ReadSource source(compressed, maxRead);
+    filter.setPreFilter(sink);
+    filter.setPostFilter(source);
+    source.setPreFilter(filter);
+
+    RCF::ByteBuffer ownBuffer(messageLength);
+    message.clear();
+    try
+    {
+        while (message.size() < messageLength)
+        {
+            sink.mCompleted = false;
+            RCF::ByteBuffer byteBuffer;
+            if (useOwnBuffer)
+            {
+                byteBuffer = RCF::ByteBuffer(ownBuffer, message.size());
+            }
+            static_cast<RCF::Filter &>(filter).read(byteBuffer, messageLength - message.size());
+            if (!sink.mCompleted)
+            {
+                return -1;
+            }
+            if (useOwnBuffer)
+            {
+                CHECK(sink.mByteBuffer.getPtr() == ownBuffer.getPtr() + message.size());
+            }
+            message.append(sink.mByteBuffer.getPtr(), sink.mByteBuffer.getLength());
+        }
+    }
+    catch (const RCF::Exception & e)
+    {
+        return e.getErrorId();
+    }
+    return 0;
+}
+
+// Messages spanning frame boundaries, written and read in pieces of various sizes.
+void testFilterRoundTrip()
+{
+    std::vector<std::string> messages = {
+        makeText(1, 1),
+        makeText(MaxFrameLength - 1, 2),
+        makeText(MaxFrameLength, 3),
+        makeText(MaxFrameLength + 1, 4),
+        makeText(2*MaxFrameLength + 12345, 5),
+        makeRandom(MaxFrameLength + 7, 6),
+        makeText(3000, 7) };
+
+    for (bool stateful : { false, true })
+    {
+        for (bool useOwnBuffer : { false, true })
+        {
+            for (std::size_t chunkSize : { std::size_t(3), std::size_t(4096), std::size_t(10*1024*1024) })
+            {
+                RCF::Lz4CompressionFilter writer(stateful);
+                RCF::Lz4CompressionFilter reader(stateful);
+
+                for (const std::string & message : messages)
+                {
+                    // Passing megabytes through 3 bytes at a time is slow, and adds nothing to the smaller messages.
+                    if (chunkSize == 3 && message.size() > 100*1000)
+                    {
+                        continue;
+                    }
+
+                    std::string compressed = compressMessage(writer, message, chunkSize);
+                    std::string received;
+                    CHECK(decompressMessage(reader, compressed, message.size(), chunkSize, useOwnBuffer, received) == 0);
+                    CHECK(received == message);
+                }
+            }
+        }
+    }
+}
+
+// In stateful mode, a message repeating the previous one compresses against the history.
+void testFilterHistory()
+{
+    std::string message = makeRandom(30000, 8);
+
+    for (bool stateful : { false, true })
+    {
+        RCF::Lz4CompressionFilter writer(stateful);
+        RCF::Lz4CompressionFilter reader(stateful);
+
+        std::string first = compressMessage(writer, message, 10*1024*1024);
+        std::string second = compressMessage(writer, message, 10*1024*1024);
+
+        // Random data doesn't compress on its own, and is sent as a stored frame.
+        CHECK(first.size() == message.size() + 8);
+        if (stateful)
+        {
+            CHECK(second.size() < 200);
+        }
+        else
+        {
+            CHECK(second == first);
+        }
+
+        std::string received;
+        CHECK(decompressMessage(reader, first, message.size(), 4096, false, received) == 0);
+        CHECK(received == message);
+        CHECK(decompressMessage(reader, second, message.size(), 4096, false, received) == 0);
+        CHECK(received == message);
+
+        // The second message can't be read without the first.
+        if (stateful)
+        {
+            RCF::Lz4CompressionFilter fresh(stateful);
+            CHECK(decompressMessage(fresh, second, message.size(), 4096, false, received)
+                == RCF::RcfError_CompressedData_Id);
+        }
+    }
+}
+
+std::string makeHeader(std::uint32_t frameLength, std::uint32_t encodedLength)
+{
+    std::uint32_t header[2] = { frameLength, encodedLength };
+    RCF::machineToNetworkOrder(header, 4, 2);
+    return std::string(reinterpret_cast<const char *>(header), 8);
+}
+
+const std::uint32_t StoredFlag = 0x80000000;
+
+void testStoredFrames()
+{
+    std::string frames = makeHeader(5, 5 | StoredFlag) + "hello" + makeHeader(6, 6 | StoredFlag) + " world";
+
+    for (bool stateful : { false, true })
+    {
+        for (bool useOwnBuffer : { false, true })
+        {
+            RCF::Lz4CompressionFilter reader(stateful);
+            std::string received;
+            CHECK(decompressMessage(reader, frames, 11, 4096, useOwnBuffer, received) == 0);
+            CHECK(received == "hello world");
+        }
+    }
+
+    // A stored frame followed by a compressed frame that refers back into it.
+    std::string block;
+    appendSequence(block, "", 5, 5);
+    appendSequence(block, "!", 0, 0);
+    std::string mixed = makeHeader(5, 5 | StoredFlag) + "hello" + makeHeader(6, std::uint32_t(block.size())) + block;
+
+    RCF::Lz4CompressionFilter stateful(true);
+    std::string received;
+    CHECK(decompressMessage(stateful, mixed, 11, 4096, false, received) == 0);
+    CHECK(received == "hellohello!");
+
+    RCF::Lz4CompressionFilter stateless(false);
+    CHECK(decompressMessage(stateless, mixed, 11, 4096, false, received) == RCF::RcfError_CompressedData_Id);
+}
+
+void testInvalidFrames()
+{
+    std::string block;
+    appendSequence(block, "", 0, 0);
+
+    std::vector<std::string> invalid = {
+        makeHeader(0, 0 | StoredFlag),
+        makeHeader(0, 0),
+        makeHeader(std::uint32_t(MaxFrameLength + 1), std::uint32_t(MaxFrameLength + 1) | StoredFlag),
+        makeHeader(0xFFFFFFFF, 10),
+        makeHeader(5, 6 | StoredFlag) + "hello!",
+        makeHeader(5, 4 | StoredFlag) + "hell",
+        makeHeader(5, 5) + "hello",
+        makeHeader(5, 6) + "hello!",
+        makeHeader(5, std::uint32_t(block.size())) + block };
+
+    for (const std::string & frame : invalid)
+    {
+        for (bool stateful : { false, true })
+        {
+            RCF::Lz4CompressionFilter reader(stateful);
+            std::string received;
+            // Rejected before any data is returned.
+            CHECK(decompressMessage(reader, frame, 1, 4096, false, received) == RCF::RcfError_CompressedData_Id);
+        }
+    }
+
+    // Compressed data that runs out, in the header and in the frame.
+    std::string compressed;
+    {
+        RCF::Lz4CompressionFilter writer(true);
+        compressed = compressMessage(writer, makeText(50000, 10), 10*1024*1024);
+    }
+    for (std::size_t length : { std::size_t(0), std::size_t(5), std::size_t(8), compressed.size() / 2, compressed.size() - 1 })
+    {
+        RCF::Lz4CompressionFilter reader(true);
+        std::string received;
+        CHECK(decompressMessage(reader, compressed.substr(0, length), 50000, 4096, false, received) == -1);
+    }
+}
+
+// Remote calls through the LZ4 filter, with messages spanning frame boundaries.
+RCF_BEGIN(I_Echo, "I_Echo")
+    RCF_METHOD_R1(std::string, echo, const std::string &)
+RCF_END(I_Echo)
+
+class Echo
+{
+public:
+    std::string echo(const std::string & s)
+    {
+        return s;
+    }
+};
+
+void testRemote()
+{
+    Echo echo;
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.getServerTransport().setMaxIncomingMessageLength(10*1024*1024);
+    server.bind<I_Echo>(echo);
+    server.start();
+    int port = server.getIpServerTransport().getPort();
+
+    for (bool stateful : { false, true })
+    {
+        RcfClient<I_Echo> client( RCF::TcpEndpoint("127.0.0.1", port) );
+        client.getClientStub().getTransport().setMaxIncomingMessageLength(10*1024*1024);
+
+        std::vector<RCF::FilterPtr> filters;
+        filters.push_back( RCF::FilterPtr(new RCF::Lz4CompressionFilter(stateful)) );
+        client.getClientStub().requestTransportFilters(filters);
+
+        for (std::size_t length : { std::size_t(10), MaxFrameLength - 100, MaxFrameLength + 100, 3*MaxFrameLength })
+        {
+            std::string s = makeText(length, unsigned(length));
+            CHECK(client.echo(s) == s);
+
+            std::string r = makeRandom(length, unsigned(length));
+            CHECK(client.echo(r) == r);
+        }
+    }
+}
+
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    testTruncated();
+    testOffsets();
+    testOverlappingMatches();
+    testCodecRoundTrip();
+    testFilterRoundTrip();
+    testFilterHistory();
+    testStoredFrames();
+    testInvalidFrames();
+    testRemote();
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
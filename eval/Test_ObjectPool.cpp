@@ -0,0 +1,137 @@
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/ObjectPool.hpp>
+#include <RCF/ReallocBuffer.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+// Number of read buffers in the global pool. Buffers held in thread local caches are not counted.
+std::size_t countPooledBuffers()
+{
+    std::vector<std::size_t> bufferSizes;
+    RCF::getObjectPool().enumerateReadBuffers(bufferSizes);
+    return bufferSizes.size();
+}
+
+// Acquires count buffers of the given capacity, and releases them again.
+void acquireAndRelease(std::size_t count, std::size_t capacity)
+{
+    std::vector<RCF::ReallocBufferPtr> buffers;
+    for (std::size_t i=0; i<count; ++i)
+    {
+        RCF::ReallocBufferPtr bufferPtr = RCF::getObjectPool().getReallocBufferPtr(capacity);
+        bufferPtr->resize(capacity);
+        buffers.push_back(bufferPtr);
+    }
+}
+
+// Empties the global pool. Buffers released while the size limit is zero are deleted.
+void clearPool()
+{
+    RCF::ObjectPool & pool = RCF::getObjectPool();
+    std::size_t bufferSizeLimit = pool.getBufferSizeLimit();
+    pool.setBufferSizeLimit(0);
+
+    // On a thread of its own, so that whatever ends up in its thread local cache is deleted when it exits.
+    std::thread thread([&]()
+    {
+        std::vector<RCF::ReallocBufferPtr> buffers;
+        while (countPooledBuffers())
+        {
+            buffers.push_back(pool.getReallocBufferPtr());
+        }
+    });
+    thread.join();
+
+    pool.setBufferSizeLimit(bufferSizeLimit);
+}
+
+// Runs the test on a thread of its own, starting with an empty thread local cache and an empty global pool.
+void runTest(void (*test)())
+{
+    clearPool();
+    std::thread thread(test);
+    thread.join();
+}
+
+// Buffers up to the size limit are released into the thread local cache, larger ones into the global pool.
+void testSizeLimit()
+{
+    RCF::ObjectPool & pool = RCF::getObjectPool();
+    pool.setThreadCacheCountLimit(4);
+    pool.setThreadCacheSizeLimit(96*1024);
+
+    acquireAndRelease(2, 32*1024);
+    CHECK(countPooledBuffers() == 0);
+
+    acquireAndRelease(2, 100*1024);
+    CHECK(countPooledBuffers() == 2);
+}
+
+// Buffers taken from the global pool only refill the thread local cache if their whole size class is within the
+// size limit. Here the limit falls in the middle of the 64-128 kB size class.
+void testRefillLimit()
+{
+    RCF::ObjectPool & pool = RCF::getObjectPool();
+    pool.setThreadCacheCountLimit(4);
+    pool.setThreadCacheSizeLimit(96*1024);
+
+    acquireAndRelease(3, 120*1024);
+    CHECK(countPooledBuffers() == 3);
+
+    // Taking one buffer out leaves the others in the global pool.
+    RCF::ReallocBufferPtr bufferPtr = pool.getReallocBufferPtr(120*1024);
+    CHECK(bufferPtr->capacity() == 120*1024);
+    CHECK(countPooledBuffers() == 2);
+
+    // Once the whole size class is within the limit, the thread local cache takes the remaining buffer.
+    pool.setThreadCacheSizeLimit(128*1024);
+    RCF::ReallocBufferPtr secondPtr = pool.getReallocBufferPtr(120*1024);
+    CHECK(countPooledBuffers() == 0);
+}
+
+// With the count limit at zero, nothing is cached per thread.
+void testCountLimit()
+{
+    RCF::ObjectPool & pool = RCF::getObjectPool();
+    pool.setThreadCacheCountLimit(0);
+    pool.setThreadCacheSizeLimit(96*1024);
+
+    acquireAndRelease(2, 4*1024);
+    CHECK(countPooledBuffers() == 2);
+
+    pool.setThreadCacheCountLimit(4);
+}
+
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    runTest(testSizeLimit);
+    runTest(testRefillLimit);
+    runTest(testCountLimit);
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
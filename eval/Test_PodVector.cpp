@@ -0,0 +1,209 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/SerializationProtocol.hpp>
+#include <SF/vector.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+// The same layout, declared under different names and spellings on each side.
+namespace a {
+
+    struct Pt
+    {
+        double          x;
+        double          y;
+        std::int32_t    id;
+        std::int32_t    flags;
+    };
+
+    SF_SERIALIZE_AS_POD(Pt)
+
+    bool operator==(const Pt & lhs, const Pt & rhs)
+    {
+        return lhs.x == rhs.x && lhs.y == rhs.y && lhs.id == rhs.id && lhs.flags == rhs.flags;
+    }
+}
+
+namespace b {
+
+    struct Point
+    {
+        double          x;
+        double          y;
+        std::int32_t    id;
+        std::int32_t    flags;
+    };
+
+    SF_SERIALIZE_AS_POD(b::Point)
+}
+
+// Same size and alignment as a::Pt, but a different layout, told apart by its layout version.
+namespace c {
+
+    struct PtV2
+    {
+        double          x;
+        double          y;
+        std::int64_t    id;
+    };
+
+    SF_SERIALIZE_AS_POD_VERSIONED(PtV2, 2)
+}
+
+// Different size.
+namespace d {
+
+    struct Pt
+    {
+        double          x;
+        double          y;
+    };
+
+    SF_SERIALIZE_AS_POD(Pt)
+}
+
+
+RCF_BEGIN(I_Points, "I_Points")
+    RCF_METHOD_R1(std::vector<a::Pt>, echo, const std::vector<a::Pt> &)
+RCF_END(I_Points)
+
+class Points
+{
+public:
+    std::vector<a::Pt> echo(const std::vector<a::Pt> & pts)
+    {
+        return pts;
+    }
+};
+
+
+std::vector<a::Pt> makePoints(std::size_t count)
+{
+    std::vector<a::Pt> pts(count);
+    for (std::size_t i=0; i<count; ++i)
+    {
+        pts[i].x = double(i) * 1.5;
+        pts[i].y = -double(i);
+        pts[i].id = std::int32_t(i);
+        pts[i].flags = std::int32_t(i % 7);
+    }
+    return pts;
+}
+
+RCF::ByteBuffer writeMessage(const std::vector<a::Pt> & pts)
+{
+    RCF::SerializationProtocolOut out;
+    out.reset(RCF::Sp_SfBinary, 0, RCF::ByteBuffer(), RCF::getRuntimeVersion(), 0, false);
+    out.write(pts);
+
+    std::vector<RCF::ByteBuffer> byteBuffers;
+    out.extractByteBuffers(byteBuffers);
+
+    RCF::ByteBuffer message(RCF::lengthByteBuffers(byteBuffers));
+    RCF::copyByteBuffers(byteBuffers, message.getPtr());
+    return message;
+}
+
+// Reads a vector of T from the message, and returns the error id if deserialization fails.
+template<typename T>
+int readMessage(const RCF::ByteBuffer & message, std::vector<T> & vec)
+{
+    RCF::SerializationProtocolIn in;
+    in.reset(message, RCF::Sp_SfBinary, RCF::getRuntimeVersion(), 0, false);
+    try
+    {
+        in.read(vec);
+    }
+    catch (const RCF::Exception & e)
+    {
+        return e.getErrorId();
+    }
+    return 0;
+}
+
+void testRoundTrip()
+{
+    for (std::size_t count : { 0, 1, 1000 })
+    {
+        std::vector<a::Pt> pts = makePoints(count);
+        std::vector<a::Pt> received;
+        CHECK(readMessage(writeMessage(pts), received) == 0);
+        CHECK(received == pts);
+    }
+}
+
+// The checksum does not depend on how the type is spelled.
+void testSpelling()
+{
+    std::vector<a::Pt> pts = makePoints(100);
+    std::vector<b::Point> received;
+    CHECK(readMessage(writeMessage(pts), received) == 0);
+    CHECK(received.size() == pts.size());
+    for (std::size_t i=0; i<received.size() && i<pts.size(); ++i)
+    {
+        CHECK(received[i].x == pts[i].x && received[i].id == pts[i].id && received[i].flags == pts[i].flags);
+    }
+}
+
+void testMismatch()
+{
+    RCF::ByteBuffer message = writeMessage(makePoints(10));
+
+    std::vector<c::PtV2> differentVersion;
+    CHECK(readMessage(message, differentVersion) == RCF::RcfError_SfPodLayoutMismatch_Id);
+
+    std::vector<d::Pt> differentSize;
+    CHECK(readMessage(message, differentSize) == RCF::RcfError_SfPodLayoutMismatch_Id);
+}
+
+void testRemote()
+{
+    Points points;
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.bind<I_Points>(points);
+    server.start();
+    int port = server.getIpServerTransport().getPort();
+
+    RcfClient<I_Points> client( RCF::TcpEndpoint("127.0.0.1", port) );
+
+    for (std::size_t count : { 0, 1, 10000 })
+    {
+        std::vector<a::Pt> pts = makePoints(count);
+        std::vector<a::Pt> echoed = client.echo(pts);
+        CHECK(echoed == pts);
+    }
+}
+
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    testRoundTrip();
+    testSpelling();
+    testMismatch();
+    testRemote();
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
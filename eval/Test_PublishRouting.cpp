@@ -0,0 +1,452 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <SF/string.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+const std::uint64_t MaxKey = (std::numeric_limits<std::uint64_t>::max)();
+
+RCF_BEGIN(I_Reading, "I_Reading")
+    RCF_METHOD_V1(void, reading, const std::string &)
+RCF_END(I_Reading)
+
+// Records the messages it receives, up to an "end" marker. "warm" messages are only sent while waiting for
+// subscribers to be picked up, and are ignored.
+class Reading
+{
+public:
+    Reading() : mEnded(false)
+    {
+    }
+
+    void reading(const std::string & message)
+    {
+        RCF::Lock lock(mMutex);
+        if (message == "end")
+        {
+            mEnded = true;
+        }
+        else if (message != "warm")
+        {
+            mReceived.push_back(message);
+        }
+    }
+
+    // Returns the messages received before the end marker, and starts over.
+    bool takeReceived(std::vector<std::string> & received)
+    {
+        for (int i=0; i<1000 && !mEnded; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        RCF::Lock lock(mMutex);
+        received.swap(mReceived);
+        mReceived.clear();
+        bool ended = mEnded;
+        mEnded = false;
+        return ended;
+    }
+
+private:
+    RCF::Mutex                  mMutex;
+    std::vector<std::string>    mReceived;
+    std::atomic<bool>           mEnded;
+};
+
+// A message to publish, either with a routing key, with a tag, or to everyone.
+struct Message
+{
+    enum Kind { Key, Tag, All };
+
+    Kind            mKind;
+    std::uint64_t   mKey;
+    std::string     mTag;
+
+    std::string getText() const
+    {
+        return
+            mKind == Key ? "k" + std::to_string(mKey) :
+            mKind == Tag ? "t" + mTag :
+            "all";
+    }
+};
+
+Message keyMessage(std::uint64_t key)
+{
+    Message msg = { Message::Key, key, "" };
+    return msg;
+}
+
+Message tagMessage(const std::string & tag)
+{
+    Message msg = { Message::Tag, 0, tag };
+    return msg;
+}
+
+Message allMessage()
+{
+    Message msg = { Message::All, 0, "" };
+    return msg;
+}
+
+// Reference implementation of filter matching.
+bool matches(const RCF::SubscriptionFilter & filter, const Message & msg)
+{
+    if (filter.isEmpty() || msg.mKind == Message::All)
+    {
+        return true;
+    }
+    if (msg.mKind == Message::Key)
+    {
+        for (const RCF::SubscriptionFilter::KeyRange & keyRange : filter.getKeyRanges())
+        {
+            if (keyRange.first <= msg.mKey && msg.mKey <= keyRange.second)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    for (const std::string & tag : filter.getTags())
+    {
+        if (tag == msg.mTag)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A publisher and a set of subscribers, each with its own filter.
+class Fixture
+{
+public:
+
+    Fixture() :
+        mPubServer( RCF::TcpEndpoint("127.0.0.1", 0) ),
+        mSubServer( RCF::TcpEndpoint(-1) )
+    {
+        mPubServer.start();
+        mSubServer.start();
+        mPubPtr = mPubServer.createPublisher<I_Reading>();
+    }
+
+    ~Fixture()
+    {
+        mPubPtr->close();
+    }
+
+    void subscribe(const RCF::SubscriptionFilter & filter)
+    {
+        RCF::SubscriptionParms parms;
+        parms.setPublisherEndpoint( RCF::TcpEndpoint("127.0.0.1", mPubServer.getIpServerTransport().getPort()) );
+        parms.setFilter(filter);
+
+        Subscriber subscriber;
+        subscriber.mFilter = filter;
+        subscriber.mReadingPtr.reset( new Reading() );
+        subscriber.mSubscriptionPtr = mSubServer.createSubscription<I_Reading>(*subscriber.mReadingPtr, parms);
+        mSubscribers.push_back(subscriber);
+
+        waitForSubscribers();
+    }
+
+    void unsubscribe(std::size_t idx)
+    {
+        mSubscribers[idx].mSubscriptionPtr->close();
+        mSubscribers.erase(mSubscribers.begin() + idx);
+
+        waitForSubscribers();
+    }
+
+    // Publishes the messages, and checks that each subscriber receives exactly those that match its filter, in
+    // order.
+    void publishAndCheck(const std::vector<Message> & messages)
+    {
+        for (const Message & msg : messages)
+        {
+            switch (msg.mKind)
+            {
+            case Message::Key:  mPubPtr->publishToKey(msg.mKey).reading(msg.getText());    break;
+            case Message::Tag:  mPubPtr->publishToTag(msg.mTag).reading(msg.getText());    break;
+            case Message::All:  mPubPtr->publish().reading(msg.getText());                 break;
+            }
+        }
+        mPubPtr->publish().reading("end");
+
+        for (const Subscriber & subscriber : mSubscribers)
+        {
+            std::vector<std::string> expected;
+            for (const Message & msg : messages)
+            {
+                if (matches(subscriber.mFilter, msg))
+                {
+                    expected.push_back(msg.getText());
+                }
+            }
+
+            std::vector<std::string> received;
+            CHECK(subscriber.mReadingPtr->takeReceived(received));
+            CHECK(received == expected);
+        }
+    }
+
+private:
+
+    // Subscribers are picked up by the publisher when it publishes.
+    void waitForSubscribers()
+    {
+        for (int i=0; i<1000 && mPubPtr->getSubscriberCount() != mSubscribers.size(); ++i)
+        {
+            mPubPtr->publish().reading("warm");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        CHECK(mPubPtr->getSubscriberCount() == mSubscribers.size());
+    }
+
+    struct Subscriber
+    {
+        RCF::SubscriptionFilter         mFilter;
+        std::shared_ptr<Reading>        mReadingPtr;
+        RCF::SubscriptionPtr            mSubscriptionPtr;
+    };
+
+    RCF::RcfServer                                  mPubServer;
+    RCF::RcfServer                                  mSubServer;
+    std::shared_ptr< RCF::Publisher<I_Reading> >    mPubPtr;
+    std::vector<Subscriber>                         mSubscribers;
+};
+
+// Keys on and around the edges of the key ranges in makeFilters(), tags in and not in the filters, and a broadcast.
+std::vector<Message> makeMessages()
+{
+    std::vector<Message> messages;
+    for (std::uint64_t key : { 0, 1, 4, 5, 9, 10, 12, 13, 14, 15, 20, 21, 22, 25, 26, 30, 31, 40, 41 })
+    {
+        messages.push_back( keyMessage(key) );
+    }
+    for (std::uint64_t offset : { 6, 5, 4, 1, 0 })
+    {
+        messages.push_back( keyMessage(MaxKey - offset) );
+    }
+    for (const char * tag : { "red", "blue", "green", "" })
+    {
+        messages.push_back( tagMessage(tag) );
+    }
+    messages.push_back( allMessage() );
+    return messages;
+}
+
+std::vector<RCF::SubscriptionFilter> makeFilters()
+{
+    std::vector<RCF::SubscriptionFilter> filters(8);
+
+    // Overlapping ranges, across subscribers.
+    filters[0].addKeyRange(10, 20);
+    filters[1].addKeyRange(15, 30);
+    filters[1].addKey(40);
+
+    // Overlapping and adjacent ranges, within one subscriber.
+    filters[2].addKey(21);
+    filters[2].addKeyRange(20, 25);
+    filters[2].addKeyRange(26, 26);
+
+    // Ranges at either end of the key space.
+    filters[3].addKeyRange(MaxKey - 5, MaxKey);
+    filters[4].addKey(0);
+    filters[4].addKey(MaxKey);
+
+    // Tags, with a duplicate.
+    filters[5].addTag("red");
+    filters[5].addTag("blue");
+    filters[5].addTag("red");
+
+    // Tags and keys.
+    filters[6].addTag("blue");
+    filters[6].addKey(10);
+
+    // filters[7] is empty, and receives everything.
+
+    return filters;
+}
+
+void testRouting()
+{
+    Fixture fixture;
+    for (const RCF::SubscriptionFilter & filter : makeFilters())
+    {
+        fixture.subscribe(filter);
+    }
+    fixture.publishAndCheck( makeMessages() );
+
+    // The routing table is rebuilt as subscribers leave and join.
+    fixture.unsubscribe(1);
+    fixture.publishAndCheck( makeMessages() );
+
+    RCF::SubscriptionFilter filter;
+    filter.addKeyRange(5, 12);
+    filter.addKeyRange(0, MaxKey - 5);
+    fixture.subscribe(filter);
+    fixture.publishAndCheck( makeMessages() );
+
+    fixture.unsubscribe(6);
+    fixture.publishAndCheck( makeMessages() );
+}
+
+// Without any unfiltered subscribers, and with only tags.
+void testFilteredOnly()
+{
+    Fixture fixture;
+
+    RCF::SubscriptionFilter filter;
+    filter.addTag("green");
+    fixture.subscribe(filter);
+    fixture.publishAndCheck( makeMessages() );
+
+    RCF::SubscriptionFilter whole;
+    whole.addKeyRange(0, MaxKey);
+    fixture.subscribe(whole);
+    fixture.publishAndCheck( makeMessages() );
+}
+
+int subscribeWithFilter(RCF::RcfServer & subServer, int port, int runtimeVersion, const RCF::SubscriptionFilter & filter)
+{
+    RcfClient<I_Reading> client( RCF::TcpEndpoint("127.0.0.1", port) );
+    client.getClientStub().setRuntimeVersion(runtimeVersion);
+
+    RCF::SubscriptionParms parms;
+    parms.setPublisherEndpoint(client);
+    parms.setFilter(filter);
+
+    Reading reading;
+    try
+    {
+        RCF::SubscriptionPtr subscriptionPtr = subServer.createSubscription<I_Reading>(reading, parms);
+        subscriptionPtr->close();
+    }
+    catch (const RCF::Exception & e)
+    {
+        return e.getErrorId();
+    }
+    return 0;
+}
+
+// The publisher limits the number of key ranges and tags in a filter.
+void testFilterSize()
+{
+    RCF::RcfServer pubServer( RCF::TcpEndpoint("127.0.0.1", 0) );
+    pubServer.start();
+    int port = pubServer.getIpServerTransport().getPort();
+    std::shared_ptr< RCF::Publisher<I_Reading> > pubPtr = pubServer.createPublisher<I_Reading>();
+
+    RCF::RcfServer subServer( RCF::TcpEndpoint(-1) );
+    subServer.start();
+
+    int version = RCF::getRuntimeVersion();
+
+    RCF::SubscriptionFilter keys;
+    RCF::SubscriptionFilter tags;
+    for (std::size_t i=0; i<RCF::SubscriptionFilter::MaxEntries; ++i)
+    {
+        keys.addKeyRange(10*i, 10*i + 5);
+        tags.addTag("tag" + std::to_string(i));
+    }
+    CHECK(subscribeWithFilter(subServer, port, version, keys) == 0);
+    CHECK(subscribeWithFilter(subServer, port, version, tags) == 0);
+
+    keys.addKey(MaxKey);
+    tags.addTag("one too many");
+    CHECK(subscribeWithFilter(subServer, port, version, keys) == RCF::RcfError_SubscriptionFilterTooLarge_Id);
+    CHECK(subscribeWithFilter(subServer, port, version, tags) == RCF::RcfError_SubscriptionFilterTooLarge_Id);
+
+    pubPtr->close();
+}
+
+// Publishers before runtime version 20 can't evaluate filters, so filtered subscriptions to them fail, whether the
+// subscriber is limited to an older version up front, or negotiates down to it.
+void testOldPublisher()
+{
+    RCF::RcfServer pubServer( RCF::TcpEndpoint("127.0.0.1", 0) );
+    pubServer.setRuntimeVersion(19);
+    pubServer.start();
+    int port = pubServer.getIpServerTransport().getPort();
+    std::shared_ptr< RCF::Publisher<I_Reading> > pubPtr = pubServer.createPublisher<I_Reading>();
+
+    RCF::RcfServer subServer( RCF::TcpEndpoint(-1) );
+    subServer.start();
+
+    RCF::SubscriptionFilter filter;
+    filter.addKey(1);
+
+    CHECK(subscribeWithFilter(subServer, port, 19, filter) == RCF::RcfError_SubscriptionFilterNotSupported_Id);
+    CHECK(subscribeWithFilter(subServer, port, RCF::getRuntimeVersion(), filter) == RCF::RcfError_SubscriptionFilterNotSupported_Id);
+    CHECK(subscribeWithFilter(subServer, port, 19, RCF::SubscriptionFilter()) == 0);
+
+    // Async subscriptions report the failure through the completion handler.
+    Reading reading;
+    std::atomic<bool> completed(false);
+    int errorId = 0;
+    RCF::SubscriptionPtr subscriptionPtr;
+
+    RCF::SubscriptionParms parms;
+    parms.setPublisherEndpoint( RCF::TcpEndpoint("127.0.0.1", port) );
+    parms.setFilter(filter);
+    parms.setOnAsyncSubscribeCompleted( [&](RCF::SubscriptionPtr subPtr, RCF::ExceptionPtr ePtr)
+    {
+        subscriptionPtr = subPtr;
+        errorId = ePtr ? ePtr->getErrorId() : 0;
+        completed = true;
+    });
+    subServer.createSubscription<I_Reading>(reading, parms);
+
+    for (int i=0; i<1000 && !completed; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(completed);
+    CHECK(errorId == RCF::RcfError_SubscriptionFilterNotSupported_Id);
+    CHECK(!subscriptionPtr);
+
+    pubPtr->close();
+}
+
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    testRouting();
+    testFilteredOnly();
+    testFilterSize();
+    testOldPublisher();
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <SF/IBinaryStream.hpp>
+#include <SF/ITextStream.hpp>
+#include <SF/OBinaryStream.hpp>
+#include <SF/OTextStream.hpp>
+#include <SF/vector.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+// Integers at the edges of their ranges.
+struct Edges
+{
+    short               s;
+    unsigned short      us;
+    int                 i;
+    unsigned int        ui;
+    long long           ll;
+    unsigned long long  ull;
+    std::vector<int>    vec;
+
+    bool operator==(const Edges & rhs) const
+    {
+        return s == rhs.s && us == rhs.us && i == rhs.i && ui == rhs.ui && ll == rhs.ll && ull == rhs.ull
+            && vec == rhs.vec;
+    }
+};
+
+void serialize(SF::Archive & ar, Edges & e)
+{
+    ar & e.s & e.us & e.i & e.ui & e.ll & e.ull & e.vec;
+}
+
+std::vector<Edges> makeEdges()
+{
+    std::vector<Edges> edges;
+
+    Edges e = {};
+    edges.push_back(e);
+
+    e.s     = -1;
+    e.us    = 1;
+    e.i     = -1;
+    e.ui    = 1;
+    e.ll    = -1;
+    e.ull   = 1;
+    e.vec   = { -1, 0, 1 };
+    edges.push_back(e);
+
+    e.s     = -300;
+    e.us    = 300;
+    e.i     = -64;
+    e.ui    = 127;
+    e.ll    = -65;
+    e.ull   = 128;
+    e.vec   = { -64, 63, 64, -65 };
+    edges.push_back(e);
+
+    e.s     = (std::numeric_limits<short>::min)();
+    e.us    = (std::numeric_limits<unsigned short>::max)();
+    e.i     = (std::numeric_limits<int>::min)();
+    e.ui    = (std::numeric_limits<unsigned int>::max)();
+    e.ll    = (std::numeric_limits<long long>::min)();
+    e.ull   = (std::numeric_limits<unsigned long long>::max)();
+    e.vec   = { (std::numeric_limits<int>::min)(), (std::numeric_limits<int>::max)() };
+    edges.push_back(e);
+
+    e.s     = (std::numeric_limits<short>::max)();
+    e.us    = 0;
+    e.i     = (std::numeric_limits<int>::max)();
+    e.ui    = 0;
+    e.ll    = (std::numeric_limits<long long>::max)();
+    e.ull   = 0;
+    e.vec.clear();
+    edges.push_back(e);
+
+    return edges;
+}
+
+
+RCF_BEGIN(I_Echo, "I_Echo")
+    RCF_METHOD_R1(Edges, echo, const Edges &)
+    RCF_METHOD_R1(int, getRuntimeVersion, int)
+RCF_END(I_Echo)
+
+class Echo
+{
+public:
+    Edges echo(const Edges & e)
+    {
+        return e;
+    }
+
+    // Returns the runtime version the request was received with.
+    int getRuntimeVersion(int)
+    {
+        return RCF::getCurrentRcfSession().getRuntimeVersion();
+    }
+};
+
+
+template<typename T>
+std::string writeBinary(const T & t, int runtimeVersion)
+{
+    std::ostringstream os;
+    SF::OBinaryStream sfos(os);
+    sfos.setRuntimeVersion(runtimeVersion);
+    sfos << t;
+    return os.str();
+}
+
+// Reads t at the runtime version stamped in the archive, or at the given runtime version if ignoreVersionStamp is
+// set. Returns the error id if deserialization fails.
+template<typename T>
+int readBinary(const std::string & data, T & t, int runtimeVersion, bool ignoreVersionStamp = false)
+{
+    std::istringstream is(data);
+    SF::IBinaryStream sfis(is);
+    sfis.setRuntimeVersion(runtimeVersion);
+    sfis.ignoreVersionStamp(ignoreVersionStamp);
+    try
+    {
+        sfis >> t;
+    }
+    catch (const RCF::Exception & e)
+    {
+        return e.getErrorId();
+    }
+    return 0;
+}
+
+void testRoundTrip()
+{
+    for (const Edges & e : makeEdges())
+    {
+        for (int version : { 15, 16, int(RCF::getRuntimeVersion()) })
+        {
+            Edges received;
+            CHECK(readBinary(writeBinary(e, version), received, version) == 0);
+            CHECK(received == e);
+        }
+    }
+}
+
+// A peer at runtime version 16 or later writes the fixed width format once the runtime version has been negotiated
+// down to 15, and a peer that only knows version 15 can read it.
+void testOldReaderNewWriter()
+{
+    for (const Edges & e : makeEdges())
+    {
+        std::string data = writeBinary(e, 15);
+
+        Edges received;
+        CHECK(readBinary(data, received, 15, true) == 0);
+        CHECK(received == e);
+
+        // A current reader picks up the version from the archive.
+        Edges current;
+        CHECK(readBinary(data, current, RCF::getRuntimeVersion()) == 0);
+        CHECK(current == e);
+    }
+
+    // Small integers are shorter in the packed format.
+    std::vector<Edges> edges = makeEdges();
+    CHECK(writeBinary(edges[1], 16).size() < writeBinary(edges[1], 15).size());
+}
+
+// Values that don't fit the destination type are rejected rather than truncated.
+void testOutOfRange()
+{
+    long long big = (std::numeric_limits<long long>::max)();
+    int i = 0;
+    CHECK(readBinary(writeBinary(big, 16), i, 16) == RCF::RcfError_SfDataFormat_Id);
+
+    unsigned int large = 70000;
+    unsigned short us = 0;
+    CHECK(readBinary(writeBinary(large, 16), us, 16) == RCF::RcfError_SfDataFormat_Id);
+
+    // Truncated varint.
+    std::string data = writeBinary(big, 16);
+    data.resize(data.size() - 2);
+    long long ll = 0;
+    CHECK(readBinary(data, ll, 16) != 0);
+}
+
+std::string writeText(const Edges & e, int runtimeVersion)
+{
+    std::ostringstream os;
+    SF::OTextStream sfos(os);
+    sfos.setRuntimeVersion(runtimeVersion);
+    sfos.suppressArchiveMetadata();
+    sfos << e;
+    return os.str();
+}
+
+// Text archives keep the fixed width format at all runtime versions.
+void testTextArchive()
+{
+    for (const Edges & e : makeEdges())
+    {
+        std::string text = writeText(e, RCF::getRuntimeVersion());
+        CHECK(text == writeText(e, 15));
+
+        std::istringstream is(text);
+        SF::ITextStream sfis(is);
+        sfis.setRuntimeVersion(RCF::getRuntimeVersion());
+        Edges received;
+        sfis >> received;
+        CHECK(received == e);
+    }
+
+    // Integers are written as text.
+    Edges e = makeEdges()[3];
+    CHECK(writeText(e, RCF::getRuntimeVersion()).find("-2147483648") != std::string::npos);
+}
+
+// Remote calls between a current server and clients at older and newer runtime versions.
+void testRemote()
+{
+    Echo echo;
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.bind<I_Echo>(echo);
+    server.start();
+    int port = server.getIpServerTransport().getPort();
+
+    for (int version : { 15, 16, int(RCF::getRuntimeVersion()) })
+    {
+        RcfClient<I_Echo> client( RCF::TcpEndpoint("127.0.0.1", port) );
+        client.getClientStub().setRuntimeVersion(version);
+
+        CHECK(client.getRuntimeVersion(0) == version);
+        for (const Edges & e : makeEdges())
+        {
+            Edges echoed = client.echo(e);
+            CHECK(echoed == e);
+        }
+    }
+}
+
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    testRoundTrip();
+    testOldReaderNewWriter();
+    testOutOfRange();
+    testTextArchive();
+    testRemote();
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
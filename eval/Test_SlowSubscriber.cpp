@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <SF/string.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+RCF_BEGIN(I_Tick, "I_Tick")
+    RCF_METHOD_V2(void, tick, int, const std::string &)
+RCF_END(I_Tick)
+
+// Records the sequence numbers of the messages it receives. A stalled sink blocks in its first call, until it is
+// released.
+class Sink
+{
+public:
+    Sink(bool stalled) : mStalled(stalled)
+    {
+    }
+
+    void tick(int seq, const std::string &)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mReceived.push_back(seq);
+        mCondition.notify_all();
+        mCondition.wait(lock, [&]() { return !mStalled; });
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStalled = false;
+        mCondition.notify_all();
+    }
+
+    // Waits until the given message has been received, or until nothing has been received for a while.
+    std::vector<int> waitFor(int seq)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        std::size_t count = mReceived.size();
+        while (std::find(mReceived.begin(), mReceived.end(), seq) == mReceived.end())
+        {
+            mCondition.wait_for(lock, std::chrono::seconds(5));
+            if (mReceived.size() == count)
+            {
+                break;
+            }
+            count = mReceived.size();
+        }
+        return mReceived;
+    }
+
+private:
+    std::mutex                  mMutex;
+    std::condition_variable     mCondition;
+    bool                        mStalled;
+    std::vector<int>            mReceived;
+};
+
+// True if the first count elements of received are 0, 1, 2, ...
+bool isSequence(const std::vector<int> & received, std::size_t count)
+{
+    for (std::size_t i=0; i<count; ++i)
+    {
+        if (received[i] != int(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Large messages, so that only a few of them fit in the socket buffers between the publisher and the stalled
+// subscriber, and the rest back up in the publisher's queue for it.
+const std::size_t MessageSize = 1024*1024;
+const int MessageCount = 100;
+const std::size_t QueueLength = 5;
+const int FastCount = 3;
+const int ConflationKeys = 3;
+
+// Publishes messages to fast subscribers and to one stalled subscriber. Each message is published once the fast
+// subscribers have received the previous one, so the fast subscribers' queues never fill up. Returns the messages
+// the stalled subscriber received once it was released, and the number of subscribers left at the end.
+std::vector<int> publishToStalledSubscriber(
+    RCF::SlowSubscriberPolicy policy,
+    std::size_t & subscriberCount,
+    int & disconnectCount)
+{
+    // Declared ahead of the servers, which may still call into them as they stop.
+    std::atomic<int> disconnects(0);
+    std::vector< std::shared_ptr<Sink> > fastSinks;
+    Sink slowSink(true);
+
+    RCF::RcfServer pubServer( RCF::TcpEndpoint("127.0.0.1", 0) );
+    pubServer.start();
+
+    RCF::PublisherParms parms;
+    parms.setSubscriberQueueLength(QueueLength);
+    parms.setSlowSubscriberPolicy(policy);
+    parms.setOnSubscriberDisconnect([&](RCF::RcfSession &, const std::string &) { ++disconnects; });
+    std::shared_ptr< RCF::Publisher<I_Tick> > pubPtr = pubServer.createPublisher<I_Tick>(parms);
+
+    // The stalled subscriber has a server of its own, so it doesn't hold up the others.
+    RCF::RcfServer fastServer( RCF::TcpEndpoint(-1) );
+    RCF::RcfServer slowServer( RCF::TcpEndpoint(-1) );
+    fastServer.getServerTransport().setMaxIncomingMessageLength(4*MessageSize);
+    slowServer.getServerTransport().setMaxIncomingMessageLength(4*MessageSize);
+    fastServer.start();
+    slowServer.start();
+
+    RCF::TcpEndpoint pubEndpoint("127.0.0.1", pubServer.getIpServerTransport().getPort());
+
+    std::vector<RCF::SubscriptionPtr> subscriptions;
+    for (int i=0; i<FastCount; ++i)
+    {
+        fastSinks.push_back( std::make_shared<Sink>(false) );
+        subscriptions.push_back( fastServer.createSubscription<I_Tick>(*fastSinks.back(), pubEndpoint) );
+    }
+    subscriptions.push_back( slowServer.createSubscription<I_Tick>(slowSink, pubEndpoint) );
+
+    // Subscribers are picked up by the publisher when it publishes.
+    for (int i=0; i<1000 && pubPtr->getSubscriberCount() != FastCount + 1; ++i)
+    {
+        pubPtr->publish().tick(-1, "");
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(pubPtr->getSubscriberCount() == FastCount + 1);
+
+    const std::string payload(MessageSize, 'x');
+    for (int seq=0; seq<MessageCount; ++seq)
+    {
+        if (policy == RCF::Ssp_Conflate)
+        {
+            pubPtr->publish("key" + std::to_string(seq % ConflationKeys)).tick(seq, payload);
+        }
+        else
+        {
+            pubPtr->publish().tick(seq, payload);
+        }
+
+        // Fast subscribers receive every message, in order, whatever happens to the stalled one.
+        for (std::shared_ptr<Sink> & sinkPtr : fastSinks)
+        {
+            std::vector<int> received = sinkPtr->waitFor(seq);
+            received.erase(std::remove(received.begin(), received.end(), -1), received.end());
+            CHECK(received.size() == std::size_t(seq + 1) && isSequence(received, received.size()));
+        }
+    }
+
+    // Without the release, a disconnected subscriber can't be removed until its write in progress times out.
+    slowSink.release();
+    std::vector<int> received = slowSink.waitFor(MessageCount - 1);
+    received.erase(std::remove(received.begin(), received.end(), -1), received.end());
+
+    // Closed subscribers are removed when publishing.
+    for (int i=0; i<500 && (pubPtr->getSubscriberCount() == FastCount + 1) == (policy == RCF::Ssp_Disconnect); ++i)
+    {
+        pubPtr->publish().tick(-1, "");
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (int i=0; i<500 && disconnects == 0 && policy == RCF::Ssp_Disconnect; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    subscriberCount = pubPtr->getSubscriberCount();
+    disconnectCount = disconnects;
+
+    for (RCF::SubscriptionPtr & subscriptionPtr : subscriptions)
+    {
+        subscriptionPtr->close();
+    }
+    pubPtr->close();
+
+    return received;
+}
+
+// The messages already handed to the transport arrive in order. After that, the queue holds the last QueueLength
+// messages.
+void testDropOldest()
+{
+    std::size_t subscriberCount = 0;
+    int disconnectCount = 0;
+    std::vector<int> received = publishToStalledSubscriber(RCF::Ssp_DropOldest, subscriberCount, disconnectCount);
+
+    CHECK(received.size() > QueueLength);
+    std::size_t inFlight = received.size() - QueueLength;
+    CHECK(inFlight + QueueLength < MessageCount);
+    CHECK(isSequence(received, inFlight));
+    for (std::size_t i=0; i<QueueLength; ++i)
+    {
+        CHECK(received[inFlight + i] == int(MessageCount - QueueLength + i));
+    }
+
+    CHECK(subscriberCount == FastCount + 1);
+    CHECK(disconnectCount == 0);
+}
+
+// Queued messages are replaced by later messages with the same conflation key, so the queue never fills up, and
+// ends up holding the last message for each key.
+void testConflate()
+{
+    std::size_t subscriberCount = 0;
+    int disconnectCount = 0;
+    std::vector<int> received = publishToStalledSubscriber(RCF::Ssp_Conflate, subscriberCount, disconnectCount);
+
+    CHECK(received.size() > ConflationKeys);
+    std::size_t inFlight = received.size() - ConflationKeys;
+    CHECK(inFlight + ConflationKeys < MessageCount);
+    CHECK(isSequence(received, inFlight));
+
+    // Each key keeps the queue position of the first message queued with it.
+    for (std::size_t i=0; i<ConflationKeys; ++i)
+    {
+        int seq = received[inFlight + i];
+        CHECK(seq >= MessageCount - ConflationKeys);
+        CHECK(seq % ConflationKeys == int(inFlight + i) % ConflationKeys);
+    }
+
+    CHECK(subscriberCount == FastCount + 1);
+    CHECK(disconnectCount == 0);
+}
+
+// A subscriber whose queue is full is disconnected, and receives nothing that was queued for it.
+void testDisconnect()
+{
+    std::size_t subscriberCount = 0;
+    int disconnectCount = 0;
+    std::vector<int> received = publishToStalledSubscriber(RCF::Ssp_Disconnect, subscriberCount, disconnectCount);
+
+    CHECK(received.size() > 0);
+    CHECK(received.size() + QueueLength < MessageCount);
+    CHECK(isSequence(received, received.size()));
+
+    CHECK(subscriberCount == FastCount);
+    CHECK(disconnectCount == 1);
+}
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    testDropOldest();
+    testConflate();
+    testDisconnect();
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,420 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <RCF/FileStream.hpp>
+#include <RCF/FileTransferInterface.hpp>
+#include <RCF/FileTransferService.hpp>
+#include <SF/string.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+#if RCF_FEATURE_FILETRANSFER==1
+
+namespace fs = std::filesystem;
+
+RCF_BEGIN(I_Files, "I_Files")
+    RCF_METHOD_R1(std::string, offerDownload, const std::string &)
+    RCF_METHOD_R1(std::string, getUploadPath, const std::string &)
+RCF_END(I_Files)
+
+class Files
+{
+public:
+    std::string offerDownload(const std::string & filePath)
+    {
+        return RCF::getCurrentRcfSession().configureDownload(filePath);
+    }
+
+    std::string getUploadPath(const std::string & uploadId)
+    {
+        return RCF::getCurrentRcfSession().getUploadPath(uploadId).u8string();
+    }
+};
+
+std::string readFile(const fs::path & path)
+{
+    std::ifstream fin(path, std::ios::binary);
+    return std::string( std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>() );
+}
+
+void writeFile(const fs::path & path, const std::string & data)
+{
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    fout.write(data.data(), data.size());
+}
+
+std::string makeData(std::size_t size, unsigned int seed)
+{
+    std::mt19937 gen(seed);
+    std::string data(size, 0);
+    for ( char & ch : data )
+    {
+        ch = char(gen());
+    }
+    return data;
+}
+
+// Not a multiple of the chunk size, so the last chunk of the last stripe is a short one.
+const std::size_t FileSize = 6*1024*1024 + 12345;
+const std::uint32_t ChunkSize = 256*1024;
+
+class Fixture
+{
+public:
+    Fixture(const fs::path & testDir) :
+        mServer( RCF::TcpEndpoint("127.0.0.1", 0) ),
+        mTestDir(testDir)
+    {
+        fs::create_directories(testDir / "uploads");
+        fs::create_directories(testDir / "downloads");
+
+        mServer.setUploadDirectory(testDir / "uploads");
+        mServer.bind<I_Files>(mFiles);
+        mServer.start();
+
+        mClientPtr.reset( new RcfClient<I_Files>( RCF::TcpEndpoint("127.0.0.1", mServer.getIpServerTransport().getPort()) ) );
+    }
+
+    RCF::FileTransferOptions getOptions(std::uint32_t connectionCount)
+    {
+        RCF::FileTransferOptions options;
+        options.mConnectionCount = connectionCount;
+        options.mChunkSize = ChunkSize;
+        return options;
+    }
+
+    RCF::RcfServer                          mServer;
+    Files                                   mFiles;
+    fs::path                                mTestDir;
+    std::shared_ptr< RcfClient<I_Files> >   mClientPtr;
+};
+
+// Uploads and downloads are identical to the original, whatever the number of connections.
+void testRoundTrip(const fs::path & testDir)
+{
+    Fixture fixture(testDir);
+    RcfClient<I_Files> & client = *fixture.mClientPtr;
+
+    std::string data = makeData(FileSize, 1);
+    writeFile(testDir / "data.bin", data);
+    writeFile(testDir / "empty.bin", "");
+
+    for ( std::uint32_t connectionCount : { 1, 2, 4, 7 } )
+    {
+        RCF::FileTransferOptions options = fixture.getOptions(connectionCount);
+
+        std::string uploadId;
+        client.getClientStub().uploadFile(uploadId, testDir / "data.bin", &options);
+        std::string uploadPath = client.getUploadPath(uploadId);
+        CHECK(readFile(uploadPath) == data);
+
+        fs::path downloadPath = testDir / "downloads" / ("data" + std::to_string(connectionCount) + ".bin");
+        std::string downloadId = client.offerDownload( (testDir / "data.bin").u8string() );
+        client.getClientStub().downloadFile(downloadId, downloadPath, &options);
+        CHECK(readFile(downloadPath) == data);
+        CHECK(!fs::exists(downloadPath.u8string() + ".stripes"));
+
+        // Empty files.
+        uploadId.clear();
+        client.getClientStub().uploadFile(uploadId, testDir / "empty.bin", &options);
+        uploadPath = client.getUploadPath(uploadId);
+        CHECK(fs::file_size(uploadPath) == 0);
+
+        downloadPath = testDir / "downloads" / ("empty" + std::to_string(connectionCount) + ".bin");
+        downloadId = client.offerDownload( (testDir / "empty.bin").u8string() );
+        client.getClientStub().downloadFile(downloadId, downloadPath, &options);
+        CHECK(fs::exists(downloadPath) && fs::file_size(downloadPath) == 0);
+    }
+}
+
+// Writes a .stripes record for the byte ranges still to be downloaded.
+void writeStripesRecord(const fs::path & downloadPath, const std::vector<std::uint64_t> & values)
+{
+    std::ofstream fout(downloadPath.u8string() + ".stripes", std::ios::binary | std::ios::trunc);
+    fout.write( (const char *) &values[0], values.size()*sizeof(std::uint64_t) );
+}
+
+// Downloads, and returns the progress reported before the first chunk arrived.
+std::uint64_t resumeDownload(Fixture & fixture, const fs::path & downloadPath)
+{
+    RcfClient<I_Files> & client = *fixture.mClientPtr;
+
+    std::uint64_t startBytes = std::uint64_t(-1);
+    client.getClientStub().setFileProgressCallback([&](const RCF::FileTransferProgress & progress, RCF::RemoteCallAction &)
+    {
+        if ( startBytes == std::uint64_t(-1) )
+        {
+            startBytes = progress.mBytesTransferredSoFar;
+        }
+    });
+
+    RCF::FileTransferOptions options = fixture.getOptions(3);
+    std::string downloadId = client.offerDownload( (fixture.mTestDir / "data.bin").u8string() );
+    client.getClientStub().downloadFile(downloadId, downloadPath, &options);
+    client.getClientStub().setFileProgressCallback();
+
+    return startBytes;
+}
+
+// Interrupted downloads resume from the ranges listed in their .stripes record.
+void testDownloadResume(const fs::path & testDir)
+{
+    Fixture fixture(testDir);
+    RcfClient<I_Files> & client = *fixture.mClientPtr;
+
+    std::string data = makeData(FileSize, 2);
+    writeFile(testDir / "data.bin", data);
+
+    // Cancelled part way through.
+    {
+        fs::path downloadPath = testDir / "downloads" / "cancelled.bin";
+
+        int calls = 0;
+        client.getClientStub().setFileProgressCallback([&](const RCF::FileTransferProgress &, RCF::RemoteCallAction & action)
+        {
+            if ( ++calls == 8 )
+            {
+                action = RCF::Rca_Cancel;
+            }
+        });
+
+        bool cancelled = false;
+        try
+        {
+            RCF::FileTransferOptions options = fixture.getOptions(3);
+            std::string downloadId = client.offerDownload( (testDir / "data.bin").u8string() );
+            client.getClientStub().downloadFile(downloadId, downloadPath, &options);
+        }
+        catch ( const RCF::Exception & )
+        {
+            cancelled = true;
+        }
+        client.getClientStub().setFileProgressCallback();
+        CHECK(cancelled);
+        CHECK(fs::exists(downloadPath.u8string() + ".stripes"));
+
+        std::uint64_t startBytes = resumeDownload(fixture, downloadPath);
+        CHECK(startBytes > 0 && startBytes < FileSize);
+        CHECK(readFile(downloadPath) == data);
+        CHECK(!fs::exists(downloadPath.u8string() + ".stripes"));
+    }
+
+    // Only the ranges listed in the record are downloaded. The rest of the file is left as it is.
+    {
+        fs::path downloadPath = testDir / "downloads" / "holes.bin";
+
+        std::vector<std::uint64_t> values = { 0, FileSize, 1000000, 2500000, 4000000, FileSize };
+        std::uint64_t pendingBytes = (2500000 - 1000000) + (FileSize - 4000000);
+
+        std::string partial = data;
+        for ( std::size_t i=2; i<values.size(); i+=2 )
+        {
+            std::fill(partial.begin() + values[i], partial.begin() + values[i+1], 0);
+        }
+        partial[0] = ~data[0];
+        writeFile(downloadPath, partial);
+        writeStripesRecord(downloadPath, values);
+
+        CHECK(resumeDownload(fixture, downloadPath) == FileSize - pendingBytes);
+
+        std::string expected = data;
+        expected[0] = ~data[0];
+        CHECK(readFile(downloadPath) == expected);
+        CHECK(!fs::exists(downloadPath.u8string() + ".stripes"));
+    }
+
+    // Records that don't match the download, or are malformed, start the download over.
+    std::vector< std::vector<std::uint64_t> > badRecords =
+    {
+        { 0, FileSize + 1, 1000000, 2000000 },
+        { 0, FileSize, 2000000, 1000000 },
+        { 0, FileSize, 1000000, FileSize + 1 },
+        { 0, FileSize, 1000000 },
+    };
+    for ( const std::vector<std::uint64_t> & values : badRecords )
+    {
+        fs::path downloadPath = testDir / "downloads" / "bad.bin";
+        writeFile(downloadPath, std::string(FileSize, 0));
+        writeStripesRecord(downloadPath, values);
+
+        CHECK(resumeDownload(fixture, downloadPath) == 0);
+        CHECK(readFile(downloadPath) == data);
+    }
+}
+
+// Interrupted uploads resume under the same upload id, sending only the ranges the server doesn't have yet.
+void testUploadResume(const fs::path & testDir)
+{
+    Fixture fixture(testDir);
+    RcfClient<I_Files> & client = *fixture.mClientPtr;
+
+    std::string data = makeData(FileSize, 3);
+    writeFile(testDir / "data.bin", data);
+
+    RCF::FileTransferOptions options = fixture.getOptions(4);
+    std::string uploadId;
+
+    int calls = 0;
+    client.getClientStub().setFileProgressCallback([&](const RCF::FileTransferProgress &, RCF::RemoteCallAction & action)
+    {
+        if ( ++calls == 8 )
+        {
+            action = RCF::Rca_Cancel;
+        }
+    });
+
+    bool cancelled = false;
+    try
+    {
+        client.getClientStub().uploadFile(uploadId, testDir / "data.bin", &options);
+    }
+    catch ( const RCF::Exception & )
+    {
+        cancelled = true;
+    }
+    CHECK(cancelled);
+    CHECK(uploadId.size() > 0);
+
+    std::uint64_t startBytes = std::uint64_t(-1);
+    client.getClientStub().setFileProgressCallback([&](const RCF::FileTransferProgress & progress, RCF::RemoteCallAction &)
+    {
+        if ( startBytes == std::uint64_t(-1) )
+        {
+            startBytes = progress.mBytesTransferredSoFar;
+        }
+    });
+
+    std::string resumedId = uploadId;
+    client.getClientStub().uploadFile(resumedId, testDir / "data.bin", &options);
+    client.getClientStub().setFileProgressCallback();
+
+    CHECK(resumedId == uploadId);
+    CHECK(startBytes > 0 && startBytes < FileSize);
+    std::string uploadPath = client.getUploadPath(uploadId);
+    CHECK(readFile(uploadPath) == data);
+}
+
+std::size_t countFiles(const fs::path & dir)
+{
+    return std::distance(fs::directory_iterator(dir), fs::directory_iterator());
+}
+
+// Idle striped uploads are abandoned, and their partial files deleted. Uploads that are still active are not.
+void testIdleExpiry(const fs::path & testDir)
+{
+    fs::path uploadDir = testDir / "expiry";
+    fs::create_directories(uploadDir);
+
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.setUploadDirectory(uploadDir);
+    server.setUploadIdleTimeoutS(1);
+    server.getFileTransferServicePtr()->setTransferWindowS(1);
+    server.start();
+
+    RCF::RcfClient<RCF::I_FileTransferService> client( RCF::TcpEndpoint("127.0.0.1", server.getIpServerTransport().getPort()) );
+
+    RCF::FileManifest manifest;
+    RCF::FileInfo fileInfo;
+    fileInfo.mFilePath = "idle.bin";
+    fileInfo.mFileSize = 100;
+    manifest.mFiles.push_back(fileInfo);
+
+    std::string uploadId;
+    std::vector<std::uint64_t> ranges;
+    std::uint32_t maxMessageLength = 0;
+    std::uint32_t bps = 0;
+    client.BeginStripedUpload(manifest, uploadId, ranges, maxMessageLength, bps);
+    CHECK(ranges == std::vector<std::uint64_t>({ 0, 100 }));
+
+    std::vector<RCF::FileChunk> chunks(1);
+    chunks[0].mOffset = 0;
+    chunks[0].mData = RCF::ByteBuffer(10);
+    client.UploadStripeChunks(uploadId, chunks, bps);
+    CHECK(countFiles(uploadDir) == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(3500));
+    CHECK(countFiles(uploadDir) == 0);
+
+    int errorId = 0;
+    try
+    {
+        client.UploadStripeChunks(uploadId, chunks, bps);
+    }
+    catch ( const RCF::RemoteException & e )
+    {
+        errorId = e.getErrorId();
+    }
+    CHECK(errorId == RCF::RcfError_NoUpload_Id);
+
+    // Resuming an expired upload starts it over, under a new upload id.
+    std::string resumedId = uploadId;
+    client.BeginStripedUpload(manifest, resumedId, ranges, maxMessageLength, bps);
+    CHECK(resumedId != uploadId);
+    CHECK(ranges == std::vector<std::uint64_t>({ 0, 100 }));
+
+    // An upload that keeps receiving chunks stays alive past the idle timeout, and completes.
+    for ( std::uint64_t offset = 0; offset < 100; offset += 10 )
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        chunks[0].mOffset = offset;
+        client.UploadStripeChunks(resumedId, chunks, bps);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+    CHECK(countFiles(uploadDir) == 1);
+    CHECK(fs::file_size(server.getUploadPath(resumedId)) == 100);
+}
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    fs::path testDir = fs::temp_directory_path() / "Test_StripedTransfer";
+    fs::remove_all(testDir);
+    fs::create_directories(testDir);
+
+    testRoundTrip(testDir);
+    testDownloadResume(testDir);
+    testUploadResume(testDir);
+    testIdleExpiry(testDir);
+
+    fs::remove_all(testDir);
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
+
+#else
+
+int main()
+{
+    std::cout << "File transfers are not enabled in this build (RCF_FEATURE_FILETRANSFER)." << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,637 @@
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+#include <RCF/RCF.hpp>
+#include <SF/IBinaryStream.hpp>
+#include <SF/memory.hpp>
+#include <SF/OBinaryStream.hpp>
+#include <SF/SerializeParent.hpp>
+#include <SF/string.hpp>
+#include <SF/vector.hpp>
+
+
+int gFailures = 0;
+
+#define CHECK(cond)                                                                         \
+    if (!(cond))                                                                            \
+    {                                                                                       \
+        std::cout << __FILE__ << "(" << __LINE__ << "): check failed: " << #cond << std::endl; \
+        ++gFailures;                                                                        \
+    }
+
+
+// Pointer tracking.
+
+struct Item;
+typedef std::shared_ptr<Item> ItemPtr;
+
+// A node in a chain of items, which also refers to a later item in the chain, so the same item is reached more 
+// than once.
+struct Item
+{
+    int             mValue = 0;
+    std::string     mName;
+    ItemPtr         mNext;
+    ItemPtr         mLater;
+
+    void serialize(SF::Archive & ar)
+    {
+        ar & mValue & mName & mNext & mLater;
+    }
+};
+
+struct Graph
+{
+    ItemPtr         mHead;
+
+    void serialize(SF::Archive & ar)
+    {
+        ar & mHead;
+    }
+};
+
+Graph makeGraph(std::size_t length)
+{
+    std::vector<ItemPtr> items;
+    for (std::size_t i=0; i<length; ++i)
+    {
+        ItemPtr itemPtr( new Item() );
+        itemPtr->mValue = int(i);
+        itemPtr->mName = "item" + std::to_string(i);
+        items.push_back(itemPtr);
+    }
+    for (std::size_t i=0; i+1<length; ++i)
+    {
+        items[i]->mNext = items[i+1];
+        items[i]->mLater = items[ RCF_MIN(length-1, i + 1 + (i*7) % 10) ];
+    }
+
+    Graph graph;
+    if (length)
+    {
+        graph.mHead = items[0];
+    }
+    return graph;
+}
+
+// Returns the number of distinct items reachable from the head.
+std::size_t countDistinct(const Graph & graph)
+{
+    std::set<Item *> distinct;
+    for (Item * pItem = graph.mHead.get(); pItem; pItem = pItem->mNext.get())
+    {
+        distinct.insert(pItem);
+        if (pItem->mLater)
+        {
+            distinct.insert(pItem->mLater.get());
+        }
+    }
+    return distinct.size();
+}
+
+bool sameGraph(const Graph & lhs, const Graph & rhs)
+{
+    if (countDistinct(lhs) != countDistinct(rhs))
+    {
+        return false;
+    }
+    Item * pLhs = lhs.mHead.get();
+    Item * pRhs = rhs.mHead.get();
+    while (pLhs && pRhs)
+    {
+        if (    pLhs->mValue != pRhs->mValue 
+            ||  pLhs->mName != pRhs->mName 
+            ||  bool(pLhs->mLater) != bool(pRhs->mLater)
+            ||  (pLhs->mLater && pLhs->mLater->mValue != pRhs->mLater->mValue))
+        {
+            return false;
+        }
+        pLhs = pLhs->mNext.get();
+        pRhs = pRhs->mNext.get();
+    }
+    return !pLhs && !pRhs;
+}
+
+// Skips nids on the writing side, so that the nids that follow are far beyond the number of objects in the archive,
+// as they would be in a malformed archive. Nothing is written.
+struct NidGap
+{
+    std::size_t     mCount = 0;
+
+    void serialize(SF::Archive & ar)
+    {
+        if (ar.isWrite() && ar.getOstream()->getEnablePointerTracking())
+        {
+            SF::ContextWrite & ctx = ar.getOstream()->getTrackingContext();
+            for (std::size_t i=0; i<mCount; ++i)
+            {
+                SF::UInt32 nid = 0;
+                ctx.add( SF::ObjectId(reinterpret_cast<void *>(i+1), &typeid(NidGap)), nid );
+            }
+        }
+    }
+};
+
+// Two items on either side of a gap in the nids, and a second reference to the first one.
+struct GappedItems
+{
+    ItemPtr         mFirst;
+    NidGap          mGap;
+    ItemPtr         mSecond;
+    ItemPtr         mFirstAgain;
+
+    void serialize(SF::Archive & ar)
+    {
+        ar & mFirst & mGap & mSecond & mFirstAgain;
+    }
+};
+
+GappedItems makeGappedItems(std::size_t gap)
+{
+    GappedItems items;
+    items.mFirst.reset( new Item() );
+    items.mFirst->mValue = 1;
+    items.mSecond.reset( new Item() );
+    items.mSecond->mValue = 2;
+    items.mFirstAgain = items.mFirst;
+    items.mGap.mCount = gap;
+    return items;
+}
+
+bool isIntact(const GappedItems & items)
+{
+    return items.mFirst 
+        && items.mFirst->mValue == 1 
+        && items.mSecond 
+        && items.mSecond->mValue == 2 
+        && items.mFirstAgain == items.mFirst;
+}
+
+
+// Polymorphic serialization, with types registered by type id and by name.
+
+class Shape
+{
+public:
+    virtual ~Shape() {}
+    virtual double area() const = 0;
+
+    void serialize(SF::Archive &)
+    {
+    }
+};
+
+class Square : public Shape
+{
+public:
+    double mSide = 0;
+
+    double area() const
+    {
+        return mSide*mSide;
+    }
+
+    void serialize(SF::Archive & ar)
+    {
+        SF::serializeParent<Shape>(ar, *this);
+        ar & mSide;
+    }
+};
+
+class Rect : public Shape
+{
+public:
+    double mWidth = 0;
+    double mHeight = 0;
+
+    double area() const
+    {
+        return mWidth*mHeight;
+    }
+
+    void serialize(SF::Archive & ar)
+    {
+        SF::serializeParent<Shape>(ar, *this);
+        ar & mWidth & mHeight;
+    }
+};
+
+typedef std::shared_ptr<Shape> ShapePtr;
+
+void registerShapes()
+{
+    SF::registerType<Square>("Square", 1);
+    SF::registerBaseAndDerived<Shape, Square>();
+
+    // Registered by name only.
+    SF::registerType<Rect>("Rect");
+    SF::registerBaseAndDerived<Shape, Rect>();
+}
+
+std::vector<ShapePtr> makeShapes()
+{
+    std::vector<ShapePtr> shapes;
+    for (int i=0; i<10; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            std::shared_ptr<Rect> rectPtr( new Rect() );
+            rectPtr->mWidth = i;
+            rectPtr->mHeight = 2;
+            shapes.push_back(rectPtr);
+        }
+        else
+        {
+            std::shared_ptr<Square> squarePtr( new Square() );
+            squarePtr->mSide = i;
+            shapes.push_back(squarePtr);
+        }
+    }
+    shapes.push_back( ShapePtr() );
+    return shapes;
+}
+
+bool sameShapes(const std::vector<ShapePtr> & lhs, const std::vector<ShapePtr> & rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (std::size_t i=0; i<lhs.size(); ++i)
+    {
+        if (bool(lhs[i]) != bool(rhs[i]))
+        {
+            return false;
+        }
+        if (lhs[i] && (typeid(*lhs[i]) != typeid(*rhs[i]) || lhs[i]->area() != rhs[i]->area()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Schema-fixed serialization.
+
+struct Record
+{
+    int                 mId = 0;
+    std::string         mName;
+    std::vector<double> mValues;
+
+    void serialize(SF::Archive & ar)
+    {
+        ar & mId & mName & mValues;
+    }
+
+    bool operator==(const Record & rhs) const
+    {
+        return mId == rhs.mId && mName == rhs.mName && mValues == rhs.mValues;
+    }
+};
+
+std::vector<Record> makeRecords()
+{
+    std::vector<Record> records(100);
+    for (std::size_t i=0; i<records.size(); ++i)
+    {
+        records[i].mId = int(i) - 50;
+        records[i].mName = "record" + std::to_string(i);
+        records[i].mValues.assign(i % 5, double(i));
+    }
+    return records;
+}
+
+
+RCF_BEGIN(I_Compat, "I_Compat")
+    RCF_METHOD_R0(int, getRuntimeVersion)
+    RCF_METHOD_R1(Graph, echoGraph, const Graph &)
+    RCF_METHOD_R1(std::size_t, countDistinctItems, const Graph &)
+    RCF_METHOD_R1(bool, checkGappedItems, const GappedItems &)
+    RCF_METHOD_R1(std::vector<ShapePtr>, echoShapes, const std::vector<ShapePtr> &)
+    RCF_METHOD_R1(double, totalArea, const std::vector<ShapePtr> &)
+    RCF_METHOD_R1(std::vector<Record>, echoRecords, const std::vector<Record> &)
+    RCF_METHOD_V2(void, scaleRecords, std::vector<Record> &, double)
+    RCF_METHOD_R3(std::size_t, countAll, const std::vector<Record> &, const std::vector<double> &, const std::string &)
+RCF_END(I_Compat)
+
+class Compat
+{
+public:
+
+    // Returns the runtime version the request was received with.
+    int getRuntimeVersion()
+    {
+        return RCF::getCurrentRcfSession().getRuntimeVersion();
+    }
+
+    // Pointer tracking for responses is enabled by the server.
+    Graph echoGraph(const Graph & graph)
+    {
+        RCF::getCurrentRcfSession().setEnableSfPointerTracking(true);
+        return graph;
+    }
+
+    std::size_t countDistinctItems(const Graph & graph)
+    {
+        return countDistinct(graph);
+    }
+
+    bool checkGappedItems(const GappedItems & items)
+    {
+        return isIntact(items);
+    }
+
+    std::vector<ShapePtr> echoShapes(const std::vector<ShapePtr> & shapes)
+    {
+        return shapes;
+    }
+
+    std::vector<Record> echoRecords(const std::vector<Record> & records)
+    {
+        return records;
+    }
+
+    void scaleRecords(std::vector<Record> & records, double factor)
+    {
+        if (factor < 0)
+        {
+            throw std::runtime_error("Negative factor.");
+        }
+        for (Record & record : records)
+        {
+            for (double & value : record.mValues)
+            {
+                value *= factor;
+            }
+        }
+    }
+
+    std::size_t countAll(
+        const std::vector<Record> &     records, 
+        const std::vector<double> &     values, 
+        const std::string &             text)
+    {
+        return records.size() + values.size() + text.size();
+    }
+
+    double totalArea(const std::vector<ShapePtr> & shapes)
+    {
+        double area = 0;
+        for (const ShapePtr & shapePtr : shapes)
+        {
+            area += shapePtr ? shapePtr->area() : 0;
+        }
+        return area;
+    }
+};
+
+
+typedef RcfClient<I_Compat> CompatClient;
+
+// Runs test against a server limited to serverVersion, from a client limited to clientVersion. The client
+// negotiates down to the lower of the two versions.
+void runAtVersions(
+    int                                         clientVersion,
+    int                                         serverVersion,
+    std::function<void(CompatClient &)>         test)
+{
+    Compat compat;
+    RCF::RcfServer server( RCF::TcpEndpoint("127.0.0.1", 0) );
+    server.setRuntimeVersion(serverVersion);
+    server.bind<I_Compat>(compat);
+    server.start();
+    int port = server.getIpServerTransport().getPort();
+
+    CompatClient client( RCF::TcpEndpoint("127.0.0.1", port) );
+    client.getClientStub().setRuntimeVersion(clientVersion);
+
+    int expectedVersion = RCF_MIN(clientVersion, serverVersion);
+    CHECK(client.getRuntimeVersion() == expectedVersion);
+    CHECK(int(client.getClientStub().getRuntimeVersion()) == expectedVersion);
+
+    test(client);
+}
+
+// Runs test with an old client against a current server, and a current client against an old server.
+void runAgainstVersion(int oldVersion, std::function<void(CompatClient &)> test)
+{
+    int currentVersion = RCF::getRuntimeVersion();
+    runAtVersions(oldVersion, currentVersion, test);
+    runAtVersions(currentVersion, oldVersion, test);
+}
+
+
+void testPointerTracking(CompatClient & client)
+{
+    client.getClientStub().setEnableSfPointerTracking(true);
+
+    for (std::size_t length : { 1, 10, 500 })
+    {
+        Graph graph = makeGraph(length);
+        CHECK(client.countDistinctItems(graph) == length);
+
+        Graph echoed = client.echoGraph(graph);
+        CHECK(sameGraph(echoed, graph));
+    }
+
+    // Without tracking, each reference is deserialized as a separate object.
+    client.getClientStub().setEnableSfPointerTracking(false);
+    Graph graph = makeGraph(10);
+    CHECK(client.countDistinctItems(graph) > 10);
+}
+
+// Reads GappedItems written at the given runtime version. Returns the error id if deserialization fails.
+int readGappedItems(std::size_t gap, int runtimeVersion, GappedItems & items)
+{
+    std::ostringstream os;
+    SF::OBinaryStream sfos(os);
+    sfos.setRuntimeVersion(runtimeVersion);
+    sfos.setEnablePointerTracking(true);
+    sfos << makeGappedItems(gap);
+
+    std::istringstream is(os.str());
+    SF::IBinaryStream sfis(is);
+    try
+    {
+        sfis >> items;
+    }
+    catch (const RCF::Exception & e)
+    {
+        return e.getErrorId();
+    }
+    return 0;
+}
+
+// Nids far beyond the number of objects tracked so far are rejected, rather than allocated for.
+void testMalformedTracking()
+{
+    for (int version : { 10, 15, int(RCF::getRuntimeVersion()) })
+    {
+        for (std::size_t gap : { 0, 100, 1000 })
+        {
+            GappedItems items;
+            CHECK(readGappedItems(gap, version, items) == 0);
+            CHECK(isIntact(items));
+        }
+
+        for (std::size_t gap : { 2000, 100000 })
+        {
+            GappedItems items;
+            CHECK(readGappedItems(gap, version, items) == RCF::RcfError_Decoding_Id);
+        }
+    }
+}
+
+void testMalformedTrackingRemote(CompatClient & client)
+{
+    client.getClientStub().setEnableSfPointerTracking(true);
+    CHECK(client.checkGappedItems(makeGappedItems(100)));
+
+    bool threw = false;
+    try
+    {
+        client.checkGappedItems(makeGappedItems(100000));
+    }
+    catch (const RCF::RemoteException & e)
+    {
+        threw = e.getErrorId() == RCF::RcfError_Decoding_Id;
+    }
+    CHECK(threw);
+
+    // The connection is still usable.
+    CHECK(client.checkGappedItems(makeGappedItems(0)));
+}
+
+void testPolymorphic(CompatClient & client)
+{
+    std::vector<ShapePtr> shapes = makeShapes();
+
+    double area = 0;
+    for (const ShapePtr & shapePtr : shapes)
+    {
+        area += shapePtr ? shapePtr->area() : 0;
+    }
+    CHECK(client.totalArea(shapes) == area);
+
+    std::vector<ShapePtr> echoed = client.echoShapes(shapes);
+    CHECK(sameShapes(echoed, shapes));
+}
+
+void testSchemaFixed(CompatClient & client)
+{
+    client.getClientStub().setEnableSfSchemaFixed(true);
+
+    std::vector<Record> records = makeRecords();
+    CHECK(client.echoRecords(records) == records);
+
+    std::vector<Record> scaled = records;
+    client.scaleRecords(scaled, 2.0);
+    for (std::size_t i=0; i<records.size(); ++i)
+    {
+        for (std::size_t j=0; j<records[i].mValues.size(); ++j)
+        {
+            CHECK(scaled[i].mValues[j] == 2*records[i].mValues[j]);
+        }
+    }
+
+    // Exceptions are serialized with node headers.
+    bool threw = false;
+    try
+    {
+        client.scaleRecords(scaled, -1.0);
+    }
+    catch (const RCF::RemoteException & e)
+    {
+        threw = std::string(e.what()).find("Negative factor.") != std::string::npos;
+    }
+    CHECK(threw);
+
+    // Calls still work after the exception.
+    CHECK(client.echoRecords(records) == records);
+}
+
+void testParallelSerialization(CompatClient & client)
+{
+    // Low enough that every parameter below is written as a parallel segment.
+    client.getClientStub().setParallelSerializationThreshold(1024);
+
+    std::vector<Record> records = makeRecords();
+    std::vector<double> values(20000, 1.5);
+    std::string text(5000, 't');
+
+    CHECK(client.countAll(records, values, text) == records.size() + values.size() + text.size());
+    CHECK(client.echoRecords(records) == records);
+
+    // Parameters below the threshold, mixed with parameters above it.
+    CHECK(client.countAll(std::vector<Record>(), values, "") == values.size());
+
+    std::vector<Record> scaled = records;
+    client.scaleRecords(scaled, 3.0);
+    CHECK(scaled.size() == records.size() && scaled.back().mValues == std::vector<double>(4, 3*99.0));
+
+    // Together with schema-fixed serialization.
+    client.getClientStub().setEnableSfSchemaFixed(true);
+    CHECK(client.echoRecords(records) == records);
+}
+
+
+int main()
+{
+    RCF::RcfInit rcfInit;
+
+    registerShapes();
+
+    // Pointer tracking settings in request headers came with runtime version 10.
+    for (int version : { 10, 13, 15 })
+    {
+        runAgainstVersion(version, testPointerTracking);
+    }
+    runAtVersions(RCF::getRuntimeVersion(), RCF::getRuntimeVersion(), testPointerTracking);
+
+    testMalformedTracking();
+    for (int version : { 10, 15 })
+    {
+        runAgainstVersion(version, testMalformedTrackingRemote);
+    }
+    runAtVersions(RCF::getRuntimeVersion(), RCF::getRuntimeVersion(), testMalformedTrackingRemote);
+
+    // Polymorphic types are written by type id from runtime version 15, and by name before that.
+    for (int version : { 13, 14, 15 })
+    {
+        runAgainstVersion(version, testPolymorphic);
+    }
+    runAtVersions(RCF::getRuntimeVersion(), RCF::getRuntimeVersion(), testPolymorphic);
+
+    // The schema-fixed request flag came with runtime version 17. Older peers get regular SF serialization.
+    for (int version : { 15, 16, 17 })
+    {
+        runAgainstVersion(version, testSchemaFixed);
+    }
+    runAtVersions(RCF::getRuntimeVersion(), RCF::getRuntimeVersion(), testSchemaFixed);
+
+    // Segmented messages came with runtime version 18. Older peers get a single serialized message.
+    for (int version : { 16, 17, 18 })
+    {
+        runAgainstVersion(version, testParallelSerialization);
+    }
+    runAtVersions(RCF::getRuntimeVersion(), RCF::getRuntimeVersion(), testParallelSerialization);
+
+    if (gFailures)
+    {
+        std::cout << gFailures << " checks failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,155 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_ARRAYBUFFER_HPP
+#define INCLUDE_RCF_ARRAYBUFFER_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <string.h>
+
+#include <RCF/ByteBuffer.hpp>
+#include <RCF/Tools.hpp>
+
+namespace RCF {
+
+    /// ArrayBuffer<T> is a reference counted array of fundamental elements, stored in a ByteBuffer. 
+    /// 
+    /// When an ArrayBuffer<T> is received as a remote call parameter or return value, it refers directly into the
+    /// message receive buffer and takes shared ownership of it, so even very large arrays are deserialized without
+    /// copying. ArrayBuffer<T> is serialized in the same format as std::vector<T>, so one side of a connection can
+    /// use std::vector<T> while the other side uses ArrayBuffer<T>.
+    template<typename T>
+    class ArrayBuffer
+    {
+    public:
+
+        static_assert(
+            std::is_fundamental<T>::value && !std::is_same<T, bool>::value, 
+            "ArrayBuffer<T> requires a fundamental, non-bool, element type.");
+
+        typedef T           value_type;
+        typedef T *         iterator;
+        typedef const T *   const_iterator;
+
+        ArrayBuffer()
+        {
+        }
+
+        /// Allocates an array of count elements. The elements are not initialized.
+        explicit
+        ArrayBuffer(std::size_t count) : mByteBuffer(ByteBuffer::createUninitialized(count*sizeof(T)))
+        {
+        }
+
+        /// Copies count elements from pt.
+        ArrayBuffer(const T * pt, std::size_t count) : mByteBuffer(ByteBuffer::createUninitialized(count*sizeof(T)))
+        {
+            if (count)
+            {
+                memcpy(mByteBuffer.getPtr(), pt, count*sizeof(T));
+            }
+        }
+
+        /// Copies the elements of vec.
+        explicit
+        ArrayBuffer(const std::vector<T> & vec) : mByteBuffer(ByteBuffer::createUninitialized(vec.size()*sizeof(T)))
+        {
+            if (!vec.empty())
+            {
+                memcpy(mByteBuffer.getPtr(), &vec[0], vec.size()*sizeof(T));
+            }
+        }
+
+        /// Refers to the contents of byteBuffer, without copying. The length and alignment of byteBuffer must 
+        /// be suitable for T.
+        explicit
+        ArrayBuffer(const ByteBuffer & byteBuffer) : mByteBuffer(byteBuffer)
+        {
+            RCF_ASSERT(mByteBuffer.getLength() % sizeof(T) == 0);
+            RCF_ASSERT(reinterpret_cast<std::uintptr_t>(mByteBuffer.getPtr()) % alignof(T) == 0);
+        }
+
+        std::size_t         size() const            { return mByteBuffer.getLength() / sizeof(T); }
+        bool                empty() const           { return mByteBuffer.isEmpty(); }
+        T *                 data() const            { return reinterpret_cast<T *>(mByteBuffer.getPtr()); }
+        T &                 operator[](std::size_t idx) const { return data()[idx]; }
+        iterator            begin() const           { return data(); }
+        iterator            end() const             { return data() + size(); }
+
+        /// Resizes the array. Existing elements are copied into a new buffer, new elements are not initialized.
+        void resize(std::size_t count)
+        {
+            if (count != size())
+            {
+                ByteBuffer byteBuffer = ByteBuffer::createUninitialized(count*sizeof(T));
+                std::size_t bytesToCopy = RCF_MIN(count, size())*sizeof(T);
+                if (bytesToCopy)
+                {
+                    memcpy(byteBuffer.getPtr(), mByteBuffer.getPtr(), bytesToCopy);
+                }
+                mByteBuffer = byteBuffer;
+            }
+        }
+
+        void clear()
+        {
+            mByteBuffer.clear();
+        }
+
+        /// Returns a copy of the elements, as a std::vector<T>.
+        std::vector<T> toVector() const
+        {
+            return std::vector<T>(begin(), end());
+        }
+
+        /// Returns the underlying byte buffer.
+        const ByteBuffer & getByteBuffer() const
+        {
+            return mByteBuffer;
+        }
+
+    private:
+        ByteBuffer mByteBuffer;
+    };
+
+} // namespace RCF
+
+namespace SF {
+
+    class Archive;
+
+    RCF_EXPORT void serializeArrayBufferImpl(
+        SF::Archive &           ar, 
+        RCF::ByteBuffer &       byteBuffer, 
+        std::size_t             sizeofElement, 
+        std::size_t             alignofElement);
+
+    template<typename T>
+    inline void serialize(SF::Archive & ar, RCF::ArrayBuffer<T> & arr)
+    {
+        RCF::ByteBuffer byteBuffer = arr.getByteBuffer();
+        serializeArrayBufferImpl(ar, byteBuffer, sizeof(T), alignof(T));
+        arr = RCF::ArrayBuffer<T>(byteBuffer);
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_RCF_ARRAYBUFFER_HPP
@@ -0,0 +1,125 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_BUFFERALLOCATOR_HPP
+#define INCLUDE_RCF_BUFFERALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <RCF/Export.hpp>
+#include <RCF/ThreadLibrary.hpp>
+
+namespace RCF {
+
+    /// Base class for allocators backing the storage of ReallocBuffer and ByteBuffer.
+    class RCF_EXPORT BufferAllocator
+    {
+    public:
+        virtual ~BufferAllocator() {}
+
+        /// Allocates a block of at least size bytes. The usable size of the block is returned in capacity.
+        virtual char *  allocate(std::size_t size, std::size_t & capacity) = 0;
+
+        /// Grows a block to at least newSize bytes. The contents of the old block are preserved.
+        virtual char *  reallocate(
+                            char *          pch,
+                            std::size_t     capacity,
+                            std::size_t     newSize,
+                            std::size_t &   newCapacity) = 0;
+
+        /// Releases a block previously returned by allocate() or reallocate().
+        virtual void    deallocate(char * pch, std::size_t capacity) = 0;
+    };
+
+    typedef std::shared_ptr<BufferAllocator> BufferAllocatorPtr;
+
+    /// Allocates buffers from the heap. This is the default buffer allocator.
+    class RCF_EXPORT HeapBufferAllocator : public BufferAllocator
+    {
+    public:
+        char *  allocate(std::size_t size, std::size_t & capacity);
+        char *  reallocate(char * pch, std::size_t capacity, std::size_t newSize, std::size_t & newCapacity);
+        void    deallocate(char * pch, std::size_t capacity);
+    };
+
+    /// Allocates small buffers from the heap, medium buffers from pooled power-of-two size classes, and large
+    /// buffers from memory mapped regions in multiples of 2 MB, backed by huge pages where the system supports it.
+    /// Large buffers are grown in place with mremap() where available. Released medium and large blocks are cached,
+    /// so that repeated large messages reuse memory that has already been faulted in.
+    class RCF_EXPORT SizeClassBufferAllocator : public BufferAllocator
+    {
+    public:
+
+        /// Buffers of at least largeBufferThreshold bytes are memory mapped. At most cacheSizeLimit bytes of
+        /// released blocks are retained for reuse.
+        SizeClassBufferAllocator(
+            std::size_t     largeBufferThreshold    = 4*1024*1024,
+            std::size_t     cacheSizeLimit          = 256*1024*1024);
+
+        ~SizeClassBufferAllocator();
+
+        char *  allocate(std::size_t size, std::size_t & capacity);
+        char *  reallocate(char * pch, std::size_t capacity, std::size_t newSize, std::size_t & newCapacity);
+        void    deallocate(char * pch, std::size_t capacity);
+
+        /// Releases all cached blocks.
+        void    trim();
+
+        /// Returns the number of bytes currently held in the cache.
+        std::size_t getCachedBytes();
+
+    private:
+
+        struct LargeBlock
+        {
+            char *          mpch;
+            std::size_t     mCapacity;
+        };
+
+        char *          allocateLarge(std::size_t size, std::size_t & capacity);
+        char *          mapLarge(std::size_t capacity);
+        void            unmapLarge(char * pch, std::size_t capacity);
+
+        std::size_t     getSizeClass(std::size_t size, std::size_t & capacity);
+
+        static const std::size_t SmallBufferLimit = 4*1024;
+        static const std::size_t SizeClassCount = 32;
+
+        std::size_t                     mLargeBufferThreshold;
+        std::size_t                     mCacheSizeLimit;
+
+        Mutex                           mMutex;
+        std::size_t                     mCachedBytes;
+        std::vector<char *>             mMediumCache[SizeClassCount];
+        std::vector<LargeBlock>         mLargeCache;
+        std::atomic<bool>               mUseHugeTlb;
+    };
+
+    /// Sets the allocator used for new ReallocBuffer and ByteBuffer storage. Existing buffers continue to use the
+    /// allocator they were created with.
+    RCF_EXPORT void                 setDefaultBufferAllocator(BufferAllocatorPtr allocatorPtr);
+
+    /// Gets the allocator used for new ReallocBuffer and ByteBuffer storage.
+    RCF_EXPORT BufferAllocatorPtr   getDefaultBufferAllocator();
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_BUFFERALLOCATOR_HPP
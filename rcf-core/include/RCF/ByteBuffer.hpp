@@ -43,6 +43,7 @@ namespace RCF {
 
         ByteBuffer();
 
+        /// Allocates a zero-filled buffer of pvlen bytes from the default BufferAllocator.
         explicit
         ByteBuffer(std::size_t pvlen);
 
@@ -119,6 +120,13 @@ namespace RCF {
             ReallocBufferPtr sprb,
             bool readOnly = false);
 
+        /// Refers to pvlen bytes at pv, which remain valid for as long as spOwner is held. 
+        ByteBuffer(
+            char *pv,
+            std::size_t pvlen,
+            std::shared_ptr<void> spOwner,
+            bool readOnly = false);
+
         ByteBuffer(
             const ByteBuffer & byteBuffer,
             std::size_t offset = 0,
@@ -140,6 +148,10 @@ namespace RCF {
                             operator bool();
         bool                operator !();
 
+        /// Allocates a buffer of pvlen bytes from the default BufferAllocator, without initializing the contents. 
+        /// Only for callers that overwrite the whole buffer before it is read or sent.
+        static ByteBuffer   createUninitialized(std::size_t pvlen);
+
         static const std::size_t npos;
 
     private:
@@ -147,6 +159,7 @@ namespace RCF {
         std::shared_ptr< std::vector<char> >      mSpvc;
         std::shared_ptr< MemOstream >             mSpos;
         std::shared_ptr< ReallocBuffer >          mSprb;
+        std::shared_ptr< void >                   mSpOwner;
 
         char *                                      mPv;
         std::size_t                                 mPvlen;
@@ -19,12 +19,27 @@
 #ifndef INCLUDE_RCF_BYTEORDERING_HPP
 #define INCLUDE_RCF_BYTEORDERING_HPP
 
+#include <cstddef>
+
 #include <RCF/Export.hpp>
 
 namespace RCF {
 
     RCF_EXPORT void machineToNetworkOrder(void *buffer, int width, int count);
     RCF_EXPORT void networkToMachineOrder(void *buffer, int width, int count);
+
+    // Converts count elements of the given width from src into dest. dest may be the same as src.
+    RCF_EXPORT void machineToNetworkOrder(void *dest, const void *src, int width, int count);
+    RCF_EXPORT void networkToMachineOrder(void *dest, const void *src, int width, int count);
+
+    // In place conversion of arrays with more elements than an int can count.
+    RCF_EXPORT void machineToNetworkOrderLarge(void *buffer, std::size_t width, std::size_t count);
+    RCF_EXPORT void networkToMachineOrderLarge(void *buffer, std::size_t width, std::size_t count);
+
+    // Reverses the byte order of count elements of the given width, regardless of the machine byte order. 2, 4 and 
+    // 8 byte elements are converted with SSSE3, AVX2 or NEON instructions, if the build targets them.
+    RCF_EXPORT void reverseByteOrder(void *buffer, int width, int count);
+    RCF_EXPORT void reverseByteOrder(void *dest, const void *src, int width, int count);
     RCF_EXPORT bool machineOrderEqualsNetworkOrder();
     RCF_EXPORT bool isPlatformLittleEndian();
 
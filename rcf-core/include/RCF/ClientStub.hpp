@@ -219,12 +219,18 @@ namespace RCF {
 
         /// Sets whether compression is enabled for this connection. 
         
-        /// Compression requires zlib and RCF_FEATURE_ZLIB=1 to be defined.
+        /// zlib compression requires zlib and RCF_FEATURE_ZLIB=1 to be defined. See setCompressionAlgorithm().
         void                    setEnableCompression(bool enableCompression);
 
         /// Gets whether compression is enabled for this connection. 
         bool                    getEnableCompression() const;
 
+        /// Sets the compression algorithm used when compression is enabled. The default is Ca_Zlib.
+        void                    setCompressionAlgorithm(CompressionAlgorithm compressionAlgorithm);
+
+        /// Gets the compression algorithm used when compression is enabled.
+        CompressionAlgorithm    getCompressionAlgorithm() const;
+
         /// Sets the protection level for messages sent using the Kerberos, NTLM and Negotiate transport protocols.
         void                    setSspiMessageProtection(SspiMessageProtection sspiMessageProtection);
 
@@ -260,6 +266,25 @@ namespace RCF {
         /// Gets pointer tracking mode when using SF serialization.
         bool                    getEnableSfPointerTracking() const;
 
+        /// Sets schema-fixed mode when using SF binary serialization. In schema-fixed mode, parameters and return 
+        /// values that cannot be polymorphic are serialized without SF node headers, and each call carries a hash 
+        /// of the method signature, which the server verifies. Both ends must be built from the same interface 
+        /// definition, with the same compiler. Requires runtime version 17 or later on both ends.
+        void                    setEnableSfSchemaFixed(bool enable);
+
+        /// Gets schema-fixed mode when using SF binary serialization.
+        bool                    getEnableSfSchemaFixed() const;
+
+        /// Sets the parallel serialization threshold, in bytes, when using SF binary serialization. If non-zero, 
+        /// each parameter and return value is serialized as a separate segment of the message, and segments of at 
+        /// least this size are serialized and deserialized concurrently on the SerializationThreadPool, at both ends 
+        /// of the call. Pointer tracking does not extend across segments. Requires runtime version 18 or later on 
+        /// both ends. Defaults to 0, which disables parallel serialization.
+        void                    setParallelSerializationThreshold(std::uint32_t thresholdBytes);
+
+        /// Gets the parallel serialization threshold.
+        std::uint32_t           getParallelSerializationThreshold() const;
+
         /// Sets the auto-versioning property. 
         
         /// If auto-versioning is enabled, the RCF client will automatically adjust the RCF runtime version 
@@ -474,6 +499,12 @@ namespace RCF {
         /// Gets the cipher suite to use when establishing an SSL connection. Only applicable to OpenSSL-based SSL.
         std::string             getOpenSslCipherSuite() const;
 
+        /// Enables or disables SSL session resumption. When enabled, reconnecting to the same server resumes the previous SSL session, skipping the full handshake. Enabled by default. Only applicable to OpenSSL-based SSL.
+        void                    setEnableSslSessionResumption(bool enable);
+
+        /// Returns true if SSL session resumption is enabled. Only applicable to OpenSSL-based SSL.
+        bool                    getEnableSslSessionResumption() const;
+
         /// Sets the certificate name to match against, when validating a server certificate. Only applicable to Schannel-based SSL.
         void                    setEnableSchannelCertificateValidation(const tstring & peerName);
 
@@ -822,6 +853,8 @@ namespace RCF {
         std::uint32_t               mArchiveVersion;
 
         bool                        mEnableSfPointerTracking;
+        bool                        mEnableSfSchemaFixed = false;
+        std::uint32_t               mParallelSerializationThreshold = 0;
         bool                        mEnableNativeWstringSerialization = false;
 
         std::vector<I_Future *>     mFutures;
@@ -877,6 +910,29 @@ namespace RCF {
 
         std::vector<FileUpload>     mUploadStreams;
         std::vector<FileDownload>   mDownloadStreams;       
+
+        void                        uploadFileStriped(
+                                        std::string &           uploadId,
+                                        const FileManifest &    manifest,
+                                        std::uint32_t           chunkSize,
+                                        std::uint32_t           transferRateBps,
+                                        std::uint32_t           connectionCount);
+
+        void                        uploadFileDelta(
+                                        std::string &           uploadId,
+                                        const FileManifest &    manifest,
+                                        const std::string &     basisId,
+                                        std::uint32_t           chunkSize,
+                                        std::uint32_t           transferRateBps);
+
+        void                        downloadFileStriped(
+                                        const std::string &     downloadId,
+                                        const Path &            downloadToPath,
+                                        std::uint32_t           chunkSize,
+                                        std::uint32_t           transferRateBps,
+                                        std::uint64_t           startPosition,
+                                        std::uint64_t           endPosition,
+                                        std::uint32_t           connectionCount);
 #endif
 
         std::uint32_t               mTransferWindowS;    
@@ -907,6 +963,7 @@ namespace RCF {
         std::string                             mHttpUrlParameterString;
         tstring                                 mKerberosSpn;
         bool                                    mEnableCompression;
+        CompressionAlgorithm                    mCompressionAlgorithm = Ca_Zlib;
         SspiMessageProtection                   mSspiMessageProtection = Smp_Encryption;
 
         CertificatePtr                          mCertificatePtr;
@@ -915,6 +972,7 @@ namespace RCF {
         tstring                                 mSchannelCertificateValidation;
 
         std::string                             mOpenSslCipherSuite;
+        bool                                    mEnableSslSessionResumption = true;
 
         tstring                                 mTlsSniName;
 
@@ -0,0 +1,206 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_COMPRESSIONFILTER_HPP
+#define INCLUDE_RCF_COMPRESSIONFILTER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <RCF/ByteBuffer.hpp>
+#include <RCF/Filter.hpp>
+#include <RCF/Export.hpp>
+#include <RCF/Tools.hpp>
+
+namespace RCF {
+
+    class ReallocBuffer;
+    typedef std::shared_ptr<ReallocBuffer> ReallocBufferPtr;
+
+    /// Block compression algorithm used by CompressionFilter.
+    ///
+    /// Codecs compress and decompress whole frames. In stateful mode, the data to be compressed is preceded in memory
+    /// by up to CompressionFilter::HistoryLength bytes of previously sent data, which the codec may refer back to. The
+    /// receiving side decompresses into a buffer preceded by the same history.
+    class RCF_EXPORT CompressionCodec
+    {
+    public:
+        virtual ~CompressionCodec() {}
+
+        /// Returns the filter id of a CompressionFilter using this codec, in stateful or stateless mode.
+        virtual int getFilterId(bool stateful) const = 0;
+
+        /// Returns the largest possible compressed length of srcLength bytes.
+        virtual std::size_t getMaxCompressedLength(std::size_t srcLength) = 0;
+
+        /// Compresses srcLength bytes at pSrc, which are preceded by historyLength bytes of history. Returns the
+        /// compressed length, or zero if the data could not be compressed into destLength bytes.
+        virtual std::size_t compress(
+            const char *    pSrc,
+            std::size_t     srcLength,
+            std::size_t     historyLength,
+            char *          pDest,
+            std::size_t     destLength) = 0;
+
+        /// Decompresses srcLength bytes at pSrc into exactly destLength bytes at pDest, which are preceded by
+        /// historyLength bytes of history. Throws if the compressed data is corrupt.
+        virtual void decompress(
+            const char *    pSrc,
+            std::size_t     srcLength,
+            char *          pDest,
+            std::size_t     destLength,
+            std::size_t     historyLength) = 0;
+    };
+
+    typedef std::shared_ptr<CompressionCodec> CompressionCodecPtr;
+
+    /// LZ4 block format codec.
+    ///
+    /// Compresses at several hundred MB/s per core, at the cost of a lower compression ratio than zlib. Uses a single
+    /// hash probe per position and no entropy coding.
+    class RCF_EXPORT Lz4CompressionCodec : public CompressionCodec
+    {
+    public:
+        Lz4CompressionCodec();
+
+        int getFilterId(bool stateful) const;
+
+        std::size_t getMaxCompressedLength(std::size_t srcLength);
+
+        std::size_t compress(
+            const char *    pSrc,
+            std::size_t     srcLength,
+            std::size_t     historyLength,
+            char *          pDest,
+            std::size_t     destLength);
+
+        void decompress(
+            const char *    pSrc,
+            std::size_t     srcLength,
+            char *          pDest,
+            std::size_t     destLength,
+            std::size_t     historyLength);
+
+    private:
+        std::vector<std::uint32_t> mHashTable;
+    };
+
+    /// Creates a Lz4CompressionCodec.
+    RCF_EXPORT CompressionCodecPtr createLz4CompressionCodec();
+
+    /// Compression filter that frames each message and compresses it with a pluggable CompressionCodec.
+    ///
+    /// Messages are split into frames of at most MaxFrameLength bytes. Each frame carries an 8 byte header with its
+    /// uncompressed and encoded lengths. Frames that do not compress are sent as they are, flagged in the header.
+    ///
+    /// In stateful mode, the last HistoryLength bytes sent on the connection are available to the codec when
+    /// compressing the next frame, which improves compression of small, similar messages.
+    class RCF_EXPORT CompressionFilter :
+        public Filter,
+        Noncopyable
+    {
+    public:
+
+        static const std::size_t MaxFrameLength = 1024*1024;
+        static const std::size_t HistoryLength = 64*1024;
+
+        CompressionFilter(CompressionCodecPtr codecPtr, bool stateful);
+
+        int getFilterId() const;
+
+    private:
+
+        void resetState();
+        void read(const ByteBuffer &byteBuffer, std::size_t bytesRequested);
+        void write(const std::vector<ByteBuffer> &byteBuffers);
+        void onReadCompleted(const ByteBuffer &byteBuffer);
+        void onWriteCompleted(std::size_t bytesTransferred);
+
+        std::size_t compressFrame(char * pDest, std::size_t destLength);
+        void consumeInput();
+        void decompressFrame(const char * pFrame);
+        void deliverOutput();
+        void requestInput();
+        char * prepareWindow(ReallocBufferPtr & windowPtr, std::size_t & historyLength, std::size_t frameLength);
+
+        CompressionCodecPtr         mCodecPtr;
+        const bool                  mStateful;
+
+        // Write state.
+        std::vector<ByteBuffer>     mPreBuffers;
+        std::vector<ByteBuffer>     mPostBuffers;
+        std::size_t                 mTotalBytesIn;
+        ReallocBufferPtr            mWriteWindowPtr;
+        std::size_t                 mWriteHistoryLength;
+        ReallocBufferPtr            mCompressedPtr;
+
+        // Read state.
+        std::size_t                 mBytesRequested;
+        ByteBuffer                  mOrigBuffer;
+        ByteBuffer                  mPostBuffer;
+        char                        mReadHeader[8];
+        std::size_t                 mReadHeaderLength;
+        std::size_t                 mFrameLength;
+        std::size_t                 mEncodedLength;
+        bool                        mFrameStored;
+        ReallocBufferPtr            mFramePtr;
+        std::size_t                 mFrameBytesRead;
+        ReallocBufferPtr            mReadWindowPtr;
+        std::size_t                 mReadHistoryLength;
+        ByteBuffer                  mOutput;
+    };
+
+    typedef std::function<CompressionCodecPtr()> CompressionCodecFactory;
+
+    /// Server-side factory for CompressionFilter. Each filter gets its own codec, created by codecFactory.
+    class RCF_EXPORT CompressionFilterFactory :
+        public FilterFactory
+    {
+    public:
+        CompressionFilterFactory(CompressionCodecFactory codecFactory, bool stateful);
+
+        FilterPtr createFilter(RcfServer & server);
+        int getFilterId();
+
+    private:
+        CompressionCodecFactory     mCodecFactory;
+        bool                        mStateful;
+        int                         mFilterId;
+    };
+
+    /// LZ4 compression filter.
+    class RCF_EXPORT Lz4CompressionFilter :
+        public CompressionFilter
+    {
+    public:
+        Lz4CompressionFilter(bool stateful = true);
+    };
+
+    /// Server-side factory for Lz4CompressionFilter.
+    class RCF_EXPORT Lz4CompressionFilterFactory :
+        public CompressionFilterFactory
+    {
+    public:
+        Lz4CompressionFilterFactory(bool stateful = true);
+    };
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_COMPRESSIONFILTER_HPP
@@ -91,6 +91,16 @@ namespace RCF {
         Si_OpenSsl
     };
 
+    /// Describes which compression algorithm to use, when compression is enabled on a connection.
+    enum CompressionAlgorithm
+    {
+        /// zlib stream compression. Requires zlib.
+        Ca_Zlib,
+
+        /// LZ4 block compression. Several times faster than zlib, with a lower compression ratio.
+        Ca_Lz4
+    };
+
     /// Win32 certificate store locations.
     enum Win32CertificateLocation
     {
@@ -202,6 +212,19 @@ namespace RCF {
         Rca_Continue
     };
 
+    /// Describes what a publisher does when a message is published and a subscriber's send queue is full.
+    enum SlowSubscriberPolicy
+    {
+        /// Drop the oldest message in the queue.
+        Ssp_DropOldest,
+
+        /// Replace any queued message with the same conflation key. If there isn't one and the queue is full, drop the oldest message in the queue.
+        Ssp_Conflate,
+
+        /// Disconnect the subscriber.
+        Ssp_Disconnect
+    };
+
     /// Describes the type of protection applied to messages sent across a connection, when using any of the 
     /// SSPI-based Kerberos, NTLM or Negotiate transport protocols.
     enum SspiMessageProtection
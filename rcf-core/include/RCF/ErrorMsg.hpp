@@ -247,6 +247,16 @@ namespace RCF
     #define RcfError_HttpMessageVerificationAdmin    ErrorMsg(192) // HTTP message verification failed. %1%
     #define RcfError_HttpSessionNotAvailable         ErrorMsg(193) // HTTP session not available.
     #define RcfError_HttpInvalidMessage              ErrorMsg(194) // Invalid HTTP message.
+    #define RcfError_SfPodLayoutMismatch             ErrorMsg(195) // Memory layout mismatch while deserializing trivially copyable type. Type: %1%. Local layout checksum: %2%. Remote layout checksum: %3%.
+    #define RcfError_SfArrayTooLarge                 ErrorMsg(196) // Array too large to serialize at runtime version %2%. Element count: %1%.
+    #define RcfError_SfTypeId                        ErrorMsg(197) // Invalid SF type id %1% for type %2%. Type ids must be non-zero, less than %3%, and unique to a single type.
+    #define RcfError_SfSchemaMismatch                ErrorMsg(198) // SF schema hash mismatch. Local hash: %1%. Remote hash: %2%. Schema-fixed serialization requires both ends to be built from the same method signatures.
+    #define RcfError_SfSchemaFixedPolymorphic        ErrorMsg(199) // Polymorphic object of type %1% cannot be serialized by value in a schema-fixed SF archive. Serialize it through a pointer instead.
+    #define RcfError_SfInPlaceRead                   ErrorMsg(200) // std::string_view and std::span<const T> can only be deserialized from remote call parameters on the server.
+    #define RcfError_DeltaUploadMismatch             ErrorMsg(201) // Delta upload does not match the uploaded file. Path: %1%.
+    #define RcfError_CompressedData                  ErrorMsg(202) // Invalid compressed data. %1%
+    #define RcfError_SubscriptionFilterNotSupported  ErrorMsg(203) // Subscription filters are not supported by the publisher.
+    #define RcfError_SubscriptionFilterTooLarge      ErrorMsg(204) // Subscription filter is too large. Key ranges: %1%. Tags: %2%. Maximum: %3% of each.
 
     static const int RcfError_Ok_Id                           =   0;
     static const int RcfError_ServerMessageLength_Id          =   2;
@@ -433,6 +443,16 @@ namespace RCF
     static const int RcfError_HttpMessageVerificationAdmin_Id = 192;
     static const int RcfError_HttpSessionNotAvailable_Id      = 193;
     static const int RcfError_HttpInvalidMessage_Id           = 194;
+    static const int RcfError_SfPodLayoutMismatch_Id          = 195;
+    static const int RcfError_SfArrayTooLarge_Id              = 196;
+    static const int RcfError_SfTypeId_Id                     = 197;
+    static const int RcfError_SfSchemaMismatch_Id             = 198;
+    static const int RcfError_SfSchemaFixedPolymorphic_Id     = 199;
+    static const int RcfError_SfInPlaceRead_Id                = 200;
+    static const int RcfError_DeltaUploadMismatch_Id          = 201;
+    static const int RcfError_CompressedData_Id               = 202;
+    static const int RcfError_SubscriptionFilterNotSupported_Id= 203;
+    static const int RcfError_SubscriptionFilterTooLarge_Id   = 204;
 
     //[[[end]]]
 
@@ -35,11 +35,17 @@ namespace RCF {
 
     class FileHandle;
     typedef std::shared_ptr<FileHandle> FileHandlePtr;
+
+    class FileIoThreadPool;
+    typedef std::shared_ptr<FileIoThreadPool> FileIoThreadPoolPtr;
     
+    /// Runs file reads and writes for file transfers, on a pool of threads. Each thread carries out one 
+    /// FileIoRequest at a time, so the maximum thread count determines how many transfers can access the disk 
+    /// concurrently.
     class RCF_EXPORT FileIoThreadPool
     {
     public:
-        FileIoThreadPool();
+        FileIoThreadPool(std::size_t maxThreadCount = 10);
         ~FileIoThreadPool();
 
         void stop();
@@ -73,21 +79,30 @@ namespace RCF {
     {
     public:
         FileIoRequest();    
+        FileIoRequest(FileIoThreadPool & fts);
         ~FileIoRequest();   
 
         bool isInitiated();
         bool isCompleted();
         void complete();
         void initiateRead(FileHandlePtr finPtr, RCF::ByteBuffer buffer);
+
+        // If a write is already in progress, the buffer is queued behind it, and written once the previous 
+        // writes have completed.
         void initateWrite(FileHandlePtr foutPtr, RCF::ByteBuffer buffer);
 
+        // Waits until no more than maxPendingWrites writes are in progress or queued.
+        void waitForPendingWrites(std::size_t maxPendingWrites);
+
         std::uint64_t getBytesTransferred();
+        std::uint64_t getBytesRequested();
 
     private:
 
         friend class FileIoThreadPool;
 
         void doTransfer();
+        bool nextQueuedWrite();
     
         FileIoThreadPool &                  mFts;
     
@@ -95,7 +110,9 @@ namespace RCF {
         FileHandlePtr                       mFoutPtr;
     
         RCF::ByteBuffer                     mBuffer;
+        std::deque<RCF::ByteBuffer>         mWriteQueue;
         std::uint64_t                       mBytesTransferred;
+        std::uint64_t                       mBytesRequested;
         bool                                mInitiated;
         bool                                mCompleted;
         RCF::Exception                      mError;
@@ -61,6 +61,7 @@ namespace RCF {
             Read,
             WriteTruncate,
             WriteAppend,
+            WriteInPlace,
         };
 
         FileHandle();
@@ -90,6 +91,33 @@ namespace RCF {
     };
 
     typedef std::shared_ptr< FileHandle > FileHandlePtr;
+
+#ifndef RCF_WINDOWS
+
+    /// Read-only memory mapping of a byte range of a file.
+    class RCF_EXPORT FileMapping
+    {
+    public:
+
+        FileMapping(const Path& filePath, std::uint64_t offset, std::size_t length);
+        ~FileMapping();
+
+        char *          getPtr() const;
+        std::uint64_t   getOffset() const;
+        std::size_t     getLength() const;
+
+    private:
+
+        void *          mpMapping = NULL;
+        std::size_t     mMappingLength = 0;
+        char *          mPtr = NULL;
+        std::uint64_t   mOffset = 0;
+        std::size_t     mLength = 0;
+    };
+
+    typedef std::shared_ptr< FileMapping > FileMappingPtr;
+
+#endif
     
     class FileUploadInfo;
     typedef std::shared_ptr<FileUploadInfo> FileUploadInfoPtr;
@@ -294,6 +322,48 @@ namespace RCF {
         std::uint64_t mOffset;
         ByteBuffer mData;
 
+        // Delta uploads only. If mBasisLength is non-zero, the chunk carries no data, and instead copies 
+        // mBasisLength bytes from offset mBasisOffset of the server's existing copy of the file.
+        std::uint64_t mBasisOffset;
+        std::uint32_t mBasisLength;
+
+#if RCF_FEATURE_SF==1
+        void serialize(SF::Archive & ar);
+#endif
+
+#if RCF_FEATURE_BOOST_SERIALIZATION==1
+        template<typename Archive>
+        void serialize(Archive & ar, const unsigned int)
+        {
+            RCF_UNUSED_VARIABLE(ar);
+            RCF_THROW(Exception(RcfError_BSerFileTransferNotSupported));
+        }
+#endif
+
+    };
+
+    /// Block checksums of a file, for delta uploads. The file is divided into blocks of mBlockSize bytes, and each 
+    /// whole block has a weak rolling checksum, and a strong 64 bit hash.
+    class FileBlockHashes
+    {
+    public:
+
+        FileBlockHashes();
+
+        void compute(const Path & filePath, std::uint32_t blockSize);
+
+        // A hash of the whole file, derived from the strong hashes of its blocks.
+        std::uint64_t getFileHash() const;
+
+        std::uint32_t                   mBlockSize;
+        std::uint64_t                   mFileSize;
+        std::vector<std::uint32_t>      mWeakHashes;
+        std::vector<std::uint64_t>      mStrongHashes;
+
+        // The last block of a file can be shorter than mBlockSize, and has a strong hash but no weak checksum.
+        static std::uint32_t            weakChecksum(const char * pch, std::size_t len);
+        static std::uint64_t            strongHash(const char * pch, std::size_t len);
+
 #if RCF_FEATURE_SF==1
         void serialize(SF::Archive & ar);
 #endif
@@ -387,6 +457,17 @@ namespace RCF {
         /// Progress callback. Called during the transfer to provide progress information.
         FileProgressCallback    mProgressCallback;
 
+        /// Number of connections to transfer the file over. If greater than 1, the file is split into contiguous
+        /// byte ranges, and each range is transferred over a separate connection, in parallel. Interrupted striped 
+        /// transfers are resumed by transferring only the ranges that are still missing.
+        std::uint32_t       mConnectionCount = 1;
+
+        /// Upload only. Identifies an existing copy of the file on the server, typically from an earlier upload. If 
+        /// set, only the parts of the file that differ from the server's copy are sent, and the rest is copied on the
+        /// server. The server resolves the id with its upload basis callback, or else as the upload id of a completed
+        /// upload in its upload directory. If the server has no such file, the whole file is sent.
+        std::string         mDeltaBasisId;
+
         // For test purposes.
         std::uint32_t       mChunkSize = 0;
     };
@@ -71,6 +71,45 @@ namespace RCF {
                     std::uint32_t &,                // advised wait for next call
                     std::uint32_t &)                // bps
 
+        RCF_METHOD_V5(
+            void,
+                BeginStripedUpload,
+                    const FileManifest &,           // upload manifest
+                    std::string &,                  // upload id
+                    std::vector<std::uint64_t> &,   // byte ranges still to upload
+                    std::uint32_t &,                // max message length
+                    std::uint32_t &)                // bps
+
+        RCF_METHOD_V3(
+            void,
+                UploadStripeChunks,
+                    const std::string &,            // upload id
+                    const std::vector<FileChunk> &, // file chunks to upload, at any offset
+                    std::uint32_t &)                // bps
+
+        RCF_METHOD_V6(
+            void,
+                BeginDeltaUpload,
+                    const FileManifest &,           // upload manifest
+                    const std::string &,            // basis id
+                    std::string &,                  // upload id
+                    FileBlockHashes &,              // block hashes of the basis file
+                    std::uint32_t &,                // max message length
+                    std::uint32_t &)                // bps
+
+        RCF_METHOD_V3(
+            void,
+                UploadDeltaChunks,
+                    const std::string &,            // upload id
+                    const std::vector<FileChunk> &, // file chunks to upload, or to copy from the basis file
+                    std::uint32_t &)                // bps
+
+        RCF_METHOD_V2(
+            void,
+                EndDeltaUpload,
+                    const std::string &,            // upload id
+                    std::uint64_t)                  // hash of the uploaded file
+
     RCF_END(I_FileTransferService)
 
 } // namespace RCF
@@ -23,6 +23,7 @@
 #include <set>
 
 #include <RCF/FileStream.hpp>
+#include <RCF/PeriodicTimer.hpp>
 #include <RCF/RcfFwd.hpp>
 #include <RCF/Service.hpp>
 
@@ -57,16 +58,23 @@ namespace RCF {
     typedef std::shared_ptr<FileDownloadInfo>                 FileDownloadInfoPtr;
 
     typedef std::function<bool(const FileUploadInfo &)>      UploadAccessCallback;
+
+    /// Describes user-provided callback functions for locating the server's existing copy of a file, given the basis 
+    /// id of a delta upload. Returning an empty path causes the whole file to be uploaded.
+    typedef std::function<Path(RcfSession &, const std::string &)>   UploadBasisCallback;
     typedef std::function<bool(const FileDownloadInfo &)>    DownloadAccessCallback;
 
     class FileIoRequest;
     typedef std::shared_ptr<FileIoRequest> FileIoRequestPtr;
+
+    class FileIoThreadPool;
+    typedef std::shared_ptr<FileIoThreadPool> FileIoThreadPoolPtr;
     
     /// Server-side information about a file upload taking place to a RcfServer.
     class FileUploadInfo : Noncopyable
     {
     public:
-        FileUploadInfo(BandwidthQuotaPtr quotaPtr);
+        FileUploadInfo(BandwidthQuotaPtr quotaPtr, FileIoThreadPoolPtr fileIoThreadPoolPtr);
         ~FileUploadInfo();
 
         std::string             getUploadId() const;
@@ -82,23 +90,41 @@ namespace RCF {
         
         FileHandlePtr           mFileHandle;
         Path                    mFinalFilePath;
+        FileIoThreadPoolPtr     mFileIoThreadPoolPtr;
         FileIoRequestPtr        mWriteOp;
 
         bool                    mCompleted;
         bool                    mResume;
+        bool                    mExpired;
         std::uint32_t           mTimeStampMs;
         
         std::uint32_t           mSessionLocalId;
         std::string             mUploadId;
 
         BandwidthQuotaPtr       mQuotaPtr;
+
+        // Striped uploads. Chunks arrive over several connections at once, and are written in place. 
+        // mPendingRanges maps the beginning of each byte range not yet received, to its end.
+        void                    removePendingRange(std::uint64_t begin, std::uint64_t end);
+        std::uint64_t           getPendingBytes() const;
+
+        Mutex                                   mStripeMutex;
+        std::map<std::uint64_t, std::uint64_t>  mPendingRanges;
+
+        // Delta uploads. Chunks arrive in order, and either carry data, or copy a range of the basis file.
+        void                    copyFromBasis(std::uint64_t basisOffset, std::uint32_t length);
+
+        std::uint32_t           mDeltaBlockSize;
+        Path                    mBasisPath;
+        std::uint64_t           mBasisSize;
+        FileHandlePtr           mBasisHandle;
     };
 
     /// Server-side information about a file download taking place from a RcfServer.
     class FileDownloadInfo : Noncopyable
     {
     public:
-        FileDownloadInfo(BandwidthQuotaPtr quotaPtr);
+        FileDownloadInfo(BandwidthQuotaPtr quotaPtr, FileIoThreadPoolPtr fileIoThreadPoolPtr);
         ~FileDownloadInfo();
         
         Path                    mDownloadPath;
@@ -113,11 +139,16 @@ namespace RCF {
 
         FileHandlePtr           mFileHandle;
         Path                    mFileHandlePath;
+        FileIoThreadPoolPtr     mFileIoThreadPoolPtr;
         FileIoRequestPtr        mReadOp;
         ByteBuffer              mReadBuffer;
         ByteBuffer              mSendBuffer;
         ByteBuffer              mSendBufferRemaining;
 
+#ifndef RCF_WINDOWS
+        FileMappingPtr          mMappingPtr;
+#endif
+
         bool                    mResume;
 
         Timer                   mTransferWindowTimer;
@@ -141,6 +172,8 @@ namespace RCF {
     public:
         Path                mPath;
         BandwidthQuotaPtr   mBandwidthQuotaPtr;
+        FileUploadInfoPtr   mStripedUploadPtr;
+        FileUploadInfoPtr   mDeltaUploadPtr;
     };
 
     class RCF_EXPORT FileTransferService : public I_Service
@@ -190,6 +223,35 @@ namespace RCF {
                                 std::uint32_t & adviseWaitMs,
                                 std::uint32_t & bps);
 
+        void                BeginStripedUpload(
+                                const FileManifest & manifest,
+                                std::string & uploadId,
+                                std::vector<std::uint64_t> & pendingRanges,
+                                std::uint32_t & maxMessageLength,
+                                std::uint32_t & bps);
+
+        void                UploadStripeChunks(
+                                const std::string & uploadId,
+                                const std::vector<FileChunk> & chunks,
+                                std::uint32_t & bps);
+
+        void                BeginDeltaUpload(
+                                const FileManifest & manifest,
+                                const std::string & basisId,
+                                std::string & uploadId,
+                                FileBlockHashes & basisHashes,
+                                std::uint32_t & maxMessageLength,
+                                std::uint32_t & bps);
+
+        void                UploadDeltaChunks(
+                                const std::string & uploadId,
+                                const std::vector<FileChunk> & chunks,
+                                std::uint32_t & bps);
+
+        void                EndDeltaUpload(
+                                const std::string & uploadId,
+                                std::uint64_t fileHash);
+
         //----------------------------------------------------------------------
 
     private:
@@ -205,11 +267,18 @@ namespace RCF {
         std::map<std::string, TransferInfo> mFileTransfersInProgress;
 
         void                checkForUploadCompletion(FileUploadInfoPtr uploadInfoPtr);
+        void                completeUploadWrites(FileUploadInfo & uploadInfo);
+        ByteBuffer          mapDownloadChunk(FileDownloadInfo & di, std::size_t chunkSize);
+        void                completeStripedUpload(FileUploadInfo & uploadInfo);
+        Path                    findUploadBasis(const std::string & basisId);
 
 
 
         void                onServerStart(RcfServer & server);
         void                onServerStop(RcfServer & server);
+        void                onTimer();
+
+        void                expireUpload(FileUploadInfo & uploadInfo);
 
         Path                        mUploadDirectory;
 
@@ -218,11 +287,23 @@ namespace RCF {
 
         std::uint32_t               mTransferWindowS;
 
+        // Striped and delta uploads are not tied to a session, so idle ones are expired by a periodic sweep.
+        std::uint32_t               mUploadIdleTimeoutS;
+        PeriodicTimer               mPeriodicTimer;
+
         BandwidthQuotaPtr           mUploadQuota;
         BandwidthQuotaPtr           mDownloadQuota;
 
         BandwidthQuotaCallback      mUploadQuotaCallback;
         BandwidthQuotaCallback      mDownloadQuotaCallback;
+
+        bool                        mDownloadMemoryMapping;
+
+        UploadBasisCallback         mUploadBasisCb;
+
+        // Null if this server uses the RCF-wide file I/O thread pool.
+        FileIoThreadPoolPtr         mFileIoThreadPoolPtr;
+        std::size_t                 mFileIoQueueDepth;
     };
 
     typedef std::shared_ptr<FileTransferService> FileTransferServicePtr;
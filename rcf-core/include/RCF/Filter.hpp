@@ -37,6 +37,10 @@ namespace RCF {
     static const int RcfFilter_SspiKerberos                 = 6;
     static const int RcfFilter_SspiNegotiate                = 7;
     static const int RcfFilter_SspiSchannel                 = 8;
+    static const int RcfFilter_Lz4CompressionStateless      = 9;
+    static const int RcfFilter_Lz4CompressionStateful       = 10;
+    static const int RcfFilter_ZlibBlockCompressionStateless = 11;
+    static const int RcfFilter_ZlibBlockCompressionStateful = 12;
 
     static const int RcfFilter_Xor                          = 101;
 
@@ -46,6 +50,20 @@ namespace RCF {
 
     typedef std::shared_ptr<Filter> FilterPtr;
 
+    // Buffer ownership in the filter chain:
+    //
+    // * read(): if byteBuffer is non-empty, the filter writes into it and completes with a slice of it. If it is 
+    //   empty, the filter may complete with a buffer of its own, which the caller may hold on to. A filter that 
+    //   hands out its own buffer must not write to it again while the caller still references it.
+    //
+    // * write(): the filter may hold references to the buffers it is given, until onWriteCompleted() has been 
+    //   called. Space in the left margin of the first buffer may be used to prepend headers in place (see 
+    //   ByteBuffer::expandIntoLeftMargin()), so filters that produce new buffers should leave a left margin on 
+    //   them as well.
+    //
+    // * Scratch buffers should come from the object pool (getObjectPool().getReallocBufferPtr()), rather than 
+    //   being allocated per message.
+
     class RCF_EXPORT Filter
     {
     public:
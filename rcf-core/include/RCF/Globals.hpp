@@ -31,6 +31,7 @@ namespace RCF {
     class ZlibDll;
     class OpenSslDll;
     class OpenSslCryptoDll;
+    class OpenSslContextCache;
     class RcfSession;
 
     enum SslImplementation;
@@ -80,12 +81,19 @@ namespace RCF {
         std::string         getOpenSslCryptoDllName() const;
 
         // Sets the simultaneous publish limit. 
-        // The publishing service issues messages asynchronously across all subscriber connections, and this setting controls how many asynchronous writes it can perform concurrently.
+        // No longer used. Publishers queue messages for each subscriber, and each subscriber connection has at most one asynchronous write in progress. See PublisherParms::setSubscriberQueueLength().
         void                setSimultaneousPublishLimit(std::size_t simultaneousPublishLimit);
 
         // Gets the simultaneous publish limit.
         std::size_t         getSimultaneousPublishLimit() const;
 
+        // Sets the zero copy send threshold. 
+        // Contiguous arrays of fundamental types (std::vector<>, std::span<>) at least this large are sent directly from application memory, rather than being copied into the serialization buffer. The arrays must then remain valid until the message has been written, so they cannot be temporaries created within a serialize() function. Defaults to zero, which disables zero copy sends.
+        void                setZeroCopySendThreshold(std::size_t zeroCopySendThreshold);
+
+        // Gets the zero copy send threshold.
+        std::size_t         getZeroCopySendThreshold() const;
+
         // Default download directory for FileStream objects (deprecated).
         void                setFileStreamDefaultDownloadDirectory(const std::string & downloadDirectory);
         std::string         getFileStreamDefaultDownloadDirectory();
@@ -94,22 +102,26 @@ namespace RCF {
         ZlibDll &           getZlibDll();
         OpenSslDll &        getOpenSslDll();
         OpenSslCryptoDll &  getOpenSslCryptoDll();
+        OpenSslContextCache & getOpenSslContextCache();
 
     private:
 
         void                releaseZlibDll();
         void                releaseOpenSslDll();
         void                releaseOpenSslCryptoDll();
+        void                releaseOpenSslContextCache();
 
         ZlibDll *           mpZlibDll;
         OpenSslDll *        mpOpenSslDll;
         OpenSslCryptoDll *  mpOpenSslCryptoDll;
+        OpenSslContextCache * mpOpenSslContextCache;
 
         std::string         mZlibDllName;
         std::string         mOpenSslDllName;
         std::string         mOpenSslCryptoDllName;
 
         std::size_t         mSimultaneousPublishLimit;
+        std::size_t         mZeroCopySendThreshold;
 
         std::string         mFileStreamDefaultDownloadDirectory;
 
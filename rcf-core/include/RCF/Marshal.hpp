@@ -32,6 +32,10 @@
 #include <RCF/TypeTraits.hpp>
 #include <RCF/Version.hpp>
 
+#include <string>
+#include <typeinfo>
+#include <vector>
+
 #if RCF_FEATURE_SF==1
 #include <SF/memory.hpp>
 #endif
@@ -240,6 +244,32 @@ namespace RCF {
 
     RCF_EXPORT bool deserializeOverride(SerializationProtocolIn &in, ByteBuffer & u);
 
+    // In schema-fixed SF serialization, requests and responses begin with a hash of the method signature. The hash
+    // is computed from the compiler's names for the return and parameter types.
+
+    RCF_EXPORT std::uint32_t computeSfSchemaHash(const std::type_info * const * types, std::size_t count);
+
+    RCF_EXPORT void writeSfSchemaHash(SerializationProtocolOut &out, std::uint32_t hash);
+
+    RCF_EXPORT void verifySfSchemaHash(SerializationProtocolIn &in, std::uint32_t hash);
+
+    template<
+        typename R, 
+        typename A1, typename A2, typename A3, typename A4, typename A5, 
+        typename A6, typename A7, typename A8, typename A9, typename A10, 
+        typename A11, typename A12, typename A13, typename A14, typename A15>
+    inline std::uint32_t getSfSchemaHash()
+    {
+        static const std::type_info * const types[] = {
+            &typeid(R), 
+            &typeid(A1), &typeid(A2), &typeid(A3), &typeid(A4), &typeid(A5), 
+            &typeid(A6), &typeid(A7), &typeid(A8), &typeid(A9), &typeid(A10), 
+            &typeid(A11), &typeid(A12), &typeid(A13), &typeid(A14), &typeid(A15) };
+
+        static const std::uint32_t hash = computeSfSchemaHash(types, sizeof(types)/sizeof(types[0]));
+        return hash;
+    }
+
     // -------------------------------------------------------------------------
     // Parameter store.
 
@@ -547,10 +577,11 @@ namespace RCF {
                     // If BSer, deserialize through pointer.
                     // If SF and caching disabled, deserialize through pointer.
                     // If SF and caching enabled, use object cache and deserialize through value.
+                    // If SF schema-fixed, deserialize through value.
 
                     int sp = in.getSerializationProtocol();
                     if (    (sp == Sp_SfBinary || sp == Sp_SfText)
-                        &&  getObjectPool().isCachingEnabled( (T *) NULL ))
+                        &&  (in.getEnableSfSchemaFixed() || getObjectPool().isCachingEnabled( (T *) NULL )))
                     {
                         mPs.allocate(mVec);
                         deserialize(in, *mPs);
@@ -645,10 +676,11 @@ namespace RCF {
                     // If BSer, deserialize through pointer.
                     // If SF and caching disabled, deserialize through pointer.
                     // If SF and caching enabled, use object cache and deserialize through value.
+                    // If SF schema-fixed, deserialize through value.
 
                     int sp = in.getSerializationProtocol();
                     if (    (sp == Sp_SfBinary || sp == Sp_SfText)
-                        &&  getObjectPool().isCachingEnabled( (T *) NULL ))
+                        &&  (in.getEnableSfSchemaFixed() || getObjectPool().isCachingEnabled( (T *) NULL )))
                     {
                         mPs.allocate(mVec);
                         deserialize(in, *mPs);
@@ -954,7 +986,12 @@ namespace RCF {
         void write(SerializationProtocolOut &out) 
         { 
             int ver = out.getRuntimeVersion();
-            if (ver < 8)
+            if (out.getEnableSfSchemaFixed())
+            {
+                // Schema-fixed archives are read as values on the server.
+                serialize(out, mT);
+            }
+            else if (ver < 8)
             {
                 serialize(out, &mT);
             }
@@ -1004,7 +1041,12 @@ namespace RCF {
         void write(SerializationProtocolOut &out) 
         { 
             int ver = out.getRuntimeVersion();
-            if (ver < 8)
+            if (out.getEnableSfSchemaFixed())
+            {
+                // Schema-fixed archives are read as values on the server.
+                serialize(out, mT);
+            }
+            else if (ver < 8)
             {
                 serialize(out, &mT);
             }
@@ -1155,6 +1197,103 @@ namespace RCF {
         >::type type;
     };
 
+    // -------------------------------------------------------------------------
+    // Size hints.
+
+    // Parameters report the number of bytes their large contiguous contents will occupy in the serialized message, 
+    // so the output buffer can be allocated at full size before serialization starts, rather than being regrown 
+    // and copied as it fills. Size hints also decide which parameters are serialized concurrently, in parallel 
+    // serialization. Types without a cheap size estimate report 0.
+
+    // Returns the hint for an array of the given size, or 0 if it will be sent without copying.
+    RCF_EXPORT std::size_t getArraySizeHint(std::size_t bytes);
+
+    template<typename T>
+    inline std::size_t getSizeHint(const T &)
+    {
+        return 0;
+    }
+
+    template<typename T, typename A>
+    inline std::size_t getSizeHint(const std::vector<T, A> & v)
+    {
+        if (std::is_fundamental<T>::value && !std::is_same<T, bool>::value)
+        {
+            return getArraySizeHint(v.size()*sizeof(T));
+        }
+
+        // Rough estimate for elements that are serialized individually.
+        return v.size()*sizeof(T);
+    }
+
+    template<typename C, typename Tr, typename A>
+    inline std::size_t getSizeHint(const std::basic_string<C, Tr, A> & s)
+    {
+        return s.size()*sizeof(C);
+    }
+
+    template<typename P>
+    inline std::size_t getParameterSizeHint(P &)
+    {
+        return 0;
+    }
+
+    template<typename T>
+    inline std::size_t getParameterSizeHint(Cm_Value<T> & p)
+    {
+        return getSizeHint(p.get());
+    }
+
+    template<typename T>
+    inline std::size_t getParameterSizeHint(Cm_CRef<T> & p)
+    {
+        return getSizeHint(p.get());
+    }
+
+    template<typename T>
+    inline std::size_t getParameterSizeHint(Cm_Ref<T> & p)
+    {
+        return getSizeHint(p.get());
+    }
+
+    template<typename T>
+    inline std::size_t getParameterSizeHint(Sm_Ret<T> & p)
+    {
+        return getSizeHint(p.get());
+    }
+
+    template<typename T>
+    inline std::size_t getParameterSizeHint(Sm_Ref<T> & p)
+    {
+        return getSizeHint(p.get());
+    }
+
+    template<typename T>
+    inline std::size_t getParameterSizeHint(Sm_OutRef<T> & p)
+    {
+        return getSizeHint(p.get());
+    }
+
+    // Parallel serialization writes and reads each parameter as a separate segment.
+
+    template<typename P>
+    inline void addSegmentWriter(
+        std::vector<SegmentWriter> &    writers, 
+        std::vector<std::size_t> &      sizeHints, 
+        P &                             p)
+    {
+        writers.push_back( [&p](SerializationProtocolOut & out) { p.write(out); } );
+        sizeHints.push_back( getParameterSizeHint(p) );
+    }
+
+    template<typename P>
+    inline void addSegmentReader(
+        std::vector<SegmentReader> &    readers, 
+        P &                             p)
+    {
+        readers.push_back( [&p](SerializationProtocolIn & in) { p.read(in); } );
+    }
+
     class I_Parameters
     {
     public:
@@ -1319,6 +1458,34 @@ namespace RCF {
 
         void read(SerializationProtocolIn &in)
         {
+            if (in.getEnableSfSchemaFixed())
+            {
+                verifySfSchemaHash(in, getSchemaHash());
+            }
+
+            if (in.getParallelSerializationThreshold())
+            {
+                std::vector<SegmentReader> readers;
+                if RCF_CONSTEXPR(IsReturnValue<R>::value)        addSegmentReader(readers, r);
+                if RCF_CONSTEXPR(IsOutParameter<A1 >::value)     addSegmentReader(readers, a1);
+                if RCF_CONSTEXPR(IsOutParameter<A2 >::value)     addSegmentReader(readers, a2);
+                if RCF_CONSTEXPR(IsOutParameter<A3 >::value)     addSegmentReader(readers, a3);
+                if RCF_CONSTEXPR(IsOutParameter<A4 >::value)     addSegmentReader(readers, a4);
+                if RCF_CONSTEXPR(IsOutParameter<A5 >::value)     addSegmentReader(readers, a5);
+                if RCF_CONSTEXPR(IsOutParameter<A6 >::value)     addSegmentReader(readers, a6);
+                if RCF_CONSTEXPR(IsOutParameter<A7 >::value)     addSegmentReader(readers, a7);
+                if RCF_CONSTEXPR(IsOutParameter<A8 >::value)     addSegmentReader(readers, a8);
+                if RCF_CONSTEXPR(IsOutParameter<A9 >::value)     addSegmentReader(readers, a9);
+                if RCF_CONSTEXPR(IsOutParameter<A10>::value)     addSegmentReader(readers, a10);
+                if RCF_CONSTEXPR(IsOutParameter<A11>::value)     addSegmentReader(readers, a11);
+                if RCF_CONSTEXPR(IsOutParameter<A12>::value)     addSegmentReader(readers, a12);
+                if RCF_CONSTEXPR(IsOutParameter<A13>::value)     addSegmentReader(readers, a13);
+                if RCF_CONSTEXPR(IsOutParameter<A14>::value)     addSegmentReader(readers, a14);
+                if RCF_CONSTEXPR(IsOutParameter<A15>::value)     addSegmentReader(readers, a15);
+                in.readSegments(readers);
+                return;
+            }
+
             if RCF_CONSTEXPR(IsReturnValue<R>::value)        r.read(in);
             if RCF_CONSTEXPR(IsOutParameter<A1 >::value)     a1.read(in);
             if RCF_CONSTEXPR(IsOutParameter<A2 >::value)     a2.read(in);
@@ -1339,6 +1506,36 @@ namespace RCF {
 
         void write(SerializationProtocolOut &out)
         {
+            if (out.getEnableSfSchemaFixed())
+            {
+                writeSfSchemaHash(out, getSchemaHash());
+            }
+
+            if (out.getParallelSerializationThreshold())
+            {
+                std::vector<SegmentWriter> writers;
+                std::vector<std::size_t> sizeHints;
+                if RCF_CONSTEXPR(IsInParameter<A1 >::value)      addSegmentWriter(writers, sizeHints, a1);
+                if RCF_CONSTEXPR(IsInParameter<A2 >::value)      addSegmentWriter(writers, sizeHints, a2);
+                if RCF_CONSTEXPR(IsInParameter<A3 >::value)      addSegmentWriter(writers, sizeHints, a3);
+                if RCF_CONSTEXPR(IsInParameter<A4 >::value)      addSegmentWriter(writers, sizeHints, a4);
+                if RCF_CONSTEXPR(IsInParameter<A5 >::value)      addSegmentWriter(writers, sizeHints, a5);
+                if RCF_CONSTEXPR(IsInParameter<A6 >::value)      addSegmentWriter(writers, sizeHints, a6);
+                if RCF_CONSTEXPR(IsInParameter<A7 >::value)      addSegmentWriter(writers, sizeHints, a7);
+                if RCF_CONSTEXPR(IsInParameter<A8 >::value)      addSegmentWriter(writers, sizeHints, a8);
+                if RCF_CONSTEXPR(IsInParameter<A9 >::value)      addSegmentWriter(writers, sizeHints, a9);
+                if RCF_CONSTEXPR(IsInParameter<A10>::value)      addSegmentWriter(writers, sizeHints, a10);
+                if RCF_CONSTEXPR(IsInParameter<A11>::value)      addSegmentWriter(writers, sizeHints, a11);
+                if RCF_CONSTEXPR(IsInParameter<A12>::value)      addSegmentWriter(writers, sizeHints, a12);
+                if RCF_CONSTEXPR(IsInParameter<A13>::value)      addSegmentWriter(writers, sizeHints, a13);
+                if RCF_CONSTEXPR(IsInParameter<A14>::value)      addSegmentWriter(writers, sizeHints, a14);
+                if RCF_CONSTEXPR(IsInParameter<A15>::value)      addSegmentWriter(writers, sizeHints, a15);
+                out.writeSegments(writers, sizeHints);
+                return;
+            }
+
+            out.reserve( getSizeHint() );
+
             if RCF_CONSTEXPR(IsInParameter<A1 >::value)      a1.write(out);
             if RCF_CONSTEXPR(IsInParameter<A2 >::value)      a2.write(out);
             if RCF_CONSTEXPR(IsInParameter<A3 >::value)      a3.write(out);
@@ -1402,6 +1599,33 @@ namespace RCF {
             return enrolled;
         }
 
+        static std::uint32_t getSchemaHash()
+        {
+            return getSfSchemaHash<
+                R, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11, A12, A13, A14, A15>();
+        }
+
+        std::size_t getSizeHint()
+        {
+            std::size_t sizeHint = 0;
+            if RCF_CONSTEXPR(IsInParameter<A1 >::value)      sizeHint += getParameterSizeHint(a1);
+            if RCF_CONSTEXPR(IsInParameter<A2 >::value)      sizeHint += getParameterSizeHint(a2);
+            if RCF_CONSTEXPR(IsInParameter<A3 >::value)      sizeHint += getParameterSizeHint(a3);
+            if RCF_CONSTEXPR(IsInParameter<A4 >::value)      sizeHint += getParameterSizeHint(a4);
+            if RCF_CONSTEXPR(IsInParameter<A5 >::value)      sizeHint += getParameterSizeHint(a5);
+            if RCF_CONSTEXPR(IsInParameter<A6 >::value)      sizeHint += getParameterSizeHint(a6);
+            if RCF_CONSTEXPR(IsInParameter<A7 >::value)      sizeHint += getParameterSizeHint(a7);
+            if RCF_CONSTEXPR(IsInParameter<A8 >::value)      sizeHint += getParameterSizeHint(a8);
+            if RCF_CONSTEXPR(IsInParameter<A9 >::value)      sizeHint += getParameterSizeHint(a9);
+            if RCF_CONSTEXPR(IsInParameter<A10>::value)      sizeHint += getParameterSizeHint(a10);
+            if RCF_CONSTEXPR(IsInParameter<A11>::value)      sizeHint += getParameterSizeHint(a11);
+            if RCF_CONSTEXPR(IsInParameter<A12>::value)      sizeHint += getParameterSizeHint(a12);
+            if RCF_CONSTEXPR(IsInParameter<A13>::value)      sizeHint += getParameterSizeHint(a13);
+            if RCF_CONSTEXPR(IsInParameter<A14>::value)      sizeHint += getParameterSizeHint(a14);
+            if RCF_CONSTEXPR(IsInParameter<A15>::value)      sizeHint += getParameterSizeHint(a15);
+            return sizeHint;
+        }
+
         Cm_Ret<R>                               r;
         typename ClientMarshal<A1>::type        a1;
         typename ClientMarshal<A2>::type        a2;
@@ -1562,6 +1786,33 @@ namespace RCF {
 
         void read(SerializationProtocolIn &in)
         {
+            if (in.getEnableSfSchemaFixed())
+            {
+                verifySfSchemaHash(in, getSchemaHash());
+            }
+
+            if (in.getParallelSerializationThreshold())
+            {
+                std::vector<SegmentReader> readers;
+                if RCF_CONSTEXPR(IsInParameter<A1 >::value)      addSegmentReader(readers, a1);
+                if RCF_CONSTEXPR(IsInParameter<A2 >::value)      addSegmentReader(readers, a2);
+                if RCF_CONSTEXPR(IsInParameter<A3 >::value)      addSegmentReader(readers, a3);
+                if RCF_CONSTEXPR(IsInParameter<A4 >::value)      addSegmentReader(readers, a4);
+                if RCF_CONSTEXPR(IsInParameter<A5 >::value)      addSegmentReader(readers, a5);
+                if RCF_CONSTEXPR(IsInParameter<A6 >::value)      addSegmentReader(readers, a6);
+                if RCF_CONSTEXPR(IsInParameter<A7 >::value)      addSegmentReader(readers, a7);
+                if RCF_CONSTEXPR(IsInParameter<A8 >::value)      addSegmentReader(readers, a8);
+                if RCF_CONSTEXPR(IsInParameter<A9 >::value)      addSegmentReader(readers, a9);
+                if RCF_CONSTEXPR(IsInParameter<A10>::value)      addSegmentReader(readers, a10);
+                if RCF_CONSTEXPR(IsInParameter<A11>::value)      addSegmentReader(readers, a11);
+                if RCF_CONSTEXPR(IsInParameter<A12>::value)      addSegmentReader(readers, a12);
+                if RCF_CONSTEXPR(IsInParameter<A13>::value)      addSegmentReader(readers, a13);
+                if RCF_CONSTEXPR(IsInParameter<A14>::value)      addSegmentReader(readers, a14);
+                if RCF_CONSTEXPR(IsInParameter<A15>::value)      addSegmentReader(readers, a15);
+                in.readSegments(readers);
+                return;
+            }
+
             if RCF_CONSTEXPR(IsInParameter<A1 >::value)      a1.read(in);
             if RCF_CONSTEXPR(IsInParameter<A2 >::value)      a2.read(in);
             if RCF_CONSTEXPR(IsInParameter<A3 >::value)      a3.read(in);
@@ -1581,6 +1832,37 @@ namespace RCF {
 
         void write(SerializationProtocolOut &out)
         {
+            if (out.getEnableSfSchemaFixed())
+            {
+                writeSfSchemaHash(out, getSchemaHash());
+            }
+
+            if (out.getParallelSerializationThreshold())
+            {
+                std::vector<SegmentWriter> writers;
+                std::vector<std::size_t> sizeHints;
+                if RCF_CONSTEXPR(IsReturnValue<R>::value)        addSegmentWriter(writers, sizeHints, r);
+                if RCF_CONSTEXPR(IsOutParameter<A1>::value)      addSegmentWriter(writers, sizeHints, a1);
+                if RCF_CONSTEXPR(IsOutParameter<A2>::value)      addSegmentWriter(writers, sizeHints, a2);
+                if RCF_CONSTEXPR(IsOutParameter<A3>::value)      addSegmentWriter(writers, sizeHints, a3);
+                if RCF_CONSTEXPR(IsOutParameter<A4>::value)      addSegmentWriter(writers, sizeHints, a4);
+                if RCF_CONSTEXPR(IsOutParameter<A5>::value)      addSegmentWriter(writers, sizeHints, a5);
+                if RCF_CONSTEXPR(IsOutParameter<A6>::value)      addSegmentWriter(writers, sizeHints, a6);
+                if RCF_CONSTEXPR(IsOutParameter<A7>::value)      addSegmentWriter(writers, sizeHints, a7);
+                if RCF_CONSTEXPR(IsOutParameter<A8>::value)      addSegmentWriter(writers, sizeHints, a8);
+                if RCF_CONSTEXPR(IsOutParameter<A9>::value)      addSegmentWriter(writers, sizeHints, a9);
+                if RCF_CONSTEXPR(IsOutParameter<A10>::value)     addSegmentWriter(writers, sizeHints, a10);
+                if RCF_CONSTEXPR(IsOutParameter<A11>::value)     addSegmentWriter(writers, sizeHints, a11);
+                if RCF_CONSTEXPR(IsOutParameter<A12>::value)     addSegmentWriter(writers, sizeHints, a12);
+                if RCF_CONSTEXPR(IsOutParameter<A13>::value)     addSegmentWriter(writers, sizeHints, a13);
+                if RCF_CONSTEXPR(IsOutParameter<A14>::value)     addSegmentWriter(writers, sizeHints, a14);
+                if RCF_CONSTEXPR(IsOutParameter<A15>::value)     addSegmentWriter(writers, sizeHints, a15);
+                out.writeSegments(writers, sizeHints);
+                return;
+            }
+
+            out.reserve( getSizeHint() );
+
             if RCF_CONSTEXPR(IsReturnValue<R>::value)        r.write(out);
             if RCF_CONSTEXPR(IsOutParameter<A1>::value)      a1.write(out);
             if RCF_CONSTEXPR(IsOutParameter<A2>::value)      a2.write(out);
@@ -1606,6 +1888,34 @@ namespace RCF {
             return false;
         }
 
+        static std::uint32_t getSchemaHash()
+        {
+            return getSfSchemaHash<
+                R, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11, A12, A13, A14, A15>();
+        }
+
+        std::size_t getSizeHint()
+        {
+            std::size_t sizeHint = 0;
+            if RCF_CONSTEXPR(IsReturnValue<R>::value)        sizeHint += getParameterSizeHint(r);
+            if RCF_CONSTEXPR(IsOutParameter<A1>::value)      sizeHint += getParameterSizeHint(a1);
+            if RCF_CONSTEXPR(IsOutParameter<A2>::value)      sizeHint += getParameterSizeHint(a2);
+            if RCF_CONSTEXPR(IsOutParameter<A3>::value)      sizeHint += getParameterSizeHint(a3);
+            if RCF_CONSTEXPR(IsOutParameter<A4>::value)      sizeHint += getParameterSizeHint(a4);
+            if RCF_CONSTEXPR(IsOutParameter<A5>::value)      sizeHint += getParameterSizeHint(a5);
+            if RCF_CONSTEXPR(IsOutParameter<A6>::value)      sizeHint += getParameterSizeHint(a6);
+            if RCF_CONSTEXPR(IsOutParameter<A7>::value)      sizeHint += getParameterSizeHint(a7);
+            if RCF_CONSTEXPR(IsOutParameter<A8>::value)      sizeHint += getParameterSizeHint(a8);
+            if RCF_CONSTEXPR(IsOutParameter<A9>::value)      sizeHint += getParameterSizeHint(a9);
+            if RCF_CONSTEXPR(IsOutParameter<A10>::value)     sizeHint += getParameterSizeHint(a10);
+            if RCF_CONSTEXPR(IsOutParameter<A11>::value)     sizeHint += getParameterSizeHint(a11);
+            if RCF_CONSTEXPR(IsOutParameter<A12>::value)     sizeHint += getParameterSizeHint(a12);
+            if RCF_CONSTEXPR(IsOutParameter<A13>::value)     sizeHint += getParameterSizeHint(a13);
+            if RCF_CONSTEXPR(IsOutParameter<A14>::value)     sizeHint += getParameterSizeHint(a14);
+            if RCF_CONSTEXPR(IsOutParameter<A15>::value)     sizeHint += getParameterSizeHint(a15);
+            return sizeHint;
+        }
+
         typename ServerMarshalRet<R>::type      r;
         typename ServerMarshal<A1>::type        a1;
         typename ServerMarshal<A2>::type        a2;
@@ -118,6 +118,10 @@ namespace RCF {
     private:   
         std::streambuf::int_type overflow(std::streambuf::int_type ch);
 
+        char * reserveWrite(std::size_t len);
+        void reserve(std::size_t len);
+        void grow(std::size_t newSize);
+
         pos_type seekoff(
             off_type off, 
             std::ios_base::seekdir dir,
@@ -142,6 +146,13 @@ namespace RCF {
 
         std::size_t capacity();
 
+        // Reserves len bytes at the current write position, and returns a pointer to them. The caller fills them in 
+        // directly, instead of writing from a separate buffer. The pointer is invalidated by the next write.
+        char * reserveWrite(std::size_t len);
+
+        // Makes room for at least len more bytes after the current write position, with a single allocation.
+        void reserve(std::size_t len);
+
         void rewind()
         {
             rdbuf()->pubseekoff(0, std::ios::beg, std::ios::out);
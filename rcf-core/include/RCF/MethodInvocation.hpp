@@ -28,6 +28,7 @@
 #include <RCF/Export.hpp>
 #include <RCF/Exception.hpp>
 #include <RCF/SerializationProtocol_Base.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 
 namespace RCF {
 
@@ -113,7 +114,9 @@ namespace RCF {
                             std::uint32_t                   pingBackIntervalMs,
                             int                             archiveVersion,
                             bool                            enableSfPointerTracking,
-                            bool                            enableNativeWstringSerialization);
+                            bool                            enableNativeWstringSerialization,
+                            bool                            enableSfSchemaFixed,
+                            std::uint32_t                   parallelSerializationThreshold);
 
         int             getFnId() const;
         bool            getOneway() const;
@@ -180,6 +183,8 @@ namespace RCF {
         ByteBuffer              mResponseUserData;
         bool                    mEnableSfPointerTracking;
         bool                    mEnableNativeWstringSerialization = false;
+        bool                    mEnableSfSchemaFixed = false;
+        std::uint32_t           mParallelSerializationThreshold = 0;
         ByteBuffer              mOutOfBandRequest;
         ByteBuffer              mOutOfBandResponse;
 
@@ -302,7 +307,8 @@ namespace RCF {
         OobRequestSubscription(
             int                     runtimeVersion, 
             const std::string &     publisherName, 
-            std::uint32_t           subToPubPingIntervalMs);
+            std::uint32_t           subToPubPingIntervalMs,
+            const SubscriptionFilter & filter = SubscriptionFilter());
 
         virtual OobMessageType  getMessageType();
         virtual void            encodeRequest(ByteBuffer & buffer);
@@ -314,6 +320,7 @@ namespace RCF {
         std::string             mPublisherName;
         std::uint32_t           mSubToPubPingIntervalMs;
         std::uint32_t           mPubToSubPingIntervalMs;
+        SubscriptionFilter      mFilter;
     };
 
     class RCF_EXPORT OobRequestProxyConnection : public OobMessage
@@ -24,7 +24,9 @@
 #include <vector>
 
 #include <RCF/ClientTransport.hpp>
+#include <RCF/Enums.hpp>
 #include <RCF/Export.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 #include <RCF/ThreadLibrary.hpp>
 
 namespace RCF {
@@ -32,23 +34,35 @@ namespace RCF {
     typedef std::shared_ptr< ClientTransportUniquePtr >       ClientTransportUniquePtrPtr;
     typedef std::vector< ClientTransportUniquePtrPtr >        ClientTransportList;
 
+    class SubscriberQueue;
+    typedef std::shared_ptr<SubscriberQueue>                  SubscriberQueuePtr;
+    typedef std::vector<SubscriberQueuePtr>                   SubscriberQueueList;
+
+    class SubscriberRoutingTable;
+    typedef std::shared_ptr<SubscriberRoutingTable>           SubscriberRoutingTablePtr;
+
     // Special purpose client transport for sending messages in parallel on multiple sub-transports.
+    //
+    // Each sub-transport has its own bounded queue of outgoing messages, and at most one asynchronous write in 
+    // progress. send() queues the message on every sub-transport and returns without waiting for any of the writes,
+    // so a slow subscriber doesn't hold up the publisher or the other subscribers.
+    //
+    // Messages with a routing key or tag only go to sub-transports whose subscription filter matches, and to 
+    // sub-transports without a filter. The filters are indexed, so routing a message doesn't visit the sub-transports
+    // it isn't sent to.
     class RCF_EXPORT MulticastClientTransport : public ClientTransport
     {
     public:
 
+        MulticastClientTransport();
+        ~MulticastClientTransport();
+
         TransportType getTransportType();
 
         std::unique_ptr<ClientTransport> clone() const;
 
         EndpointPtr getEndpointPtr() const;
 
-        void        doSendOnTransports(
-            Lock&                           lock,
-            ClientTransportList&            transportList,
-            const std::vector<ByteBuffer> & data,
-            unsigned int                    timeoutMs);
-
         int         send(
                         ClientTransportCallback &     clientStub, 
                         const std::vector<ByteBuffer> & data, 
@@ -68,8 +82,12 @@ namespace RCF {
         void        disconnect(
                         unsigned int                    timeoutMs);
 
+        // If pIoService is given, writes to an idle sub-transport are started from that I/O service rather than 
+        // from send().
         void        addTransport(
-                        ClientTransportUniquePtr          clientTransportUniquePtr);
+                        ClientTransportUniquePtr          clientTransportUniquePtr,
+                        AsioIoService *                 pIoService = NULL,
+                        const SubscriptionFilter &      filter = SubscriptionFilter());
 
         void        setTransportFilters(
                         const std::vector<FilterPtr> &  filters);
@@ -86,19 +104,50 @@ namespace RCF {
 
         std::size_t getTransportCount();
 
+        // Sets the maximum number of messages queued per sub-transport (zero for no limit), and what to do when a 
+        // queue is full.
+        void        setQueueLimits(
+                        std::size_t                     maxQueueLength,
+                        SlowSubscriberPolicy            slowSubscriberPolicy);
+
+        // Sets the conflation key of the next message sent.
+        void        setConflationKey(
+                        const std::string &             conflationKey);
+
+        // Sets the routing key or tag of the next message sent. Without either, the message is sent on all 
+        // sub-transports.
+        void        setRoutingKey(
+                        std::uint64_t                   routingKey);
+
+        void        setRoutingTag(
+                        const std::string &             routingTag);
+
+        void        clearRouting();
+
     private:
 
         void        bringInNewTransports();
+        void        removeClosedTransports();
 
         Mutex                                           mClientTransportsMutex;
-        ClientTransportList                             mClientTransports;
-        ClientTransportList                             mClientTransportsTemp;
-        ClientTransportList                             mClientTransportsSending;
+        SubscriberQueueList                             mClientTransports;
 
         Mutex                                           mAddedClientTransportsMutex;
-        ClientTransportList                             mAddedClientTransports;
+        SubscriberQueueList                             mAddedClientTransports;
 
         ClientTransportUniquePtr                          mMulticastTemp;
+
+        std::size_t                                     mMaxQueueLength;
+        SlowSubscriberPolicy                            mSlowSubscriberPolicy;
+        std::string                                     mConflationKey;
+
+        bool                                            mHasRoutingKey;
+        std::uint64_t                                   mRoutingKey;
+        bool                                            mHasRoutingTag;
+        std::string                                     mRoutingTag;
+
+        // Built on demand, and discarded whenever sub-transports are added or removed.
+        SubscriberRoutingTablePtr                       mRoutingTablePtr;
     };
 
 } // namespace RCF
@@ -32,6 +32,12 @@ namespace RCF {
 
     static const std::size_t CbSize = 128;
 
+    // Pooled buffers are grouped into power-of-two size classes. Size class 0 holds buffers with a capacity
+    // below 2 KB, and size class N holds buffers with a capacity in [2^(N+10), 2^(N+11)).
+    static const std::size_t BufferSizeClassCount = 32;
+
+    RCF_EXPORT std::size_t getBufferSizeClass(std::size_t capacity);
+
     class ObjectPool;
 
     class RCF_EXPORT CbAllocatorBase
@@ -172,18 +178,34 @@ namespace RCF {
             return false;
         }
 
-        MemOstreamPtr getMemOstreamPtr();
-        ReallocBufferPtr getReallocBufferPtr();
+        /// Returns a pooled MemOstream. If sizeHint is non-zero, a buffer with at least that capacity is preferred.
+        MemOstreamPtr getMemOstreamPtr(std::size_t sizeHint = 0);
+
+        /// Returns a pooled ReallocBuffer. If sizeHint is non-zero, a buffer with at least that capacity is preferred.
+        ReallocBufferPtr getReallocBufferPtr(std::size_t sizeHint = 0);
 
         void enumerateWriteBuffers(std::vector<std::size_t> & bufferSizes);
         void enumerateReadBuffers(std::vector<std::size_t> & bufferSizes);
 
+        /// Sets the maximum number of buffers held in the global pool, per buffer size class.
         void setBufferCountLimit(std::size_t bufferCountLimit);
         std::size_t getBufferCountLimit();
 
+        /// Sets the maximum capacity of a buffer that will be returned to the pool. Larger buffers are freed.
         void setBufferSizeLimit(std::size_t bufferSizeLimit);
         std::size_t getBufferSizeLimit();
 
+        /// Sets the maximum number of buffers each thread caches locally, per buffer size class. 
+        /// Buffers in a thread local cache can be acquired and released without locking the global pool.
+        /// Set to zero to disable thread local caching.
+        void setThreadCacheCountLimit(std::size_t threadCacheCountLimit);
+        std::size_t getThreadCacheCountLimit();
+
+        /// Sets the maximum capacity of a buffer that will be held in a thread local cache. Larger
+        /// buffers are returned directly to the global pool.
+        void setThreadCacheSizeLimit(std::size_t threadCacheSizeLimit);
+        std::size_t getThreadCacheSizeLimit();
+
         /// Returns an object of type T from the cache. The object is returned as a std::shared_ptr<T>
         /// and is equipped with a custom deleter, so that once the shared_ptr<T> goes out of scope,
         /// the object is automatically returned to the cache.
@@ -367,51 +389,37 @@ namespace RCF {
         void putMemOstream(MemOstream * pOs);
         void putReallocBuffer(ReallocBuffer * pRb);
 
+        template<typename T>
+        T * getBuffer(
+            std::size_t             sizeHint,
+            std::vector<T *> *      tlsCache,
+            std::vector<T *> *      pool,
+            Mutex &                 poolMutex);
+
+        template<typename T>
+        void putBuffer(
+            T *                     pt,
+            std::size_t             bufferSize,
+            std::vector<T *> *      tlsCache,
+            std::vector<T *> *      pool,
+            Mutex &                 poolMutex);
+
         std::size_t                             mBufferCountLimit;
         std::size_t                             mBufferSizeLimit;
+        std::size_t                             mThreadCacheCountLimit;
+        std::size_t                             mThreadCacheSizeLimit;
+
+        // Buffers are pooled by size class, see getBufferSizeClass().
 
         Mutex                                   mOsPoolMutex;
-        std::vector< MemOstream * >             mOsPool;
+        std::vector< MemOstream * >             mOsPool[BufferSizeClassCount];
 
         Mutex                                   mRbPoolMutex;
-        std::vector< ReallocBuffer * >          mRbPool;
+        std::vector< ReallocBuffer * >          mRbPool[BufferSizeClassCount];
 
         Mutex                                   mCbPoolMutex;
         std::vector< void * >                   mCbPool;
 
-        template<typename T, typename Spt, typename PtrList, typename Pfn>
-        void getPtr(
-            T *,
-            Spt &           spt, 
-            PtrList &       ptrList,
-            Mutex &         ptrListMutex,
-            Pfn             pfn)
-        {
-            T * pt = NULL;
-
-            {
-                Lock lock(ptrListMutex);
-
-                if (ptrList.empty())
-                {
-                    pt = new T();
-                }
-                else
-                {
-                    pt = ptrList.back();
-                    ptrList.pop_back();
-                }
-            }
-
-            // Use shared_ptr allocator to avoid all allocations when a buffer is requested.
-
-            spt = std::shared_ptr<T>( 
-                pt, 
-                std::bind(pfn, this, std::placeholders::_1),
-                CbAllocator<void>(*this) );
-
-        }
-
     };
 
     RCF_EXPORT ObjectPool & getObjectPool();
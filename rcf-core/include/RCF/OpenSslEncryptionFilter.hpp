@@ -113,7 +113,7 @@ namespace RCF {
         OpenSslEncryptionFilter(
             ClientStub *            pClientStub,
             SslRole                 sslRole = SslClient,
-            unsigned int            bioBufferSize = 2048);
+            unsigned int            bioBufferSize = 17*1024);
 
         OpenSslEncryptionFilter(
             const std::string &     certificateFile,
@@ -122,7 +122,8 @@ namespace RCF {
             const std::string &     ciphers,
             CertificateValidationCallback verifyFunctor,
             SslRole                 sslRole = SslClient,
-            unsigned int            bioBufferSize = 2048);
+            unsigned int            bioBufferSize = 17*1024,
+            bool                    enableSessionResumption = false);
 
         void        resetState();
         void        read(const ByteBuffer &byteBuffer, std::size_t bytesRequested);
@@ -23,11 +23,13 @@
 #include <map>
 #include <string>
 
+#include <RCF/Enums.hpp>
 #include <RCF/Export.hpp>
 #include <RCF/PeriodicTimer.hpp>
 #include <RCF/RcfClient.hpp>
 #include <RCF/RcfFwd.hpp>
 #include <RCF/Service.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 #include <RCF/ThreadLibrary.hpp>
 #include <RCF/Timer.hpp>
 #include <RCF/Tools.hpp>
@@ -51,13 +53,28 @@ namespace RCF {
         /// Configures a callback to be called whenever a subscriber disconnects from this publisher.
         void setOnSubscriberDisconnect(OnSubscriberDisconnect onSubscriberDisconnect);
 
+        /// Sets the maximum number of messages queued for each subscriber. Publishing doesn't wait for messages to reach subscribers. Instead each subscriber has a queue of messages waiting to be sent, and the slow subscriber policy applies when a message is published to a full queue. Zero means no limit. Defaults to 1000.
+        void setSubscriberQueueLength(std::size_t queueLength);
+
+        /// Gets the maximum number of messages queued for each subscriber.
+        std::size_t getSubscriberQueueLength() const;
+
+        /// Sets what happens when a message is published and a subscriber's queue is full. Defaults to Ssp_Disconnect.
+        void setSlowSubscriberPolicy(SlowSubscriberPolicy policy);
+
+        /// Gets what happens when a message is published and a subscriber's queue is full.
+        SlowSubscriberPolicy getSlowSubscriberPolicy() const;
+
     private:
 
         friend class PublishingService;
+        friend class PublisherBase;
 
         std::string             mTopicName;
         OnSubscriberConnect     mOnSubscriberConnect;
         OnSubscriberDisconnect  mOnSubscriberDisconnect;
+        std::size_t             mSubscriberQueueLength = 1000;
+        SlowSubscriberPolicy    mSlowSubscriberPolicy = Ssp_Disconnect;
     };
 
     /// Base class of all publishers.
@@ -81,6 +98,9 @@ namespace RCF {
         friend class PublishingService;
 
         void init();
+        void prepareMessage(const std::string & conflationKey);
+        void prepareMessage(std::uint64_t routingKey, const std::string & conflationKey);
+        void prepareTaggedMessage(const std::string & tag, const std::string & conflationKey);
 
         PublishingService &     mPublishingService;
         PublisherParms          mParms;
@@ -116,6 +136,31 @@ namespace RCF {
         RcfClientT & publish()
         {
             RCF_ASSERT(!mClosed);
+            prepareMessage(std::string());
+            return *mpClient;
+        }
+
+        /// Returns a reference to the RcfClient<> instance to use when publishing a message with a conflation key. With the Ssp_Conflate policy, the message replaces any message with the same key still waiting to be sent to a subscriber.
+        RcfClientT & publish(const std::string & conflationKey)
+        {
+            RCF_ASSERT(!mClosed);
+            prepareMessage(conflationKey);
+            return *mpClient;
+        }
+
+        /// Returns a reference to the RcfClient<> instance to use when publishing a message with a routing key. The message is only sent to subscribers whose SubscriptionFilter contains the key, and to subscribers without a filter.
+        RcfClientT & publishToKey(std::uint64_t routingKey, const std::string & conflationKey = std::string())
+        {
+            RCF_ASSERT(!mClosed);
+            prepareMessage(routingKey, conflationKey);
+            return *mpClient;
+        }
+
+        /// Returns a reference to the RcfClient<> instance to use when publishing a message with a tag. The message is only sent to subscribers whose SubscriptionFilter contains the tag, and to subscribers without a filter.
+        RcfClientT & publishToTag(const std::string & tag, const std::string & conflationKey = std::string())
+        {
+            RCF_ASSERT(!mClosed);
+            prepareTaggedMessage(tag, conflationKey);
             return *mpClient;
         }
 
@@ -170,6 +215,12 @@ namespace RCF {
                             std::uint32_t subToPubPingIntervalMs,
                             std::uint32_t & pubToSubPingIntervalMs);
 
+        std::int32_t  RequestSubscription(
+                            const std::string &subscriptionName,
+                            std::uint32_t subToPubPingIntervalMs,
+                            std::uint32_t & pubToSubPingIntervalMs,
+                            const SubscriptionFilter & filter);
+
     private:
 
         void            onServiceAdded(RcfServer &server);
@@ -180,7 +231,8 @@ namespace RCF {
         void            addSubscriberTransport(
                             RcfSession &session,
                             const std::string &publisherName,
-                            ClientTransportUniquePtrPtr clientTransportUniquePtrPtr);
+                            ClientTransportUniquePtrPtr clientTransportUniquePtrPtr,
+                            const SubscriptionFilter &filter);
 
         void            closePublisher(const std::string & name);
 
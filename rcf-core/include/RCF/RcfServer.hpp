@@ -21,6 +21,8 @@
 #ifndef INCLUDE_RCF_RCFSERVER_HPP
 #define INCLUDE_RCF_RCFSERVER_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -171,6 +173,7 @@ namespace RCF {
 
             WriteLock writeLock(mStubMapMutex);
             mStubMap.erase(name_);
+            ++mStubMapVersion;
             return true;
         }
         
@@ -193,6 +196,12 @@ namespace RCF {
         /// Gets the cipher suite to use when establishing an SSL connection. Only applicable to OpenSSL - based SSL.
         std::string             getOpenSslCipherSuite() const;
 
+        /// Enables or disables SSL session resumption for incoming connections. Enabled by default. Only applicable to OpenSSL - based SSL.
+        void                    setEnableSslSessionResumption(bool enable);
+
+        /// Returns true if SSL session resumption is enabled. Only applicable to OpenSSL - based SSL.
+        bool                    getEnableSslSessionResumption() const;
+
         /// Sets the certificate authority certificate to use when validating certificates from a HTTPS client. Not applicable to Schannel-based SSL.
         void                    setCaCertificate(CertificatePtr certificatePtr);
 
@@ -392,6 +401,42 @@ namespace RCF {
         /// Gets the total bandwidth limit for all downloads from this RcfServer. By default the bandwidth limit is zero (unlimited).
         std::uint32_t       getDownloadBandwidthLimit() const;
 
+        /// Sets whether file downloads are served from memory mapped regions of the file, rather than being read into 
+        /// buffers first. Chunk data is then sent directly from the page cache. The default is false. Files must not 
+        /// be truncated while they are being downloaded, as reading a mapped region past the end of a file terminates 
+        /// the process. Only applies on non-Windows platforms.
+        void                setDownloadMemoryMapping(bool enable);
+
+        /// Gets whether file downloads are served from memory mapped regions of the file.
+        bool                getDownloadMemoryMapping() const;
+
+        /// Sets the callback used to locate the existing copy of a file on this RcfServer, when a client makes a 
+        /// delta upload against it. By default the basis id is taken to be the upload id of a completed upload in 
+        /// the upload directory.
+        void                setUploadBasisCallback(UploadBasisCallback uploadBasisCb);
+
+        /// Sets the maximum number of threads this RcfServer uses for reading and writing files during file 
+        /// transfers. If set to zero, the RCF-wide file I/O thread pool is used. Default is zero.
+        void                setFileIoThreadCount(std::size_t threadCount);
+
+        /// Gets the maximum number of threads this RcfServer uses for reading and writing files during file transfers.
+        std::size_t         getFileIoThreadCount() const;
+
+        /// Sets the number of chunks each file transfer keeps in flight to and from the disk. Downloads read this 
+        /// many chunks ahead of the client, and uploads allow this many chunks to be written behind the client. 
+        /// Higher values increase disk throughput, at the cost of more memory per transfer. Default is 1.
+        void                setFileIoQueueDepth(std::size_t queueDepth);
+
+        /// Gets the number of chunks each file transfer keeps in flight to and from the disk.
+        std::size_t         getFileIoQueueDepth() const;
+
+        /// Sets the time after which an idle striped or delta upload is abandoned, and its partially uploaded file 
+        /// deleted. A client resuming the upload after that starts it again. Default is 600 seconds.
+        void                setUploadIdleTimeoutS(std::uint32_t idleTimeoutS);
+
+        /// Gets the time after which an idle striped or delta upload is abandoned.
+        std::uint32_t       getUploadIdleTimeoutS() const;
+
         /// Sets the path under which client uploads are saved. Must be set before any files can be uploaded.
         void                setUploadDirectory(const Path & uploadDir);
 
@@ -523,6 +568,9 @@ namespace RCF {
         typedef std::map<std::string, RcfClientPtr>     StubMap;
         StubMap                                         mStubMap;
 
+        // Incremented whenever mStubMap changes, so sessions know when to discard their resolved bindings.
+        std::atomic<std::uint32_t>                      mStubMapVersion = {0};
+
 
         typedef std::function<void(const JsonRpcRequest &, JsonRpcResponse &)> JsonRpcMethod;
         typedef std::map<std::string, JsonRpcMethod>    JsonRpcMethods;
@@ -596,6 +644,12 @@ namespace RCF {
         std::uint32_t                       mFileDownloadQuota;
         DownloadBandwidthQuotaCallback      mFileDownloadQuotaCb;
 
+        bool                                mFileDownloadMemoryMapping;
+        UploadBasisCallback                 mFileUploadBasisCb;
+        std::size_t                         mFileIoThreadCount;
+        std::size_t                         mFileIoQueueDepth;
+        std::uint32_t                       mFileUploadIdleTimeoutS;
+
         friend class FileTransferService;
 
 #endif
@@ -607,6 +661,7 @@ namespace RCF {
         std::vector<TransportProtocol>  mSupportedProtocols;
         CertificatePtr                  mCertificatePtr;
         std::string                     mOpenSslCipherSuite;
+        bool                            mEnableSslSessionResumption = true;
 
         CertificatePtr                  mCaCertificatePtr;
         CertificateValidationCallback   mCertificateValidationCb;
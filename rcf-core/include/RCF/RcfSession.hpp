@@ -21,6 +21,7 @@
 #ifndef INCLUDE_RCF_RCFSESSION_HPP
 #define INCLUDE_RCF_RCFSESSION_HPP
 
+#include <cstdint>
 #include <vector>
 #include <functional>
 #include <memory>
@@ -180,6 +181,9 @@ namespace RCF {
         void            setDefaultStubEntryPtr(RcfClientPtr stubEntryPtr);
         void            setCachedStubEntryPtr(RcfClientPtr stubEntryPtr);
 
+        RcfClientPtr    getResolvedStubEntryPtr(const std::string & name, std::uint32_t stubMapVersion);
+        void            addResolvedStubEntryPtr(const std::string & name, std::uint32_t stubMapVersion, RcfClientPtr stubEntryPtr);
+
         /// @name Custom request/response user data
         /// The application data in a remote call is normally carried in the parameters of the remote call itself.
         /// RCF also allows you to add untyped custom data to the remote call request and response.
@@ -535,6 +539,11 @@ namespace RCF {
         RcfClientPtr                            mDefaultStubEntryPtr;
         RcfClientPtr                            mCachedStubEntryPtr;
 
+        // Servant bindings resolved by this session, valid for a single version of the server's stub map.
+        typedef std::pair<std::string, RcfClientPtr> ResolvedStubEntry;
+        std::vector<ResolvedStubEntry>          mResolvedStubEntries;
+        std::uint32_t                           mResolvedStubMapVersion;
+
     public:
         NetworkSession & getNetworkSession() const;
         void setNetworkSession(NetworkSession & networkSession);
@@ -21,10 +21,12 @@
 
 #include <memory>
 
+#include <RCF/BufferAllocator.hpp>
 #include <RCF/Export.hpp>
 
 namespace RCF {
 
+    /// Growable byte buffer. Storage is obtained from the default BufferAllocator at the time of the first allocation.
     class RCF_EXPORT ReallocBuffer
     {
     public:
@@ -48,6 +50,8 @@ namespace RCF {
         char *          mpch;
         std::size_t     mSize;
         std::size_t     mCapacity;
+
+        BufferAllocatorPtr  mAllocatorPtr;
     };
 
     typedef std::shared_ptr<ReallocBuffer> ReallocBufferPtr;
@@ -19,9 +19,11 @@
 #ifndef INCLUDE_RCF_SERIALIZATIONPROTOCOL_HPP
 #define INCLUDE_RCF_SERIALIZATIONPROTOCOL_HPP
 
+#include <functional>
 #include <map>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include <RCF/ByteBuffer.hpp>
 #include <RCF/MemStream.hpp>
@@ -51,6 +53,14 @@ namespace RCF {
     class MethodInvocationRequest;
     class MethodInvocationResponse;
 
+    class SerializationProtocolIn;
+    class SerializationProtocolOut;
+
+    // Parallel serialization. Each segment of a message is an independent archive, written and read by its own 
+    // functor.
+    typedef std::function<void(SerializationProtocolOut &)>    SegmentWriter;
+    typedef std::function<void(SerializationProtocolIn &)>     SegmentReader;
+
     class RCF_EXPORT SerializationProtocolIn
     {
     public:
@@ -67,14 +77,31 @@ namespace RCF {
                             int protocol, 
                             int runtimeVersion, 
                             int archiveVersion,
-                            bool enableSfPointerTracking);
+                            bool enableSfPointerTracking,
+                            bool enableSfSchemaFixed = false);
 
         void            clearByteBuffer();
         void            clear();
         void            extractSlice(ByteBuffer &byteBuffer, std::size_t len);
+
+        // Keeps a buffer alive until the received message is released, for deserialized objects that refer to it.
+        void            retainByteBuffer(const ByteBuffer &byteBuffer);
+
         std::size_t     getArchiveLength();
         std::size_t     getRemainingArchiveLength();
 
+        // Segments of a message are read by their own SerializationProtocolIn. Returns the one reading the whole 
+        // message.
+        SerializationProtocolIn & 
+                        getRoot();
+
+        void            setParallelSerializationThreshold(std::uint32_t thresholdBytes);
+        std::uint32_t   getParallelSerializationThreshold() const;
+
+        // Reads segments written by SerializationProtocolOut::writeSegments(). Segments of at least the parallel 
+        // serialization threshold are read concurrently.
+        void            readSegments(const std::vector<SegmentReader> & readers);
+
         template<typename T>
         void read(const T *pt)
         {
@@ -114,6 +141,7 @@ namespace RCF {
         }
 
         int             getRuntimeVersion();
+        bool            getEnableSfSchemaFixed() const;
 
     private:
 
@@ -125,6 +153,7 @@ namespace RCF {
 
         int                                     mProtocol;
         ByteBuffer                              mByteBuffer;
+        std::vector<ByteBuffer>                 mRetainedByteBuffers;
         MemIstream                              mIs;
 
         Protocol< Int<1> >::In     mInProtocol1;
@@ -135,6 +164,10 @@ namespace RCF {
 
         int                                     mRuntimeVersion;
         int                                     mArchiveVersion;
+        bool                                    mEnableSfPointerTracking;
+        bool                                    mEnableSfSchemaFixed;
+        std::uint32_t                           mParallelSerializationThreshold;
+        SerializationProtocolIn *               mpParent;
     };
 
     class RCF_EXPORT SerializationProtocolOut
@@ -153,7 +186,8 @@ namespace RCF {
                     ByteBuffer byteBuffer,
                     int runtimeVersion,
                     int archiveVersion,
-                    bool enableSfPointerTracking);
+                    bool enableSfPointerTracking,
+                    bool enableSfSchemaFixed = false);
 
         template<typename T>
         void    write(const T &t)
@@ -183,10 +217,30 @@ namespace RCF {
         }
 
         void    insert(const ByteBuffer &byteBuffer);
+
+        // Makes room in the output buffer for a message body of approximately the given size.
+        void    reserve(std::size_t sizeHint);
+
+        // Inserts a buffer referring directly to application memory, if it is
+        // at least as large as the zero copy send threshold. The memory must
+        // remain valid until the message has been written.
+        bool    insertUserBuffer(const char * pch, std::size_t len);
+        bool    hasUserBuffers() const;
+
         void    extractByteBuffers();
         void    extractByteBuffers(std::vector<ByteBuffer> &byteBuffers);
 
         int     getRuntimeVersion();
+        bool    getEnableSfSchemaFixed() const;
+
+        void            setParallelSerializationThreshold(std::uint32_t thresholdBytes);
+        std::uint32_t   getParallelSerializationThreshold() const;
+
+        // Writes each segment as an independent archive, inserted into this message. Segments with a size hint of 
+        // at least the parallel serialization threshold are written concurrently.
+        void    writeSegments(
+                    const std::vector<SegmentWriter> &  writers, 
+                    const std::vector<std::size_t> &    sizeHints);
 
     private:
 
@@ -201,6 +255,7 @@ namespace RCF {
         std::size_t                                         mMargin;
         std::shared_ptr<MemOstream>                       mOsPtr;
         std::vector<std::pair<std::size_t, ByteBuffer> >    mByteBuffers;
+        bool                                                mHasUserBuffers;
 
         // these need to be below mOsPtr, for good order of destruction
         Protocol< Int<1> >::Out                mOutProtocol1;
@@ -211,6 +266,9 @@ namespace RCF {
 
         int                                                 mRuntimeVersion;
         int                                                 mArchiveVersion;
+        bool                                                mEnableSfPointerTracking;
+        bool                                                mEnableSfSchemaFixed;
+        std::uint32_t                                       mParallelSerializationThreshold;
     };
 
     inline void serialize(
@@ -0,0 +1,72 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_SERIALIZATIONTHREADPOOL_HPP
+#define INCLUDE_RCF_SERIALIZATIONTHREADPOOL_HPP
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <RCF/Export.hpp>
+#include <RCF/ThreadLibrary.hpp>
+#include <RCF/ThreadPool.hpp>
+
+namespace RCF {
+
+    /// Thread pool shared by parallel serialization and deserialization of remote call parameters. Threads are 
+    /// started on first use, and exit after being idle for 30 seconds.
+    class RCF_EXPORT SerializationThreadPool
+    {
+    public:
+        SerializationThreadPool();
+        ~SerializationThreadPool();
+
+        void stop();
+
+        /// Sets the maximum number of threads. Defaults to the number of hardware threads.
+        void setThreadMaxCount(std::size_t threadMaxCount);
+
+        /// Runs the tasks concurrently, and returns once all of them have completed. The calling thread runs tasks 
+        /// as well, so tasks complete even if all pool threads are busy. Tasks run with the caller's current 
+        /// RcfSession and ClientStub. If any task throws, the first exception is rethrown to the caller.
+        void runTasks(const std::vector< std::function<void()> > & tasks);
+
+    private:
+
+        class TaskBatch;
+        typedef std::shared_ptr<TaskBatch> TaskBatchPtr;
+
+        bool task();
+        void stopTask();
+
+        void runBatchTasks(TaskBatch & batch, bool onPoolThread);
+
+        RCF::Mutex                      mBatchesMutex;
+        RCF::Condition                  mBatchesCondition;
+        std::deque<TaskBatchPtr>        mBatches;
+
+        RCF::ThreadPool                 mThreadPool;
+    };
+
+    RCF_EXPORT SerializationThreadPool & getSerializationThreadPool();
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_SERIALIZATIONTHREADPOOL_HPP
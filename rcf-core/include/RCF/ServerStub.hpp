@@ -19,6 +19,7 @@
 #ifndef INCLUDE_RCF_SERVERSTUB_HPP
 #define INCLUDE_RCF_SERVERSTUB_HPP
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <vector>
@@ -353,6 +354,7 @@ namespace RCF {
         Mutex                           mMutex;
         ServerMethodPtr                 mServerMethodPtr;
         AccessControlCallback           mCbAccessControl;
+        std::atomic<bool>               mHasAccessControl = {false};
     };
 
     template<typename InterfaceT, typename ImplementationT, typename ImplementationPtrT>
@@ -0,0 +1,75 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_SUBSCRIPTIONFILTER_HPP
+#define INCLUDE_RCF_SUBSCRIPTIONFILTER_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <RCF/Export.hpp>
+
+namespace RCF {
+
+    /// Selects which published messages a subscription receives. The filter is sent to the publisher when the 
+    /// subscription is created, and evaluated by the publisher.
+    ///
+    /// Messages published with a routing key (Publisher::publishToKey()) are only sent to subscriptions whose filter
+    /// contains the key, and messages published with a tag (Publisher::publishToTag()) are only sent to subscriptions
+    /// whose filter contains the tag. Messages published without a routing key or tag are sent to all subscriptions.
+    /// A subscription with an empty filter receives all messages.
+    ///
+    /// A filter can hold at most MaxEntries key ranges, and at most MaxEntries tags. Subscriptions with larger 
+    /// filters are rejected.
+    class RCF_EXPORT SubscriptionFilter
+    {
+    public:
+
+        typedef std::pair<std::uint64_t, std::uint64_t> KeyRange;
+
+        static const std::size_t MaxEntries = 256;
+
+        /// Adds a single routing key to the filter.
+        void addKey(std::uint64_t key);
+
+        /// Adds the routing keys from firstKey to lastKey, inclusive, to the filter.
+        void addKeyRange(std::uint64_t firstKey, std::uint64_t lastKey);
+
+        /// Adds a tag to the filter.
+        void addTag(const std::string & tag);
+
+        /// Returns true if no keys or tags have been added to the filter.
+        bool isEmpty() const;
+
+        /// Gets the key ranges of the filter. Single keys are ranges with identical first and last keys.
+        const std::vector<KeyRange> &       getKeyRanges() const;
+
+        /// Gets the tags of the filter.
+        const std::vector<std::string> &    getTags() const;
+
+    private:
+
+        std::vector<KeyRange>               mKeyRanges;
+        std::vector<std::string>            mTags;
+    };
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_SUBSCRIPTIONFILTER_HPP
@@ -33,6 +33,7 @@
 #include <RCF/PeriodicTimer.hpp>
 #include <RCF/ServerStub.hpp>
 #include <RCF/Service.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 
 namespace RCF {
 
@@ -111,6 +112,12 @@ namespace RCF {
         /// Configures a callback to be called when an asynchronous subscription connection is established.
         void        setOnAsyncSubscribeCompleted(OnAsyncSubscribeCompleted onAsyncSubscribeCompleted);
 
+        /// Sets a filter, evaluated by the publisher, selecting which published messages the subscription receives. Requires a publisher of runtime version 20 or later.
+        void        setFilter(const SubscriptionFilter & filter);
+
+        /// Gets the filter of the subscription.
+        const SubscriptionFilter & getFilter() const;
+
     private:
 
         friend class SubscriptionService;
@@ -119,6 +126,7 @@ namespace RCF {
         ClientStub                              mClientStub;
         OnSubscriptionDisconnect                mOnDisconnect;
         OnAsyncSubscribeCompleted               mOnAsyncSubscribeCompleted;
+        SubscriptionFilter                      mFilter;
     };
 
     class RCF_EXPORT SubscriptionService :
@@ -220,7 +228,8 @@ namespace RCF {
             const std::string &             publisherName,
             std::uint32_t                   subToPubPingIntervalMs, 
             std::uint32_t &                 pubToSubPingIntervalMs,
-            bool &                          pingsEnabled);
+            bool &                          pingsEnabled,
+            const SubscriptionFilter &      filter);
 
         void doRequestSubscriptionAsync(
             ClientStub &                    clientStubOrig, 
@@ -234,7 +243,8 @@ namespace RCF {
             const std::string &             publisherName,
             RcfClientPtr                    rcfClientPtr,
             OnSubscriptionDisconnect        onDisconnect,
-            OnAsyncSubscribeCompleted       onCompletion);
+            OnAsyncSubscribeCompleted       onCompletion,
+            bool                            hasFilter);
 
         // Legacy subscription requests.
 
@@ -86,6 +86,28 @@ namespace RCF {
     // 2017-09-04   - version number 13
     //      - Serialization of fs::path changed to use wstring instead of string.
     //      - Serialization of RemoteException changed.
+
+    // 2026-10-18   - version number 14
+    //      - SF: 64 bit element counts for arrays, vectors and byte buffers with more than 2^32 - 2 elements.
+
+    // 2026-10-18   - version number 15
+    //      - SF: polymorphic types registered with a type id are identified by type id rather than type name.
+
+    // 2026-10-18   - version number 16
+    //      - SF: node headers, counts and lengths are LEB128 varints, and single integers are zigzag varints.
+
+    // 2026-10-18   - version number 17
+    //      - Request header carries a flag for schema-fixed SF parameter serialization.
+
+    // 2026-10-18   - version number 18
+    //      - Request header carries the parallel serialization threshold. Parameters of such requests and their 
+    //        responses are serialized as separate segments.
+
+    // 2026-10-18   - version number 19
+    //      - FileChunk serialization includes the basis offset and length used by delta uploads.
+
+    // 2026-10-18   - version number 20
+    //      - Subscription requests carry a subscription filter.
  
 
     /// Gets the maximum RCF runtime version number this RCF build supports.
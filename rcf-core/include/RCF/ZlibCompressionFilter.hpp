@@ -22,6 +22,7 @@
 #include <memory>
 #include <vector>
 
+#include <RCF/CompressionFilter.hpp>
 #include <RCF/Filter.hpp>
 #include <RCF/Export.hpp>
 #include <RCF/Tools.hpp>
@@ -32,21 +33,51 @@ namespace RCF {
 
     class ZlibCompressionReadFilter;
     class ZlibCompressionWriteFilter;
+    class ZlibCodecStreams;
     class ZlibDll;
 
     std::string zlibError(int zErr);
 
+    /// Base class of the zlib compression filters. 
+    ///
+    /// Compression is adaptive. Messages below a minimum size, and messages that look incompressible, are written as 
+    /// zlib stored blocks rather than being deflated. Stored blocks are part of the zlib format, so the receiving 
+    /// side decompresses them as usual, and needs no configuration.
     class RCF_EXPORT ZlibCompressionFilterBase : 
         public Filter, 
         Noncopyable
     {
     public:
         ZlibCompressionFilterBase(bool stateful, bool serverSide);
+
+        /// Sets the zlib compression level, from 1 (fastest) to 9 (best compression). The default of -1 selects 
+        /// zlib's default level.
+        void setCompressionLevel(int compressionLevel);
+
+        /// Gets the zlib compression level.
+        int getCompressionLevel() const;
+
+        /// Sets the size below which messages are sent uncompressed. The default is zero.
+        void setMinCompressionSize(std::size_t minCompressionSize);
+
+        /// Gets the size below which messages are sent uncompressed.
+        std::size_t getMinCompressionSize() const;
+
+        /// Sets whether messages are sampled before being compressed, and sent uncompressed if their byte entropy 
+        /// shows them to be already compressed, encrypted or random. The default is true.
+        void setSkipIncompressible(bool skipIncompressible);
+
+        /// Gets whether incompressible messages are sent uncompressed.
+        bool getSkipIncompressible() const;
        
     private:
 
         ZlibDll & mZlibDll;
 
+        int         mCompressionLevel;
+        std::size_t mMinCompressionSize;
+        bool        mSkipIncompressible;
+
         void resetState();
 
         void read(const ByteBuffer &byteBuffer, std::size_t bytesRequested);
@@ -105,22 +136,79 @@ namespace RCF {
         public FilterFactory
     {
     public:
-        ZlibStatelessCompressionFilterFactory();
+
+        /// Server-side filters are created with the given compression level and minimum compression size. See
+        /// ZlibCompressionFilterBase.
+        ZlibStatelessCompressionFilterFactory(
+            int             compressionLevel = -1, 
+            std::size_t     minCompressionSize = 0);
 
         FilterPtr createFilter(RcfServer & server);
         int getFilterId();
+
+    private:
+        int             mCompressionLevel;
+        std::size_t     mMinCompressionSize;
     };
 
     class RCF_EXPORT ZlibStatefulCompressionFilterFactory :
         public FilterFactory
     {
     public:
-        ZlibStatefulCompressionFilterFactory();
+
+        /// Server-side filters are created with the given compression level and minimum compression size. See
+        /// ZlibCompressionFilterBase.
+        ZlibStatefulCompressionFilterFactory(
+            int             compressionLevel = -1, 
+            std::size_t     minCompressionSize = 0);
 
         FilterPtr createFilter(RcfServer & server);
         int getFilterId();
+
+    private:
+        int             mCompressionLevel;
+        std::size_t     mMinCompressionSize;
     };
 
+    /// zlib codec for CompressionFilter.
+    ///
+    /// Each frame is compressed as a separate zlib stream. In stateful mode, the history is passed to zlib as a
+    /// preset dictionary. This is not wire compatible with ZlibStatefulCompressionFilter and 
+    /// ZlibStatelessCompressionFilter, which compress the connection as a single stream.
+    class RCF_EXPORT ZlibCompressionCodec : public CompressionCodec
+    {
+    public:
+
+        /// Creates a codec using the given zlib compression level. The default of -1 selects zlib's default level.
+        ZlibCompressionCodec(int compressionLevel = -1);
+
+        int getFilterId(bool stateful) const;
+
+        std::size_t getMaxCompressedLength(std::size_t srcLength);
+
+        std::size_t compress(
+            const char *    pSrc,
+            std::size_t     srcLength,
+            std::size_t     historyLength,
+            char *          pDest,
+            std::size_t     destLength);
+
+        void decompress(
+            const char *    pSrc,
+            std::size_t     srcLength,
+            char *          pDest,
+            std::size_t     destLength,
+            std::size_t     historyLength);
+
+    private:
+        ZlibDll &                           mZlibDll;
+        int                                 mCompressionLevel;
+        std::shared_ptr<ZlibCodecStreams>   mStreamsPtr;
+    };
+
+    /// Creates a ZlibCompressionCodec with zlib's default compression level.
+    RCF_EXPORT CompressionCodecPtr createZlibCompressionCodec();
+
     typedef ZlibStatefulCompressionFilter               ZlibCompressionFilter;
     typedef std::shared_ptr<ZlibCompressionFilter>    ZlibCompressionFilterPtr;
 
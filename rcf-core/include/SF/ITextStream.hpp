@@ -31,13 +31,19 @@ namespace SF {
     {
     public:
         ITextStream() : IStream()
-        {}
+        {
+            setTextFormat();
+        }
 
         ITextStream(RCF::MemIstream &is) : IStream(is)
-        {}
+        {
+            setTextFormat();
+        }
 
         ITextStream(std::istream &is) : IStream(is)
-        {}
+        {
+            setTextFormat();
+        }
 
         I_Encoding &getEncoding()
         {
@@ -27,13 +27,19 @@ namespace SF {
     {
     public:
         OTextStream() : OStream()
-        {}
+        {
+            setTextFormat();
+        }
 
         OTextStream(RCF::MemOstream &os) : OStream(os)
-        {}
+        {
+            setTextFormat();
+        }
 
         OTextStream(std::ostream &os) : OStream(os)
-        {}
+        {
+            setTextFormat();
+        }
 
         I_Encoding &getEncoding()
         {
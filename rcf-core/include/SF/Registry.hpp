@@ -21,9 +21,11 @@
 #ifndef INCLUDE_SF_REGISTRY_HPP
 #define INCLUDE_SF_REGISTRY_HPP
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <typeinfo>
+#include <vector>
 
 #include <memory>
 
@@ -32,6 +34,8 @@
 
 #include <RCF/Tools.hpp>
 
+#include <SF/PortableTypes.hpp>
+
 namespace SF {
 
     typedef RCF::ReadWriteMutex    ReadWriteMutex;
@@ -41,6 +45,28 @@ namespace SF {
     class I_SerializerPolymorphic;
     class I_SerializerAny;
 
+    /// Type ids must be non-zero and less than MaxTypeId.
+    static const UInt32 MaxTypeId = 1024;
+
+    // Lookup table entry for a type registered with a type id. Entries are never modified after being published,
+    // except to append base types, so they can be read without locking.
+    class TypeIdEntry : Noncopyable
+    {
+    public:
+        TypeIdEntry() : mpTypeInfo(), mTypeId(), mBaseCount(0), mBases(), mSerializers()
+        {
+        }
+
+        static const std::size_t MaxBases = 16;
+
+        const std::type_info *                      mpTypeInfo;
+        UInt32                                      mTypeId;
+        std::string                                 mTypeName;
+        std::atomic<std::size_t>                    mBaseCount;
+        const std::type_info *                      mBases[MaxBases];
+        I_SerializerPolymorphic *                   mSerializers[MaxBases];
+    };
+
     class RCF_EXPORT Registry : Noncopyable
     {
     private:
@@ -66,10 +92,35 @@ namespace SF {
         RttiToSerializerAny                         mRttiToSerializerAny;
         ReadWriteMutex                              mReadWriteMutex;
 
+        // Types registered with a type id. Lookups by type id, or by type_info address, don't lock the registry.
+        static const std::size_t                    TypeInfoSlots = 2*MaxTypeId;
+
+        std::map<Rtti, const std::type_info *>      mRttiToBaseTypeInfo;
+        std::vector<TypeIdEntry *>                  mTypeIdEntries;
+        std::atomic<TypeIdEntry *>                  mTypeIdToEntry[MaxTypeId];
+        std::atomic<TypeIdEntry *>                  mTypeInfoToEntry[TypeInfoSlots];
+
+        void                                        addTypeIdEntry(
+                                                        const std::type_info &  ti, 
+                                                        const std::string &     typeName, 
+                                                        UInt32                  typeId);
+
+        void                                        addTypeIdBase(
+                                                        const std::type_info &  derivedTi, 
+                                                        const std::type_info &  baseTi, 
+                                                        I_SerializerPolymorphic * pSerializer);
+
+        I_SerializerPolymorphic *                   getSerializerPolymorphic(
+                                                        const std::type_info &  baseTi, 
+                                                        UInt32                  derivedTypeId, 
+                                                        std::string &           derivedTypeName);
+
     public:
 
         friend void initRegistrySingleton();
 
+        ~Registry();
+
         static Registry &getSingleton();
 
         static Registry *getSingletonPtr();
@@ -80,6 +131,9 @@ namespace SF {
         template<typename Type>
         void registerType(Type *, const std::string &typeName);
 
+        template<typename Type>
+        void registerType(Type *, const std::string &typeName, UInt32 typeId);
+
         template<typename Base, typename Derived>
         void registerBaseAndDerived(Base *, Derived *);
 
@@ -88,6 +142,11 @@ namespace SF {
             Base *, 
             const std::string &derivedTypeName);
 
+        template<typename Base>
+        I_SerializerPolymorphic &getSerializerPolymorphic(
+            Base *, 
+            UInt32 derivedTypeId);
+
         template<typename T>
         std::string getTypeName()
         {
@@ -133,6 +192,9 @@ namespace SF {
 
         std::string getTypeName(const std::type_info &ti);
 
+        /// Returns the type id the given type was registered with, or zero if it was not registered with a type id.
+        UInt32 getTypeId(const std::type_info &ti);
+
         void clear();
 
     };
@@ -174,6 +236,16 @@ namespace SF {
         Registry::getSingleton().registerType( (T *) 0, typeName);
     }
 
+    /// Register a type T with SF runtime, with a type id as well as a type name. When serializing 
+    /// polymorphic objects of type T, typeId is written to the archive instead of typeName. The type 
+    /// must be registered with the same type id on both sides of a connection. typeId must be non-zero
+    /// and less than SF::MaxTypeId.
+    template<typename T>
+    void registerType(const std::string &typeName, UInt32 typeId)
+    {
+        Registry::getSingleton().registerType( (T *) 0, typeName, typeId);
+    }
+
     /// Register a base/derived relationship with the SF runtime. Allows SF to locate the correct
     /// serialization function for objects of type Derived, when Derived objects are serialized 
     /// through a Base pointer.
@@ -222,6 +294,17 @@ namespace SF {
         //}
     }
 
+    template<typename Type>
+    void Registry::registerType(Type *, const std::string &typeName, UInt32 typeId)
+    {
+        WriteLock lock(mReadWriteMutex); 
+        RCF_UNUSED_VARIABLE(lock);
+        addTypeIdEntry(typeid(Type), typeName, typeId);
+        Rtti typeRtti = typeid(Type).name();
+        mRttiToTypename[typeRtti] = typeName;
+        mTypenameToRtti[typeName] = typeRtti;
+    }
+
     template<typename Base, typename Derived>
     void Registry::registerBaseAndDerived(Base *, Derived *)
     {
@@ -231,8 +314,15 @@ namespace SF {
         Rtti derivedRtti = typeid(Derived).name();
         std::pair<Rtti, Rtti> baseDerivedRtti(baseRtti, derivedRtti);
 
-        mRttiToSerializerPolymorphic[baseDerivedRtti].reset(
-            new SerializerPolymorphic<Base,Derived>);
+        // Serializers are referenced by the type id tables, so they are not replaced once registered.
+        std::shared_ptr<I_SerializerPolymorphic> & serializerPtr = mRttiToSerializerPolymorphic[baseDerivedRtti];
+        if (!serializerPtr)
+        {
+            serializerPtr.reset( new SerializerPolymorphic<Base,Derived>() );
+        }
+
+        mRttiToBaseTypeInfo[baseRtti] = &typeid(Base);
+        addTypeIdBase(typeid(Derived), typeid(Base), serializerPtr.get());
     }
 
     template<typename Base>
@@ -258,6 +348,20 @@ namespace SF {
         return *mRttiToSerializerPolymorphic[ baseDerivedRtti ];
     }
 
+    template<typename Base>
+    I_SerializerPolymorphic &Registry::getSerializerPolymorphic(
+        Base *, 
+        UInt32 derivedTypeId)
+    {
+        std::string derivedTypeName;
+        I_SerializerPolymorphic * pSerializer = getSerializerPolymorphic(typeid(Base), derivedTypeId, derivedTypeName);
+        if (pSerializer)
+        {
+            return *pSerializer;
+        }
+        return getSerializerPolymorphic( (Base *) 0, derivedTypeName);
+    }
+
 } // namespace SF
 
 #endif // ! INCLUDE_SF_REGISTRY_HPP
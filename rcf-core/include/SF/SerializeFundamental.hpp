@@ -19,6 +19,10 @@
 #ifndef INCLUDE_SF_SERIALIZEFUNDAMENTAL_HPP
 #define INCLUDE_SF_SERIALIZEFUNDAMENTAL_HPP
 
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
 #include <SF/Archive.hpp>
 #include <SF/DataPtr.hpp>
 #include <SF/I_Stream.hpp>
@@ -27,6 +31,84 @@
 
 namespace SF {
 
+    // From runtime version 16, binary streams write single integers wider than a byte as LEB128 varints, with signed 
+    // integers zigzag encoded, so that small values of either sign take up a single byte. Text streams keep writing 
+    // integers as text.
+
+    template<typename U>
+    struct IsPackedInteger : public std::integral_constant<bool, (
+            std::is_integral<U>::value 
+        &&  sizeof(U) > 1 
+        &&  !std::is_same<U, bool>::value 
+        &&  !std::is_same<U, wchar_t>::value)>
+    {
+    };
+
+    inline std::uint64_t zigzagEncode(std::int64_t n)
+    {
+        return (static_cast<std::uint64_t>(n) << 1) ^ static_cast<std::uint64_t>(n >> 63);
+    }
+
+    inline std::int64_t zigzagDecode(std::uint64_t n)
+    {
+        return static_cast<std::int64_t>(n >> 1) ^ -static_cast<std::int64_t>(n & 1);
+    }
+
+    template<typename U>
+    inline bool serializePackedInteger(SF::Archive &, U &, RCF::FalseType *)
+    {
+        return false;
+    }
+
+    template<typename U>
+    inline bool serializePackedInteger(SF::Archive &ar, U &u, RCF::TrueType *)
+    {
+        bool usePackedIntegers = ar.isRead() ? 
+            ar.getIstream()->getUsePackedIntegers() : 
+            ar.getOstream()->getUsePackedIntegers();
+
+        if (!usePackedIntegers)
+        {
+            return false;
+        }
+
+        if (ar.isRead())
+        {
+            std::uint64_t n = 0;
+            ar.getIstream()->getPackedInt(n);
+
+            bool inRange = false;
+            if (std::is_signed<U>::value)
+            {
+                std::int64_t value = zigzagDecode(n);
+                inRange = 
+                        value >= static_cast<std::int64_t>((std::numeric_limits<U>::min)()) 
+                    &&  value <= static_cast<std::int64_t>((std::numeric_limits<U>::max)());
+                u = static_cast<U>(value);
+            }
+            else
+            {
+                inRange = n <= static_cast<std::uint64_t>((std::numeric_limits<U>::max)());
+                u = static_cast<U>(n);
+            }
+
+            if (!inRange)
+            {
+                RCF::Exception e(RCF::RcfError_SfDataFormat);
+                RCF_THROW(e);
+            }
+        }
+        else if (ar.isWrite())
+        {
+            std::uint64_t n = std::is_signed<U>::value ? 
+                zigzagEncode(static_cast<std::int64_t>(u)) : 
+                static_cast<std::uint64_t>(u);
+
+            ar.getOstream()->putPackedInt(n);
+        }
+        return true;
+    }
+
     // serialize fundamental types
 
     template<typename T>
@@ -39,6 +121,11 @@ namespace SF {
         static_assert( RCF::IsFundamental<U>::value, "" );
         U * pt = const_cast<U *>(&t);
 
+        if (count == 1 && serializePackedInteger(ar, *pt, (typename IsPackedInteger<U>::type *) NULL))
+        {
+            return;
+        }
+
         if (ar.isRead())
         {
             I_Encoding &encoding = ar.getIstream()->getEncoding();
@@ -41,13 +41,17 @@ namespace SF {
     private:
         void                invokeRead(Archive &ar);
         void                invokeWrite(Archive &ar);
+        bool                isSchemaFixedValue(Archive &ar);
 
         // Following are overridden to provide type-specific operations.
         virtual std::string getTypeName() = 0;
+        virtual UInt32      getTypeId() = 0;
         virtual void        newObject(Archive &ar) = 0;
         virtual bool        isDerived() = 0;
         virtual std::string getDerivedTypeName() = 0;
+        virtual UInt32      getDerivedTypeId() = 0;
         virtual void        getSerializerPolymorphic(const std::string &derivedTypeName) = 0;
+        virtual void        getSerializerPolymorphic(UInt32 derivedTypeId) = 0;
         virtual void        invokeSerializerPolymorphic(SF::Archive &) = 0;
         virtual void        serializeContents(Archive &ar) = 0;
         virtual void        addToInputContext(IStream *, const UInt32 &) = 0;
@@ -90,10 +94,13 @@ namespace SF {
         IdT                         id;
 
         std::string         getTypeName();
+        UInt32              getTypeId();
         void                newObject(Archive &ar);
         bool                isDerived();
         std::string         getDerivedTypeName();
+        UInt32              getDerivedTypeId();
         void                getSerializerPolymorphic(const std::string &derivedTypeName);
+        void                getSerializerPolymorphic(UInt32 derivedTypeId);
         void                invokeSerializerPolymorphic(SF::Archive &ar);
         void                serializeContents(Archive &ar);
         void                addToInputContext(SF::IStream *stream, const UInt32 &nid);
@@ -386,6 +393,12 @@ namespace SF {
         return SF::Registry::getSingleton().getTypeName( (T *) 0);
     }
 
+    template<typename T>
+    UInt32 Serializer<T>::getTypeId()
+    {
+        return SF::Registry::getSingleton().getTypeId( typeid(T) );
+    }
+
 #ifdef _MSC_VER
 #pragma warning( push )
 #pragma warning( disable: 4702 )
@@ -409,7 +422,8 @@ namespace SF {
         {
             if ( *ppt && typeid(T) != typeid(**ppt) )
             {
-                if ( !SF::Registry::getSingleton().isTypeRegistered(typeid(**ppt)) )
+                SF::Registry & registry = SF::Registry::getSingleton();
+                if ( !registry.getTypeId(typeid(**ppt)) && !registry.isTypeRegistered(typeid(**ppt)) )
                 {
                     RCF::Exception e(RCF::RcfError_SfTypeRegistration, typeid(**ppt).name());
                     RCF_THROW(e);
@@ -426,6 +440,12 @@ namespace SF {
         return SF::Registry::getSingleton().getTypeName( typeid(**ppt) );
     }
 
+    template<typename T>
+    UInt32 Serializer<T>::getDerivedTypeId()
+    {
+        return SF::Registry::getSingleton().getTypeId( typeid(**ppt) );
+    }
+
     template<typename T>
     void Serializer<T>::getSerializerPolymorphic(
         const std::string &derivedTypeName)
@@ -435,6 +455,15 @@ namespace SF {
             derivedTypeName);
     }
 
+    template<typename T>
+    void Serializer<T>::getSerializerPolymorphic(
+        UInt32 derivedTypeId)
+    {
+        pf = & SF::Registry::getSingleton().getSerializerPolymorphic( 
+            (T *) 0, 
+            derivedTypeId);
+    }
+
     template<typename T>
     void Serializer<T>::invokeSerializerPolymorphic(SF::Archive &ar)
     {
@@ -19,7 +19,9 @@
 #ifndef INCLUDE_SF_STREAM_HPP
 #define INCLUDE_SF_STREAM_HPP
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 
 #include <RCF/Export.hpp>
@@ -77,6 +79,12 @@ namespace SF {
     //**************************************************
     // Context handling
 
+    class ContextReadTables;
+    class ContextWriteTables;
+
+    // The pointer tracking tables are flat hash tables, acquired from the RCF object pool the first time an object is
+    // tracked, and returned to the pool when the context is cleared.
+
     class RCF_EXPORT ContextRead
     {
     public:
@@ -92,9 +100,8 @@ namespace SF {
         bool getEnabled() const;
 
     private:
-        bool mEnabled;
-        std::unique_ptr<std::map<UInt32, ObjectId> >                          mNidToIdMap;
-        std::unique_ptr<std::map<std::string, std::map< void *, void * > > >  mTypeToObjMap;
+        bool                                            mEnabled;
+        std::shared_ptr<ContextReadTables>              mTablesPtr;
     };
 
     class RCF_EXPORT ContextWrite
@@ -110,7 +117,7 @@ namespace SF {
     private:
         bool                                            mEnabled;
         UInt32                                          mCurrentId;
-        std::unique_ptr<std::map<ObjectId, UInt32> >      mIdToNidMap;
+        std::shared_ptr<ContextWriteTables>             mTablesPtr;
     };
 
     //**************************************************
@@ -170,8 +177,10 @@ namespace SF {
 
         bool        begin(Node &node);
         bool        get(DataPtr &value);
+        void        getPackedInt(std::uint64_t &n);
         void        end();
         UInt32      read_int(UInt32 &n);
+        UInt32      read_varint(std::uint64_t &n);
         UInt32      read_byte(Byte8 &byte);
         void        putback_byte(Byte8 byte);
 
@@ -208,6 +217,15 @@ namespace SF {
         void            setEnablePointerTracking(bool enable);
         bool            getEnablePointerTracking() const;
 
+        /// Enables schema-fixed mode, in which values that cannot be polymorphic are read without node headers.
+        /// The stream must have been written in the same mode, from the same type definitions.
+        void            setEnableSchemaFixed(bool enable);
+        bool            getEnableSchemaFixed() const;
+
+        /// Returns true if integers are read as varints. Binary streams use varints from runtime version 16, text 
+        /// streams keep the fixed width format at all runtime versions.
+        bool            getUsePackedIntegers() const;
+
         // Streaming operators.
 
         /// Deserialize an object from the stream.
@@ -218,6 +236,11 @@ namespace SF {
         template<typename T>
         IStream & operator>>(const T &t);
 
+    protected:
+
+        // Called by text streams.
+        void            setTextFormat();
+
     private:
 
         ContextRead         mContextRead;
@@ -228,6 +251,8 @@ namespace SF {
         int                 mRuntimeVersion;
         int                 mArchiveVersion;
         bool                mIgnoreVersionStamp;
+        bool                mSchemaFixed;
+        bool                mTextFormat;
 
         RCF::SerializationProtocolIn * mpSerializationProtocolIn;
     };
@@ -260,10 +285,16 @@ namespace SF {
 
         UInt32      writeRaw(const Byte8 *pBytes, UInt32 nLength);
 
+        /// Reserves nLength bytes in the output, to be filled in directly by the caller. Returns NULL if the 
+        /// underlying stream is not a MemOstream, in which case writeRaw() must be used instead.
+        Byte8 *     reserveRaw(UInt32 nLength);
+
         void        begin(const Node &node);
         void        put(const DataPtr &value);
+        void        putPackedInt(std::uint64_t n);
         void        end();
         UInt32      write_int(UInt32 n);
+        UInt32      write_varint(std::uint64_t n);
         UInt32      write_byte(Byte8 byte);
         UInt32      write(const Byte8 *pBytes, UInt32 nLength);
 
@@ -298,12 +329,26 @@ namespace SF {
         void            setEnablePointerTracking(bool enable);
         bool            getEnablePointerTracking() const;
 
+        /// Enables schema-fixed mode, in which values that cannot be polymorphic are written without node headers.
+        /// The stream can only be read in the same mode, from the same type definitions.
+        void            setEnableSchemaFixed(bool enable);
+        bool            getEnableSchemaFixed() const;
+
+        /// Returns true if integers are written as varints. Binary streams use varints from runtime version 16, text 
+        /// streams keep the fixed width format at all runtime versions.
+        bool            getUsePackedIntegers() const;
+
         // Streaming operator.
 
         /// Serialize an object to the stream.
         template<typename T>
         OStream & operator<<(const T &t);
 
+    protected:
+
+        // Called by text streams.
+        void            setTextFormat();
+
     private:
 
         void            writeArchiveMetadata();
@@ -312,10 +357,13 @@ namespace SF {
         LocalStorage    mLocalStorage;
 
         std::ostream *  mpOs;
+        RCF::MemOstream * mpMemOs;
         int             mRuntimeVersion;
         int             mArchiveVersion;
         bool            mSuppressArchiveMetadata;
         bool            mArchiveMetadataWritten;
+        bool            mSchemaFixed;
+        bool            mTextFormat;
 
         RCF::SerializationProtocolOut * mpSerializationProtocolOut;
     };
@@ -0,0 +1,70 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_SPAN_HPP
+#define INCLUDE_SF_SPAN_HPP
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include <SF/vector.hpp>
+
+namespace SF {
+
+    // std::span
+
+    // A span of fundamental types is serialized in the same format as a std::vector<> of the same type, so it can be
+    // sent from a client and received by a server as a std::vector<> or RCF::ArrayBuffer<>. 
+    // 
+    // A std::span<const T> server parameter is deserialized in place, and refers directly into the received request.
+    // It remains valid until the remote call completes. Deserializing into a span of non-const elements requires the 
+    // span to already have the correct size.
+    template<typename T, std::size_t Extent>
+    inline void serialize(
+        SF::Archive &           ar,
+        std::span<T, Extent> &  s)
+    {
+        typedef typename std::remove_cv<T>::type U;
+        static_assert( std::is_fundamental<U>::value && !std::is_same<U, bool>::value, "std::span<> serialization requires a fundamental, non-bool element type." );
+
+        if (std::is_const<T>::value && ar.isRead())
+        {
+            std::uint64_t count = readArrayCount(ar);
+            if (Extent != std::dynamic_extent && count != Extent)
+            {
+                RCF::Exception e(RCF::RcfError_ArraySizeMismatch, Extent, count);
+                RCF_THROW(e);
+            }
+
+            const char * pch = readArrayInPlace(ar, count, sizeof(U), alignof(U));
+            s = std::span<T, Extent>( reinterpret_cast<T *>(pch), static_cast<std::size_t>(count) );
+            return;
+        }
+
+        serializeSpanImpl(
+            ar,
+            const_cast<char *>(reinterpret_cast<const char *>(s.data())),
+            s.size(),
+            sizeof(U),
+            std::is_const<T>::value);
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_SPAN_HPP
@@ -0,0 +1,58 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_STRING_VIEW_HPP
+#define INCLUDE_SF_STRING_VIEW_HPP
+
+#include <cstdint>
+#include <string_view>
+
+#include <SF/Archive.hpp>
+#include <SF/Stream.hpp>
+#include <SF/vector.hpp>
+
+namespace SF {
+
+    // std::string_view
+
+    // A string_view is serialized in the same format as a std::string, so it can be sent from a client and received 
+    // by a server as a std::string. A std::string_view server parameter is deserialized in place, and refers directly
+    // into the received request. It remains valid until the remote call completes.
+    template<typename Traits>
+    inline void serialize(
+        SF::Archive &                           ar,
+        std::basic_string_view<char, Traits> &  s)
+    {
+        if (ar.isRead())
+        {
+            std::uint32_t count = 0;
+            ar & count;
+            const char * pch = readArrayInPlace(ar, count, 1, 1);
+            s = std::basic_string_view<char, Traits>(pch, count);
+        }
+        else if (ar.isWrite())
+        {
+            std::uint32_t count = static_cast<std::uint32_t>(s.length());
+            ar & count;
+            writeRawOrInsert(ar, s.data(), count);
+        }
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_STRING_VIEW_HPP
@@ -19,6 +19,7 @@
 #ifndef INCLUDE_SF_VECTOR_HPP
 #define INCLUDE_SF_VECTOR_HPP
 
+#include <cstdint>
 #include <type_traits>
 #include <vector>
 
@@ -27,10 +28,52 @@
 
 namespace SF {
 
+    // SF_SERIALIZE_AS_POD
+
+    // Describes a type declared with SF_SERIALIZE_AS_POD(). The type name is only used in error messages, and is 
+    // not part of the layout checksum.
+    struct PodLayoutInfo
+    {
+        const char *    mTypeName;
+        std::uint32_t   mLayoutVersion;
+    };
+
+    // Fallback for types that have not been declared with SF_SERIALIZE_AS_POD().
+    inline void sfPodLayoutInfo(...)
+    {
+    }
+
+    template<typename T>
+    class IsSerializedAsPod
+    {
+    public:
+        typedef decltype( sfPodLayoutInfo((T *) 0) ) InfoType;
+        static const bool value = std::is_same<InfoType, PodLayoutInfo>::value;
+        typedef typename std::integral_constant<bool, value>::type type;
+    };
+
+/// Instructs RCF to serialize std::vector<Type> as a single block of memory, rather than element by element. Type 
+/// must be trivially copyable, and must have the same memory layout on both ends of the connection. A checksum of the 
+/// size, alignment and byte order of Type is sent along with the data, and is verified when deserializing. Must be 
+/// used in the same namespace as Type.
+#define SF_SERIALIZE_AS_POD(Type)                                                               \
+    SF_SERIALIZE_AS_POD_VERSIONED(Type, 0)
+
+/// As SF_SERIALIZE_AS_POD(), with a layout version that is included in the checksum. Change the version whenever the 
+/// members of Type change in a way that leaves its size and alignment unchanged.
+#define SF_SERIALIZE_AS_POD_VERSIONED(Type, Version)                                            \
+    inline SF::PodLayoutInfo sfPodLayoutInfo(Type *)                                            \
+    {                                                                                           \
+        static_assert(                                                                          \
+            std::is_trivially_copyable<Type>::value,                                            \
+            "SF_SERIALIZE_AS_POD() can only be used with trivially copyable types.");           \
+        return SF::PodLayoutInfo{ #Type, static_cast<std::uint32_t>(Version) };                 \
+    }
+
     // std::vector
 
     template<typename T, typename A>
-    inline void serializeVector(
+    inline void serializeVectorPod(
         SF::Archive &           ar,
         std::vector<T,A> &      vec,
         RCF::FalseType *)
@@ -38,6 +81,25 @@ namespace SF {
         serializeStlContainer<PushBackSemantics, ReserveSemantics>(ar, vec);
     }
 
+    template<typename T, typename A>
+    inline void serializeVectorPod(
+        SF::Archive &           ar,
+        std::vector<T,A> &      vec,
+        RCF::TrueType *)
+    {
+        serializeVectorPodFast(ar, vec);
+    }
+
+    template<typename T, typename A>
+    inline void serializeVector(
+        SF::Archive &           ar,
+        std::vector<T,A> &      vec,
+        RCF::FalseType *)
+    {
+        typedef typename IsSerializedAsPod<T>::type type;
+        serializeVectorPod(ar, vec, (type *) 0);
+    }
+
     template<typename T, typename A>
     inline void serializeVector(
         SF::Archive &           ar,
@@ -72,7 +134,7 @@ namespace SF {
         virtual ~I_VecWrapper() {}
 
         virtual void            resize(std::size_t newSize) = 0;
-        virtual std::uint32_t size() = 0;
+        virtual std::size_t     size() = 0;
         virtual char *          addressOfElement(std::size_t idx) = 0;
         virtual std::uint32_t sizeofElement() = 0;
     };
@@ -90,9 +152,9 @@ namespace SF {
             mVec.resize(newSize);
         }
 
-        std::uint32_t size()
+        std::size_t size()
         {
-            return static_cast<std::uint32_t>(mVec.size());
+            return mVec.size();
         }
 
         char * addressOfElement(std::size_t idx)
@@ -114,6 +176,62 @@ namespace SF {
         SF::Archive &           ar,
         I_VecWrapper &          vec);
 
+    // Element counts of arrays. Counts that don't fit in 32 bits require runtime version 14 or later.
+    RCF_EXPORT void writeArrayCount(
+        SF::Archive &           ar,
+        std::uint64_t           count);
+
+    RCF_EXPORT std::uint64_t readArrayCount(
+        SF::Archive &           ar);
+
+    // Raw array contents, of any length.
+    RCF_EXPORT void writeArrayBytes(
+        SF::Archive &           ar,
+        const char *            pch,
+        std::uint64_t           bytesToWrite);
+
+    RCF_EXPORT void readArrayBytes(
+        SF::Archive &           ar,
+        char *                  pch,
+        std::uint64_t           bytesToRead);
+
+    RCF_EXPORT void writeRawOrInsert(
+        SF::Archive &           ar,
+        const char *            pch,
+        std::uint64_t           bytesToWrite);
+
+    RCF_EXPORT void serializeVectorPodImpl(
+        SF::Archive &           ar,
+        I_VecWrapper &          vec,
+        const PodLayoutInfo &   layoutInfo,
+        std::size_t             alignofElement);
+
+    template<typename T, typename A>
+    inline void serializeVectorPodFast(
+        SF::Archive &           ar,
+        std::vector<T,A> &      vec)
+    {
+        VecWrapper< std::vector<T,A> > vecWrapper(vec);
+        serializeVectorPodImpl(ar, vecWrapper, sfPodLayoutInfo((T *) 0), alignof(T));
+    }
+
+    // Reads the contents of an array of count elements in place, from the request being dispatched by the current
+    // RcfSession. The returned pointer refers into the received message, unless the elements need to be realigned
+    // or byte reordered, and remains valid until the remote call completes.
+    RCF_EXPORT const char * readArrayInPlace(
+        SF::Archive &           ar,
+        std::uint64_t           count,
+        std::size_t             sizeofElement,
+        std::size_t             alignofElement);
+
+    // Shared implementation for std::span<> (see SF/span.hpp).
+    RCF_EXPORT void serializeSpanImpl(
+        SF::Archive &           ar,
+        char *                  pch,
+        std::size_t             count,
+        std::size_t             sizeofElement,
+        bool                    readOnly);
+
     template<typename T, typename A>
     inline void serializeVectorFast(
         SF::Archive &           ar,
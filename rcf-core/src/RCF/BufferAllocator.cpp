@@ -0,0 +1,406 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#include <RCF/BufferAllocator.hpp>
+
+#include <RCF/Tools.hpp>
+
+#if RCF_FEATURE_CUSTOM_ALLOCATOR==1
+#include <RCF/CustomAllocator.hpp>
+#endif
+
+#ifndef RCF_WINDOWS
+#include <sys/mman.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace RCF {
+
+    //--------------------------------------------------------------------------
+    // HeapBufferAllocator
+
+#if RCF_FEATURE_CUSTOM_ALLOCATOR==1
+
+    char * HeapBufferAllocator::allocate(std::size_t size, std::size_t & capacity)
+    {
+        capacity = size;
+        return (char *) RCF_new(size);
+    }
+
+    char * HeapBufferAllocator::reallocate(
+        char *          pch,
+        std::size_t     capacity,
+        std::size_t     newSize,
+        std::size_t &   newCapacity)
+    {
+        char * pchNew = (char *) RCF_new(newSize);
+        memcpy(pchNew, pch, RCF_MIN(capacity, newSize));
+        RCF_delete(pch);
+        newCapacity = newSize;
+        return pchNew;
+    }
+
+    void HeapBufferAllocator::deallocate(char * pch, std::size_t capacity)
+    {
+        RCF_UNUSED_VARIABLE(capacity);
+        RCF_delete(pch);
+    }
+
+#else
+
+    char * HeapBufferAllocator::allocate(std::size_t size, std::size_t & capacity)
+    {
+        char * pch = (char *) malloc(size);
+        if (!pch)
+        {
+            throw std::bad_alloc();
+        }
+        capacity = size;
+        return pch;
+    }
+
+    char * HeapBufferAllocator::reallocate(
+        char *          pch,
+        std::size_t     capacity,
+        std::size_t     newSize,
+        std::size_t &   newCapacity)
+    {
+        RCF_UNUSED_VARIABLE(capacity);
+        char * pchNew = (char *) realloc(pch, newSize);
+        if (!pchNew)
+        {
+            throw std::bad_alloc();
+        }
+        newCapacity = newSize;
+        return pchNew;
+    }
+
+    void HeapBufferAllocator::deallocate(char * pch, std::size_t capacity)
+    {
+        RCF_UNUSED_VARIABLE(capacity);
+        free(pch);
+    }
+
+#endif
+
+    //--------------------------------------------------------------------------
+    // SizeClassBufferAllocator
+
+    static const std::size_t HugePageSize = 2*1024*1024;
+
+    static std::size_t roundUpToHugePage(std::size_t size)
+    {
+        return (size + HugePageSize - 1) & ~(HugePageSize - 1);
+    }
+
+    SizeClassBufferAllocator::SizeClassBufferAllocator(
+        std::size_t     largeBufferThreshold,
+        std::size_t     cacheSizeLimit) :
+            mLargeBufferThreshold( RCF_MAX(largeBufferThreshold, 2*SmallBufferLimit) ),
+            mCacheSizeLimit(cacheSizeLimit),
+            mCachedBytes(0),
+            mUseHugeTlb(true)
+    {
+    }
+
+    SizeClassBufferAllocator::~SizeClassBufferAllocator()
+    {
+        trim();
+    }
+
+    // Size class N holds blocks of 2^N * SmallBufferLimit bytes.
+    std::size_t SizeClassBufferAllocator::getSizeClass(std::size_t size, std::size_t & capacity)
+    {
+        std::size_t sizeClass = 0;
+        capacity = SmallBufferLimit;
+        while (capacity < size)
+        {
+            capacity <<= 1;
+            ++sizeClass;
+        }
+        RCF_ASSERT(sizeClass < SizeClassCount);
+        return sizeClass;
+    }
+
+    char * SizeClassBufferAllocator::allocate(std::size_t size, std::size_t & capacity)
+    {
+        if (size < SmallBufferLimit)
+        {
+            char * pch = (char *) malloc(size);
+            if (!pch)
+            {
+                throw std::bad_alloc();
+            }
+            capacity = size;
+            return pch;
+        }
+        else if (size >= mLargeBufferThreshold)
+        {
+            return allocateLarge(size, capacity);
+        }
+
+        std::size_t sizeClass = getSizeClass(size, capacity);
+        if (capacity >= mLargeBufferThreshold)
+        {
+            return allocateLarge(size, capacity);
+        }
+
+        {
+            Lock lock(mMutex);
+            std::vector<char *> & cache = mMediumCache[sizeClass];
+            if (!cache.empty())
+            {
+                char * pch = cache.back();
+                cache.pop_back();
+                mCachedBytes -= capacity;
+                return pch;
+            }
+        }
+
+        char * pch = (char *) malloc(capacity);
+        if (!pch)
+        {
+            throw std::bad_alloc();
+        }
+        return pch;
+    }
+
+    char * SizeClassBufferAllocator::reallocate(
+        char *          pch,
+        std::size_t     capacity,
+        std::size_t     newSize,
+        std::size_t &   newCapacity)
+    {
+        if (newSize <= capacity)
+        {
+            newCapacity = capacity;
+            return pch;
+        }
+
+#if defined(__linux__)
+
+        // Large blocks are remapped, rather than copied. Kernels before 6.3 can't remap MAP_HUGETLB mappings, 
+        // so if the remap fails, we copy instead.
+        if (capacity >= mLargeBufferThreshold)
+        {
+            std::size_t mapSize = roundUpToHugePage(newSize);
+            void * pv = mremap(pch, capacity, mapSize, MREMAP_MAYMOVE);
+            if (pv != MAP_FAILED)
+            {
+#ifdef MADV_HUGEPAGE
+                madvise(pv, mapSize, MADV_HUGEPAGE);
+#endif
+                newCapacity = mapSize;
+                return (char *) pv;
+            }
+        }
+
+#endif
+
+        char * pchNew = allocate(newSize, newCapacity);
+        memcpy(pchNew, pch, capacity);
+        deallocate(pch, capacity);
+        return pchNew;
+    }
+
+    void SizeClassBufferAllocator::deallocate(char * pch, std::size_t capacity)
+    {
+        if (capacity < SmallBufferLimit)
+        {
+            free(pch);
+            return;
+        }
+
+        Lock lock(mMutex);
+        if (mCachedBytes + capacity <= mCacheSizeLimit)
+        {
+            mCachedBytes += capacity;
+            if (capacity >= mLargeBufferThreshold)
+            {
+                LargeBlock block = { pch, capacity };
+                mLargeCache.push_back(block);
+            }
+            else
+            {
+                std::size_t classCapacity = 0;
+                mMediumCache[getSizeClass(capacity, classCapacity)].push_back(pch);
+            }
+            return;
+        }
+        lock.unlock();
+
+        if (capacity >= mLargeBufferThreshold)
+        {
+            unmapLarge(pch, capacity);
+        }
+        else
+        {
+            free(pch);
+        }
+    }
+
+    char * SizeClassBufferAllocator::allocateLarge(std::size_t size, std::size_t & capacity)
+    {
+        std::size_t mapSize = roundUpToHugePage( RCF_MAX(size, mLargeBufferThreshold) );
+
+        {
+            // Best fit from the cache of released large blocks.
+            Lock lock(mMutex);
+            std::size_t bestIdx = std::size_t(-1);
+            for (std::size_t i=0; i<mLargeCache.size(); ++i)
+            {
+                const LargeBlock & block = mLargeCache[i];
+                if (    block.mCapacity >= mapSize
+                    &&  (bestIdx == std::size_t(-1) || block.mCapacity < mLargeCache[bestIdx].mCapacity))
+                {
+                    bestIdx = i;
+                }
+            }
+
+            if (bestIdx != std::size_t(-1))
+            {
+                LargeBlock block = mLargeCache[bestIdx];
+                mLargeCache[bestIdx] = mLargeCache.back();
+                mLargeCache.pop_back();
+                mCachedBytes -= block.mCapacity;
+                capacity = block.mCapacity;
+                return block.mpch;
+            }
+        }
+
+        capacity = mapSize;
+        return mapLarge(mapSize);
+    }
+
+#ifdef RCF_WINDOWS
+
+    char * SizeClassBufferAllocator::mapLarge(std::size_t capacity)
+    {
+        char * pch = (char *) malloc(capacity);
+        if (!pch)
+        {
+            throw std::bad_alloc();
+        }
+        return pch;
+    }
+
+    void SizeClassBufferAllocator::unmapLarge(char * pch, std::size_t capacity)
+    {
+        RCF_UNUSED_VARIABLE(capacity);
+        free(pch);
+    }
+
+#else
+
+    char * SizeClassBufferAllocator::mapLarge(std::size_t capacity)
+    {
+        void * pv = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+        // Explicit huge pages are only available if the administrator has reserved them. If the first
+        // attempt fails, we fall back to transparent huge pages from then on.
+        if (mUseHugeTlb)
+        {
+            pv = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (pv == MAP_FAILED)
+            {
+                mUseHugeTlb = false;
+            }
+        }
+#endif
+
+        if (pv == MAP_FAILED)
+        {
+            pv = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (pv == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+
+#ifdef MADV_HUGEPAGE
+            madvise(pv, capacity, MADV_HUGEPAGE);
+#endif
+        }
+
+        return (char *) pv;
+    }
+
+    void SizeClassBufferAllocator::unmapLarge(char * pch, std::size_t capacity)
+    {
+        munmap(pch, capacity);
+    }
+
+#endif
+
+    void SizeClassBufferAllocator::trim()
+    {
+        std::vector<char *> mediumBlocks;
+        std::vector<LargeBlock> largeBlocks;
+
+        {
+            Lock lock(mMutex);
+            for (std::size_t i=0; i<SizeClassCount; ++i)
+            {
+                mediumBlocks.insert(mediumBlocks.end(), mMediumCache[i].begin(), mMediumCache[i].end());
+                mMediumCache[i].clear();
+            }
+            largeBlocks.swap(mLargeCache);
+            mCachedBytes = 0;
+        }
+
+        for (std::size_t i=0; i<mediumBlocks.size(); ++i)
+        {
+            free(mediumBlocks[i]);
+        }
+
+        for (std::size_t i=0; i<largeBlocks.size(); ++i)
+        {
+            unmapLarge(largeBlocks[i].mpch, largeBlocks[i].mCapacity);
+        }
+    }
+
+    std::size_t SizeClassBufferAllocator::getCachedBytes()
+    {
+        Lock lock(mMutex);
+        return mCachedBytes;
+    }
+
+    //--------------------------------------------------------------------------
+    // Default allocator
+
+    BufferAllocatorPtr gDefaultBufferAllocatorPtr;
+
+    void setDefaultBufferAllocator(BufferAllocatorPtr allocatorPtr)
+    {
+        std::atomic_store(&gDefaultBufferAllocatorPtr, allocatorPtr);
+    }
+
+    BufferAllocatorPtr getDefaultBufferAllocator()
+    {
+        BufferAllocatorPtr allocatorPtr = std::atomic_load(&gDefaultBufferAllocatorPtr);
+        if (!allocatorPtr)
+        {
+            static BufferAllocatorPtr heapAllocatorPtr( new HeapBufferAllocator() );
+            allocatorPtr = heapAllocatorPtr;
+        }
+        return allocatorPtr;
+    }
+
+} // namespace RCF
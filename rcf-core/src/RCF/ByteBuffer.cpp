@@ -41,13 +41,23 @@ namespace RCF {
     {}
 
     ByteBuffer::ByteBuffer(std::size_t pvlen) :
-        mSpvc(new std::vector<char>(pvlen)),
-        mPv( mSpvc->empty() ? NULL : &mSpvc->front()),
+        mSprb(new ReallocBuffer(pvlen)),
+        mPv( mSprb->empty() ? NULL : mSprb->getPtr()),
         mPvlen(pvlen),
         mLeftMargin(),
         mReadOnly()
         
-    {}
+    {
+        if (mPv)
+        {
+            memset(mPv, 0, mPvlen);
+        }
+    }
+
+    ByteBuffer ByteBuffer::createUninitialized(std::size_t pvlen)
+    {
+        return ByteBuffer( ReallocBufferPtr(new ReallocBuffer(pvlen)) );
+    }
 
     ByteBuffer::ByteBuffer(const std::vector<char> & vc) :
         mSpvc( new std::vector<char>(vc) ),
@@ -198,6 +208,17 @@ namespace RCF {
             mReadOnly(readOnly)
     {}
 
+    ByteBuffer::ByteBuffer(
+        char *pv,
+        std::size_t pvlen,
+        std::shared_ptr<void> spOwner,
+        bool readOnly) :
+            mSpOwner(spOwner),
+            mPv(pv),
+            mPvlen(pvlen),
+            mLeftMargin(),
+            mReadOnly(readOnly)
+    {}
 
     ByteBuffer::ByteBuffer(
         const ByteBuffer &byteBuffer,
@@ -206,6 +227,7 @@ namespace RCF {
             mSpvc(byteBuffer.mSpvc),
             mSpos(byteBuffer.mSpos),
             mSprb(byteBuffer.mSprb),
+            mSpOwner(byteBuffer.mSpOwner),
             mPv(byteBuffer.mPv + offset),
             mPvlen( len == npos ? byteBuffer.mPvlen-offset : len),
             mLeftMargin( offset ? 0 : byteBuffer.mLeftMargin),
@@ -464,12 +486,15 @@ namespace RCF {
 
 #if RCF_FEATURE_SF==1
 
+#include <RCF/ArrayBuffer.hpp>
+#include <RCF/ByteOrdering.hpp>
 #include <RCF/ClientStub.hpp>
 #include <RCF/CurrentSerializationProtocol.hpp>
 #include <RCF/RcfSession.hpp>
 #include <RCF/SerializationProtocol.hpp>
 #include <SF/Archive.hpp>
 #include <SF/Stream.hpp>
+#include <SF/vector.hpp>
 
 namespace SF {
 
@@ -477,8 +502,11 @@ namespace SF {
     {
         if (ar.isRead())
         {
-            std::uint32_t len = 0;
-            ar & len;
+            std::uint64_t len64 = readArrayCount(ar);
+            RCF_VERIFY(
+                len64 <= std::uint64_t( std::size_t(-1) ), 
+                RCF::Exception(RCF::RcfError_SfDataFormat));
+            std::size_t len = static_cast<std::size_t>(len64);
 
             byteBuffer.clear();
 
@@ -498,40 +526,132 @@ namespace SF {
                 }
                 else
                 {
-                    byteBuffer = RCF::ByteBuffer(len);
+                    byteBuffer = RCF::ByteBuffer::createUninitialized(len);
                 }
 
-                SF::IStream &is = *ar.getIstream();
+                readArrayBytes(ar, byteBuffer.getPtr(), len);
+            }
+        }
+        else if (ar.isWrite())
+        {
+            std::size_t len = byteBuffer.getLength();
+            writeArrayCount(ar, len);
 
-                std::uint32_t bytesToRead = len;
-                std::uint32_t bytesRead = is.read( (SF::Byte8 *) byteBuffer.getPtr(), bytesToRead);
+            // See if we have a remote call context.
+            RCF::SerializationProtocolOut *pOut = 
+                ar.getOstream()->getRemoteCallContext();
 
-                if ( bytesRead != bytesToRead )
+            if (pOut && len)
+            {
+                pOut->insert(byteBuffer);
+            }
+            else if (len)
+            {
+                writeArrayBytes(ar, byteBuffer.getPtr(), len);
+            }
+        }
+    }
+
+    void serializeArrayBufferImpl(
+        SF::Archive &           ar, 
+        RCF::ByteBuffer &       byteBuffer, 
+        std::size_t             sizeofElement, 
+        std::size_t             alignofElement)
+    {
+        if (ar.isRead())
+        {
+            std::uint64_t count64 = readArrayCount(ar);
+            RCF_VERIFY(
+                count64 <= std::uint64_t( std::size_t(-1) / sizeofElement ), 
+                RCF::Exception(RCF::RcfError_SfDataFormat));
+            std::size_t count = static_cast<std::size_t>(count64);
+
+            byteBuffer.clear();
+            if (count == 0)
+            {
+                return;
+            }
+
+            std::size_t bytesToRead = count*sizeofElement;
+
+            // See if we have a remote call context.
+            RCF::SerializationProtocolIn *pIn = ar.getIstream()->getRemoteCallContext();
+
+            if (ar.verifyAgainstArchiveSize(bytesToRead))
+            {
+                if (pIn)
+                {
+                    // Refer directly into the receive buffer.
+                    pIn->extractSlice(byteBuffer, bytesToRead);
+
+                    bool isAligned = reinterpret_cast<std::uintptr_t>(byteBuffer.getPtr()) % alignofElement == 0;
+                    bool needsReordering = !RCF::machineOrderEqualsNetworkOrder() && ar.getRuntimeVersion() >= 8;
+                    if (!isAligned || (needsReordering && byteBuffer.getReadOnly()))
+                    {
+                        RCF::ByteBuffer alignedBuffer = RCF::ByteBuffer::createUninitialized(bytesToRead);
+                        memcpy(alignedBuffer.getPtr(), byteBuffer.getPtr(), bytesToRead);
+                        byteBuffer = alignedBuffer;
+                    }
+                }
+                else
                 {
-                    RCF::Exception e(RCF::RcfError_SfReadFailure);
-                    RCF_THROW(e);
+                    byteBuffer = RCF::ByteBuffer::createUninitialized(bytesToRead);
+                    readArrayBytes(ar, byteBuffer.getPtr(), bytesToRead);
                 }
             }
+            else
+            {
+                // Size field not verified, so read in chunks.
+                std::shared_ptr< std::vector<char> > vecPtr( new std::vector<char>() );
+                std::size_t bytesRemaining = bytesToRead;
+                while (bytesRemaining)
+                {
+                    const std::size_t ChunkSize = 1024*1024;
+                    std::size_t bytesReadSoFar = vecPtr->size();
+                    std::size_t bytesToReadNow = RCF_MIN(ChunkSize, bytesRemaining);
+                    vecPtr->resize(bytesReadSoFar + bytesToReadNow);
+                    readArrayBytes(ar, &(*vecPtr)[bytesReadSoFar], bytesToReadNow);
+                    bytesRemaining -= bytesToReadNow;
+                }
+                byteBuffer = RCF::ByteBuffer(vecPtr);
+            }
+
+            // Byte ordering.
+            if (ar.getRuntimeVersion() >= 8)
+            {
+                RCF::networkToMachineOrderLarge(byteBuffer.getPtr(), sizeofElement, count);
+            }
         }
         else if (ar.isWrite())
         {
-            std::uint32_t len = static_cast<std::uint32_t>(byteBuffer.getLength());
-            ar & len;
+            std::size_t count = byteBuffer.getLength() / sizeofElement;
+            writeArrayCount(ar, count);
+            if (count == 0)
+            {
+                return;
+            }
+
+            RCF::ByteBuffer dataBuffer = byteBuffer;
+
+            if (!RCF::machineOrderEqualsNetworkOrder() && ar.getRuntimeVersion() >= 8)
+            {
+                // Reordering needed, so we go through a temporary buffer.
+                dataBuffer = RCF::ByteBuffer::createUninitialized(byteBuffer.getLength());
+                memcpy(dataBuffer.getPtr(), byteBuffer.getPtr(), byteBuffer.getLength());
+                RCF::machineToNetworkOrderLarge(dataBuffer.getPtr(), sizeofElement, count);
+            }
 
             // See if we have a remote call context.
             RCF::SerializationProtocolOut *pOut = 
                 ar.getOstream()->getRemoteCallContext();
 
-            if (pOut && len)
+            if (pOut)
             {
-                pOut->insert(byteBuffer);
+                pOut->insert(dataBuffer);
             }
-            else if (len)
+            else
             {
-                std::uint32_t bytesToWrite = len;
-                ar.getOstream()->writeRaw(
-                    (SF::Byte8 *) byteBuffer.getPtr(),
-                    bytesToWrite);
+                writeArrayBytes(ar, dataBuffer.getPtr(), dataBuffer.getLength());
             }
         }
     }
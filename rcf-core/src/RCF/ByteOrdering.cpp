@@ -17,9 +17,28 @@
 //******************************************************************************
 
 #include <RCF/ByteOrdering.hpp>
+
+#include <cstdint>
+#include <string.h>
+
 #include <RCF/Exception.hpp>
 #include <RCF/Tools.hpp>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RCF_BYTE_ORDERING_AVX2
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define RCF_BYTE_ORDERING_SSSE3
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RCF_BYTE_ORDERING_NEON
+#endif
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
 namespace RCF {
 
     enum ByteOrder
@@ -65,31 +84,167 @@ namespace RCF {
 
     const ByteOrder NetworkByteOrder = LittleEndian;
 
-    void swapBytes(char *b1, char *b2)
+    // Scalar byte swaps.
+
+    inline std::uint16_t bswap(std::uint16_t n)
     {
-        char temp = *b1;
-        *b1 = *b2;
-        *b2 = temp;
+#if defined(_MSC_VER)
+        return _byteswap_ushort(n);
+#elif defined(__GNUC__)
+        return __builtin_bswap16(n);
+#else
+        return static_cast<std::uint16_t>((n >> 8) | (n << 8));
+#endif
     }
 
-    void reverseByteOrder(void *buffer, int width, int count)
+    inline std::uint32_t bswap(std::uint32_t n)
+    {
+#if defined(_MSC_VER)
+        return _byteswap_ulong(n);
+#elif defined(__GNUC__)
+        return __builtin_bswap32(n);
+#else
+        return 
+                ((n & 0x000000FFu) << 24) 
+            |   ((n & 0x0000FF00u) << 8) 
+            |   ((n & 0x00FF0000u) >> 8) 
+            |   ((n & 0xFF000000u) >> 24);
+#endif
+    }
+
+    inline std::uint64_t bswap(std::uint64_t n)
+    {
+#if defined(_MSC_VER)
+        return _byteswap_uint64(n);
+#elif defined(__GNUC__)
+        return __builtin_bswap64(n);
+#else
+        return 
+                (static_cast<std::uint64_t>( bswap(static_cast<std::uint32_t>(n)) ) << 32) 
+            |   bswap(static_cast<std::uint32_t>(n >> 32));
+#endif
+    }
+
+    // Vector byte swaps, 16 or 32 bytes at a time. Elements never straddle a 16 byte lane, so the same shuffle 
+    // applies to every lane. Each block is loaded before it is stored, so source and destination may be the same.
+
+    template<typename UInt>
+    std::size_t reverseBlocks(char * dest, const char * src, std::size_t bytes)
+    {
+        std::size_t pos = 0;
+
+#if defined(RCF_BYTE_ORDERING_AVX2) || defined(RCF_BYTE_ORDERING_SSSE3)
+
+        const int W = sizeof(UInt);
+        char mask[16];
+        for (int i=0; i<16; ++i)
+        {
+            mask[i] = static_cast<char>( (i/W)*W + (W - 1 - i%W) );
+        }
+        __m128i mask128 = _mm_loadu_si128( reinterpret_cast<const __m128i *>(mask) );
+
+#if defined(RCF_BYTE_ORDERING_AVX2)
+        __m256i mask256 = _mm256_broadcastsi128_si256(mask128);
+        for (; pos + 32 <= bytes; pos += 32)
+        {
+            __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(src + pos) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i *>(dest + pos), _mm256_shuffle_epi8(v, mask256) );
+        }
+#endif
+
+        for (; pos + 16 <= bytes; pos += 16)
+        {
+            __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i *>(src + pos) );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>(dest + pos), _mm_shuffle_epi8(v, mask128) );
+        }
+
+#elif defined(RCF_BYTE_ORDERING_NEON)
+
+        for (; pos + 16 <= bytes; pos += 16)
+        {
+            uint8x16_t v = vld1q_u8( reinterpret_cast<const std::uint8_t *>(src + pos) );
+            switch (sizeof(UInt))
+            {
+            case 2:     v = vrev16q_u8(v); break;
+            case 4:     v = vrev32q_u8(v); break;
+            default:    v = vrev64q_u8(v); break;
+            }
+            vst1q_u8( reinterpret_cast<std::uint8_t *>(dest + pos), v );
+        }
+
+#else
+
+        RCF_UNUSED_VARIABLE(dest);
+        RCF_UNUSED_VARIABLE(src);
+        RCF_UNUSED_VARIABLE(bytes);
+
+#endif
+
+        return pos;
+    }
+
+    template<typename UInt>
+    void reverseElements(char * dest, const char * src, std::size_t count)
+    {
+        std::size_t bytes = count*sizeof(UInt);
+        std::size_t pos = reverseBlocks<UInt>(dest, src, bytes);
+
+        // Remaining elements. memcpy() takes care of unaligned access.
+        for (; pos < bytes; pos += sizeof(UInt))
+        {
+            UInt n = 0;
+            memcpy(&n, src + pos, sizeof(UInt));
+            n = bswap(n);
+            memcpy(dest + pos, &n, sizeof(UInt));
+        }
+    }
+
+    void reverseByteOrder(void *dest, const void *src, int width, int count)
     {
         RCF_ASSERT(width > 0);
-        RCF_ASSERT(count > 0);
-        if (width == 1) return;
+        RCF_ASSERT(count >= 0);
+
+        char * chDest = static_cast<char *>(dest);
+        const char * chSrc = static_cast<const char *>(src);
+        std::size_t elements = static_cast<std::size_t>(count);
 
-        char *chBuffer = static_cast<char *>(buffer);
-        for (int i=0; i<count; i++)
+        switch (width)
         {
-            for (int j=0;j<width/2;j++)
+        case 1: 
+            if (chDest != chSrc)
             {
-                swapBytes(
-                    chBuffer + i*width + j,
-                    chBuffer + i*width + width - j - 1 );
+                memmove(chDest, chSrc, elements);
+            }
+            break;
+
+        case 2: reverseElements<std::uint16_t>(chDest, chSrc, elements); break;
+        case 4: reverseElements<std::uint32_t>(chDest, chSrc, elements); break;
+        case 8: reverseElements<std::uint64_t>(chDest, chSrc, elements); break;
+
+        default:
+            for (std::size_t i=0; i<elements; ++i)
+            {
+                const char * pSrc = chSrc + i*width;
+                char * pDest = chDest + i*width;
+                for (int j=0; j<width/2; ++j)
+                {
+                    char temp = pSrc[j];
+                    pDest[j] = pSrc[width - j - 1];
+                    pDest[width - j - 1] = temp;
+                }
+                if (width % 2 && pDest != pSrc)
+                {
+                    pDest[width/2] = pSrc[width/2];
+                }
             }
         }
     }
 
+    void reverseByteOrder(void *buffer, int width, int count)
+    {
+        reverseByteOrder(buffer, buffer, width, count);
+    }
+
     void machineToNetworkOrder(void *buffer, int width, int count)
     {
         if RCF_CONSTEXPR(MachineByteOrder != NetworkByteOrder)
@@ -106,6 +261,64 @@ namespace RCF {
         }
     }
 
+    void machineToNetworkOrder(void *dest, const void *src, int width, int count)
+    {
+        if RCF_CONSTEXPR(MachineByteOrder != NetworkByteOrder)
+        {
+            reverseByteOrder(dest, src, width, count);
+        }
+        else if (dest != src)
+        {
+            memmove(dest, src, static_cast<std::size_t>(width)*count);
+        }
+    }
+
+    void networkToMachineOrder(void *dest, const void *src, int width, int count)
+    {
+        if RCF_CONSTEXPR(MachineByteOrder != NetworkByteOrder)
+        {
+            reverseByteOrder(dest, src, width, count);
+        }
+        else if (dest != src)
+        {
+            memmove(dest, src, static_cast<std::size_t>(width)*count);
+        }
+    }
+
+    // The byte ordering functions take an int count.
+    static void reorderLarge(
+        void (*reorder)(void *, int, int), 
+        void * buffer, 
+        std::size_t width, 
+        std::size_t count)
+    {
+        const std::size_t ElementsMax = 1024*1024*1024;
+        char * pch = static_cast<char *>(buffer);
+        while (count)
+        {
+            std::size_t elements = RCF_MIN(count, ElementsMax);
+            reorder(pch, static_cast<int>(width), static_cast<int>(elements));
+            pch += elements*width;
+            count -= elements;
+        }
+    }
+
+    void machineToNetworkOrderLarge(void *buffer, std::size_t width, std::size_t count)
+    {
+        if RCF_CONSTEXPR(MachineByteOrder != NetworkByteOrder)
+        {
+            reorderLarge(&machineToNetworkOrder, buffer, width, count);
+        }
+    }
+
+    void networkToMachineOrderLarge(void *buffer, std::size_t width, std::size_t count)
+    {
+        if RCF_CONSTEXPR(MachineByteOrder != NetworkByteOrder)
+        {
+            reorderLarge(&networkToMachineOrder, buffer, width, count);
+        }
+    }
+
     bool machineOrderEqualsNetworkOrder()
     {
         return MachineByteOrder == NetworkByteOrder;
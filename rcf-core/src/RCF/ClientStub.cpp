@@ -157,6 +157,8 @@ namespace RCF {
             mRuntimeVersion                 = rhs.mRuntimeVersion;
             mArchiveVersion                 = rhs.mArchiveVersion;
             mEnableSfPointerTracking        = rhs.mEnableSfPointerTracking;
+            mEnableSfSchemaFixed            = rhs.mEnableSfSchemaFixed;
+            mParallelSerializationThreshold = rhs.mParallelSerializationThreshold;
             mEnableNativeWstringSerialization = rhs.mEnableNativeWstringSerialization;
             mPingBackIntervalMs             = rhs.mPingBackIntervalMs;
             mSignalled                      = false;
@@ -178,12 +180,14 @@ namespace RCF {
             mPassword                       = rhs.mPassword;
             mKerberosSpn                    = rhs.mKerberosSpn;
             mEnableCompression              = rhs.mEnableCompression;
+            mCompressionAlgorithm           = rhs.mCompressionAlgorithm;
 
             mCertificatePtr                 = rhs.mCertificatePtr;
             mCaCertificatePtr               = rhs.mCaCertificatePtr;
             mCertificateValidationCb        = rhs.mCertificateValidationCb;
             mSchannelCertificateValidation  = rhs.mSchannelCertificateValidation;
             mOpenSslCipherSuite             = rhs.mOpenSslCipherSuite;
+            mEnableSslSessionResumption     = rhs.mEnableSslSessionResumption;
 
             mSslImplementation              = rhs.mSslImplementation;
 
@@ -264,6 +268,26 @@ namespace RCF {
         return mEnableSfPointerTracking;
     }
 
+    void ClientStub::setEnableSfSchemaFixed(bool enable)
+    {
+        mEnableSfSchemaFixed = enable;
+    }
+
+    bool ClientStub::getEnableSfSchemaFixed() const
+    {
+        return mEnableSfSchemaFixed;
+    }
+
+    void ClientStub::setParallelSerializationThreshold(std::uint32_t thresholdBytes)
+    {
+        mParallelSerializationThreshold = thresholdBytes;
+    }
+
+    std::uint32_t ClientStub::getParallelSerializationThreshold() const
+    {
+        return mParallelSerializationThreshold;
+    }
+
     void ClientStub::setEndpoint(const Endpoint &endpoint)
     {
         mEndpoint = endpoint.clone();
@@ -1277,6 +1301,24 @@ namespace RCF {
         return mEnableCompression;
     }
 
+    void ClientStub::setCompressionAlgorithm(CompressionAlgorithm compressionAlgorithm)
+    {
+        if (mCompressionAlgorithm != compressionAlgorithm)
+        {
+            mCompressionAlgorithm = compressionAlgorithm;
+            if (mEnableCompression)
+            {
+                disconnect();
+                clearTransportFilters();
+            }
+        }
+    }
+
+    CompressionAlgorithm ClientStub::getCompressionAlgorithm() const
+    {
+        return mCompressionAlgorithm;
+    }
+
     void ClientStub::setSspiMessageProtection(SspiMessageProtection sspiMessageProtection)
     {
         mSspiMessageProtection = sspiMessageProtection;
@@ -1347,6 +1389,16 @@ namespace RCF {
         return mOpenSslCipherSuite;
     }
 
+    void ClientStub::setEnableSslSessionResumption(bool enable)
+    {
+        mEnableSslSessionResumption = enable;
+    }
+
+    bool ClientStub::getEnableSslSessionResumption() const
+    {
+        return mEnableSslSessionResumption;
+    }
+
     void ClientStub::setTlsSniName(const tstring & serverName)
     {
         mTlsSniName = serverName;
@@ -0,0 +1,759 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#include <RCF/CompressionFilter.hpp>
+
+#include <RCF/ByteOrdering.hpp>
+#include <RCF/Exception.hpp>
+#include <RCF/ObjectPool.hpp>
+#include <RCF/ReallocBuffer.hpp>
+#include <RCF/Tools.hpp>
+
+#include <algorithm>
+#include <string.h> // memcpy
+
+namespace RCF {
+
+    //**************************************************************************
+    // Lz4CompressionCodec
+
+    // LZ4 block format, as described at https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md .
+
+    static const std::size_t    Lz4MinMatch         = 4;
+    static const std::size_t    Lz4LastLiterals     = 5;
+    static const std::size_t    Lz4MatchFindLimit   = 12;
+    static const std::size_t    Lz4MaxOffset        = 65535;
+    static const int            Lz4HashLog          = 14;
+
+    static const char *         Lz4Malformed        = "Malformed LZ4 block.";
+
+    inline std::uint32_t lz4Read32(const char * p)
+    {
+        std::uint32_t n = 0;
+        memcpy(&n, p, sizeof(n));
+        return n;
+    }
+
+    inline std::uint64_t lz4Read64(const char * p)
+    {
+        std::uint64_t n = 0;
+        memcpy(&n, p, sizeof(n));
+        return n;
+    }
+
+    inline std::uint32_t lz4Hash(std::uint32_t n)
+    {
+        return (n * 2654435761U) >> (32 - Lz4HashLog);
+    }
+
+    inline char * lz4WriteLength(char * op, std::size_t length)
+    {
+        while (length >= 255)
+        {
+            *op++ = char(255);
+            length -= 255;
+        }
+        *op++ = char(length);
+        return op;
+    }
+
+    // Writes a literal run followed by a match. The final sequence of a block has no match, and a matchLength of zero.
+    char * lz4WriteSequence(
+        char *          op,
+        const char *    pLiterals,
+        std::size_t     literalLength,
+        std::size_t     offset,
+        std::size_t     matchLength)
+    {
+        char * pToken = op++;
+        unsigned char token = 0;
+
+        if (literalLength >= 15)
+        {
+            token = 15 << 4;
+            op = lz4WriteLength(op, literalLength - 15);
+        }
+        else
+        {
+            token = (unsigned char) (literalLength << 4);
+        }
+
+        memcpy(op, pLiterals, literalLength);
+        op += literalLength;
+
+        if (matchLength > 0)
+        {
+            *op++ = char(offset & 0xFF);
+            *op++ = char(offset >> 8);
+
+            std::size_t length = matchLength - Lz4MinMatch;
+            if (length >= 15)
+            {
+                token |= 15;
+                op = lz4WriteLength(op, length - 15);
+            }
+            else
+            {
+                token |= (unsigned char) length;
+            }
+        }
+
+        *pToken = char(token);
+        return op;
+    }
+
+    Lz4CompressionCodec::Lz4CompressionCodec()
+    {
+    }
+
+    int Lz4CompressionCodec::getFilterId(bool stateful) const
+    {
+        return stateful ? RcfFilter_Lz4CompressionStateful : RcfFilter_Lz4CompressionStateless;
+    }
+
+    std::size_t Lz4CompressionCodec::getMaxCompressedLength(std::size_t srcLength)
+    {
+        return srcLength + srcLength/255 + 16;
+    }
+
+    std::size_t Lz4CompressionCodec::compress(
+        const char *    pSrc,
+        std::size_t     srcLength,
+        std::size_t     historyLength,
+        char *          pDest,
+        std::size_t     destLength)
+    {
+        RCF_ASSERT(destLength >= getMaxCompressedLength(srcLength));
+        RCF_UNUSED_VARIABLE(destLength);
+
+        // Positions are stored relative to the start of the history, and are only meaningful for the current frame.
+        mHashTable.resize(std::size_t(1) << Lz4HashLog);
+        std::fill(mHashTable.begin(), mHashTable.end(), 0);
+
+        historyLength = RCF_MIN(historyLength, Lz4MaxOffset);
+        const char * const pBase = pSrc - historyLength;
+        const char * const pEnd = pSrc + srcLength;
+
+        // Index the tail of the history. Indexing all of it would dominate the cost of compressing small frames.
+        std::size_t indexLength = RCF_MIN(historyLength, RCF_MAX(std::size_t(4096), 16*srcLength));
+        for (const char * p = pSrc - indexLength; p < pSrc && p + 4 <= pEnd; ++p)
+        {
+            mHashTable[lz4Hash(lz4Read32(p))] = std::uint32_t(p - pBase);
+        }
+
+        const char * ip = pSrc;
+        const char * anchor = pSrc;
+        char * op = pDest;
+
+        if (srcLength > Lz4MatchFindLimit)
+        {
+            const char * const pMatchLimit = pEnd - Lz4LastLiterals;
+            const char * const pFindLimit = pEnd - Lz4MatchFindLimit;
+
+            while (ip < pFindLimit)
+            {
+                std::uint32_t sequence = lz4Read32(ip);
+                std::uint32_t & entry = mHashTable[lz4Hash(sequence)];
+                const char * ref = pBase + entry;
+                entry = std::uint32_t(ip - pBase);
+
+                if (ref >= ip || std::size_t(ip - ref) > Lz4MaxOffset || lz4Read32(ref) != sequence)
+                {
+                    // Step faster through data that isn't matching.
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                while (ip > anchor && ref > pBase && ip[-1] == ref[-1])
+                {
+                    --ip;
+                    --ref;
+                }
+
+                const char * matchEnd = ip + Lz4MinMatch;
+                const char * refEnd = ref + Lz4MinMatch;
+                while (matchEnd + 8 <= pMatchLimit && lz4Read64(matchEnd) == lz4Read64(refEnd))
+                {
+                    matchEnd += 8;
+                    refEnd += 8;
+                }
+                while (matchEnd < pMatchLimit && *matchEnd == *refEnd)
+                {
+                    ++matchEnd;
+                    ++refEnd;
+                }
+
+                op = lz4WriteSequence(op, anchor, ip - anchor, ip - ref, matchEnd - ip);
+
+                ip = matchEnd;
+                anchor = ip;
+
+                if (ip < pFindLimit)
+                {
+                    mHashTable[lz4Hash(lz4Read32(ip - 2))] = std::uint32_t(ip - 2 - pBase);
+                }
+            }
+        }
+
+        op = lz4WriteSequence(op, anchor, pEnd - anchor, 0, 0);
+        return op - pDest;
+    }
+
+    void Lz4CompressionCodec::decompress(
+        const char *    pSrc,
+        std::size_t     srcLength,
+        char *          pDest,
+        std::size_t     destLength,
+        std::size_t     historyLength)
+    {
+        const unsigned char * ip = (const unsigned char *) pSrc;
+        const unsigned char * const ipEnd = ip + srcLength;
+        char * op = pDest;
+        char * const opEnd = pDest + destLength;
+        const char * const pLow = pDest - historyLength;
+
+        while (true)
+        {
+            RCF_VERIFY(ip < ipEnd, Exception(RcfError_CompressedData, Lz4Malformed));
+            unsigned char token = *ip++;
+
+            std::size_t literalLength = token >> 4;
+            if (literalLength == 15)
+            {
+                unsigned char n = 0;
+                do
+                {
+                    RCF_VERIFY(ip < ipEnd, Exception(RcfError_CompressedData, Lz4Malformed));
+                    n = *ip++;
+                    literalLength += n;
+                } while (n == 255);
+            }
+
+            RCF_VERIFY(
+                literalLength <= std::size_t(ipEnd - ip) && literalLength <= std::size_t(opEnd - op),
+                Exception(RcfError_CompressedData, Lz4Malformed));
+
+            // Short runs are copied with a fixed length copy, which may write past the run but not past the output.
+            if (literalLength <= 16 && ipEnd - ip >= 16 && opEnd - op >= 16)
+            {
+                memcpy(op, ip, 16);
+            }
+            else
+            {
+                memcpy(op, ip, literalLength);
+            }
+            ip += literalLength;
+            op += literalLength;
+
+            if (ip == ipEnd)
+            {
+                break;
+            }
+
+            RCF_VERIFY(ipEnd - ip >= 2, Exception(RcfError_CompressedData, Lz4Malformed));
+            std::size_t offset = std::size_t(ip[0]) | (std::size_t(ip[1]) << 8);
+            ip += 2;
+
+            std::size_t matchLength = token & 15;
+            if (matchLength == 15)
+            {
+                unsigned char n = 0;
+                do
+                {
+                    RCF_VERIFY(ip < ipEnd, Exception(RcfError_CompressedData, Lz4Malformed));
+                    n = *ip++;
+                    matchLength += n;
+                } while (n == 255);
+            }
+            matchLength += Lz4MinMatch;
+
+            RCF_VERIFY(
+                offset > 0 && offset <= std::size_t(op - pLow) && matchLength <= std::size_t(opEnd - op),
+                Exception(RcfError_CompressedData, Lz4Malformed));
+
+            const char * ref = op - offset;
+            if (offset >= 8 && std::size_t(opEnd - op) >= matchLength + 8)
+            {
+                // With an offset of at least 8, each 8 byte chunk only reads bytes that have already been written.
+                for (std::size_t i=0; i<matchLength; i+=8)
+                {
+                    memcpy(op + i, ref + i, 8);
+                }
+            }
+            else if (offset >= matchLength)
+            {
+                memcpy(op, ref, matchLength);
+            }
+            else
+            {
+                // Overlapping match, repeating the last offset bytes.
+                for (std::size_t i=0; i<matchLength; ++i)
+                {
+                    op[i] = ref[i];
+                }
+            }
+            op += matchLength;
+        }
+
+        RCF_VERIFY(op == opEnd, Exception(RcfError_CompressedData, Lz4Malformed));
+    }
+
+    //**************************************************************************
+    // CompressionFilter
+
+    // Frame header: uncompressed length, followed by encoded length, in network byte order. The top bit of the
+    // encoded length is set if the frame is stored uncompressed.
+
+    static const std::size_t    FrameHeaderLength   = 8;
+    static const std::uint32_t  FrameStoredFlag     = 0x80000000;
+
+    const std::size_t CompressionFilter::MaxFrameLength;
+    const std::size_t CompressionFilter::HistoryLength;
+
+    CompressionFilter::CompressionFilter(CompressionCodecPtr codecPtr, bool stateful) :
+        mCodecPtr(codecPtr),
+        mStateful(stateful),
+        mTotalBytesIn(0),
+        mWriteHistoryLength(0),
+        mBytesRequested(0),
+        mReadHeaderLength(0),
+        mFrameLength(0),
+        mEncodedLength(0),
+        mFrameStored(false),
+        mFrameBytesRead(0),
+        mReadHistoryLength(0)
+    {
+        RCF_ASSERT(mCodecPtr);
+    }
+
+    int CompressionFilter::getFilterId() const
+    {
+        return mCodecPtr->getFilterId(mStateful);
+    }
+
+    void CompressionFilter::resetState()
+    {
+        mPreBuffers.clear();
+        mPostBuffers.clear();
+        mTotalBytesIn = 0;
+        mWriteHistoryLength = 0;
+
+        mBytesRequested = 0;
+        mOrigBuffer.clear();
+        mPostBuffer.clear();
+        mReadHeaderLength = 0;
+        mFrameBytesRead = 0;
+        mReadHistoryLength = 0;
+        mOutput.clear();
+    }
+
+    // Makes room for a frame of frameLength bytes after the history in a window buffer, discarding history beyond
+    // HistoryLength bytes. Returns a pointer to the frame.
+    char * CompressionFilter::prepareWindow(
+        ReallocBufferPtr &  windowPtr,
+        std::size_t &       historyLength,
+        std::size_t         frameLength)
+    {
+        std::size_t keepLength = RCF_MIN(historyLength, HistoryLength);
+
+        if (!windowPtr)
+        {
+            windowPtr = getObjectPool().getReallocBufferPtr(keepLength + frameLength);
+        }
+        else if (!windowPtr.unique())
+        {
+            // A previous frame is still referenced further up the filter chain.
+            ReallocBufferPtr newWindowPtr = getObjectPool().getReallocBufferPtr(keepLength + frameLength);
+            newWindowPtr->resize(keepLength + frameLength);
+            if (keepLength > 0)
+            {
+                memcpy(newWindowPtr->getPtr(), windowPtr->getPtr() + historyLength - keepLength, keepLength);
+            }
+            windowPtr = newWindowPtr;
+            historyLength = keepLength;
+            return windowPtr->getPtr() + keepLength;
+        }
+        else if (keepLength > 0 && keepLength < historyLength)
+        {
+            memmove(windowPtr->getPtr(), windowPtr->getPtr() + historyLength - keepLength, keepLength);
+        }
+
+        historyLength = keepLength;
+        windowPtr->resize(keepLength + frameLength);
+        return windowPtr->getPtr() + keepLength;
+    }
+
+    void CompressionFilter::write(const std::vector<ByteBuffer> &byteBuffers)
+    {
+        // All frames of the message are passed down in a single write, so the transport doesn't send 
+        // each frame on its own.
+        mTotalBytesIn = lengthByteBuffers(byteBuffers);
+        std::size_t leftMargin = byteBuffers.empty() ? 0 : byteBuffers.front().getLeftMargin();
+
+        std::size_t maxLength = leftMargin;
+        std::size_t offset = 0;
+        do
+        {
+            std::size_t frameLength = RCF_MIN(mTotalBytesIn - offset, MaxFrameLength);
+            maxLength += FrameHeaderLength + mCodecPtr->getMaxCompressedLength(frameLength);
+            offset += frameLength;
+        }
+        while (offset < mTotalBytesIn);
+
+        if (!mCompressedPtr || !mCompressedPtr.unique())
+        {
+            mCompressedPtr = getObjectPool().getReallocBufferPtr(maxLength);
+        }
+        mCompressedPtr->resize(maxLength);
+
+        // Leave the same left margin as the original buffers, for filters further down the chain.
+        char * pBegin = mCompressedPtr->getPtr() + leftMargin;
+        char * pEnd = mCompressedPtr->getPtr() + maxLength;
+        char * pOut = pBegin;
+        char * pPending = pBegin;
+
+        mPostBuffers.clear();
+        offset = 0;
+        do
+        {
+            std::size_t frameLength = RCF_MIN(mTotalBytesIn - offset, MaxFrameLength);
+            sliceByteBuffers(mPreBuffers, byteBuffers, offset, frameLength);
+            offset += frameLength;
+
+            std::size_t encodedLength = compressFrame(pOut + FrameHeaderLength, pEnd - pOut - FrameHeaderLength);
+            bool stored = (encodedLength == 0 || encodedLength >= frameLength);
+
+            std::uint32_t header[2] = {
+                std::uint32_t(frameLength),
+                stored ? std::uint32_t(frameLength) | FrameStoredFlag : std::uint32_t(encodedLength) };
+
+            machineToNetworkOrder(header, 4, 2);
+            memcpy(pOut, header, FrameHeaderLength);
+            pOut += FrameHeaderLength;
+
+            if (stored)
+            {
+                // Send the original buffers as they are, after the header.
+                mPostBuffers.push_back( ByteBuffer(
+                    pPending, 
+                    pOut - pPending, 
+                    pPending == pBegin ? leftMargin : 0, 
+                    mCompressedPtr) );
+
+                mPostBuffers.insert(mPostBuffers.end(), mPreBuffers.begin(), mPreBuffers.end());
+                pPending = pOut;
+            }
+            else
+            {
+                pOut += encodedLength;
+            }
+        }
+        while (offset < mTotalBytesIn);
+
+        if (pOut > pPending)
+        {
+            mPostBuffers.push_back( ByteBuffer(
+                pPending, 
+                pOut - pPending, 
+                pPending == pBegin ? leftMargin : 0, 
+                mCompressedPtr) );
+        }
+
+        getPostFilter().write(mPostBuffers);
+    }
+
+    // Compresses the frame in mPreBuffers to pDest. Returns zero if it doesn't fit in destLength bytes.
+    std::size_t CompressionFilter::compressFrame(char * pDest, std::size_t destLength)
+    {
+        std::size_t frameLength = lengthByteBuffers(mPreBuffers);
+
+        // The codec needs the frame to be contiguous, and in stateful mode, to follow the history.
+        const char * pSrc = NULL;
+        std::size_t historyLength = 0;
+        if (!mStateful && mPreBuffers.size() == 1)
+        {
+            pSrc = mPreBuffers.front().getPtr();
+        }
+        else
+        {
+            char * pFrame = prepareWindow(mWriteWindowPtr, mWriteHistoryLength, frameLength);
+            copyByteBuffers(mPreBuffers, pFrame);
+            pSrc = pFrame;
+            historyLength = mWriteHistoryLength;
+            if (mStateful)
+            {
+                mWriteHistoryLength += frameLength;
+            }
+        }
+
+        return mCodecPtr->compress(pSrc, frameLength, historyLength, pDest, destLength);
+    }
+
+    void CompressionFilter::onWriteCompleted(std::size_t bytesTransferred)
+    {
+        RCF_ASSERT(bytesTransferred <= lengthByteBuffers(mPostBuffers));
+
+        if (bytesTransferred < lengthByteBuffers(mPostBuffers))
+        {
+            std::vector<ByteBuffer> slicedBuffers;
+            sliceByteBuffers(slicedBuffers, mPostBuffers, bytesTransferred);
+            mPostBuffers = slicedBuffers;
+            getPostFilter().write(mPostBuffers);
+        }
+        else
+        {
+            mPreBuffers.resize(0);
+            mPostBuffers.resize(0);
+            getPreFilter().onWriteCompleted(mTotalBytesIn);
+        }
+    }
+
+    void CompressionFilter::read(const ByteBuffer &byteBuffer, std::size_t bytesRequested)
+    {
+        if (byteBuffer.isEmpty() && bytesRequested == 0)
+        {
+            mBytesRequested = 0;
+            if (mOutput.getLength() > 0 || mPostBuffer.getLength() > 0)
+            {
+                getPreFilter().onReadCompleted(byteBuffer);
+            }
+            else
+            {
+                getPostFilter().read(ByteBuffer(), 0);
+            }
+            return;
+        }
+
+        mBytesRequested = bytesRequested;
+        mOrigBuffer = ByteBuffer(byteBuffer, 0, RCF_MIN(byteBuffer.getLength(), bytesRequested));
+
+        consumeInput();
+        if (mOutput.getLength() > 0)
+        {
+            deliverOutput();
+        }
+        else
+        {
+            requestInput();
+        }
+    }
+
+    void CompressionFilter::onReadCompleted(const ByteBuffer &byteBuffer)
+    {
+        if (mBytesRequested == 0)
+        {
+            RCF_ASSERT(byteBuffer.isEmpty());
+            getPreFilter().onReadCompleted(ByteBuffer());
+            return;
+        }
+
+        mPostBuffer = byteBuffer;
+
+        consumeInput();
+        if (mOutput.getLength() > 0)
+        {
+            deliverOutput();
+        }
+        else
+        {
+            requestInput();
+        }
+    }
+
+    void CompressionFilter::requestInput()
+    {
+        std::size_t bytesNeeded = (mReadHeaderLength < FrameHeaderLength) ?
+            FrameHeaderLength - mReadHeaderLength :
+            mEncodedLength - mFrameBytesRead;
+
+        getPostFilter().read(ByteBuffer(), RCF_MAX(bytesNeeded, std::size_t(4096)));
+    }
+
+    // Parses frame headers and bodies from the input we have, until a frame has been decompressed.
+    void CompressionFilter::consumeInput()
+    {
+        while (mOutput.isEmpty() && !mPostBuffer.isEmpty())
+        {
+            const char * pInput = mPostBuffer.getPtr();
+            std::size_t inputLength = mPostBuffer.getLength();
+            std::size_t bytesUsed = 0;
+
+            if (mReadHeaderLength < FrameHeaderLength)
+            {
+                bytesUsed = RCF_MIN(FrameHeaderLength - mReadHeaderLength, inputLength);
+                memcpy(mReadHeader + mReadHeaderLength, pInput, bytesUsed);
+                mReadHeaderLength += bytesUsed;
+
+                if (mReadHeaderLength == FrameHeaderLength)
+                {
+                    std::uint32_t header[2] = { 0 };
+                    memcpy(header, mReadHeader, FrameHeaderLength);
+                    networkToMachineOrder(header, 4, 2);
+
+                    mFrameLength = header[0];
+                    mFrameStored = (header[1] & FrameStoredFlag) != 0;
+                    mEncodedLength = header[1] & ~FrameStoredFlag;
+                    mFrameBytesRead = 0;
+
+                    RCF_VERIFY(
+                        0 < mFrameLength && mFrameLength <= MaxFrameLength
+                            && (mFrameStored ? mEncodedLength == mFrameLength : mEncodedLength < mFrameLength),
+                        Exception(RcfError_CompressedData, "Invalid frame header."));
+                }
+            }
+            else if (mFrameBytesRead == 0 && inputLength >= mEncodedLength)
+            {
+                // Whole frame is available, decompress it in place.
+                bytesUsed = mEncodedLength;
+                decompressFrame(pInput);
+            }
+            else
+            {
+                if (!mFramePtr)
+                {
+                    mFramePtr = getObjectPool().getReallocBufferPtr(mEncodedLength);
+                }
+                mFramePtr->resize(mEncodedLength);
+
+                bytesUsed = RCF_MIN(mEncodedLength - mFrameBytesRead, inputLength);
+                memcpy(mFramePtr->getPtr() + mFrameBytesRead, pInput, bytesUsed);
+                mFrameBytesRead += bytesUsed;
+
+                if (mFrameBytesRead == mEncodedLength)
+                {
+                    decompressFrame(mFramePtr->getPtr());
+                }
+            }
+
+            mPostBuffer = ByteBuffer(mPostBuffer, bytesUsed);
+            if (mPostBuffer.getLength() == 0)
+            {
+                mPostBuffer.clear();
+            }
+        }
+    }
+
+    void CompressionFilter::decompressFrame(const char * pFrame)
+    {
+        mOutput.clear();
+
+        mReadHeaderLength = 0;
+        mFrameBytesRead = 0;
+
+        if (!mStateful && mOrigBuffer.getLength() >= mFrameLength)
+        {
+            // No history to keep, so decompress straight into the caller's buffer.
+            if (mFrameStored)
+            {
+                memcpy(mOrigBuffer.getPtr(), pFrame, mFrameLength);
+            }
+            else
+            {
+                mCodecPtr->decompress(pFrame, mEncodedLength, mOrigBuffer.getPtr(), mFrameLength, 0);
+            }
+            mOutput = ByteBuffer(mOrigBuffer, 0, mFrameLength);
+            return;
+        }
+
+        char * pOut = prepareWindow(mReadWindowPtr, mReadHistoryLength, mFrameLength);
+
+        if (mFrameStored)
+        {
+            memcpy(pOut, pFrame, mFrameLength);
+        }
+        else
+        {
+            mCodecPtr->decompress(pFrame, mEncodedLength, pOut, mFrameLength, mReadHistoryLength);
+        }
+
+        mOutput = ByteBuffer(pOut, mFrameLength, mReadWindowPtr);
+
+        if (mStateful)
+        {
+            mReadHistoryLength += mFrameLength;
+        }
+    }
+
+    void CompressionFilter::deliverOutput()
+    {
+        std::size_t bytesOut = RCF_MIN(mOutput.getLength(), mBytesRequested);
+
+        ByteBuffer byteBuffer;
+        if (mOrigBuffer.getLength() > 0)
+        {
+            bytesOut = RCF_MIN(bytesOut, mOrigBuffer.getLength());
+            if (mOutput.getPtr() != mOrigBuffer.getPtr())
+            {
+                memcpy(mOrigBuffer.getPtr(), mOutput.getPtr(), bytesOut);
+            }
+            byteBuffer = ByteBuffer(mOrigBuffer, 0, bytesOut);
+        }
+        else
+        {
+            byteBuffer = ByteBuffer(mOutput, 0, bytesOut);
+        }
+
+        mOutput = ByteBuffer(mOutput, bytesOut);
+        if (mOutput.getLength() == 0)
+        {
+            mOutput.clear();
+        }
+
+        mOrigBuffer.clear();
+        getPreFilter().onReadCompleted(byteBuffer);
+    }
+
+    //**************************************************************************
+    // CompressionFilterFactory
+
+    CompressionFilterFactory::CompressionFilterFactory(CompressionCodecFactory codecFactory, bool stateful) :
+        mCodecFactory(codecFactory),
+        mStateful(stateful),
+        mFilterId( codecFactory()->getFilterId(stateful) )
+    {
+    }
+
+    FilterPtr CompressionFilterFactory::createFilter(RcfServer &)
+    {
+        return FilterPtr( new CompressionFilter(mCodecFactory(), mStateful) );
+    }
+
+    int CompressionFilterFactory::getFilterId()
+    {
+        return mFilterId;
+    }
+
+    //**************************************************************************
+    // Lz4CompressionFilter
+
+    CompressionCodecPtr createLz4CompressionCodec()
+    {
+        return CompressionCodecPtr( new Lz4CompressionCodec() );
+    }
+
+    Lz4CompressionFilter::Lz4CompressionFilter(bool stateful) :
+        CompressionFilter(createLz4CompressionCodec(), stateful)
+    {
+    }
+
+    Lz4CompressionFilterFactory::Lz4CompressionFilterFactory(bool stateful) :
+        CompressionFilterFactory(&createLz4CompressionCodec, stateful)
+    {
+    }
+
+} // namespace RCF
@@ -238,6 +238,16 @@ namespace RCF
         case 192   /*RcfError_HttpMessageVerificationAdmin   */: return "HTTP message verification failed. %1%"; 
         case 193   /*RcfError_HttpSessionNotAvailable        */: return "HTTP session not available."; 
         case 194   /*RcfError_HttpInvalidMessage             */: return "Invalid HTTP message."; 
+        case 195   /*RcfError_SfPodLayoutMismatch            */: return "Memory layout mismatch while deserializing trivially copyable type. Type: %1%. Local layout checksum: %2%. Remote layout checksum: %3%."; 
+        case 196   /*RcfError_SfArrayTooLarge                */: return "Array too large to serialize at runtime version %2%. Element count: %1%."; 
+        case 197   /*RcfError_SfTypeId                       */: return "Invalid SF type id %1% for type %2%. Type ids must be non-zero, less than %3%, and unique to a single type."; 
+        case 198   /*RcfError_SfSchemaMismatch               */: return "SF schema hash mismatch. Local hash: %1%. Remote hash: %2%. Schema-fixed serialization requires both ends to be built from the same method signatures."; 
+        case 199   /*RcfError_SfSchemaFixedPolymorphic       */: return "Polymorphic object of type %1% cannot be serialized by value in a schema-fixed SF archive. Serialize it through a pointer instead."; 
+        case 200   /*RcfError_SfInPlaceRead                  */: return "std::string_view and std::span<const T> can only be deserialized from remote call parameters on the server."; 
+        case 201   /*RcfError_DeltaUploadMismatch            */: return "Delta upload does not match the uploaded file. Path: %1%."; 
+        case 202   /*RcfError_CompressedData                 */: return "Invalid compressed data. %1%"; 
+        case 203   /*RcfError_SubscriptionFilterNotSupported */: return "Subscription filters are not supported by the publisher."; 
+        case 204   /*RcfError_SubscriptionFilterTooLarge     */: return "Subscription filter is too large. Key ranges: %1%. Tags: %2%. Maximum: %3% of each."; 
 
         //[[[end]]]
 
@@ -28,9 +28,9 @@
 
 namespace RCF {
 
-    FileIoThreadPool::FileIoThreadPool() : 
+    FileIoThreadPool::FileIoThreadPool(std::size_t maxThreadCount) : 
         mSerializeFileIo(false),
-        mThreadPool(1,10) 
+        mThreadPool(1, RCF_MAX(maxThreadCount, std::size_t(1))) 
     {
         mThreadPool.setThreadName("RCF Async File IO");
         mThreadPool.setThreadIdleTimeoutMs(30*1000);
@@ -129,11 +129,10 @@ namespace RCF {
         // Unregister op.
         unregisterOp(opPtr);
 
-        // Notify completion.
+        // Writes queued behind this one are carried out on the same thread, so they reach the file in order.
+        while (opPtr->nextQueuedWrite())
         {
-            RCF::Lock lock(mCompletionMutex);
-            opPtr->mCompleted = true;
-            mCompletionCondition.notify_all();
+            opPtr->doTransfer();
         }
 
         return false;
@@ -148,6 +147,17 @@ namespace RCF {
     FileIoRequest::FileIoRequest() :
         mFts( getFileIoThreadPool() ),
         mBytesTransferred(0),
+        mBytesRequested(0),
+        mInitiated(false),
+        mCompleted(true)
+    {
+        RCF_LOG_4() << "FileIoRequest::FileIoRequest()";
+    }
+
+    FileIoRequest::FileIoRequest(FileIoThreadPool & fts) :
+        mFts(fts),
+        mBytesTransferred(0),
+        mBytesRequested(0),
         mInitiated(false),
         mCompleted(true)
     {
@@ -198,6 +208,7 @@ namespace RCF {
         mFoutPtr.reset();
         mBuffer = buffer;
         mBytesTransferred = 0;
+        mBytesRequested = buffer.getLength();
         mInitiated = true;
         mCompleted = false;
 
@@ -218,10 +229,29 @@ namespace RCF {
     {
         RCF_LOG_4()(foutPtr.get())((void*)buffer.getPtr())(buffer.getLength()) << "FileIoRequest::write()";
 
+        {
+            RCF::Lock lock(mFts.mCompletionMutex);
+            if (mInitiated && !mCompleted)
+            {
+                RCF_ASSERT(mFoutPtr == foutPtr);
+                mWriteQueue.push_back(buffer);
+                mBytesRequested += buffer.getLength();
+                return;
+            }
+        }
+
+        // If earlier writes have completed but not yet been collected with complete(), their byte counts are 
+        // carried over, so a failed write is still reported.
+        if (!mInitiated)
+        {
+            mBytesTransferred = 0;
+            mBytesRequested = 0;
+        }
+
         mFinPtr.reset();
         mFoutPtr = foutPtr;
         mBuffer = buffer;
-        mBytesTransferred = 0;
+        mBytesRequested += buffer.getLength();
         mInitiated = true;
         mCompleted = false;
 
@@ -253,12 +283,19 @@ namespace RCF {
         {
             RCF_LOG_4()(mBuffer.getLength()) << "FileIoRequest::doTransfer() - initiate write.";
 
-            mBytesTransferred = mFoutPtr->write(mBuffer);
-            RCF_ASSERT(mBytesTransferred == mBuffer.getLength());
+            std::uint64_t bytesWritten = mFoutPtr->write(mBuffer);
+            RCF_ASSERT(bytesWritten == mBuffer.getLength());
             mFoutPtr->flush();
-            mFoutPtr.reset();
 
-            RCF_LOG_4()(mBytesTransferred) << "FileIoRequest::doTransfer() - write complete.";
+            RCF::Lock lock(mFts.mCompletionMutex);
+            mBytesTransferred += bytesWritten;
+            if (bytesWritten < mBuffer.getLength())
+            {
+                // Don't write queued buffers beyond a failed write.
+                mWriteQueue.clear();
+            }
+
+            RCF_LOG_4()(bytesWritten) << "FileIoRequest::doTransfer() - write complete.";
         }
         else
         {
@@ -267,13 +304,54 @@ namespace RCF {
         }
     }
 
+    bool FileIoRequest::nextQueuedWrite()
+    {
+        RCF::Lock lock(mFts.mCompletionMutex);
+        if (mWriteQueue.size() > 0)
+        {
+            mBuffer = mWriteQueue.front();
+            mWriteQueue.pop_front();
+            return true;
+        }
+
+        // Nothing more to do. Notify completion.
+        mBuffer = ByteBuffer();
+        mFoutPtr.reset();
+        mCompleted = true;
+        mFts.mCompletionCondition.notify_all();
+        return false;
+    }
+
+    void FileIoRequest::waitForPendingWrites(std::size_t maxPendingWrites)
+    {
+        RCF_LOG_4()(maxPendingWrites) << "FileIoRequest::waitForPendingWrites() - entry";
+
+        RCF::Lock lock(mFts.mCompletionMutex);
+        while (!mCompleted && 1 + mWriteQueue.size() > maxPendingWrites)
+        {
+            using namespace std::chrono_literals;
+            mFts.mCompletionCondition.wait_for(lock, 1000ms);
+        }
+
+        RCF_LOG_4() << "FileIoRequest::waitForPendingWrites() - exit";
+    }
+
     std::uint64_t FileIoRequest::getBytesTransferred()
     {
         RCF_LOG_4()(mBytesTransferred) << "FileIoRequest::getBytesTransferred()";
 
+        RCF::Lock lock(mFts.mCompletionMutex);
         return mBytesTransferred;
     }
 
+    std::uint64_t FileIoRequest::getBytesRequested()
+    {
+        RCF_LOG_4()(mBytesRequested) << "FileIoRequest::getBytesRequested()";
+
+        RCF::Lock lock(mFts.mCompletionMutex);
+        return mBytesRequested;
+    }
+
     static FileIoThreadPool * gpFileIoThreadPool = NULL;
 
     void initFileIoThreadPool()
@@ -18,7 +18,17 @@
 
 #include <RCF/ClientStub.hpp>
 
+#include <algorithm>
+#include <exception>
+
 #include <sys/stat.h>
+
+#ifndef RCF_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include <RCF/FileSystem.hpp>
 #include <RCF/FileIoThreadPool.hpp>
 #include <RCF/FileTransferInterface.hpp>
@@ -96,6 +106,23 @@ namespace RCF {
             mpFile = _wfsopen(wFilePath.c_str(), L"ab", _SH_DENYWR);            
 #else
             mpFile = fopen(uFilePath.c_str(), "ab");
+#endif
+        }
+        else if ( mode == OpenMode::WriteInPlace )
+        {
+            // Existing contents are preserved, and several handles may write to the file at once.
+#ifdef RCF_WINDOWS
+            mpFile = _wfsopen(wFilePath.c_str(), L"r+b", _SH_DENYNO);
+            if ( !mpFile )
+            {
+                mpFile = _wfsopen(wFilePath.c_str(), L"w+b", _SH_DENYNO);
+            }
+#else
+            mpFile = fopen(uFilePath.c_str(), "r+b");
+            if ( !mpFile )
+            {
+                mpFile = fopen(uFilePath.c_str(), "w+b");
+            }
 #endif
         }
         if ( !mpFile )
@@ -104,6 +131,14 @@ namespace RCF {
             RCF_THROW(RCF::Exception(RcfError_FileOpen, filePath.u8string(), Platform::OS::GetErrorString(err)));
         }
 
+#if !defined(RCF_WINDOWS) && defined(POSIX_FADV_SEQUENTIAL)
+        if ( mode == OpenMode::Read )
+        {
+            // Files are read front to back, so have the OS read ahead aggressively.
+            posix_fadvise(fileno(mpFile), 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
+
         if ( mode == OpenMode::WriteAppend )
         {
             // Do an explicit seek to the end so that ftell() returns predictable results.
@@ -208,6 +243,66 @@ namespace RCF {
         return ret;
     }
 
+#ifndef RCF_WINDOWS
+
+    // FileMapping
+
+    FileMapping::FileMapping(const Path & filePath, std::uint64_t offset, std::size_t length) :
+        mOffset(offset),
+        mLength(length)
+    {
+        std::string uFilePath = filePath.u8string();
+        int fd = ::open(uFilePath.c_str(), O_RDONLY);
+        if ( fd == -1 )
+        {
+            int err = Platform::OS::BsdSockets::GetLastError();
+            RCF_THROW(RCF::Exception(RcfError_FileOpen, uFilePath, Platform::OS::GetErrorString(err)));
+        }
+
+        // Mappings start on a page boundary.
+        std::uint64_t pageSize = static_cast<std::uint64_t>( sysconf(_SC_PAGESIZE) );
+        std::uint64_t mappingOffset = offset - offset % pageSize;
+        mMappingLength = static_cast<std::size_t>(offset - mappingOffset) + length;
+
+        mpMapping = mmap(NULL, mMappingLength, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(mappingOffset));
+        int err = Platform::OS::BsdSockets::GetLastError();
+        ::close(fd);
+
+        if ( mpMapping == MAP_FAILED )
+        {
+            mpMapping = NULL;
+            RCF_THROW(RCF::Exception(RcfError_FileRead, uFilePath, Platform::OS::GetErrorString(err)));
+        }
+
+        madvise(mpMapping, mMappingLength, MADV_SEQUENTIAL);
+        mPtr = static_cast<char *>(mpMapping) + (offset - mappingOffset);
+    }
+
+    FileMapping::~FileMapping()
+    {
+        if ( mpMapping )
+        {
+            munmap(mpMapping, mMappingLength);
+        }
+    }
+
+    char * FileMapping::getPtr() const
+    {
+        return mPtr;
+    }
+
+    std::uint64_t FileMapping::getOffset() const
+    {
+        return mOffset;
+    }
+
+    std::size_t FileMapping::getLength() const
+    {
+        return mLength;
+    }
+
+#endif
+
     // FileStream
 
     FileStream::FileStream() : mImplPtr( new FileStreamImpl() )
@@ -587,6 +682,8 @@ namespace RCF {
         std::uint32_t chunkSize = 1024 * 1024;
         std::uint32_t transferRateBps = 0;
         std::uint32_t sessionLocalId = 0;
+        std::uint32_t connectionCount = 1;
+        std::string deltaBasisId;
 
         if ( pOptions )
         {
@@ -598,6 +695,23 @@ namespace RCF {
             {
                 transferRateBps = pOptions->mBandwidthLimitBps;
             }
+            if ( pOptions->mConnectionCount )
+            {
+                connectionCount = pOptions->mConnectionCount;
+            }
+            deltaBasisId = pOptions->mDeltaBasisId;
+        }
+
+        if ( deltaBasisId.size() > 0 )
+        {
+            uploadFileDelta(uploadId, manifest, deltaBasisId, chunkSize, transferRateBps);
+            return;
+        }
+
+        if ( connectionCount > 1 )
+        {
+            uploadFileStriped(uploadId, manifest, chunkSize, transferRateBps, connectionCount);
+            return;
         }
         
         uploadFiles(manifest, uploadId, chunkSize, transferRateBps, sessionLocalId);
@@ -949,6 +1063,7 @@ namespace RCF {
         std::uint32_t transferRateBps = 0;
         std::uint64_t startPosition = 0;
         std::uint64_t endPosition = std::uint64_t(-1);
+        std::uint32_t connectionCount = 1;
 
         if ( pOptions )
         {
@@ -968,6 +1083,24 @@ namespace RCF {
             {
                 endPosition = pOptions->mEndPos;
             }
+            if ( pOptions->mConnectionCount )
+            {
+                connectionCount = pOptions->mConnectionCount;
+            }
+        }
+
+        if ( connectionCount > 1 )
+        {
+            downloadFileStriped(
+                downloadId, 
+                downloadToPath, 
+                chunkSize, 
+                transferRateBps, 
+                startPosition, 
+                endPosition, 
+                connectionCount);
+
+            return;
         }
 
         std::uint32_t sessionLocalDownloadId = 0;
@@ -1305,4 +1438,1077 @@ namespace RCF {
             << "ClientStub::downloadFiles() - exit.";
 
     }
+
+    //--------------------------------------------------------------------------
+    // Striped transfers
+
+    typedef std::pair<std::uint64_t, std::uint64_t>     ByteRange;
+    typedef std::vector<ByteRange>                      ByteRanges;
+
+    // Splits byte ranges into at most stripeCount stripes of roughly equal size, in whole chunks.
+    std::vector<ByteRanges> splitIntoStripes(
+        const ByteRanges &  ranges, 
+        std::uint32_t       stripeCount, 
+        std::uint32_t       chunkSize)
+    {
+        std::uint64_t totalBytes = 0;
+        for ( const ByteRange & range : ranges )
+        {
+            totalBytes += range.second - range.first;
+        }
+
+        std::uint64_t chunkCount = (totalBytes + chunkSize - 1) / chunkSize;
+        std::uint64_t stripeBytes = (chunkCount + stripeCount - 1) / stripeCount * chunkSize;
+
+        std::vector<ByteRanges> stripes;
+        std::uint64_t stripeBytesRemaining = 0;
+        for ( ByteRange range : ranges )
+        {
+            while ( range.first < range.second )
+            {
+                if ( stripeBytesRemaining == 0 )
+                {
+                    stripes.push_back( ByteRanges() );
+                    stripeBytesRemaining = stripeBytes;
+                }
+
+                std::uint64_t bytes = RCF_MIN(stripeBytesRemaining, range.second - range.first);
+                stripes.back().push_back( ByteRange(range.first, range.first + bytes) );
+                range.first += bytes;
+                stripeBytesRemaining -= bytes;
+            }
+        }
+        return stripes;
+    }
+
+    // Splits a bandwidth limit evenly between the stripes of a transfer.
+    std::uint32_t calculateStripeBps(
+        std::uint32_t serverBps, 
+        std::uint32_t clientBps, 
+        std::size_t stripeCount)
+    {
+        std::uint32_t effectiveBps = calculateEffectiveBps(serverBps, clientBps);
+        if ( effectiveBps )
+        {
+            effectiveBps = RCF_MAX(std::uint32_t(1), effectiveBps / static_cast<std::uint32_t>(stripeCount));
+        }
+        return effectiveBps;
+    }
+
+    // Runs each stripe of a transfer on its own thread, while the calling thread runs progress notifications. If a
+    // stripe fails, or a progress notification cancels the transfer, the other stripes stop after their current 
+    // chunk, and the first error is rethrown once all stripes have stopped.
+    class StripedTransfer
+    {
+    public:
+
+        StripedTransfer(std::uint64_t bytesTransferred, std::uint32_t serverLimitBps) :
+            mBytesTransferred(bytesTransferred),
+            mServerLimitBps(serverLimitBps),
+            mStripesRunning(0),
+            mCancel(false)
+        {
+        }
+
+        void run(
+            std::size_t                                         stripeCount, 
+            std::function<void(std::size_t)>                    stripeTask,
+            std::function<void(std::uint64_t, std::uint32_t)>   progressCb)
+        {
+            mStripesRunning = stripeCount;
+
+            std::vector<ThreadPtr> threads;
+            for ( std::size_t i=0; i<stripeCount; ++i )
+            {
+                threads.push_back( ThreadPtr( new Thread( [this, stripeTask, i]() { runStripe(stripeTask, i); } ) ) );
+            }
+
+            std::exception_ptr progressError;
+            std::uint64_t bytesReported = std::uint64_t(-1);
+
+            Lock lock(mMutex);
+            while ( true )
+            {
+                while ( mStripesRunning > 0 && mBytesTransferred == bytesReported )
+                {
+                    mCondition.wait(lock);
+                }
+
+                bool finished = (mStripesRunning == 0);
+                bytesReported = mBytesTransferred;
+                std::uint32_t serverLimitBps = mServerLimitBps;
+
+                if ( !mCancel )
+                {
+                    lock.unlock();
+                    try
+                    {
+                        progressCb(bytesReported, serverLimitBps);
+                    }
+                    catch ( ... )
+                    {
+                        progressError = std::current_exception();
+                        cancel();
+                    }
+                    lock.lock();
+                }
+
+                if ( finished )
+                {
+                    break;
+                }
+            }
+            lock.unlock();
+
+            for ( ThreadPtr threadPtr : threads )
+            {
+                threadPtr->join();
+            }
+
+            if ( progressError )
+            {
+                std::rethrow_exception(progressError);
+            }
+            if ( mStripeError )
+            {
+                std::rethrow_exception(mStripeError);
+            }
+        }
+
+        void addBytes(std::uint64_t bytes, std::uint32_t serverLimitBps)
+        {
+            Lock lock(mMutex);
+            mBytesTransferred += bytes;
+            mServerLimitBps = serverLimitBps;
+            mCondition.notify_all();
+        }
+
+        bool isCancelled()
+        {
+            Lock lock(mMutex);
+            return mCancel;
+        }
+
+        void cancel()
+        {
+            Lock lock(mMutex);
+            mCancel = true;
+            mCondition.notify_all();
+        }
+
+        // Waits until the calling stripe is the only one still running.
+        void waitForOtherStripes()
+        {
+            Lock lock(mMutex);
+            while ( mStripesRunning > 1 && !mCancel )
+            {
+                mCondition.wait(lock);
+            }
+        }
+
+    private:
+
+        void runStripe(const std::function<void(std::size_t)> & stripeTask, std::size_t stripe)
+        {
+            try
+            {
+                stripeTask(stripe);
+            }
+            catch ( ... )
+            {
+                Lock lock(mMutex);
+                if ( !mStripeError )
+                {
+                    mStripeError = std::current_exception();
+                }
+                mCancel = true;
+            }
+
+            Lock lock(mMutex);
+            --mStripesRunning;
+            mCondition.notify_all();
+        }
+
+        Mutex                       mMutex;
+        Condition                   mCondition;
+        std::uint64_t               mBytesTransferred;
+        std::uint32_t               mServerLimitBps;
+        std::size_t                 mStripesRunning;
+        bool                        mCancel;
+        std::exception_ptr          mStripeError;
+    };
+
+    // Limits the rate of a single stripe, over transfer windows of a fixed length.
+    class StripeThrottle
+    {
+    public:
+
+        StripeThrottle(std::uint32_t transferWindowS) : 
+            mTransferWindowS(transferWindowS), 
+            mWindowBytesSoFar(0)
+        {
+        }
+
+        void onTransfer(std::uint64_t bytes, std::uint32_t bps)
+        {
+            if ( !bps )
+            {
+                return;
+            }
+
+            mWindowBytesSoFar += bytes;
+
+            std::uint64_t windowBytesTotal = std::uint64_t(bps) * mTransferWindowS;
+            if ( mWindowBytesSoFar >= windowBytesTotal )
+            {
+                // Exceeded window capacity. Wait for window to expire.
+                std::uint32_t windowMsSoFar = mWindowTimer.getDurationMs();
+                if ( windowMsSoFar < mTransferWindowS*1000 )
+                {
+                    sleepMs(mTransferWindowS*1000 - windowMsSoFar);
+                }
+
+                // Carry over balance from previous window.
+                mWindowTimer.restart();
+                mWindowBytesSoFar -= windowBytesTotal;
+            }
+            else if ( mWindowTimer.elapsed(mTransferWindowS*1000) )
+            {
+                mWindowTimer.restart();
+                mWindowBytesSoFar = 0;
+            }
+        }
+
+    private:
+
+        std::uint32_t               mTransferWindowS;
+        Timer                       mWindowTimer;
+        std::uint64_t               mWindowBytesSoFar;
+    };
+
+    // The progress of an interrupted striped download is kept alongside the file being downloaded, as the requested
+    // start and end positions, followed by the byte ranges still to be downloaded.
+
+    bool readStripeProgress(
+        const Path &        progressPath, 
+        std::uint64_t       startPosition, 
+        std::uint64_t       endPosition, 
+        ByteRanges &        ranges)
+    {
+        ranges.clear();
+
+        const std::size_t RecordSize = 2*sizeof(std::uint64_t);
+        std::size_t fileSize = static_cast<std::size_t>(fs::file_size(progressPath));
+        if ( fileSize < RecordSize || fileSize % RecordSize != 0 )
+        {
+            return false;
+        }
+
+        ByteBuffer buffer(fileSize);
+        FileHandle fin(progressPath, FileHandle::Read);
+        if ( fin.read(buffer) != fileSize )
+        {
+            return false;
+        }
+
+        std::vector<std::uint64_t> values(fileSize / sizeof(std::uint64_t));
+        memcpy(&values[0], buffer.getPtr(), fileSize);
+        if ( values[0] != startPosition || values[1] != endPosition )
+        {
+            return false;
+        }
+
+        for ( std::size_t i=2; i<values.size(); i+=2 )
+        {
+            if ( values[i] < startPosition || values[i] > values[i+1] || values[i+1] > endPosition )
+            {
+                ranges.clear();
+                return false;
+            }
+            ranges.push_back( ByteRange(values[i], values[i+1]) );
+        }
+        return true;
+    }
+
+    void writeStripeProgress(
+        const Path &                        progressPath, 
+        std::uint64_t                       startPosition, 
+        std::uint64_t                       endPosition, 
+        const std::vector<ByteRanges> &     stripes)
+    {
+        std::vector<std::uint64_t> values;
+        values.push_back(startPosition);
+        values.push_back(endPosition);
+        for ( const ByteRanges & stripe : stripes )
+        {
+            for ( const ByteRange & range : stripe )
+            {
+                if ( range.first < range.second )
+                {
+                    values.push_back(range.first);
+                    values.push_back(range.second);
+                }
+            }
+        }
+
+        // Written to a temporary file first, so an interruption never leaves a partially written record.
+        Path tempPath = progressPath;
+        tempPath += ".tmp";
+
+        ByteBuffer buffer(values.size()*sizeof(std::uint64_t));
+        memcpy(buffer.getPtr(), &values[0], buffer.getLength());
+        {
+            FileHandle fout(tempPath, FileHandle::WriteTruncate);
+            if ( fout.write(buffer) != buffer.getLength() )
+            {
+                Exception e = fout.err();
+                RCF_ASSERT(e.bad());
+                RCF_THROW(e);
+            }
+        }
+        fs::rename(tempPath, progressPath);
+    }
+
+    typedef RcfClient<I_FileTransferService>        FtsClient;
+    typedef std::shared_ptr<FtsClient>              FtsClientPtr;
+
+    void ClientStub::uploadFileStriped(
+        std::string &           uploadId,
+        const FileManifest &    manifest,
+        std::uint32_t           chunkSize,
+        std::uint32_t           transferRateBps,
+        std::uint32_t           connectionCount)
+    {
+        RCF_LOG_3()(uploadId)(chunkSize)(transferRateBps)(connectionCount) 
+            << "ClientStub::uploadFileStriped() - entry.";
+
+        ClientStub & clientStub = *this;
+
+        if (! clientStub.isConnected())
+        {
+            clientStub.connect();
+        }
+
+        FtsClient ftsClient(clientStub);
+        ftsClient.getClientStub().setTransport( clientStub.releaseTransport() );
+
+        RestoreClientTransportGuard guard(clientStub, ftsClient.getClientStub());
+        RCF_UNUSED_VARIABLE(guard);
+
+        // The server returns the byte ranges it has not yet received, which for a resumed upload may be fragmented.
+        std::vector<std::uint64_t>  pendingRanges;
+        std::uint32_t               maxMessageLength    = 0;
+        std::uint32_t               serverBps           = 0;
+
+        ftsClient.BeginStripedUpload(manifest, uploadId, pendingRanges, maxMessageLength, serverBps);
+
+        RCF_LOG_3()(uploadId)(pendingRanges.size())(maxMessageLength)(serverBps) 
+            << "ClientStub::uploadFileStriped() - BeginStripedUpload() returned.";
+
+        // Limit the chunk size to 80 % of max message length.
+        if ( maxMessageLength )
+        {
+            chunkSize = RCF_MIN(chunkSize, maxMessageLength * 8 / 10);
+        }
+
+        ByteRanges ranges;
+        std::uint64_t pendingBytes = 0;
+        for ( std::size_t i=0; i+1<pendingRanges.size(); i+=2 )
+        {
+            ranges.push_back( ByteRange(pendingRanges[i], pendingRanges[i+1]) );
+            pendingBytes += pendingRanges[i+1] - pendingRanges[i];
+        }
+
+        std::vector<ByteRanges> stripes = splitIntoStripes(ranges, connectionCount, chunkSize);
+        std::size_t stripeCount = stripes.size();
+
+        // The first stripe uses this connection, and the others each open their own.
+        std::vector<FtsClientPtr> stripeClients;
+        for ( std::size_t i=1; i<stripeCount; ++i )
+        {
+            stripeClients.push_back( FtsClientPtr( new FtsClient(clientStub) ) );
+        }
+
+        const Path filePath = manifest.mManifestBase / manifest.mFiles[0].mFilePath;
+        const std::uint64_t totalByteSize = manifest.mFiles[0].mFileSize;
+
+        StripedTransfer transfer(totalByteSize - pendingBytes, serverBps);
+
+        auto uploadStripe = [&](std::size_t stripe)
+        {
+            FtsClient & stripeClient = (stripe == 0) ? ftsClient : *stripeClients[stripe-1];
+            std::uint32_t stripeServerBps = serverBps;
+            StripeThrottle throttle(mTransferWindowS);
+
+            FileHandle fin(filePath, FileHandle::Read);
+            ByteBuffer buffer(chunkSize);
+
+            for ( const ByteRange & range : stripes[stripe] )
+            {
+                std::uint64_t filePos = range.first;
+                fin.seek(filePos);
+
+                while ( filePos < range.second && !transfer.isCancelled() )
+                {
+                    std::size_t bytesToRead = static_cast<std::size_t>(
+                        RCF_MIN(std::uint64_t(chunkSize), range.second - filePos));
+
+                    std::size_t bytesRead = fin.read( ByteBuffer(buffer, 0, bytesToRead) );
+                    if ( bytesRead == 0 )
+                    {
+                        Exception e = fin.err();
+                        RCF_ASSERT(e.bad());
+                        RCF_THROW(e);
+                    }
+
+                    std::vector<FileChunk> chunks(1);
+                    chunks[0].mFileIndex = 0;
+                    chunks[0].mOffset = filePos;
+                    chunks[0].mData = ByteBuffer(buffer, 0, bytesRead);
+
+                    RCF_LOG_3()(stripe)(filePos)(bytesRead)
+                        << "ClientStub::uploadFileStriped() - calling UploadStripeChunks().";
+
+                    stripeClient.UploadStripeChunks(uploadId, chunks, stripeServerBps);
+
+                    filePos += bytesRead;
+                    transfer.addBytes(bytesRead, stripeServerBps);
+                    throttle.onTransfer(bytesRead, calculateStripeBps(stripeServerBps, transferRateBps, stripeCount));
+                }
+            }
+        };
+
+        FileTransferProgress progressInfo;
+        progressInfo.mBytesTotalToTransfer = totalByteSize;
+
+        transfer.run(stripeCount, uploadStripe, [&](std::uint64_t bytesSoFar, std::uint32_t serverLimitBps)
+        {
+            progressInfo.mBytesTransferredSoFar = bytesSoFar;
+            progressInfo.mServerLimitBps = serverLimitBps;
+            runFileProgressNotifications(progressInfo);
+        });
+
+        RCF_LOG_3()(uploadId)(totalByteSize)
+            << "ClientStub::uploadFileStriped() - exit.";
+    }
+
+    // Splits a file into literal data, and copies of blocks the server already has, using the block hashes of the 
+    // server's copy. Matching blocks are found at any offset, by rolling the weak checksum through the file one byte
+    // at a time, so data inserted or removed in the middle of the file only costs the affected blocks.
+    class DeltaEncoder
+    {
+    public:
+
+        typedef std::function<void(const FileChunk &)> ChunkCallback;
+
+        DeltaEncoder(const FileBlockHashes & basisHashes, std::size_t maxLiteralSize) : 
+            mBasisHashes(basisHashes),
+            mBlockSize(basisHashes.mBlockSize),
+            mMaxLiteralSize(maxLiteralSize),
+            mTags(TagCount),
+            mBufferPos(0)
+        {
+            // Only whole blocks of the basis file are matched.
+            for ( std::size_t i=0; i<basisHashes.mWeakHashes.size(); ++i )
+            {
+                std::uint32_t weak = basisHashes.mWeakHashes[i];
+                mWeakIndex.push_back( std::make_pair(weak, static_cast<std::uint32_t>(i)) );
+                mTags[getTag(weak)] = true;
+            }
+            std::sort(mWeakIndex.begin(), mWeakIndex.end());
+        }
+
+        // Chunks passed to onChunk refer to the encoder's buffer, and are only valid for the duration of the call.
+        void encode(const Path & filePath, ChunkCallback onChunk)
+        {
+            FileHandle fin(filePath, FileHandle::Read);
+            const std::uint64_t fileSize = fs::file_size(filePath);
+
+            mBuffer.clear();
+            mBufferPos = 0;
+
+            std::uint64_t pos = 0;
+            std::uint64_t literalBegin = 0;
+            bool rolling = false;
+            std::uint32_t s1 = 0;
+            std::uint32_t s2 = 0;
+
+            while ( mWeakIndex.size() > 0 && pos + mBlockSize <= fileSize )
+            {
+                fill(fin, literalBegin, RCF_MIN(pos + mBlockSize + 1, fileSize));
+                const unsigned char * p = reinterpret_cast<const unsigned char *>(&mBuffer[pos - mBufferPos]);
+
+                if ( !rolling )
+                {
+                    s1 = s2 = 0;
+                    for ( std::size_t i=0; i<mBlockSize; ++i )
+                    {
+                        s1 += p[i];
+                        s2 += s1;
+                    }
+                    rolling = true;
+                }
+
+                std::uint32_t basisBlock = 0;
+                std::uint32_t weak = (s1 & 0xFFFF) | (s2 << 16);
+                if ( mTags[getTag(weak)] && findBlock(weak, reinterpret_cast<const char *>(p), basisBlock) )
+                {
+                    emitLiteral(literalBegin, pos, onChunk);
+
+                    FileChunk chunk;
+                    chunk.mOffset = pos;
+                    chunk.mBasisOffset = std::uint64_t(basisBlock) * mBlockSize;
+                    chunk.mBasisLength = mBlockSize;
+                    onChunk(chunk);
+
+                    pos += mBlockSize;
+                    literalBegin = pos;
+                    rolling = false;
+                    continue;
+                }
+
+                // Move the window along by one byte.
+                if ( pos + mBlockSize < fileSize )
+                {
+                    std::uint32_t out = p[0];
+                    std::uint32_t in = p[mBlockSize];
+                    s1 = s1 - out + in;
+                    s2 = s2 - mBlockSize*out + s1;
+                }
+                ++pos;
+
+                if ( pos - literalBegin >= mMaxLiteralSize )
+                {
+                    emitLiteral(literalBegin, pos, onChunk);
+                    literalBegin = pos;
+                }
+            }
+
+            // Whatever is left over is sent as is.
+            while ( literalBegin < fileSize )
+            {
+                std::uint64_t end = RCF_MIN(fileSize, literalBegin + mMaxLiteralSize);
+                fill(fin, literalBegin, end);
+                emitLiteral(literalBegin, end, onChunk);
+                literalBegin = end;
+            }
+        }
+
+    private:
+
+        static const std::size_t TagCount = 64*1024;
+
+        static std::size_t getTag(std::uint32_t weak)
+        {
+            return (weak ^ (weak >> 16)) & (TagCount - 1);
+        }
+
+        bool findBlock(std::uint32_t weak, const char * pch, std::uint32_t & basisBlock)
+        {
+            auto iters = std::equal_range(
+                mWeakIndex.begin(), 
+                mWeakIndex.end(), 
+                std::make_pair(weak, std::uint32_t(0)),
+                [](const std::pair<std::uint32_t, std::uint32_t> & lhs, const std::pair<std::uint32_t, std::uint32_t> & rhs) 
+                { 
+                    return lhs.first < rhs.first; 
+                });
+
+            bool haveStrongHash = false;
+            std::uint64_t strong = 0;
+            for ( auto iter = iters.first; iter != iters.second; ++iter )
+            {
+                if ( !haveStrongHash )
+                {
+                    strong = FileBlockHashes::strongHash(pch, mBlockSize);
+                    haveStrongHash = true;
+                }
+                if ( mBasisHashes.mStrongHashes[iter->second] == strong )
+                {
+                    basisBlock = iter->second;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Makes sure the buffer holds the file contents from keepFrom up to end.
+        void fill(FileHandle & fin, std::uint64_t keepFrom, std::uint64_t end)
+        {
+            std::uint64_t bufferEnd = mBufferPos + mBuffer.size();
+            if ( end <= bufferEnd )
+            {
+                return;
+            }
+
+            RCF_ASSERT(keepFrom >= mBufferPos);
+            mBuffer.erase(mBuffer.begin(), mBuffer.begin() + static_cast<std::size_t>(keepFrom - mBufferPos));
+            mBufferPos = keepFrom;
+
+            // Read ahead in large pieces.
+            const std::size_t ReadSize = 1024*1024;
+            std::size_t bytesToRead = static_cast<std::size_t>( RCF_MAX(end - bufferEnd, std::uint64_t(ReadSize)) );
+            std::size_t oldSize = mBuffer.size();
+            mBuffer.resize(oldSize + bytesToRead);
+
+            std::size_t bytesRead = fin.read( ByteBuffer(&mBuffer[oldSize], bytesToRead) );
+            mBuffer.resize(oldSize + bytesRead);
+            if ( mBufferPos + mBuffer.size() < end )
+            {
+                Exception e = fin.err();
+                if ( !e.bad() )
+                {
+                    e = Exception(RcfError_FileRead, fin.getFilePath().u8string(), "File is shorter than expected");
+                }
+                RCF_THROW(e);
+            }
+        }
+
+        void emitLiteral(std::uint64_t begin, std::uint64_t end, ChunkCallback & onChunk)
+        {
+            while ( begin < end )
+            {
+                std::size_t len = static_cast<std::size_t>( RCF_MIN(end - begin, std::uint64_t(mMaxLiteralSize)) );
+
+                FileChunk chunk;
+                chunk.mOffset = begin;
+                chunk.mData = ByteBuffer(&mBuffer[static_cast<std::size_t>(begin - mBufferPos)], len);
+                onChunk(chunk);
+
+                begin += len;
+            }
+        }
+
+        const FileBlockHashes &                                 mBasisHashes;
+        const std::uint32_t                                     mBlockSize;
+        const std::size_t                                       mMaxLiteralSize;
+
+        std::vector< std::pair<std::uint32_t, std::uint32_t> >  mWeakIndex;
+        std::vector<bool>                                       mTags;
+
+        std::vector<char>                                       mBuffer;
+        std::uint64_t                                           mBufferPos;
+    };
+
+    void ClientStub::uploadFileDelta(
+        std::string &           uploadId,
+        const FileManifest &    manifest,
+        const std::string &     basisId,
+        std::uint32_t           chunkSize,
+        std::uint32_t           transferRateBps)
+    {
+        RCF_LOG_3()(basisId)(chunkSize)(transferRateBps) 
+            << "ClientStub::uploadFileDelta() - entry.";
+
+        ClientStub & clientStub = *this;
+
+        // Copying from the basis file relies on FileChunk fields that are only serialized from runtime version 19.
+        if ( clientStub.getRuntimeVersion() < 19 )
+        {
+            RCF_LOG_2()(clientStub.getRuntimeVersion()) 
+                << "ClientStub::uploadFileDelta() - runtime version too low for delta uploads. Uploading whole file instead.";
+
+            uploadFiles(manifest, uploadId, chunkSize, transferRateBps, 0);
+            return;
+        }
+
+        if (! clientStub.isConnected())
+        {
+            clientStub.connect();
+        }
+
+        FtsClient ftsClient(clientStub);
+        ftsClient.getClientStub().setTransport( clientStub.releaseTransport() );
+
+        RestoreClientTransportGuard guard(clientStub, ftsClient.getClientStub());
+        RCF_UNUSED_VARIABLE(guard);
+
+        auto uploadWholeFile = [&]()
+        {
+            uploadId.clear();
+            ftsClient.getClientStub().uploadFiles(manifest, uploadId, chunkSize, transferRateBps, 0);
+        };
+
+        FileBlockHashes             basisHashes;
+        std::uint32_t               maxMessageLength    = 0;
+        std::uint32_t               serverBps           = 0;
+
+        try
+        {
+            ftsClient.BeginDeltaUpload(manifest, basisId, uploadId, basisHashes, maxMessageLength, serverBps);
+        }
+        catch ( const RemoteException & e )
+        {
+            // Servers from before delta uploads don't have the method at all.
+            if ( e.getErrorId() != RcfError_FnId_Id )
+            {
+                throw;
+            }
+
+            RCF_LOG_2() 
+                << "ClientStub::uploadFileDelta() - server does not support delta uploads. Uploading whole file instead.";
+
+            uploadWholeFile();
+            return;
+        }
+
+        // The runtime version may have been negotiated down by the call. The server drops the delta upload it just 
+        // started, once it has been idle for long enough.
+        if ( ftsClient.getClientStub().getRuntimeVersion() < 19 )
+        {
+            RCF_LOG_2()(uploadId)(ftsClient.getClientStub().getRuntimeVersion()) 
+                << "ClientStub::uploadFileDelta() - runtime version negotiated down. Uploading whole file instead.";
+
+            uploadWholeFile();
+            return;
+        }
+
+        RCF_LOG_3()(uploadId)(basisHashes.mBlockSize)(basisHashes.mStrongHashes.size())(maxMessageLength)(serverBps) 
+            << "ClientStub::uploadFileDelta() - BeginDeltaUpload() returned.";
+
+        // Limit the chunk size to 80 % of max message length.
+        if ( maxMessageLength )
+        {
+            chunkSize = RCF_MIN(chunkSize, maxMessageLength * 8 / 10);
+        }
+
+        const Path filePath = manifest.mManifestBase / manifest.mFiles[0].mFilePath;
+        const std::uint64_t totalByteSize = manifest.mFiles[0].mFileSize;
+
+        // Hashed with the server's block size, so the server can verify the file it puts together.
+        FileBlockHashes fileHashes;
+        fileHashes.compute(filePath, basisHashes.mBlockSize);
+
+        FileTransferProgress progressInfo;
+        progressInfo.mBytesTotalToTransfer = totalByteSize;
+        progressInfo.mBytesTransferredSoFar = 0;
+        progressInfo.mServerLimitBps = serverBps;
+        runFileProgressNotifications(progressInfo);
+
+        StripeThrottle throttle(mTransferWindowS);
+
+        // Block copies are tiny, so they are batched up, and adjacent ones merged, until literal data comes along.
+        const std::size_t MaxCopiesPerCall = 4*1024;
+        const std::uint32_t MaxCopyLength = 1024*1024*1024;
+
+        std::vector<FileChunk> chunks;
+        std::uint64_t literalBytes = 0;
+
+        auto sendChunks = [&]()
+        {
+            if ( chunks.empty() )
+            {
+                return;
+            }
+
+            RCF_LOG_3()(chunks.size())(literalBytes)
+                << "ClientStub::uploadFileDelta() - calling UploadDeltaChunks().";
+
+            ftsClient.UploadDeltaChunks(uploadId, chunks, serverBps);
+
+            const FileChunk & lastChunk = chunks.back();
+            progressInfo.mBytesTransferredSoFar = lastChunk.mOffset + (lastChunk.mBasisLength ? lastChunk.mBasisLength : lastChunk.mData.getLength());
+            progressInfo.mServerLimitBps = serverBps;
+            runFileProgressNotifications(progressInfo);
+
+            throttle.onTransfer(literalBytes, calculateEffectiveBps(serverBps, transferRateBps));
+
+            chunks.clear();
+            literalBytes = 0;
+        };
+
+        DeltaEncoder encoder(basisHashes, chunkSize);
+        encoder.encode(filePath, [&](const FileChunk & chunk)
+        {
+            if ( chunk.mBasisLength )
+            {
+                FileChunk * pPrev = chunks.empty() ? NULL : &chunks.back();
+                if (    pPrev 
+                    &&  pPrev->mBasisLength
+                    &&  pPrev->mBasisOffset + pPrev->mBasisLength == chunk.mBasisOffset
+                    &&  pPrev->mBasisLength <= MaxCopyLength - chunk.mBasisLength )
+                {
+                    pPrev->mBasisLength += chunk.mBasisLength;
+                }
+                else
+                {
+                    chunks.push_back(chunk);
+                }
+
+                if ( chunks.size() >= MaxCopiesPerCall )
+                {
+                    sendChunks();
+                }
+            }
+            else
+            {
+                chunks.push_back(chunk);
+                literalBytes += chunk.mData.getLength();
+                sendChunks();
+            }
+        });
+        sendChunks();
+
+        try
+        {
+            ftsClient.EndDeltaUpload(uploadId, fileHashes.getFileHash());
+        }
+        catch ( const RemoteException & e )
+        {
+            if ( e.getErrorId() != RcfError_DeltaUploadMismatch_Id )
+            {
+                throw;
+            }
+
+            RCF_LOG_2()(uploadId) 
+                << "ClientStub::uploadFileDelta() - delta upload did not match. Uploading whole file instead.";
+
+            uploadWholeFile();
+        }
+
+        RCF_LOG_3()(uploadId)(totalByteSize)
+            << "ClientStub::uploadFileDelta() - exit.";
+    }
+
+    void ClientStub::downloadFileStriped(
+        const std::string &     downloadId,
+        const Path &            downloadToPath,
+        std::uint32_t           chunkSize,
+        std::uint32_t           transferRateBps,
+        std::uint64_t           startPosition,
+        std::uint64_t           endPosition,
+        std::uint32_t           connectionCount)
+    {
+        RCF_LOG_3()(downloadToPath.u8string())(downloadId)(chunkSize)(transferRateBps)(startPosition)(endPosition)(connectionCount)
+            << "ClientStub::downloadFileStriped() - entry.";
+
+        ClientStub & clientStub = *this;
+
+        if (! clientStub.isConnected())
+        {
+            clientStub.connect();
+        }
+
+        FtsClient ftsClient(clientStub);
+        ftsClient.getClientStub().setTransport( clientStub.releaseTransport() );
+
+        RestoreClientTransportGuard guard(clientStub, ftsClient.getClientStub());
+        RCF_UNUSED_VARIABLE(guard);
+
+        FileInfo                    fileInfo;
+        FileTransferRequest         request;
+        std::uint32_t               serverMaxMessageLength = 0;
+        std::uint32_t               serverBps = 0;
+
+        {
+            FileManifest                manifest;
+            std::vector<FileChunk>      chunks;
+
+            ftsClient.BeginDownload(
+                manifest,
+                request,
+                chunks,
+                serverMaxMessageLength,
+                serverBps,
+                0,
+                downloadId);
+
+            fileInfo = manifest.mFiles[0];
+
+            if ( endPosition == std::uint64_t(-1) || endPosition > fileInfo.mFileSize )
+            {
+                endPosition = fileInfo.mFileSize;
+            }
+        }
+
+        std::uint32_t clientMaxMessageLength = static_cast<std::uint32_t>(
+            ftsClient.getClientStub().getTransport().getMaxIncomingMessageLength());
+
+        RCF_LOG_3()(serverMaxMessageLength)(clientMaxMessageLength)(serverBps)
+            << "ClientStub::downloadFileStriped() - BeginDownload() returned.";
+
+        // Adjust chunk size.
+        chunkSize = RCF_MIN(chunkSize, serverMaxMessageLength*8/10);
+        chunkSize = RCF_MIN(chunkSize, clientMaxMessageLength*8/10);
+
+        // Determine file path to download to.
+        Path filePath = downloadToPath;
+        if ( fs::is_directory(filePath) )
+        {
+            // Tack on server-suggested file name.
+            filePath = filePath / fileInfo.mFilePath;
+        }
+        fs::create_directories(filePath.parent_path());
+
+        Path progressPath = filePath;
+        progressPath += ".stripes";
+
+        // Determine the byte ranges still to be downloaded.
+        ByteRanges ranges;
+        bool fileExists = fs::exists(filePath);
+        if ( fileExists && fs::exists(progressPath) )
+        {
+            // Resume an interrupted striped download. If its progress can't be read, start over.
+            if ( !readStripeProgress(progressPath, startPosition, endPosition, ranges) )
+            {
+                ranges.assign( 1, ByteRange(startPosition, endPosition) );
+            }
+        }
+        else
+        {
+            // As for regular downloads, an existing file is taken to be a previously downloaded fragment.
+            std::uint64_t currentPos = startPosition;
+            if ( fileExists )
+            {
+                currentPos = RCF_MIN(currentPos + fs::file_size(filePath), endPosition);
+            }
+            if ( currentPos < endPosition )
+            {
+                ranges.push_back( ByteRange(currentPos, endPosition) );
+            }
+        }
+
+        std::uint64_t pendingBytes = 0;
+        for ( const ByteRange & range : ranges )
+        {
+            pendingBytes += range.second - range.first;
+        }
+
+        // Progress callback.
+        FileTransferProgress progressInfo;
+        progressInfo.mDownloadPath              = filePath;
+        progressInfo.mBytesTotalToTransfer      = endPosition - startPosition;
+        progressInfo.mBytesTransferredSoFar     = endPosition - startPosition - pendingBytes;
+        progressInfo.mServerLimitBps            = serverBps;
+
+        if ( ranges.empty() )
+        {
+            // No downloading needed.
+            if ( !fileExists )
+            {
+                // If it's a zero-length file, we need to create it.
+                FileHandle().open(filePath, FileHandle::WriteTruncate);
+                setLastWriteTime(filePath, fileInfo.mLastWriteTime);
+            }
+
+            runFileProgressNotifications(progressInfo);
+            return;
+        }
+
+        std::vector<ByteRanges> stripes = splitIntoStripes(ranges, connectionCount, chunkSize);
+        std::size_t stripeCount = stripes.size();
+
+        // The first stripe uses this connection, and the others each open their own. Every stripe begins its 
+        // download before any of them finishes, as the server retires the download once its last byte is sent.
+        std::vector<FtsClientPtr> stripeClients;
+        for ( std::size_t i=1; i<stripeCount; ++i )
+        {
+            FtsClientPtr stripeClientPtr( new FtsClient(clientStub) );
+            stripeClientPtr->getClientStub().getTransport().setMaxIncomingMessageLength(clientMaxMessageLength);
+
+            FileManifest                manifest;
+            std::vector<FileChunk>      chunks;
+            std::uint32_t               maxMessageLength = 0;
+            std::uint32_t               bps = 0;
+
+            stripeClientPtr->BeginDownload(manifest, request, chunks, maxMessageLength, bps, 0, downloadId);
+            stripeClients.push_back(stripeClientPtr);
+        }
+
+        Mutex progressMutex;
+        writeStripeProgress(progressPath, startPosition, endPosition, stripes);
+
+        StripedTransfer transfer(progressInfo.mBytesTransferredSoFar, serverBps);
+
+        auto downloadStripe = [&](std::size_t stripe)
+        {
+            FtsClient & stripeClient = (stripe == 0) ? ftsClient : *stripeClients[stripe-1];
+            std::uint32_t stripeServerBps = serverBps;
+            std::uint32_t adviseWaitMs = 0;
+            StripeThrottle throttle(mTransferWindowS);
+
+            FileHandle fout(filePath, FileHandle::WriteInPlace);
+
+            ByteRanges & stripeRanges = stripes[stripe];
+            for ( std::size_t i=0; i<stripeRanges.size() && !transfer.isCancelled(); ++i )
+            {
+                std::uint64_t currentPos = stripeRanges[i].first;
+                const std::uint64_t rangeEnd = stripeRanges[i].second;
+
+                FileChunk startPos;
+                startPos.mOffset = currentPos;
+                stripeClient.TrimDownload(startPos);
+
+                while ( currentPos < rangeEnd && !transfer.isCancelled() )
+                {
+                    FileTransferRequest request;
+                    request.mFile       = 0;
+                    request.mPos        = currentPos;
+                    request.mChunkSize  = static_cast<std::uint32_t>(
+                        RCF_MIN(std::uint64_t(chunkSize), rangeEnd - currentPos));
+
+                    if ( rangeEnd == fileInfo.mFileSize && request.mChunkSize == rangeEnd - currentPos )
+                    {
+                        transfer.waitForOtherStripes();
+                    }
+
+                    // Respect server throttle settings.
+                    if ( adviseWaitMs )
+                    {
+                        sleepMs(adviseWaitMs);
+                        adviseWaitMs = 0;
+                    }
+
+                    RCF_LOG_3()(stripe)(request.mPos)(request.mChunkSize)
+                        << "ClientStub::downloadFileStriped() - calling DownloadChunks().";
+
+                    std::vector<FileChunk> chunks;
+                    stripeClient.DownloadChunks(request, chunks, adviseWaitMs, stripeServerBps);
+                    RCF_ASSERT(chunks.size() == 1);
+
+                    std::size_t bytesReceived = 0;
+                    if ( chunks.size() > 0 && chunks[0].mData.getLength() > 0 )
+                    {
+                        const FileChunk & chunk = chunks[0];
+                        bytesReceived = chunk.mData.getLength();
+
+                        RCF_VERIFY(
+                            chunk.mOffset == currentPos && bytesReceived <= rangeEnd - currentPos,
+                            Exception(RcfError_FileOffset, currentPos, chunk.mOffset));
+
+                        fout.seek(currentPos - startPosition);
+                        if ( fout.write(chunk.mData) != bytesReceived )
+                        {
+                            Exception e = fout.err();
+                            RCF_ASSERT(e.bad());
+                            RCF_THROW(e);
+                        }
+                        fout.flush();
+
+                        currentPos += bytesReceived;
+
+                        Lock lock(progressMutex);
+                        stripeRanges[i].first = currentPos;
+                        writeStripeProgress(progressPath, startPosition, endPosition, stripes);
+                    }
+
+                    transfer.addBytes(bytesReceived, stripeServerBps);
+                    throttle.onTransfer(bytesReceived, calculateStripeBps(0, transferRateBps, stripeCount));
+                }
+            }
+        };
+
+        transfer.run(stripeCount, downloadStripe, [&](std::uint64_t bytesSoFar, std::uint32_t serverLimitBps)
+        {
+            progressInfo.mBytesTransferredSoFar = bytesSoFar;
+            progressInfo.mServerLimitBps = serverLimitBps;
+            runFileProgressNotifications(progressInfo);
+        });
+
+        setLastWriteTime(filePath, fileInfo.mLastWriteTime);
+        fs::remove(progressPath);
+
+        RCF_LOG_3()
+            << "ClientStub::downloadFileStriped() - exit.";
+    }
 } // namespace RCF
@@ -83,12 +83,25 @@ namespace RCF {
 
     namespace fs = RCF_FILESYSTEM_NS;
 
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 4355 ) // warning C4355: 'this' : used in base member initializer list
+#endif
+
     FileTransferService::FileTransferService() :
             mUploadDirectory(),
-            mTransferWindowS(5)            
+            mTransferWindowS(5),
+            mUploadIdleTimeoutS(10*60),
+            mPeriodicTimer(*this, 0),
+            mDownloadMemoryMapping(false),
+            mFileIoQueueDepth(1)
     {
     }
 
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
     namespace fs = RCF_FILESYSTEM_NS;
 
     void FileTransferService::checkForUploadCompletion(FileUploadInfoPtr uploadInfoPtr)
@@ -155,7 +168,7 @@ namespace RCF {
             mUploadQuotaCallback(RCF::getCurrentRcfSession()) : 
             mUploadQuota;
 
-        FileUploadInfoPtr uploadInfoPtr( new FileUploadInfo(quotaPtr) );
+        FileUploadInfoPtr uploadInfoPtr( new FileUploadInfo(quotaPtr, mFileIoThreadPoolPtr) );
         uploadInfoPtr->mManifest = manifest;
         uploadInfoPtr->mTimeStampMs = RCF::getCurrentTimeMs();
         uploadInfoPtr->mSessionLocalId = sessionLocalId;
@@ -321,26 +334,25 @@ namespace RCF {
 
         FileHandlePtr fout = uploadInfoPtr->mFileHandle;
 
-        // Wait for previous write to complete.
+        // Wait for previous writes to complete. Up to mFileIoQueueDepth writes are left in progress behind the client.
         if (uploadInfo.mWriteOp->isInitiated())
         {
-            uploadInfo.mWriteOp->complete();
-
-            std::uint64_t bytesWritten = uploadInfo.mWriteOp->getBytesTransferred();
-            if (bytesWritten == 0)
+            uploadInfo.mWriteOp->waitForPendingWrites(mFileIoQueueDepth - 1);
+            if (uploadInfo.mWriteOp->isCompleted())
             {
-                Exception e = fout->err();
-                fout->close();
-                RCF_ASSERT(e.bad());
-                RCF_THROW(e);
+                completeUploadWrites(uploadInfo);
             }
         }
 
         // Initiate next write.
 
 
-        // Check the offset position.
-        uploadInfo.mCurrentPos = fout->tell();
+        // Check the offset position. While writes are in progress, the file position is still moving, so we rely 
+        // on our own record of it.
+        if (!uploadInfo.mWriteOp->isInitiated())
+        {
+            uploadInfo.mCurrentPos = fout->tell();
+        }
         if (chunk.mOffset != uploadInfo.mCurrentPos)
         {
             RCF_THROW( Exception(RcfError_FileOffset, uploadInfo.mCurrentPos, chunk.mOffset) );
@@ -365,7 +377,7 @@ namespace RCF {
             RCF_LOG_3()(uploadInfo.mCurrentFile) 
                 << "FileTransferService::UploadChunks() - closing file.";
 
-            uploadInfo.mWriteOp->complete();
+            completeUploadWrites(uploadInfo);
             fout->close();
 
             // Rename to drop the ".tmp" extension.
@@ -387,6 +399,558 @@ namespace RCF {
         RCF_LOG_3() << "FileTransferService::UploadChunks() - exit.";
     }
 
+    void FileTransferService::BeginStripedUpload(
+        const FileManifest & manifest,
+        std::string & uploadId,
+        std::vector<std::uint64_t> & pendingRanges,
+        std::uint32_t & maxMessageLength,
+        std::uint32_t & bps)
+    {
+        RCF_LOG_3()(uploadId) << "FileTransferService::BeginStripedUpload() - entry.";
+
+        if ( manifest.mFiles.size() != 1 )
+        {
+            Exception e("Striped uploads require a manifest with exactly one file.");
+            RCF_THROW(e);
+        }
+
+        NetworkSession & networkSession = getTlsRcfSession().getNetworkSession();
+        maxMessageLength = (std::uint32_t) networkSession.getServerTransport().getMaxIncomingMessageLength();
+
+        // Resume the upload if it is already in progress.
+        FileUploadInfoPtr uploadInfoPtr;
+        if ( uploadId.size() > 0 )
+        {
+            uploadInfoPtr = findFileTransfer(uploadId).mStripedUploadPtr;
+            if ( uploadInfoPtr && uploadInfoPtr->mManifest.mFiles[0].mFileSize != manifest.mFiles[0].mFileSize )
+            {
+                RCF_THROW( Exception(RcfError_UploadFileSize) );
+            }
+        }
+
+        if ( !uploadInfoPtr )
+        {
+            if ( mUploadDirectory.empty() )
+            {
+                RCF_THROW(Exception(RcfError_UploadDirectory));
+            }
+
+            RCF::BandwidthQuotaPtr quotaPtr = mUploadQuotaCallback ? 
+                mUploadQuotaCallback(RCF::getCurrentRcfSession()) : 
+                mUploadQuota;
+
+            uploadInfoPtr.reset( new FileUploadInfo(quotaPtr, mFileIoThreadPoolPtr) );
+            uploadInfoPtr->mManifest = manifest;
+            uploadInfoPtr->mUploadId = generateUuid();
+
+            Path uploadTempPath;
+            Path finalPath;
+            getFilePathsForUpload(mUploadDirectory, uploadInfoPtr->mUploadId, manifest, uploadTempPath, finalPath);
+            uploadInfoPtr->mFinalFilePath = finalPath;
+            uploadInfoPtr->mUploadDir = finalPath;
+
+            if ( !fs::exists(uploadTempPath.parent_path()) )
+            {
+                fs::create_directories(uploadTempPath.parent_path());
+            }
+
+            RCF_LOG_3()(uploadTempPath.u8string())
+                << "FileTransferService::BeginStripedUpload() - opening file.";
+
+            uploadInfoPtr->mFileHandle->open(uploadTempPath, FileHandle::WriteInPlace);
+
+            std::uint64_t fileSize = manifest.mFiles[0].mFileSize;
+            if ( fileSize > 0 )
+            {
+                uploadInfoPtr->mPendingRanges[0] = fileSize;
+            }
+
+            TransferInfo info;
+            info.mPath = finalPath;
+            info.mStripedUploadPtr = uploadInfoPtr;
+            addFileTransfer(uploadInfoPtr->mUploadId, info);
+        }
+
+        FileUploadInfo & uploadInfo = *uploadInfoPtr;
+        uploadId = uploadInfo.mUploadId;
+
+        {
+            Lock lock(uploadInfo.mStripeMutex);
+
+            if ( uploadInfo.mExpired )
+            {
+                RCF_THROW( Exception(RcfError_NoUpload) );
+            }
+
+            pendingRanges.clear();
+            for ( auto & range : uploadInfo.mPendingRanges )
+            {
+                pendingRanges.push_back(range.first);
+                pendingRanges.push_back(range.second);
+            }
+
+            uploadInfo.mCurrentPos = uploadInfo.mManifest.mFiles[0].mFileSize - uploadInfo.getPendingBytes();
+            uploadInfo.mTimeStampMs = RCF::getCurrentTimeMs();
+
+            if ( uploadInfo.mPendingRanges.empty() && !uploadInfo.mCompleted )
+            {
+                completeStripedUpload(uploadInfo);
+            }
+        }
+
+        bps = uploadInfo.mQuotaPtr->calculateLineSpeedLimit();
+
+        if (mUploadProgressCb)
+        {
+            mUploadProgressCb(getCurrentRcfSession(), uploadInfo);
+        }
+
+        RCF_LOG_3()(uploadId)(pendingRanges.size())(maxMessageLength)(bps)
+            << "FileTransferService::BeginStripedUpload() - exit.";
+    }
+
+    void FileTransferService::UploadStripeChunks(
+        const std::string & uploadId,
+        const std::vector<FileChunk> & chunks,
+        std::uint32_t & bps)
+    {
+        RCF_LOG_3()(uploadId)(chunks.size()) 
+            << "FileTransferService::UploadStripeChunks() - entry.";
+
+        FileUploadInfoPtr uploadInfoPtr = findFileTransfer(uploadId).mStripedUploadPtr;
+        if ( !uploadInfoPtr )
+        {
+            RCF_THROW( Exception(RcfError_NoUpload) );
+        }
+
+        FileUploadInfo & uploadInfo = *uploadInfoPtr;
+        bps = uploadInfo.mQuotaPtr->calculateLineSpeedLimit();
+
+        {
+            Lock lock(uploadInfo.mStripeMutex);
+
+            if ( uploadInfo.mExpired )
+            {
+                RCF_THROW( Exception(RcfError_NoUpload) );
+            }
+
+            if ( uploadInfo.mCompleted )
+            {
+                RCF_THROW( Exception(RcfError_UploadAlreadyCompleted) );
+            }
+
+            const FileInfo & file = uploadInfo.mManifest.mFiles[0];
+            FileHandlePtr fout = uploadInfo.mFileHandle;
+
+            for ( const FileChunk & chunk : chunks )
+            {
+                if ( chunk.mFileIndex != 0 )
+                {
+                    RCF_THROW( Exception(RcfError_FileIndex, 0, chunk.mFileIndex) );
+                }
+
+                std::uint64_t chunkLength = chunk.mData.getLength();
+                if ( chunk.mOffset > file.mFileSize || chunkLength > file.mFileSize - chunk.mOffset )
+                {
+                    RCF_THROW( Exception(RcfError_UploadFileSize) );
+                }
+
+                // Chunks from different connections can arrive in any order, so each one is written in place.
+                fout->seek(chunk.mOffset);
+                if ( fout->write(chunk.mData) != chunkLength )
+                {
+                    Exception e = fout->err();
+                    RCF_ASSERT(e.bad());
+                    RCF_THROW(e);
+                }
+
+                uploadInfo.removePendingRange(chunk.mOffset, chunk.mOffset + chunkLength);
+            }
+
+            uploadInfo.mCurrentPos = file.mFileSize - uploadInfo.getPendingBytes();
+            uploadInfo.mTimeStampMs = RCF::getCurrentTimeMs();
+
+            if ( uploadInfo.mPendingRanges.empty() )
+            {
+                completeStripedUpload(uploadInfo);
+            }
+        }
+
+        if (mUploadProgressCb)
+        {
+            mUploadProgressCb(getCurrentRcfSession(), uploadInfo);
+        }
+
+        RCF_LOG_3() << "FileTransferService::UploadStripeChunks() - exit.";
+    }
+
+    void FileTransferService::completeStripedUpload(FileUploadInfo & uploadInfo)
+    {
+        RCF_LOG_3()(uploadInfo.mUploadId) 
+            << "FileTransferService - striped upload completed.";
+
+        FileHandlePtr fout = uploadInfo.mFileHandle;
+        Path filePath = fout->getFilePath();
+        fout->close();
+
+        // Rename to drop the ".tmp" extension.
+        fs::rename(filePath, uploadInfo.mFinalFilePath);
+        setLastWriteTime(uploadInfo.mFinalFilePath, uploadInfo.mManifest.mFiles[0].mLastWriteTime);
+
+        uploadInfo.mCurrentFile = 1;
+        uploadInfo.mCurrentPos = 0;
+        uploadInfo.mCompleted = true;
+
+        removeFileTransfer(uploadInfo.mUploadId);
+    }
+
+    // Called with the upload's stripe mutex held.
+    void FileTransferService::expireUpload(FileUploadInfo & uploadInfo)
+    {
+        RCF_LOG_2()(uploadInfo.mUploadId) 
+            << "FileTransferService - expiring idle upload.";
+
+        removeFileTransfer(uploadInfo.mUploadId);
+
+        FileHandlePtr fout = uploadInfo.mFileHandle;
+        Path filePath = fout->getFilePath();
+        fout->close();
+        if ( uploadInfo.mBasisHandle )
+        {
+            uploadInfo.mBasisHandle->close();
+        }
+
+        uploadInfo.mExpired = true;
+
+        // Best effort only.
+        try
+        {
+            if ( !filePath.empty() )
+            {
+                fs::remove(filePath);
+            }
+        }
+        catch ( const std::exception & e )
+        {
+            RCF_LOG_1()(uploadInfo.mUploadId)(filePath.u8string())(e.what()) 
+                << "FileTransferService - could not remove expired upload.";
+        }
+    }
+
+    void FileTransferService::onTimer()
+    {
+        std::uint32_t nowMs = getCurrentTimeMs();
+        std::uint32_t idleTimeoutMs = 1000*mUploadIdleTimeoutS;
+
+        std::vector<FileUploadInfoPtr> candidates;
+        {
+            Lock lock(mFileTransfersInProgressMutex);
+            for ( auto & transfer : mFileTransfersInProgress )
+            {
+                if ( transfer.second.mStripedUploadPtr )
+                {
+                    candidates.push_back(transfer.second.mStripedUploadPtr);
+                }
+                else if ( transfer.second.mDeltaUploadPtr )
+                {
+                    candidates.push_back(transfer.second.mDeltaUploadPtr);
+                }
+            }
+        }
+
+        // The stripe mutex is taken before the transfer map mutex, as when an upload completes.
+        for ( FileUploadInfoPtr uploadInfoPtr : candidates )
+        {
+            FileUploadInfo & uploadInfo = *uploadInfoPtr;
+            Lock lock(uploadInfo.mStripeMutex);
+            if (    !uploadInfo.mCompleted 
+                &&  !uploadInfo.mExpired 
+                &&  nowMs - uploadInfo.mTimeStampMs > idleTimeoutMs )
+            {
+                expireUpload(uploadInfo);
+            }
+        }
+    }
+
+    // Delta upload blocks are sized so that the block hashes of even a very large file fit comfortably in a single 
+    // message.
+    std::uint32_t getDeltaBlockSize(std::uint64_t fileSize)
+    {
+        const std::uint64_t MinBlockSize = 4*1024;
+        const std::uint64_t MaxBlockCount = 32*1024;
+
+        std::uint64_t blockSize = (fileSize + MaxBlockCount - 1) / MaxBlockCount;
+        blockSize = (blockSize + 1023) / 1024 * 1024;
+        return static_cast<std::uint32_t>( RCF_MAX(blockSize, MinBlockSize) );
+    }
+
+    Path FileTransferService::findUploadBasis(const std::string & basisId)
+    {
+        if (basisId.empty())
+        {
+            return Path();
+        }
+
+        if (mUploadBasisCb)
+        {
+            return mUploadBasisCb(getCurrentRcfSession(), basisId);
+        }
+
+        // The basis id comes from the client, and must not be able to reach outside the upload directory.
+        for (char ch : basisId)
+        {
+            if (!isalnum(static_cast<unsigned char>(ch)) && ch != '-')
+            {
+                RCF_THROW( Exception(RcfError_CouldNotFindUpload, basisId) );
+            }
+        }
+
+        // A completed upload, without the ".tmp" extension.
+        std::string lookFor = basisId + ".";
+        if (!mUploadDirectory.empty() && fs::exists(mUploadDirectory))
+        {
+            for ( const Path & p : fs::directory_iterator(mUploadDirectory) )
+            {
+                std::string fileName = p.filename().u8string();
+                if (    fileName.find(lookFor) == 0 
+                    &&  p.extension() != ".tmp"
+                    &&  fs::is_regular_file(p))
+                {
+                    return p;
+                }
+            }
+        }
+
+        return Path();
+    }
+
+    void FileTransferService::BeginDeltaUpload(
+        const FileManifest & manifest,
+        const std::string & basisId,
+        std::string & uploadId,
+        FileBlockHashes & basisHashes,
+        std::uint32_t & maxMessageLength,
+        std::uint32_t & bps)
+    {
+        RCF_LOG_3()(basisId) << "FileTransferService::BeginDeltaUpload() - entry.";
+
+        if ( manifest.mFiles.size() != 1 )
+        {
+            Exception e("Delta uploads require a manifest with exactly one file.");
+            RCF_THROW(e);
+        }
+
+        if ( mUploadDirectory.empty() )
+        {
+            RCF_THROW(Exception(RcfError_UploadDirectory));
+        }
+
+        NetworkSession & networkSession = getTlsRcfSession().getNetworkSession();
+        maxMessageLength = (std::uint32_t) networkSession.getServerTransport().getMaxIncomingMessageLength();
+
+        Path basisPath = findUploadBasis(basisId);
+        if ( !basisPath.empty() && !fs::is_regular_file(basisPath) )
+        {
+            basisPath.clear();
+        }
+
+        RCF::BandwidthQuotaPtr quotaPtr = mUploadQuotaCallback ? 
+            mUploadQuotaCallback(RCF::getCurrentRcfSession()) : 
+            mUploadQuota;
+
+        FileUploadInfoPtr uploadInfoPtr( new FileUploadInfo(quotaPtr, mFileIoThreadPoolPtr) );
+        FileUploadInfo & uploadInfo = *uploadInfoPtr;
+        uploadInfo.mManifest = manifest;
+        uploadInfo.mUploadId = generateUuid();
+        uploadInfo.mTimeStampMs = RCF::getCurrentTimeMs();
+
+        Path uploadTempPath;
+        Path finalPath;
+        getFilePathsForUpload(mUploadDirectory, uploadInfo.mUploadId, manifest, uploadTempPath, finalPath);
+        uploadInfo.mFinalFilePath = finalPath;
+        uploadInfo.mUploadDir = finalPath;
+
+        if ( !fs::exists(uploadTempPath.parent_path()) )
+        {
+            fs::create_directories(uploadTempPath.parent_path());
+        }
+
+        RCF_LOG_3()(uploadTempPath.u8string())(basisPath.u8string())
+            << "FileTransferService::BeginDeltaUpload() - opening file.";
+
+        uploadInfo.mFileHandle->open(uploadTempPath, FileHandle::WriteTruncate);
+
+        // The block size is chosen here, so both sides use the same one to verify the upload.
+        basisHashes = FileBlockHashes();
+        std::uint64_t basisSize = basisPath.empty() ? 0 : fs::file_size(basisPath);
+        uploadInfo.mDeltaBlockSize = getDeltaBlockSize( RCF_MAX(basisSize, manifest.mFiles[0].mFileSize) );
+        basisHashes.mBlockSize = uploadInfo.mDeltaBlockSize;
+        if ( !basisPath.empty() )
+        {
+            basisHashes.compute(basisPath, uploadInfo.mDeltaBlockSize);
+            uploadInfo.mBasisPath = basisPath;
+            uploadInfo.mBasisSize = basisSize;
+        }
+
+        TransferInfo info;
+        info.mPath = finalPath;
+        info.mDeltaUploadPtr = uploadInfoPtr;
+        addFileTransfer(uploadInfo.mUploadId, info);
+
+        uploadId = uploadInfo.mUploadId;
+        bps = uploadInfo.mQuotaPtr->calculateLineSpeedLimit();
+
+        if (mUploadProgressCb)
+        {
+            mUploadProgressCb(getCurrentRcfSession(), uploadInfo);
+        }
+
+        RCF_LOG_3()(uploadId)(basisHashes.mBlockSize)(basisHashes.mStrongHashes.size())(maxMessageLength)(bps)
+            << "FileTransferService::BeginDeltaUpload() - exit.";
+    }
+
+    void FileTransferService::UploadDeltaChunks(
+        const std::string & uploadId,
+        const std::vector<FileChunk> & chunks,
+        std::uint32_t & bps)
+    {
+        RCF_LOG_3()(uploadId)(chunks.size()) 
+            << "FileTransferService::UploadDeltaChunks() - entry.";
+
+        FileUploadInfoPtr uploadInfoPtr = findFileTransfer(uploadId).mDeltaUploadPtr;
+        if ( !uploadInfoPtr )
+        {
+            RCF_THROW( Exception(RcfError_NoUpload) );
+        }
+
+        FileUploadInfo & uploadInfo = *uploadInfoPtr;
+        bps = uploadInfo.mQuotaPtr->calculateLineSpeedLimit();
+
+        {
+            Lock lock(uploadInfo.mStripeMutex);
+
+            if ( uploadInfo.mExpired )
+            {
+                RCF_THROW( Exception(RcfError_NoUpload) );
+            }
+
+            if ( uploadInfo.mCompleted )
+            {
+                RCF_THROW( Exception(RcfError_UploadAlreadyCompleted) );
+            }
+
+            const FileInfo & file = uploadInfo.mManifest.mFiles[0];
+            FileHandlePtr fout = uploadInfo.mFileHandle;
+
+            for ( const FileChunk & chunk : chunks )
+            {
+                if ( chunk.mFileIndex != 0 )
+                {
+                    RCF_THROW( Exception(RcfError_FileIndex, 0, chunk.mFileIndex) );
+                }
+
+                if ( chunk.mOffset != uploadInfo.mCurrentPos )
+                {
+                    RCF_THROW( Exception(RcfError_FileOffset, uploadInfo.mCurrentPos, chunk.mOffset) );
+                }
+
+                std::uint64_t chunkLength = chunk.mBasisLength ? chunk.mBasisLength : chunk.mData.getLength();
+                if ( chunkLength > file.mFileSize - uploadInfo.mCurrentPos )
+                {
+                    RCF_THROW( Exception(RcfError_UploadFileSize) );
+                }
+
+                if ( chunk.mBasisLength )
+                {
+                    uploadInfo.copyFromBasis(chunk.mBasisOffset, chunk.mBasisLength);
+                }
+                else if ( fout->write(chunk.mData) != chunkLength )
+                {
+                    Exception e = fout->err();
+                    RCF_ASSERT(e.bad());
+                    RCF_THROW(e);
+                }
+
+                uploadInfo.mCurrentPos += chunkLength;
+            }
+
+            uploadInfo.mTimeStampMs = RCF::getCurrentTimeMs();
+        }
+
+        if (mUploadProgressCb)
+        {
+            mUploadProgressCb(getCurrentRcfSession(), uploadInfo);
+        }
+
+        RCF_LOG_3() << "FileTransferService::UploadDeltaChunks() - exit.";
+    }
+
+    void FileTransferService::EndDeltaUpload(
+        const std::string & uploadId,
+        std::uint64_t fileHash)
+    {
+        RCF_LOG_3()(uploadId) << "FileTransferService::EndDeltaUpload() - entry.";
+
+        FileUploadInfoPtr uploadInfoPtr = findFileTransfer(uploadId).mDeltaUploadPtr;
+        if ( !uploadInfoPtr )
+        {
+            RCF_THROW( Exception(RcfError_NoUpload) );
+        }
+
+        FileUploadInfo & uploadInfo = *uploadInfoPtr;
+        Lock lock(uploadInfo.mStripeMutex);
+
+        if ( uploadInfo.mExpired )
+        {
+            RCF_THROW( Exception(RcfError_NoUpload) );
+        }
+
+        if ( uploadInfo.mCompleted )
+        {
+            RCF_THROW( Exception(RcfError_UploadAlreadyCompleted) );
+        }
+
+        const FileInfo & file = uploadInfo.mManifest.mFiles[0];
+        if ( uploadInfo.mCurrentPos != file.mFileSize )
+        {
+            RCF_THROW( Exception(RcfError_UploadFileSize) );
+        }
+
+        FileHandlePtr fout = uploadInfo.mFileHandle;
+        Path filePath = fout->getFilePath();
+        fout->close();
+        if ( uploadInfo.mBasisHandle )
+        {
+            uploadInfo.mBasisHandle->close();
+        }
+
+        // Verify the reconstructed file. The basis file may have changed since its hashes were sent, or a block may
+        // have matched only by hash collision. Either way, the client then uploads the whole file instead.
+        FileBlockHashes hashes;
+        hashes.compute(filePath, uploadInfo.mDeltaBlockSize);
+        if ( hashes.getFileHash() != fileHash )
+        {
+            RCF_LOG_1()(uploadId)(filePath.u8string()) 
+                << "FileTransferService::EndDeltaUpload() - uploaded file does not match.";
+
+            removeFileTransfer(uploadInfo.mUploadId);
+            fs::remove(filePath);
+            RCF_THROW( Exception(RcfError_DeltaUploadMismatch, filePath.u8string()) );
+        }
+
+        // Rename to drop the ".tmp" extension.
+        fs::rename(filePath, uploadInfo.mFinalFilePath);
+        setLastWriteTime(uploadInfo.mFinalFilePath, file.mLastWriteTime);
+
+        uploadInfo.mCurrentFile = 1;
+        uploadInfo.mCurrentPos = 0;
+        uploadInfo.mCompleted = true;
+
+        removeFileTransfer(uploadInfo.mUploadId);
+
+        RCF_LOG_3()(uploadId) << "FileTransferService::EndDeltaUpload() - exit.";
+    }
+
     namespace fs = RCF_FILESYSTEM_NS;
 
     void FileTransferService::addFileTransfer(const std::string & transferId, const TransferInfo & transferInfo)
@@ -444,7 +1008,7 @@ namespace RCF {
             
             if ( sessionLocalId )
             {
-                downloadInfoPtr.reset(new FileDownloadInfo(quotaPtr));
+                downloadInfoPtr.reset(new FileDownloadInfo(quotaPtr, mFileIoThreadPoolPtr));
                 FileStream & fs = session.mSessionDownloads[sessionLocalId];
                 downloadInfoPtr->mManifest = fs.mImplPtr->mManifest;
             }
@@ -456,7 +1020,7 @@ namespace RCF {
                 {
                     quotaPtr = info.mBandwidthQuotaPtr;
                 }
-                downloadInfoPtr.reset(new FileDownloadInfo(quotaPtr));
+                downloadInfoPtr.reset(new FileDownloadInfo(quotaPtr, mFileIoThreadPoolPtr));
                 downloadInfoPtr->mManifest.mManifestBase = downloadPath.parent_path();
                 FileInfo fileInfo;
                 fileInfo.mFilePath = downloadPath.filename();
@@ -528,6 +1092,13 @@ namespace RCF {
             RCF_ASSERT(startPos.mOffset == 0);
         }
 
+        // Discard anything read ahead from the previous position.
+        if (di.mReadOp->isInitiated())
+        {
+            di.mReadOp->complete();
+        }
+        di.mSendBufferRemaining = ByteBuffer();
+
         di.mCurrentFile = startPos.mFileIndex;
         di.mCurrentPos = startPos.mOffset;
         di.mResume = true;
@@ -629,8 +1200,8 @@ namespace RCF {
 
         FileInfo & currentFileInfo = di.mManifest.mFiles[di.mCurrentFile];
 
-        // Initial open of file.
-        if (di.mCurrentPos == 0 || di.mResume)
+        // Initial open of file. Memory mapped downloads map the file as they go.
+        if (!mDownloadMemoryMapping && (di.mCurrentPos == 0 || di.mResume))
         {
             di.mResume = false;
 
@@ -687,7 +1258,13 @@ namespace RCF {
         ByteBuffer byteBuffer;
         FileHandlePtr fin = di.mFileHandle;
 
-        if (di.mSendBufferRemaining)
+        if (mDownloadMemoryMapping)
+        {
+            // The chunk refers directly into the mapped file, and is sent without being copied.
+            byteBuffer = mapDownloadChunk(di, static_cast<std::size_t>( 
+                RCF_MIN(bytesRemainingInChunk, bytesRemainingInFile) ));
+        }
+        else if (di.mSendBufferRemaining)
         {
             // Asynchronously read data available.
             std::size_t bytesToRead = RCF_MIN(
@@ -728,6 +1305,9 @@ namespace RCF {
                 << "FileTransferService::DownloadChunks() - closing file.";
 
             fin->close();
+#ifndef RCF_WINDOWS
+            di.mMappingPtr.reset();
+#endif
             ++di.mCurrentFile;
             di.mCurrentPos = 0;
         }
@@ -762,6 +1342,7 @@ namespace RCF {
 
         // Initiate read for next chunk.
         if (    diPtr.get()
+            &&  !mDownloadMemoryMapping
             &&  di.mSendBufferRemaining.isEmpty()
             &&  di.mCurrentFile < di.mManifest.mFiles.size()
             &&  0 < di.mCurrentPos
@@ -775,8 +1356,10 @@ namespace RCF {
                     RCF_ASSERT(di.mSendBuffer.isEmpty());
                     RCF_ASSERT(di.mSendBufferRemaining.isEmpty());
 
-                    di.mReadBuffer = ByteBuffer(request.mChunkSize);
-                    di.mSendBuffer = ByteBuffer(request.mChunkSize);
+                    // Read ahead by mFileIoQueueDepth chunks at a time.
+                    std::size_t readAheadSize = static_cast<std::size_t>(request.mChunkSize) * mFileIoQueueDepth;
+                    di.mReadBuffer = ByteBuffer(readAheadSize);
+                    di.mSendBuffer = ByteBuffer(readAheadSize);
                 }
 
                 std::size_t bytesToRead = static_cast<std::size_t>(
@@ -801,6 +1384,70 @@ namespace RCF {
             << "FileTransferService::DownloadChunks() - exit.";
     }
 
+    void FileTransferService::completeUploadWrites(FileUploadInfo & uploadInfo)
+    {
+        FileIoRequest & writeOp = *uploadInfo.mWriteOp;
+        writeOp.complete();
+        if (writeOp.getBytesTransferred() < writeOp.getBytesRequested())
+        {
+            Exception e = uploadInfo.mFileHandle->err();
+            uploadInfo.mFileHandle->close();
+            RCF_ASSERT(e.bad());
+            RCF_THROW(e);
+        }
+    }
+
+    ByteBuffer FileTransferService::mapDownloadChunk(FileDownloadInfo & di, std::size_t chunkSize)
+    {
+#ifndef RCF_WINDOWS
+
+        if (chunkSize == 0)
+        {
+            return ByteBuffer();
+        }
+
+        // The file is mapped in windows spanning many chunks. A window is unmapped once the download has moved past 
+        // it, and the last chunk referring to it has been sent.
+        const std::size_t WindowSize = 64*1024*1024;
+
+        FileMappingPtr mappingPtr = di.mMappingPtr;
+        if (    !mappingPtr
+            ||  di.mCurrentPos < mappingPtr->getOffset()
+            ||  di.mCurrentPos + chunkSize > mappingPtr->getOffset() + mappingPtr->getLength())
+        {
+            const FileInfo & fileInfo = di.mManifest.mFiles[di.mCurrentFile];
+            Path filePath = di.mDownloadPath / fileInfo.mFilePath;
+
+            std::size_t windowLength = static_cast<std::size_t>( RCF_MIN(
+                fileInfo.mFileSize - di.mCurrentPos, 
+                std::uint64_t( RCF_MAX(WindowSize, chunkSize) )) );
+
+            // Reading a mapping beyond the end of the file is fatal, so check the file hasn't been truncated.
+            if (fs::file_size(filePath) < di.mCurrentPos + windowLength)
+            {
+                RCF_THROW( Exception(RcfError_FileRead, filePath.u8string(), "File has been truncated") );
+            }
+
+            RCF_LOG_3()(di.mCurrentFile)(di.mCurrentPos)(windowLength)(filePath.u8string())
+                << "FileTransferService::DownloadChunks() - mapping file.";
+
+            mappingPtr.reset( new FileMapping(filePath, di.mCurrentPos, windowLength) );
+            di.mMappingPtr = mappingPtr;
+        }
+
+        char * pch = mappingPtr->getPtr() + (di.mCurrentPos - mappingPtr->getOffset());
+        return ByteBuffer(pch, chunkSize, mappingPtr, true);
+
+#else
+
+        RCF_UNUSED_VARIABLE(di);
+        RCF_UNUSED_VARIABLE(chunkSize);
+        RCF_ASSERT_ALWAYS("Memory mapped downloads are not supported on this platform.");
+        return ByteBuffer();
+
+#endif
+    }
+
     void FileTransferService::onServerStart(RcfServer & server)
     {
         mUploadDirectory = server.getUploadDirectory();
@@ -814,11 +1461,34 @@ namespace RCF {
         mDownloadProgressCb = server.mOnFileDownloadProgress;
         mUploadProgressCb = server.mOnFileUploadProgress;
 
+#ifndef RCF_WINDOWS
+        mDownloadMemoryMapping = server.mFileDownloadMemoryMapping;
+#endif
+
+        mUploadBasisCb = server.mFileUploadBasisCb;
+
+        // Transfers in progress keep their own reference to the thread pool.
+        mFileIoThreadPoolPtr.reset();
+        if (server.mFileIoThreadCount > 0)
+        {
+            mFileIoThreadPoolPtr.reset( new FileIoThreadPool(server.mFileIoThreadCount) );
+        }
+        mFileIoQueueDepth = server.mFileIoQueueDepth;
+
+        mUploadIdleTimeoutS = server.mFileUploadIdleTimeoutS;
+        if (mUploadIdleTimeoutS)
+        {
+            mPeriodicTimer.setIntervalMs(1000*RCF_MAX(mTransferWindowS, std::uint32_t(1)));
+            mPeriodicTimer.start();
+        }
+
         server.bind<I_FileTransferService>(*this);
     }
 
     void FileTransferService::onServerStop(RcfServer & server)
     {
+        mPeriodicTimer.stop();
+
         server.unbind<I_FileTransferService>();
     }
 
@@ -830,12 +1500,128 @@ namespace RCF {
 
     }
 
-    FileChunk::FileChunk() : mFileIndex(0), mOffset(0)
+    FileChunk::FileChunk() : mFileIndex(0), mOffset(0), mBasisOffset(0), mBasisLength(0)
     {}
 
     FileTransferRequest::FileTransferRequest() : mFile(0), mPos(0), mChunkSize(0)
     {}
 
+    FileBlockHashes::FileBlockHashes() : mBlockSize(0), mFileSize(0)
+    {}
+
+    void FileBlockHashes::compute(const Path & filePath, std::uint32_t blockSize)
+    {
+        RCF_ASSERT(blockSize > 0);
+
+        mBlockSize = blockSize;
+        mFileSize = fs::file_size(filePath);
+        mWeakHashes.clear();
+        mStrongHashes.clear();
+        mWeakHashes.reserve( static_cast<std::size_t>(mFileSize / blockSize) );
+        mStrongHashes.reserve( static_cast<std::size_t>((mFileSize + blockSize - 1) / blockSize) );
+
+        // Read several blocks at a time.
+        std::size_t blocksPerRead = RCF_MAX(std::size_t(1), std::size_t(4*1024*1024) / blockSize);
+        ByteBuffer buffer(blocksPerRead * blockSize);
+
+        FileHandle fin(filePath, FileHandle::Read);
+        std::uint64_t pos = 0;
+        while (pos < mFileSize)
+        {
+            std::size_t bytesToRead = static_cast<std::size_t>(
+                RCF_MIN(std::uint64_t(buffer.getLength()), mFileSize - pos));
+
+            std::size_t bytesRead = fin.read( ByteBuffer(buffer, 0, bytesToRead) );
+            if (bytesRead != bytesToRead)
+            {
+                RCF_THROW( Exception(RcfError_FileRead, filePath.u8string(), "File is shorter than expected") );
+            }
+
+            for (std::size_t offset = 0; offset < bytesRead; offset += blockSize)
+            {
+                const char * pch = buffer.getPtr() + offset;
+                std::size_t len = RCF_MIN(std::size_t(blockSize), bytesRead - offset);
+                if (len == blockSize)
+                {
+                    mWeakHashes.push_back( weakChecksum(pch, len) );
+                }
+                mStrongHashes.push_back( strongHash(pch, len) );
+            }
+
+            pos += bytesRead;
+        }
+    }
+
+    std::uint64_t FileBlockHashes::getFileHash() const
+    {
+        // Byte order is fixed, so client and server agree regardless of platform.
+        std::vector<char> bytes(mStrongHashes.size() * 8);
+        for (std::size_t i=0; i<mStrongHashes.size(); ++i)
+        {
+            for (std::size_t j=0; j<8; ++j)
+            {
+                bytes[8*i + j] = static_cast<char>( mStrongHashes[i] >> (8*j) );
+            }
+        }
+        return strongHash(bytes.empty() ? "" : &bytes[0], bytes.size()) ^ mFileSize;
+    }
+
+    // The rolling checksum from rsync. The low 16 bits are the sum of the bytes, and the high 16 bits the sum of 
+    // those partial sums, so a window can be moved along by one byte in constant time.
+    std::uint32_t FileBlockHashes::weakChecksum(const char * pch, std::size_t len)
+    {
+        std::uint32_t s1 = 0;
+        std::uint32_t s2 = 0;
+        for (std::size_t i=0; i<len; ++i)
+        {
+            s1 += static_cast<unsigned char>(pch[i]);
+            s2 += s1;
+        }
+        return (s1 & 0xFFFF) | (s2 << 16);
+    }
+
+    // MurmurHash64A, with byte order independent loads.
+    std::uint64_t FileBlockHashes::strongHash(const char * pch, std::size_t len)
+    {
+        const std::uint64_t m = 0xc6a4a7935bd1e995ULL;
+        const int r = 47;
+
+        const unsigned char * p = reinterpret_cast<const unsigned char *>(pch);
+        std::uint64_t h = 0x5243465f44454c54ULL ^ (std::uint64_t(len) * m);
+
+        std::size_t words = len / 8;
+        for (std::size_t i=0; i<words; ++i, p += 8)
+        {
+            std::uint64_t k = 
+                    std::uint64_t(p[0])         | (std::uint64_t(p[1]) << 8) 
+                |   (std::uint64_t(p[2]) << 16) | (std::uint64_t(p[3]) << 24)
+                |   (std::uint64_t(p[4]) << 32) | (std::uint64_t(p[5]) << 40)
+                |   (std::uint64_t(p[6]) << 48) | (std::uint64_t(p[7]) << 56);
+
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+
+            h ^= k;
+            h *= m;
+        }
+
+        std::size_t tail = len & 7;
+        if (tail)
+        {
+            for (std::size_t i=0; i<tail; ++i)
+            {
+                h ^= std::uint64_t(p[i]) << (8*i);
+            }
+            h *= m;
+        }
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+
 #if RCF_FEATURE_SF==1
 
     void FileManifest::serialize(SF::Archive & ar) 
@@ -870,6 +1656,16 @@ namespace RCF {
     void FileChunk::serialize(SF::Archive & ar)
     {
         ar & mFileIndex & mOffset & mData;
+
+        if (ar.getRuntimeVersion() >= 19)
+        {
+            ar & mBasisOffset & mBasisLength;
+        }
+    }
+
+    void FileBlockHashes::serialize(SF::Archive & ar)
+    {
+        ar & mBlockSize & mFileSize & mWeakHashes & mStrongHashes;
     }
 
     void FileTransferRequest::serialize(SF::Archive & ar)
@@ -925,22 +1721,31 @@ namespace RCF {
         return totalByteSize;
     }
 
-    FileUploadInfo::FileUploadInfo(BandwidthQuotaPtr quotaPtr) : 
+    FileUploadInfo::FileUploadInfo(BandwidthQuotaPtr quotaPtr, FileIoThreadPoolPtr fileIoThreadPoolPtr) : 
         mFileHandle( new FileHandle() ),
-        mWriteOp( new FileIoRequest() ),
+        mFileIoThreadPoolPtr(fileIoThreadPoolPtr),
+        mWriteOp( fileIoThreadPoolPtr ? new FileIoRequest(*fileIoThreadPoolPtr) : new FileIoRequest() ),
         mCompleted(false),
         mResume(false),
+        mExpired(false),
         mTimeStampMs(0),
         mCurrentFile(0),
         mCurrentPos(0),
         mSessionLocalId(0),
-        mQuotaPtr(quotaPtr)
+        mQuotaPtr(quotaPtr),
+        mDeltaBlockSize(0),
+        mBasisSize(0)
     {
         mQuotaPtr->addUpload(this);
     }
 
     FileUploadInfo::~FileUploadInfo()
     {
+        // Let queued writes finish before closing the file.
+        if (mWriteOp->isInitiated())
+        {
+            mWriteOp->complete();
+        }
         mFileHandle->close();
 
         mQuotaPtr->removeUpload(this);
@@ -968,9 +1773,99 @@ namespace RCF {
         return mUploadId;
     }
 
-    FileDownloadInfo::FileDownloadInfo(BandwidthQuotaPtr quotaPtr) :
+    void FileUploadInfo::removePendingRange(std::uint64_t begin, std::uint64_t end)
+    {
+        // Start from the last range beginning at or before begin, as it may overlap.
+        auto iter = mPendingRanges.upper_bound(begin);
+        if ( iter != mPendingRanges.begin() )
+        {
+            --iter;
+        }
+
+        while ( iter != mPendingRanges.end() && iter->first < end )
+        {
+            std::uint64_t rangeBegin = iter->first;
+            std::uint64_t rangeEnd = iter->second;
+            if ( rangeEnd <= begin )
+            {
+                ++iter;
+                continue;
+            }
+
+            iter = mPendingRanges.erase(iter);
+            if ( rangeBegin < begin )
+            {
+                mPendingRanges[rangeBegin] = begin;
+            }
+            if ( end < rangeEnd )
+            {
+                mPendingRanges[end] = rangeEnd;
+            }
+        }
+    }
+
+    void FileUploadInfo::copyFromBasis(std::uint64_t basisOffset, std::uint32_t length)
+    {
+        if ( mBasisPath.empty() )
+        {
+            RCF_THROW( Exception(RcfError_FileOpen, mFinalFilePath.u8string(), "No basis file for delta upload") );
+        }
+
+        if ( !mBasisHandle )
+        {
+            mBasisHandle.reset( new FileHandle(mBasisPath, FileHandle::Read) );
+        }
+
+        // Check the whole range before writing anything, so a bad range can't leave part of a copy in the file.
+        if ( basisOffset > mBasisSize || length > mBasisSize - basisOffset )
+        {
+            RCF_THROW( Exception(RcfError_FileRead, mBasisPath.u8string(), "Copy range is beyond the end of the file") );
+        }
+
+        mBasisHandle->seek(basisOffset);
+
+        // The basis file may still shrink underneath us. If so, rewind, so the next chunk is written in place.
+        const std::uint64_t startPos = mFileHandle->tell();
+
+        ByteBuffer buffer( RCF_MIN(std::size_t(length), std::size_t(1024*1024)) );
+        std::uint64_t bytesRemaining = length;
+        while ( bytesRemaining > 0 )
+        {
+            std::size_t bytesToCopy = static_cast<std::size_t>( 
+                RCF_MIN(std::uint64_t(buffer.getLength()), bytesRemaining) );
+
+            ByteBuffer data(buffer, 0, bytesToCopy);
+            if ( mBasisHandle->read(data) != bytesToCopy )
+            {
+                mFileHandle->seek(startPos);
+                RCF_THROW( Exception(RcfError_FileRead, mBasisPath.u8string(), "File is shorter than expected") );
+            }
+
+            if ( mFileHandle->write(data) != bytesToCopy )
+            {
+                Exception e = mFileHandle->err();
+                RCF_ASSERT(e.bad());
+                RCF_THROW(e);
+            }
+
+            bytesRemaining -= bytesToCopy;
+        }
+    }
+
+    std::uint64_t FileUploadInfo::getPendingBytes() const
+    {
+        std::uint64_t pendingBytes = 0;
+        for ( auto & range : mPendingRanges )
+        {
+            pendingBytes += range.second - range.first;
+        }
+        return pendingBytes;
+    }
+
+    FileDownloadInfo::FileDownloadInfo(BandwidthQuotaPtr quotaPtr, FileIoThreadPoolPtr fileIoThreadPoolPtr) :
         mFileHandle( new FileHandle() ),
-        mReadOp( new FileIoRequest() ),
+        mFileIoThreadPoolPtr(fileIoThreadPoolPtr),
+        mReadOp( fileIoThreadPoolPtr ? new FileIoRequest(*fileIoThreadPoolPtr) : new FileIoRequest() ),
         mCurrentFile(0),
         mCurrentPos(0),
         mResume(false),
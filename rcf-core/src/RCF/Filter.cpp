@@ -22,6 +22,7 @@
 #include <RCF/ClientStub.hpp>
 #include <RCF/Exception.hpp>
 #include <RCF/InitDeinit.hpp>
+#include <RCF/ObjectPool.hpp>
 #include <RCF/ThreadLocalData.hpp>
 #include <RCF/Tools.hpp>
 
@@ -295,29 +296,44 @@ namespace RCF {
         std::size_t unfilteredDataLen,
         const std::vector<FilterPtr> &filters)
     {
-        ThreadLocalCached< std::vector<ByteBuffer> > tlcUnfilteredByteBuffers;
-        std::vector<ByteBuffer> &unfilteredByteBuffers = tlcUnfilteredByteBuffers.get();
+        // The unfiltered length is known up front, so have the filters write straight into a single buffer, 
+        // rather than returning buffers of their own that would then need to be copied together.
 
-        bool ret = unfilterData(
-            filteredByteBuffer,
-            unfilteredByteBuffers,
-            unfilteredDataLen,
-            filters);
+        std::size_t bytesTransferredTotal = 0;
 
-        if (unfilteredByteBuffers.empty())
-        {
-            unfilteredByteBuffer = ByteBuffer();
-        }
-        else if (unfilteredByteBuffers.size() == 1)
-        {
-            unfilteredByteBuffer = unfilteredByteBuffers[0];
-        }
-        else
+        ReallocBufferPtr bufferPtr = getObjectPool().getReallocBufferPtr(unfilteredDataLen);
+        bufferPtr->resize(unfilteredDataLen);
+        ByteBuffer byteBuffer(bufferPtr);
+
+        ReadProxy readProxy;
+        readProxy.setInByteBuffer(filteredByteBuffer);
+        readProxy.setPreFilter(*filters.back());
+        filters.back()->setPostFilter(readProxy);
+        filters.front()->setPreFilter(readProxy);
+
+        while (bytesTransferredTotal < unfilteredDataLen)
         {
-            // TODO: maybe check for adjacent buffers, in which case one should not need to make a copy
-            copyByteBuffers(unfilteredByteBuffers, unfilteredByteBuffer);
+            filters.front()->read(
+                ByteBuffer(byteBuffer, bytesTransferredTotal), 
+                unfilteredDataLen - bytesTransferredTotal);
+
+            std::size_t bytesTransferred = readProxy.getOutBytesTransferred();
+            ByteBuffer outByteBuffer = readProxy.getOutByteBuffer();
+            if (bytesTransferred == 0)
+            {
+                break;
+            }
+
+            // Filters should have used our buffer, but may have returned one of their own.
+            if (outByteBuffer.getPtr() != byteBuffer.getPtr() + bytesTransferredTotal)
+            {
+                memcpy(byteBuffer.getPtr() + bytesTransferredTotal, outByteBuffer.getPtr(), bytesTransferred);
+            }
+            bytesTransferredTotal += bytesTransferred;
         }
-        return ret;
+
+        unfilteredByteBuffer = ByteBuffer(byteBuffer, 0, bytesTransferredTotal);
+        return bytesTransferredTotal == unfilteredDataLen;
     }
 
     void connectFilters(const std::vector<FilterPtr> &filters)
@@ -337,6 +353,8 @@ namespace RCF {
 
 } // namespace RCF
 
+#include <RCF/CompressionFilter.hpp>
+
 #if RCF_FEATURE_ZLIB==1
 #include <RCF/ZlibCompressionFilter.hpp>
 #endif
@@ -358,7 +376,12 @@ namespace RCF {
         filters.clear();
     
         // Setup compression if configured.
-        if (mEnableCompression)
+        if (mEnableCompression && mCompressionAlgorithm == Ca_Lz4)
+        {
+            FilterPtr filterPtr( new Lz4CompressionFilter() );
+            filters.push_back(filterPtr);
+        }
+        else if (mEnableCompression)
         {
 #if RCF_FEATURE_ZLIB==1
             FilterPtr filterPtr( new ZlibStatefulCompressionFilter() );
@@ -125,7 +125,9 @@ namespace RCF {
         FilterPtr filterPtr;
         if (filters->size() > 0)
         {
-            if ( (*filters)[0]->getFilterId() == RcfFilter_ZlibCompressionStateful )
+            int filterId = (*filters)[0]->getFilterId();
+            if (    filterId == RcfFilter_ZlibCompressionStateful 
+                ||  filterId == RcfFilter_Lz4CompressionStateful )
             {
                 session.mEnableCompression = true;
                 if (filters->size() > 1)
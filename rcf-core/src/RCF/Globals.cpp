@@ -36,7 +36,9 @@ namespace RCF {
         mpZlibDll(NULL),
         mpOpenSslDll(NULL),
         mpOpenSslCryptoDll(NULL),
-        mSimultaneousPublishLimit(100)
+        mpOpenSslContextCache(NULL),
+        mSimultaneousPublishLimit(100),
+        mZeroCopySendThreshold(0)
     {
 
 #ifdef RCF_WINDOWS
@@ -59,6 +61,8 @@ namespace RCF {
     Globals::~Globals()
     {
         releaseZlibDll();
+        // Cached contexts and sessions have to be freed before the OpenSSL DLL's are unloaded.
+        releaseOpenSslContextCache();
         releaseOpenSslCryptoDll();
         releaseOpenSslDll();
     }
@@ -144,6 +148,11 @@ namespace RCF {
         RCF_ASSERT(!mpOpenSslCryptoDll);
     }
 
+    void Globals::releaseOpenSslContextCache()
+    {
+        RCF_ASSERT(!mpOpenSslContextCache);
+    }
+
 #endif
 
     void Globals::setSimultaneousPublishLimit(std::size_t simultaneousPublishLimit)
@@ -156,6 +165,16 @@ namespace RCF {
         return mSimultaneousPublishLimit;
     }
 
+    void Globals::setZeroCopySendThreshold(std::size_t zeroCopySendThreshold)
+    {
+        mZeroCopySendThreshold = zeroCopySendThreshold;
+    }
+
+    std::size_t Globals::getZeroCopySendThreshold() const
+    {
+        return mZeroCopySendThreshold;
+    }
+
     void Globals::setFileStreamDefaultDownloadDirectory(const std::string & downloadDirectory)
     {
         mFileStreamDefaultDownloadDirectory = downloadDirectory;
@@ -224,15 +224,31 @@ namespace RCF  {
             mOrigBytesRequested = bytesRequested;
 
             // If we already have bytes available for the next frame, move those bytes to 
-            // the front of the buffer.
+            // the front of the buffer. If the previous frame is still referenced further up 
+            // the filter chain, move them to a new buffer instead.
             if ( mBytesReceived > mHttpMessage.mFrameLen && mReadBufferPtr )
             {
-                std::memmove(&(*mReadBufferPtr)[0], &(*mReadBufferPtr)[mHttpMessage.mFrameLen], mBytesReceived - mHttpMessage.mFrameLen);
-                mReadBufferPtr->resize(mBytesReceived - mHttpMessage.mFrameLen);
+                std::size_t bytesRemaining = mBytesReceived - mHttpMessage.mFrameLen;
+                if ( !mReadBufferPtr.unique() )
+                {
+                    ReallocBufferPtr readBufferPtr = getObjectPool().getReallocBufferPtr(bytesRemaining);
+                    readBufferPtr->resize(bytesRemaining);
+                    memcpy(&(*readBufferPtr)[0], &(*mReadBufferPtr)[mHttpMessage.mFrameLen], bytesRemaining);
+                    mReadBufferPtr = readBufferPtr;
+                }
+                else
+                {
+                    std::memmove(&(*mReadBufferPtr)[0], &(*mReadBufferPtr)[mHttpMessage.mFrameLen], bytesRemaining);
+                    mReadBufferPtr->resize(bytesRemaining);
+                }
                 mBytesReceived = mReadBufferPtr->size();
             }
             else
             {
+                if ( mReadBufferPtr && !mReadBufferPtr.unique() )
+                {
+                    mReadBufferPtr.reset();
+                }
                 mBytesReceived = 0;
             }
 
@@ -262,20 +278,24 @@ namespace RCF  {
         }
         else
         {
-            // Return bytes from currently loaded frame.
+            // Return bytes from currently loaded frame. If the caller hasn't supplied a buffer, 
+            // return a slice of our own buffer. It is not modified again until the next frame, 
+            // and then only if nothing else holds a reference to it.
             std::size_t bytesToReturn = RCF_MIN(bytesAvailableInCurrentFrame, bytesRequested);
-            ByteBuffer byteBuffer_ = byteBuffer;
-            if ( byteBuffer_.isEmpty() )
+            ByteBuffer byteBuffer_;
+            if ( byteBuffer.isEmpty() )
+            {
+                byteBuffer_ = ByteBuffer(ByteBuffer(mReadBufferPtr), mReadPos, bytesToReturn);
+            }
+            else
             {
-                ReallocBufferPtr reallocBuffer = getObjectPool().getReallocBufferPtr();
-                reallocBuffer->resize(bytesToReturn);
-                byteBuffer_ = ByteBuffer(reallocBuffer);
+                bytesToReturn = RCF_MIN(bytesToReturn, byteBuffer.getLength());
+                memcpy(byteBuffer.getPtr(), &(*mReadBufferPtr)[mReadPos], bytesToReturn);
+                byteBuffer_ = ByteBuffer(byteBuffer, 0, bytesToReturn);
             }
-            bytesToReturn = RCF_MIN(bytesToReturn, byteBuffer_.getLength());
-            memcpy(byteBuffer_.getPtr(), &(*mReadBufferPtr)[mReadPos], bytesToReturn);
             mReadPos += bytesToReturn;
             mRecursionStateRead.clear();
-            mpPreFilter->onReadCompleted(ByteBuffer(byteBuffer_, 0, bytesToReturn));
+            mpPreFilter->onReadCompleted(byteBuffer_);
         }
     }
 
@@ -45,6 +45,7 @@ namespace RCF {
     void initTpHandlerCache();
     void initWinsock();
     void initRegistrySingleton();
+    void initSerializationThreadPool();
     void initLogManager();
     void initPfnGetUserName();
 
@@ -58,6 +59,7 @@ namespace RCF {
     void deinitTpHandlerCache();
     void deinitWinsock();
     void deinitOpenSsl();
+    void deinitSerializationThreadPool();
     void deinitRegistrySingleton();
     void deinitLogManager();
     void deinitPfnGetUserName();
@@ -87,6 +89,7 @@ namespace RCF {
             initPerformanceData();
             initThreadLocalData();
             initTpHandlerCache();
+            initSerializationThreadPool();
 
 
 #if RCF_FEATURE_FILETRANSFER==1
@@ -147,6 +150,8 @@ namespace RCF {
 #if RCF_FEATURE_FILETRANSFER==1
             deinitFileIoThreadPool();
 #endif
+
+            deinitSerializationThreadPool();
             
 
 #ifdef RCF_WINDOWS
@@ -23,10 +23,12 @@
 #include <functional>
 
 #include <RCF/AmiThreadPool.hpp>
+#include <RCF/ByteOrdering.hpp>
 #include <RCF/ClientProgress.hpp>
 #include <RCF/Endpoint.hpp>
 #include <RCF/Filter.hpp>
 #include <RCF/Future.hpp>
+#include <RCF/Globals.hpp>
 #include <RCF/InitDeinit.hpp>
 #include <RCF/OverlappedAmi.hpp>
 #include <RCF/RcfServer.hpp>
@@ -61,6 +63,50 @@ namespace RCF {
         return serializeOverride(out, *pu);
     }
 
+    std::size_t getArraySizeHint(std::size_t bytes)
+    {
+        // Arrays at or above the zero copy send threshold are inserted into the message rather than copied, if they 
+        // don't need reordering. See SF::writeRawOrInsert().
+        std::size_t threshold = globals().getZeroCopySendThreshold();
+        if (threshold != 0 && bytes >= threshold && machineOrderEqualsNetworkOrder())
+        {
+            return 0;
+        }
+        return bytes;
+    }
+
+    // FNV-1a, over the type names of the method signature.
+    std::uint32_t computeSfSchemaHash(const std::type_info * const * types, std::size_t count)
+    {
+        std::uint32_t hash = 2166136261u;
+        for (std::size_t i=0; i<count; ++i)
+        {
+            const char * pch = types[i]->name();
+            for (; *pch; ++pch)
+            {
+                hash = (hash ^ static_cast<std::uint8_t>(*pch)) * 16777619u;
+            }
+            hash = (hash ^ static_cast<std::uint8_t>(';')) * 16777619u;
+        }
+        return hash;
+    }
+
+    void writeSfSchemaHash(SerializationProtocolOut &out, std::uint32_t hash)
+    {
+        serialize(out, hash);
+    }
+
+    void verifySfSchemaHash(SerializationProtocolIn &in, std::uint32_t hash)
+    {
+        std::uint32_t remoteHash = 0;
+        deserialize(in, remoteHash);
+        if (remoteHash != hash)
+        {
+            Exception e(RcfError_SfSchemaMismatch, hash, remoteHash);
+            RCF_THROW(e);
+        }
+    }
+
     bool deserializeOverride(SerializationProtocolIn &in, ByteBuffer & u)
     {
         int runtimeVersion = in.getRuntimeVersion();
@@ -117,6 +163,18 @@ namespace RCF {
         int fnId, 
         RCF::RemoteCallMode rcs)
     {
+        // Schema-fixed serialization is signaled in the request header, from runtime version 17.
+        bool enableSfSchemaFixed = 
+                mEnableSfSchemaFixed
+            &&  getSerializationProtocol() == Sp_SfBinary
+            &&  getRuntimeVersion() >= 17;
+
+        // Parallel serialization, from runtime version 18.
+        std::uint32_t parallelSerializationThreshold = 
+                getSerializationProtocol() == Sp_SfBinary && getRuntimeVersion() >= 18 ?
+                    mParallelSerializationThreshold : 
+                    0;
+
         mRequest.init(
             getServerBindingName(),
             fnId,
@@ -128,7 +186,9 @@ namespace RCF {
             mPingBackIntervalMs,
             mArchiveVersion,
             mEnableSfPointerTracking,
-            mEnableNativeWstringSerialization);
+            mEnableNativeWstringSerialization,
+            enableSfSchemaFixed,
+            parallelSerializationThreshold);
 
         ::RCF::CurrentClientStubSentry sentry(*this);
 
@@ -138,7 +198,10 @@ namespace RCF {
             mRequest.encodeRequestHeader(),
             mRuntimeVersion,
             mArchiveVersion,
-            mEnableSfPointerTracking);
+            mEnableSfPointerTracking,
+            enableSfSchemaFixed);
+
+        mOut.setParallelSerializationThreshold(parallelSerializationThreshold);
 
         bool asyncParameters = false;
         mpParameters->write(mOut);
@@ -570,12 +633,19 @@ namespace RCF {
 
         mEncodedByteBuffer.clear();
 
+        // Exceptions are always serialized with node headers.
         mIn.reset(
             unfilteredByteBuffer,
             mOut.getSerializationProtocol(),
             mRuntimeVersion,
             mArchiveVersion,
-            response.getEnableSfPointerTracking());
+            response.getEnableSfPointerTracking(),
+            mRequest.mEnableSfSchemaFixed && !response.isException());
+
+        if (!response.isException())
+        {
+            mIn.setParallelSerializationThreshold(mRequest.mParallelSerializationThreshold);
+        }
 
         RCF_LOG_3()(this)(response) << "RcfClient - received response.";
 
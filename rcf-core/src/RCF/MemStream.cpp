@@ -122,6 +122,41 @@ namespace RCF {
         return ch;
     }
 
+    char * MemOstreamBuf::reserveWrite(std::size_t len)
+    {
+        if (static_cast<std::size_t>(epptr() - pptr()) < len)
+        {
+            std::size_t nextPos = pptr() - pbase();
+            grow( RCF_MAX(2*mWriteBuffer.size(), nextPos + len) );
+        }
+
+        char * pch = pptr();
+        pbump( static_cast<int>(len) );
+        return pch;
+    }
+
+    void MemOstreamBuf::reserve(std::size_t len)
+    {
+        if (static_cast<std::size_t>(epptr() - pptr()) < len)
+        {
+            std::size_t nextPos = pptr() - pbase();
+            grow(nextPos + len);
+        }
+    }
+
+    void MemOstreamBuf::grow(std::size_t newSize)
+    {
+        std::size_t nextPos = pptr() - pbase();
+
+        mWriteBuffer.resize(newSize);
+
+        setp( 
+            &mWriteBuffer[0],
+            &mWriteBuffer[0] + mWriteBuffer.size());
+
+        pbump( static_cast<int>(nextPos) );
+    }
+
     MemOstreamBuf::pos_type MemOstreamBuf::seekoff(
         MemOstreamBuf::off_type offset, 
         std::ios_base::seekdir dir,
@@ -386,6 +421,16 @@ namespace RCF {
         return mpBuf->mWriteBuffer.capacity();
     }
 
+    char * MemOstream::reserveWrite(std::size_t len)
+    {
+        return mpBuf->reserveWrite(len);
+    }
+
+    void MemOstream::reserve(std::size_t len)
+    {
+        mpBuf->reserve(len);
+    }
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable: 4995) // 'sprintf': name was marked as #pragma deprecated
@@ -125,7 +125,9 @@ namespace RCF {
         std::uint32_t           pingBackIntervalMs,
         int                     archiveVersion,
         bool                    enableSfPointerTracking,
-        bool                    enableNativeWstringSerialization)
+        bool                    enableNativeWstringSerialization,
+        bool                    enableSfSchemaFixed,
+        std::uint32_t           parallelSerializationThreshold)
     {
         mService                            = service;
         mFnId                               = fnId;
@@ -138,6 +140,8 @@ namespace RCF {
         mArchiveVersion                     = archiveVersion;
         mEnableSfPointerTracking            = enableSfPointerTracking;
         mEnableNativeWstringSerialization   = enableNativeWstringSerialization;
+        mEnableSfSchemaFixed                = enableSfSchemaFixed;
+        mParallelSerializationThreshold     = parallelSerializationThreshold;
     }
 
     void MethodInvocationRequest::init(
@@ -161,7 +165,9 @@ namespace RCF {
             rhs.mPingBackIntervalMs, 
             rhs.mArchiveVersion, 
             rhs.mEnableSfPointerTracking,
-            rhs.mEnableNativeWstringSerialization);
+            rhs.mEnableNativeWstringSerialization,
+            rhs.mEnableSfSchemaFixed,
+            rhs.mParallelSerializationThreshold);
     }
 
     int MethodInvocationRequest::getFnId() const
@@ -227,12 +233,14 @@ namespace RCF {
 
         // For backwards compatibility.
         mEnableSfPointerTracking = true;
+        mEnableSfSchemaFixed = false;
+        mParallelSerializationThreshold = 0;
 
         SF::decodeInt(msgId, buffer, pos);
         RCF_VERIFY(msgId == Descriptor_Request, Exception(RcfError_Decoding));
         SF::decodeInt(messageVersion, buffer, pos);
             
-        if (messageVersion > 7)
+        if (messageVersion > 9)
         {
             return false;
         }
@@ -309,6 +317,31 @@ namespace RCF {
             SF::decodeBool(mEnableSfPointerTracking, buffer, pos);
             SF::decodeByteBuffer(mOutOfBandRequest, buffer, pos);
         }
+        else if (messageVersion == 8)
+        {
+            SF::decodeInt(mRuntimeVersion, buffer, pos);
+            SF::decodeBool(ignoreRuntimeVersion, buffer, pos);
+            SF::decodeInt(mPingBackIntervalMs, buffer, pos);
+            SF::decodeInt(mArchiveVersion, buffer, pos);
+            SF::decodeByteBuffer(mRequestUserData, buffer, pos);
+            SF::decodeBool(mEnableNativeWstringSerialization, buffer, pos);
+            SF::decodeBool(mEnableSfPointerTracking, buffer, pos);
+            SF::decodeByteBuffer(mOutOfBandRequest, buffer, pos);
+            SF::decodeBool(mEnableSfSchemaFixed, buffer, pos);
+        }
+        else if (messageVersion == 9)
+        {
+            SF::decodeInt(mRuntimeVersion, buffer, pos);
+            SF::decodeBool(ignoreRuntimeVersion, buffer, pos);
+            SF::decodeInt(mPingBackIntervalMs, buffer, pos);
+            SF::decodeInt(mArchiveVersion, buffer, pos);
+            SF::decodeByteBuffer(mRequestUserData, buffer, pos);
+            SF::decodeBool(mEnableNativeWstringSerialization, buffer, pos);
+            SF::decodeBool(mEnableSfPointerTracking, buffer, pos);
+            SF::decodeByteBuffer(mOutOfBandRequest, buffer, pos);
+            SF::decodeBool(mEnableSfSchemaFixed, buffer, pos);
+            SF::decodeInt(mParallelSerializationThreshold, buffer, pos);
+        }
             
         RCF_UNUSED_VARIABLE(tokenId);
 
@@ -442,10 +475,18 @@ namespace RCF {
         {
             messageVersion = 6;
         }
-        else
+        else if (runtimeVersion <= 16)
         {
             messageVersion = 7;
         }
+        else if (runtimeVersion == 17)
+        {
+            messageVersion = 8;
+        }
+        else
+        {
+            messageVersion = 9;
+        }
 
         std::size_t pos = 0;
         SF::encodeInt(Descriptor_Request, *mVecPtr, pos);
@@ -517,6 +558,31 @@ namespace RCF {
             SF::encodeBool(mEnableSfPointerTracking, *mVecPtr, pos);
             SF::encodeByteBuffer(mOutOfBandRequest, *mVecPtr, pos);
         }
+        else if (messageVersion == 8)
+        {
+            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
+            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
+            SF::encodeInt(mArchiveVersion, *mVecPtr, pos);
+            SF::encodeByteBuffer(mRequestUserData, *mVecPtr, pos);
+            SF::encodeBool(mEnableNativeWstringSerialization, *mVecPtr, pos);
+            SF::encodeBool(mEnableSfPointerTracking, *mVecPtr, pos);
+            SF::encodeByteBuffer(mOutOfBandRequest, *mVecPtr, pos);
+            SF::encodeBool(mEnableSfSchemaFixed, *mVecPtr, pos);
+        }
+        else if (messageVersion == 9)
+        {
+            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
+            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
+            SF::encodeInt(mArchiveVersion, *mVecPtr, pos);
+            SF::encodeByteBuffer(mRequestUserData, *mVecPtr, pos);
+            SF::encodeBool(mEnableNativeWstringSerialization, *mVecPtr, pos);
+            SF::encodeBool(mEnableSfPointerTracking, *mVecPtr, pos);
+            SF::encodeByteBuffer(mOutOfBandRequest, *mVecPtr, pos);
+            SF::encodeBool(mEnableSfSchemaFixed, *mVecPtr, pos);
+            SF::encodeInt(mParallelSerializationThreshold, *mVecPtr, pos);
+        }
 
         mVecPtr->resize(pos);
 
@@ -621,12 +687,29 @@ namespace RCF {
 
         if (targetName.size() > 0)
         {
-            ReadLock readLock(rcfServer.mStubMapMutex);
-            const std::string & servantName = getService();
-            RcfServer::StubMap::iterator iter = rcfServer.mStubMap.find(servantName);
-            if (iter != rcfServer.mStubMap.end())
+            // Bindings are resolved once per session, and only looked up again
+            // in the server's stub map if the server's bindings have changed.
+            std::uint32_t stubMapVersion = rcfServer.mStubMapVersion.load();
+            if (pRcfSession)
+            {
+                stubEntryPtr = pRcfSession->getResolvedStubEntryPtr(targetName, stubMapVersion);
+            }
+
+            if (!stubEntryPtr)
             {
-                stubEntryPtr = (*iter).second;
+                {
+                    ReadLock readLock(rcfServer.mStubMapMutex);
+                    RcfServer::StubMap::iterator iter = rcfServer.mStubMap.find(targetName);
+                    if (iter != rcfServer.mStubMap.end())
+                    {
+                        stubEntryPtr = (*iter).second;
+                    }
+                }
+
+                if (stubEntryPtr && pRcfSession)
+                {
+                    pRcfSession->addResolvedStubEntryPtr(targetName, stubMapVersion, stubEntryPtr);
+                }
             }
         }
         else
@@ -951,7 +1034,9 @@ namespace RCF {
             << NAMEVALUE(r.mClose)           
             << NAMEVALUE(r.mRuntimeVersion)
             << NAMEVALUE(r.mPingBackIntervalMs)
-            << NAMEVALUE(r.mArchiveVersion);
+            << NAMEVALUE(r.mArchiveVersion)
+            << NAMEVALUE(r.mEnableSfSchemaFixed)
+            << NAMEVALUE(r.mParallelSerializationThreshold);
 
         return os;
     }
@@ -1185,11 +1270,13 @@ namespace RCF {
     OobRequestSubscription::OobRequestSubscription(
         int                     runtimeVersion,
         const std::string &     publisherName, 
-        std::uint32_t         subToPubPingIntervalMs) :
+        std::uint32_t         subToPubPingIntervalMs,
+        const SubscriptionFilter & filter) :
             OobMessage(runtimeVersion),
             mPublisherName(publisherName),
             mSubToPubPingIntervalMs(subToPubPingIntervalMs),
-            mPubToSubPingIntervalMs(0)
+            mPubToSubPingIntervalMs(0),
+            mFilter(filter)
     {
     }
 
@@ -1207,6 +1294,32 @@ namespace RCF {
         SF::encodeString(mPublisherName, *vecPtr, pos);
         SF::encodeInt(mSubToPubPingIntervalMs, *vecPtr, pos);
 
+        if (mRuntimeVersion >= 20)
+        {
+            const std::vector<SubscriptionFilter::KeyRange> & keyRanges = mFilter.getKeyRanges();
+            const std::vector<std::string> & tags = mFilter.getTags();
+
+            RCF_VERIFY(
+                keyRanges.size() <= SubscriptionFilter::MaxEntries && tags.size() <= SubscriptionFilter::MaxEntries,
+                Exception(RcfError_SubscriptionFilterTooLarge, keyRanges.size(), tags.size(), SubscriptionFilter::MaxEntries));
+
+            // 64 bit keys are encoded as two 32 bit halves.
+            SF::encodeInt(static_cast<int>(keyRanges.size()), *vecPtr, pos);
+            for (std::size_t i=0; i<keyRanges.size(); ++i)
+            {
+                SF::encodeInt(static_cast<int>(keyRanges[i].first >> 32), *vecPtr, pos);
+                SF::encodeInt(static_cast<int>(keyRanges[i].first), *vecPtr, pos);
+                SF::encodeInt(static_cast<int>(keyRanges[i].second >> 32), *vecPtr, pos);
+                SF::encodeInt(static_cast<int>(keyRanges[i].second), *vecPtr, pos);
+            }
+
+            SF::encodeInt(static_cast<int>(tags.size()), *vecPtr, pos);
+            for (std::size_t i=0; i<tags.size(); ++i)
+            {
+                SF::encodeString(tags[i], *vecPtr, pos);
+            }
+        }
+
         vecPtr->resize(pos);
         buffer = ByteBuffer(vecPtr);
     }
@@ -1217,6 +1330,42 @@ namespace RCF {
     {
         SF::decodeString(mPublisherName, buffer, pos);
         SF::decodeInt(mSubToPubPingIntervalMs, buffer, pos);
+
+        mFilter = SubscriptionFilter();
+        if (mRuntimeVersion >= 20)
+        {
+            // The publisher indexes every key range and tag of every subscriber, so their number is limited.
+            std::uint32_t keyRangeCount = 0;
+            SF::decodeInt(keyRangeCount, buffer, pos);
+            RCF_VERIFY(
+                keyRangeCount <= SubscriptionFilter::MaxEntries, 
+                Exception(RcfError_SubscriptionFilterTooLarge, keyRangeCount, 0, SubscriptionFilter::MaxEntries));
+
+            for (std::uint32_t i=0; i<keyRangeCount; ++i)
+            {
+                std::uint32_t firstHi = 0, firstLo = 0, lastHi = 0, lastLo = 0;
+                SF::decodeInt(firstHi, buffer, pos);
+                SF::decodeInt(firstLo, buffer, pos);
+                SF::decodeInt(lastHi, buffer, pos);
+                SF::decodeInt(lastLo, buffer, pos);
+                std::uint64_t firstKey = (std::uint64_t(firstHi) << 32) | firstLo;
+                std::uint64_t lastKey = (std::uint64_t(lastHi) << 32) | lastLo;
+                RCF_VERIFY(firstKey <= lastKey, Exception(RcfError_Decoding));
+                mFilter.addKeyRange(firstKey, lastKey);
+            }
+
+            std::uint32_t tagCount = 0;
+            SF::decodeInt(tagCount, buffer, pos);
+            RCF_VERIFY(
+                tagCount <= SubscriptionFilter::MaxEntries, 
+                Exception(RcfError_SubscriptionFilterTooLarge, keyRangeCount, tagCount, SubscriptionFilter::MaxEntries));
+            for (std::uint32_t i=0; i<tagCount; ++i)
+            {
+                std::string tag;
+                SF::decodeString(tag, buffer, pos);
+                mFilter.addTag(tag);
+            }
+        }
     }
 
     void OobRequestSubscription::encodeResponse(ByteBuffer & buffer)
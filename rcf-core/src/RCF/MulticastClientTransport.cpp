@@ -18,10 +18,17 @@
 
 #include <RCF/MulticastClientTransport.hpp>
 
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <map>
+
+#include <RCF/Asio.hpp>
 #include <RCF/ClientStub.hpp>
 #include <RCF/Exception.hpp>
 #include <RCF/Future.hpp>
 #include <RCF/Globals.hpp>
+#include <RCF/ObjectPool.hpp>
 #include <RCF/RcfClient.hpp>
 #include <RCF/RcfSession.hpp>
 #include <RCF/ServerTransport.hpp>
@@ -48,101 +55,159 @@ namespace RCF {
         return EndpointPtr();
     }
     
-    // Used to coordinate the async sends for a published message.
-    class PublishCompletionInfo
+    // A message waiting to be sent to a subscriber. The message buffer is shared by all subscribers.
+    class QueuedMessage
     {
     public:
+        ByteBuffer          mMessage;
+        std::string         mConflationKey;
+    };
 
-        PublishCompletionInfo(std::size_t notifyOnCount) : 
+    // Outgoing messages for a single subscriber. At most one asynchronous write is in progress at a time, and write 
+    // completions arrive on the server's I/O threads, where the next message is sent.
+    class SubscriberQueue : 
+        public ClientTransportCallback,
+        public std::enable_shared_from_this<SubscriberQueue>
+    {
+    public:
+
+        SubscriberQueue(
+            ClientTransportUniquePtr        clientTransportPtr, 
+            AsioIoService *                 pIoService,
+            const SubscriptionFilter &      filter) :
             mMutex(),
-            mCondition(),
-            mCompletedCount(0),
-            mFailedCount(0),
-            mNotifyOnCount(notifyOnCount)
+            mpIoService(pIoService),
+            mClientTransportPtr(std::move(clientTransportPtr)),
+            mFilter(filter),
+            mQueue(),
+            mSendBuffers(),
+            mSending(false),
+            mWriteIssued(false),
+            mClosed(false),
+            mDroppedCount(0)
         {
+            mClientTransportPtr->setAsync(true);
         }
 
-        void notifyCompletion(bool completedOk)
+        ~SubscriberQueue()
         {
-            Lock lock(mMutex);
-            if (completedOk)
-            {
-                ++mCompletedCount;
-            }
-            else
-            {
-                ++mFailedCount;
-            }
+            // Closing the transport waits for any completion handler that is running, and discards any that are 
+            // still outstanding.
+            mClientTransportPtr.reset();
+        }
 
-            RCF_ASSERT(mCompletedCount + mFailedCount <= mNotifyOnCount);
-            if (mCompletedCount + mFailedCount == mNotifyOnCount)
-            {
-                mCondition.notify_all();
-            }
+        ClientTransport & getTransport()
+        {
+            return *mClientTransportPtr;
         }
 
-        void wait(std::uint32_t waitMs)
+        const SubscriptionFilter & getFilter() const
         {
-            Timer waitTimer;
+            return mFilter;
+        }
 
-            Lock lock(mMutex);
+        void push(
+            const QueuedMessage &   message, 
+            std::size_t             maxQueueLength, 
+            SlowSubscriberPolicy    slowSubscriberPolicy)
+        {
+            bool startSending = false;
+            bool cancelSend = false;
 
-            while (
-                    !waitTimer.elapsed(waitMs)
-                &&  mCompletedCount + mFailedCount < mNotifyOnCount)
             {
-                std::uint32_t timeUsedSoFarMs = waitTimer.getDurationMs();
-                timeUsedSoFarMs = RCF_MIN(timeUsedSoFarMs, waitMs);
-                std::uint32_t timeRemainingMs = waitMs - timeUsedSoFarMs;
-                using namespace std::chrono_literals;
-                bool timedOut = (mCondition.wait_for(lock, timeRemainingMs * 1ms) == std::cv_status::timeout);
-                if (    !timedOut 
-                    &&  (mCompletedCount + mFailedCount == mNotifyOnCount))
+                Lock lock(mMutex);
+
+                if (mClosed)
                 {
-                    break;
+                    return;
                 }
-            }
-        }
 
-        std::size_t getCompletionCount()
-        {
-            Lock lock(mMutex);
-            return mCompletedCount + mFailedCount;
-        }
+                if (slowSubscriberPolicy == Ssp_Conflate && message.mConflationKey.size() > 0)
+                {
+                    for (std::size_t i = 0; i < mQueue.size(); ++i)
+                    {
+                        if (mQueue[i].mConflationKey == message.mConflationKey)
+                        {
+                            mQueue[i].mMessage = message.mMessage;
+                            ++mDroppedCount;
+                            return;
+                        }
+                    }
+                }
 
-    private:
+                if (maxQueueLength > 0 && mQueue.size() >= maxQueueLength)
+                {
+                    if (slowSubscriberPolicy == Ssp_Disconnect)
+                    {
+                        RCF_LOG_2()(mQueue.size()) 
+                            << "MulticastClientTransport - send queue full. Disconnecting subscriber.";
 
-        Mutex           mMutex;
-        Condition       mCondition;
+                        mClosed = true;
+                        mQueue.clear();
+                        cancelSend = mSending && mWriteIssued;
+                    }
+                    else
+                    {
+                        mQueue.pop_front();
+                        ++mDroppedCount;
+                    }
+                }
 
-        std::size_t     mCompletedCount;
-        std::size_t     mFailedCount;
-        std::size_t     mNotifyOnCount;
+                if (!mClosed)
+                {
+                    mQueue.push_back(message);
+                    if (!mSending)
+                    {
+                        mSending = true;
+                        startSending = true;
+                    }
+                }
+            }
 
-    };
+            // The transport is called without holding mMutex, as completion handlers hold the transport lock while
+            // they lock mMutex.
+            if (cancelSend)
+            {
+                mClientTransportPtr->cancel();
+            }
+            else if (startSending && mpIoService)
+            {
+                // Leave the write to the subscriber's I/O thread, so the cost of publishing doesn't depend on the 
+                // number of subscribers.
+                mpIoService->post( SubscriberSendHandler(shared_from_this()) );
+            }
+            else if (startSending)
+            {
+                sendNext();
+            }
+        }
 
-    class PublishCompletionHandler : public ClientTransportCallback
-    {
-    public:
+        void close()
+        {
+            bool cancelSend = false;
+            {
+                Lock lock(mMutex);
+                mClosed = true;
+                mQueue.clear();
+                cancelSend = mSending && mWriteIssued;
+            }
+
+            if (cancelSend)
+            {
+                mClientTransportPtr->cancel();
+            }
+        }
 
-        PublishCompletionHandler() :
-            mpClientTransport(NULL),
-            mpInfo(NULL),
-            mCompleted(false),
-            mOk(false),
-            mError()
+        bool isClosed()
         {
+            Lock lock(mMutex);
+            return mClosed;
         }
 
-        PublishCompletionHandler(
-            ClientTransport * pClientTransport,
-            PublishCompletionInfo * pInfo) : 
-                mpClientTransport(pClientTransport),
-                mpInfo(pInfo),
-                mCompleted(false),
-                mOk(false),
-                mError()
+        bool isRemovable()
         {
+            Lock lock(mMutex);
+            return mClosed && !mSending;
         }
 
         void onConnectCompleted(bool alreadyConnected = false)
@@ -153,10 +218,7 @@ namespace RCF {
 
         void onSendCompleted()
         {
-            mCompleted = true;
-            mOk = true;
-            mError = "";
-            mpInfo->notifyCompletion(mOk);
+            sendNext();
         }
 
         void onReceiveCompleted()
@@ -171,106 +233,245 @@ namespace RCF {
 
         void onError(const std::exception &e)
         {
-            mCompleted = true;
-            mOk = false;
-            mError = e.what();
-            mpInfo->notifyCompletion(mOk);
+            Lock lock(mMutex);
+
+            RCF_LOG_2()(e.what())(mQueue.size())(mDroppedCount)
+                << "MulticastClientTransport - send failed. Removing subscriber.";
+
+            mClosed = true;
+            mSending = false;
+            mQueue.clear();
         }
 
-        ClientTransport *       mpClientTransport;
-        PublishCompletionInfo * mpInfo;
+    private:
 
-        bool                    mCompleted;
-        bool                    mOk;
-        std::string             mError;
-    };
+        class SubscriberSendHandler
+        {
+        public:
+            SubscriberSendHandler(std::weak_ptr<SubscriberQueue> queueWeakPtr) : mQueueWeakPtr(queueWeakPtr)
+            {
+            }
 
-    void MulticastClientTransport::doSendOnTransports(
-        Lock&                           lock, 
-        ClientTransportList&            transportList,
-        const std::vector<ByteBuffer> & data,
-        unsigned int                    timeoutMs)
-    {
-        RCF_UNUSED_VARIABLE(lock);
-        std::size_t transportsInitial = transportList.size();
+            void operator()()
+            {
+                SubscriberQueuePtr queuePtr = mQueueWeakPtr.lock();
+                if (queuePtr)
+                {
+                    queuePtr->sendNext();
+                }
+            }
 
-        PublishCompletionInfo info(transportList.size());
+            std::weak_ptr<SubscriberQueue> mQueueWeakPtr;
+        };
 
-        // Setup completion handlers.
-        std::vector<PublishCompletionHandler> handlers(transportList.size());
-        for (std::size_t i = 0; i < transportList.size(); ++i)
+        void sendNext()
         {
-            ClientTransport * pTransport = (*transportList[i]).get();
-            handlers[i] = PublishCompletionHandler(pTransport, &info);
-        }
+            {
+                Lock lock(mMutex);
+                if (mClosed || mQueue.empty())
+                {
+                    mSending = false;
+                    return;
+                }
+
+                mSendBuffers.resize(0);
+                mSendBuffers.push_back(mQueue.front().mMessage);
+                mQueue.pop_front();
+            }
 
-        // Async send on all transports.
-        for (std::size_t i = 0; i < handlers.size(); ++i)
-        {
             try
             {
-                handlers[i].mpClientTransport->setAsync(true);
-                handlers[i].mpClientTransport->send(handlers[i], data, 0);
+                mClientTransportPtr->send(*this, mSendBuffers, 0);
+
+                // The transport can't be canceled until it has been given a callback.
+                Lock lock(mMutex);
+                mWriteIssued = true;
             }
             catch (const Exception &e)
             {
                 Exception err(RcfError_SyncPublishError, e.what());
-                handlers[i].onError(err);
+                onError(err);
             }
         }
 
-        // Wait for async completions.
-        std::uint32_t completionDurationMs = 0;
+        Mutex                           mMutex;
+        AsioIoService *                 mpIoService;
+        ClientTransportUniquePtr        mClientTransportPtr;
+        const SubscriptionFilter        mFilter;
+        std::deque<QueuedMessage>       mQueue;
+        std::vector<ByteBuffer>         mSendBuffers;
+        bool                            mSending;
+        bool                            mWriteIssued;
+        bool                            mClosed;
+        std::size_t                     mDroppedCount;
+    };
+
+    // Index of subscriber queues by the keys and tags in their subscription filters. Key ranges are split into 
+    // disjoint segments, each listing the subscribers whose ranges cover it, so routing a message costs a binary 
+    // search plus the number of matching subscribers.
+    class SubscriberRoutingTable
+    {
+    public:
+
+        SubscriberRoutingTable(const SubscriberQueueList & queues)
         {
-            Timer timer;
-            info.wait(timeoutMs);
-            completionDurationMs = timer.getDurationMs();
+            const std::uint64_t MaxKey = (std::numeric_limits<std::uint64_t>::max)();
+
+            SubscriberQueueList filteredQueues;
+            for (std::size_t i = 0; i < queues.size(); ++i)
+            {
+                const SubscriberQueuePtr & queuePtr = queues[i];
+                const SubscriptionFilter & filter = queuePtr->getFilter();
+                if (filter.isEmpty())
+                {
+                    mUnfilteredQueues.push_back(queuePtr);
+                    continue;
+                }
+
+                filteredQueues.push_back(queuePtr);
+
+                const std::vector<SubscriptionFilter::KeyRange> & keyRanges = filter.getKeyRanges();
+                for (std::size_t j = 0; j < keyRanges.size(); ++j)
+                {
+                    mSegmentStarts.push_back(keyRanges[j].first);
+                    if (keyRanges[j].second != MaxKey)
+                    {
+                        mSegmentStarts.push_back(keyRanges[j].second + 1);
+                    }
+                }
+
+                const std::vector<std::string> & tags = filter.getTags();
+                for (std::size_t j = 0; j < tags.size(); ++j)
+                {
+                    addUnique(mTagQueues[tags[j]], queuePtr);
+                }
+            }
+
+            std::sort(mSegmentStarts.begin(), mSegmentStarts.end());
+            mSegmentStarts.erase(
+                std::unique(mSegmentStarts.begin(), mSegmentStarts.end()), 
+                mSegmentStarts.end());
+
+            mSegmentQueues.resize(mSegmentStarts.size());
+
+            for (std::size_t i = 0; i < filteredQueues.size(); ++i)
+            {
+                const SubscriberQueuePtr & queuePtr = filteredQueues[i];
+                const std::vector<SubscriptionFilter::KeyRange> & keyRanges = queuePtr->getFilter().getKeyRanges();
+                for (std::size_t j = 0; j < keyRanges.size(); ++j)
+                {
+                    std::size_t first = findSegment(keyRanges[j].first);
+                    std::size_t last = keyRanges[j].second == MaxKey ? 
+                        mSegmentStarts.size() : 
+                        findSegment(keyRanges[j].second + 1);
+
+                    for (std::size_t k = first; k < last; ++k)
+                    {
+                        addUnique(mSegmentQueues[k], queuePtr);
+                    }
+                }
+            }
         }
 
-        // Cancel any outstanding sends.
-        for (std::size_t i = 0; i < handlers.size(); ++i)
+        // Subscribers that receive every message.
+        const SubscriberQueueList & getUnfilteredQueues() const
         {
-            if (!handlers[i].mCompleted)
-            {
-                (*transportList[i])->cancel();
+            return mUnfilteredQueues;
+        }
+
+        // Subscribers whose filters contain the key, or NULL if there are none.
+        const SubscriberQueueList * findKey(std::uint64_t key) const
+        {
+            std::vector<std::uint64_t>::const_iterator iter = 
+                std::upper_bound(mSegmentStarts.begin(), mSegmentStarts.end(), key);
 
-                RCF_LOG_2()(i)
-                    << "MulticastClientTransport::send() - cancel send.";
+            if (iter == mSegmentStarts.begin())
+            {
+                return NULL;
             }
+
+            return &mSegmentQueues[(iter - mSegmentStarts.begin()) - 1];
         }
 
-        // Wait for canceled ops to complete.
-        std::uint32_t cancelDurationMs = 0;
+        // Subscribers whose filters contain the tag, or NULL if there are none.
+        const SubscriberQueueList * findTag(const std::string & tag) const
         {
-            Timer timer;
-            info.wait(timeoutMs);
-            cancelDurationMs = timer.getDurationMs();
+            TagQueues::const_iterator iter = mTagQueues.find(tag);
+            return iter == mTagQueues.end() ? NULL : &iter->second;
         }
 
-        RCF_ASSERT(info.getCompletionCount() == handlers.size());
+    private:
 
-        // Close and remove any subscriber transports with errors.
-        std::size_t transportsRemoved = 0;
-        for (std::size_t i = 0; i < handlers.size(); ++i)
+        std::size_t findSegment(std::uint64_t segmentStart) const
         {
-            RCF_ASSERT(handlers[i].mCompleted);
-            if (!handlers[i].mOk)
-            {
-                transportList[i] = ClientTransportUniquePtrPtr();
-                ++transportsRemoved;
+            return std::lower_bound(mSegmentStarts.begin(), mSegmentStarts.end(), segmentStart) - mSegmentStarts.begin();
+        }
 
-                RCF_LOG_2()(i)(handlers[i].mCompleted)(handlers[i].mOk)(handlers[i].mError)
-                    << "MulticastClientTransport::send() - remove subscriber transport.";
+        // Queues are added one subscriber at a time, so a duplicate can only be the last entry.
+        static void addUnique(SubscriberQueueList & queues, const SubscriberQueuePtr & queuePtr)
+        {
+            if (queues.empty() || queues.back() != queuePtr)
+            {
+                queues.push_back(queuePtr);
             }
         }
-        eraseRemove(transportList, ClientTransportUniquePtrPtr());
 
-        std::size_t transportsFinal = transportList.size();
+        typedef std::map<std::string, SubscriberQueueList> TagQueues;
 
-        RCF_LOG_2()
-            (completionDurationMs)(cancelDurationMs)(transportsInitial)(transportsFinal)
-            << "MulticastClientTransport::doSendOnTransports()";
+        SubscriberQueueList                 mUnfilteredQueues;
+        std::vector<std::uint64_t>          mSegmentStarts;
+        std::vector<SubscriberQueueList>    mSegmentQueues;
+        TagQueues                           mTagQueues;
+    };
+
+    MulticastClientTransport::MulticastClientTransport() :
+        mMaxQueueLength(0),
+        mSlowSubscriberPolicy(Ssp_Disconnect),
+        mHasRoutingKey(false),
+        mRoutingKey(0),
+        mHasRoutingTag(false)
+    {
+    }
 
+    MulticastClientTransport::~MulticastClientTransport()
+    {
+        close();
+    }
+
+    void MulticastClientTransport::setQueueLimits(
+        std::size_t                     maxQueueLength,
+        SlowSubscriberPolicy            slowSubscriberPolicy)
+    {
+        Lock lock(mClientTransportsMutex);
+        mMaxQueueLength = maxQueueLength;
+        mSlowSubscriberPolicy = slowSubscriberPolicy;
+    }
+
+    void MulticastClientTransport::setConflationKey(const std::string & conflationKey)
+    {
+        mConflationKey = conflationKey;
+    }
+
+    void MulticastClientTransport::setRoutingKey(std::uint64_t routingKey)
+    {
+        clearRouting();
+        mHasRoutingKey = true;
+        mRoutingKey = routingKey;
+    }
+
+    void MulticastClientTransport::setRoutingTag(const std::string & routingTag)
+    {
+        clearRouting();
+        mHasRoutingTag = true;
+        mRoutingTag = routingTag;
+    }
+
+    void MulticastClientTransport::clearRouting()
+    {
+        mHasRoutingKey = false;
+        mRoutingKey = 0;
+        mHasRoutingTag = false;
+        mRoutingTag.clear();
     }
 
     int MulticastClientTransport::send(
@@ -292,45 +493,77 @@ namespace RCF {
 
         bringInNewTransports();
 
+        // The caller reuses its buffers for the next message, so the message is copied, once, into a buffer that 
+        // the subscriber queues can hold on to. Any left margin is kept.
+        std::size_t leftMargin = data.empty() ? 0 : data.front().getLeftMargin();
+        ReallocBufferPtr messagePtr = getObjectPool().getReallocBufferPtr(leftMargin + mLastRequestSize);
+        messagePtr->resize(leftMargin + mLastRequestSize);
+        copyByteBuffers(data, messagePtr->getPtr() + leftMargin);
+
+        QueuedMessage message;
+        message.mMessage = ByteBuffer(
+            messagePtr->getPtr() + leftMargin, 
+            mLastRequestSize, 
+            leftMargin, 
+            messagePtr, 
+            true);
+        message.mConflationKey.swap(mConflationKey);
+        mConflationKey.clear();
+
+        bool hasRoutingKey = mHasRoutingKey;
+        bool hasRoutingTag = mHasRoutingTag;
+        std::uint64_t routingKey = mRoutingKey;
+        std::string routingTag;
+        routingTag.swap(mRoutingTag);
+        clearRouting();
+
         Lock lock(mClientTransportsMutex);
 
+        removeClosedTransports();
+
         std::size_t transportsInitial = mClientTransports.size();
+        std::size_t transportsSent = 0;
 
-        std::size_t MaxTransportsToSendOn = globals().getSimultaneousPublishLimit();
-        if (MaxTransportsToSendOn <= 0)
+        if (!hasRoutingKey && !hasRoutingTag)
         {
-            MaxTransportsToSendOn = mClientTransports.size();
+            for (std::size_t i = 0; i < mClientTransports.size(); ++i)
+            {
+                mClientTransports[i]->push(message, mMaxQueueLength, mSlowSubscriberPolicy);
+            }
+            transportsSent = mClientTransports.size();
         }
-
-        mClientTransportsTemp.reserve(mClientTransports.size());
-        mClientTransportsTemp.resize(0);
-
-        mClientTransportsSending.reserve(MaxTransportsToSendOn);
-        mClientTransportsSending.resize(0);
-
-        while (mClientTransports.size() > 0)
+        else
         {
-            std::size_t count = RCF_MIN(MaxTransportsToSendOn, mClientTransports.size());
-            std::size_t pos = mClientTransports.size() - count;
-            mClientTransportsSending.assign(mClientTransports.begin() + pos, mClientTransports.end());
-            mClientTransports.resize(pos);
+            if (!mRoutingTablePtr)
+            {
+                mRoutingTablePtr.reset( new SubscriberRoutingTable(mClientTransports) );
+            }
 
-            doSendOnTransports(lock, mClientTransportsSending, data, timeoutMs);
+            const SubscriberQueueList & unfilteredQueues = mRoutingTablePtr->getUnfilteredQueues();
+            for (std::size_t i = 0; i < unfilteredQueues.size(); ++i)
+            {
+                unfilteredQueues[i]->push(message, mMaxQueueLength, mSlowSubscriberPolicy);
+            }
+            transportsSent = unfilteredQueues.size();
 
-            mClientTransportsTemp.insert(
-                mClientTransportsTemp.end(),
-                mClientTransportsSending.begin(),
-                mClientTransportsSending.end());
-        }
+            const SubscriberQueueList * pMatchingQueues = hasRoutingKey ? 
+                mRoutingTablePtr->findKey(routingKey) : 
+                mRoutingTablePtr->findTag(routingTag);
 
-        mClientTransports = mClientTransportsTemp;
+            if (pMatchingQueues)
+            {
+                for (std::size_t i = 0; i < pMatchingQueues->size(); ++i)
+                {
+                    (*pMatchingQueues)[i]->push(message, mMaxQueueLength, mSlowSubscriberPolicy);
+                }
+                transportsSent += pMatchingQueues->size();
+            }
+        }
 
         clientStub.onSendCompleted();
 
-        std::size_t transportsFinal = mClientTransports.size();
-
         RCF_LOG_2()
-            (lengthByteBuffers(data))(transportsInitial)(transportsFinal)
+            (lengthByteBuffers(data))(transportsInitial)(transportsSent)
             << "MulticastClientTransport::send() - exit.";
 
         return 1;
@@ -366,31 +599,61 @@ namespace RCF {
     }
 
     void MulticastClientTransport::addTransport(
-        ClientTransportUniquePtr clientTransportUniquePtr)
+        ClientTransportUniquePtr clientTransportUniquePtr,
+        AsioIoService * pIoService,
+        const SubscriptionFilter & filter)
     {
-        Lock lock(mAddedClientTransportsMutex);
-
-        clientTransportUniquePtr->setAsync(false);
+        SubscriberQueuePtr subscriberQueuePtr( new SubscriberQueue(
+            std::move(clientTransportUniquePtr), 
+            pIoService, 
+            filter) );
 
-        mAddedClientTransports.push_back( ClientTransportUniquePtrPtr( 
-            new ClientTransportUniquePtr(std::move(clientTransportUniquePtr)) ) );
+        Lock lock(mAddedClientTransportsMutex);
+        mAddedClientTransports.push_back(subscriberQueuePtr);
     }
 
     void MulticastClientTransport::bringInNewTransports()
     {
-        ClientTransportList addedClientTransports;
+        SubscriberQueueList addedClientTransports;
 
         {
             Lock lock(mAddedClientTransportsMutex);
             addedClientTransports.swap(mAddedClientTransports);
         }
 
+        if (addedClientTransports.empty())
+        {
+            return;
+        }
+
         Lock lock(mClientTransportsMutex);
 
         std::copy(
             addedClientTransports.begin(),
             addedClientTransports.end(),
             std::back_inserter(mClientTransports));
+
+        mRoutingTablePtr.reset();
+    }
+
+    void MulticastClientTransport::removeClosedTransports()
+    {
+        // Subscriber queues are only destroyed here, on the publishing thread, once their last write has completed.
+        bool needToRemove = false;
+        for (std::size_t i = 0; i < mClientTransports.size(); ++i)
+        {
+            if (mClientTransports[i]->isRemovable())
+            {
+                mClientTransports[i].reset();
+                needToRemove = true;
+            }
+        }
+
+        if (needToRemove)
+        {
+            eraseRemove(mClientTransports, SubscriberQueuePtr());
+            mRoutingTablePtr.reset();
+        }
     }
 
     void MulticastClientTransport::setTransportFilters(
@@ -419,12 +682,10 @@ namespace RCF {
 
         Lock lock(mClientTransportsMutex);
 
-        bool needToRemove = false;
-
-        ClientTransportList::iterator iter;
+        SubscriberQueueList::iterator iter;
         for (iter = mClientTransports.begin(); iter != mClientTransports.end(); ++iter)
         {
-            RCF::ClientTransport & transport = ***iter;
+            RCF::ClientTransport & transport = (*iter)->getTransport();
             RcfSessionWeakPtr rcfSessionWeakPtr = transport.getRcfSession();
             if ( rcfSessionWeakPtr == RcfSessionWeakPtr() )
             {
@@ -435,8 +696,7 @@ namespace RCF {
             if (!rcfSessionPtr)
             {
                 RCF_LOG_2() << "Dropping subscription. Subscriber has closed connection.";
-                iter->reset();
-                needToRemove = true;
+                (*iter)->close();
             }
             else
             {
@@ -451,17 +711,13 @@ namespace RCF {
                         RCF_LOG_2()(subscriberUrl)(pingIntervalMs) 
                             << "Dropping subscription. Subscriber has not sent pings within the expected ping interval.";
 
-                        iter->reset();
-                        needToRemove = true;
+                        (*iter)->close();
                     }
                 }
             }
         }
 
-        if (needToRemove)
-        {
-            eraseRemove(mClientTransports, ClientTransportUniquePtrPtr());
-        }
+        removeClosedTransports();
     }
 
     void MulticastClientTransport::pingAllTransports()
@@ -478,12 +734,15 @@ namespace RCF {
         MulticastClientTransport & multicastTemp = 
             static_cast<MulticastClientTransport &>(*mMulticastTemp);
 
+        // Pings go through the same subscriber queues as published messages.
         multicastTemp.mClientTransports.resize(0);
+        multicastTemp.mMaxQueueLength = mMaxQueueLength;
+        multicastTemp.mSlowSubscriberPolicy = mSlowSubscriberPolicy;
 
-        ClientTransportList::iterator iter;
+        SubscriberQueueList::iterator iter;
         for (iter = mClientTransports.begin(); iter != mClientTransports.end(); ++iter)
         {
-            ClientTransport & transport = ***iter;
+            ClientTransport & transport = (*iter)->getTransport();
             if ( transport.getTransportType() == Tt_Http || transport.getTransportType() == Tt_Https )
             {
                 multicastTemp.mClientTransports.push_back(*iter);
@@ -503,21 +762,42 @@ namespace RCF {
         }
 
         I_RcfClient nullClient("", std::move(mMulticastTemp) );
+
+        // The queues belong to this transport, so take them back from the temp transport before nullClient 
+        // destroys it, even if the ping throws. Otherwise its destructor would close them.
+        ScopeGuard guard([&]() { multicastTemp.mClientTransports.resize(0); });
+
         nullClient.getClientStub().ping(RCF::Oneway);
         mMulticastTemp.reset( nullClient.getClientStub().releaseTransport().release() );
-        multicastTemp.mClientTransports.resize(0);
     }
 
     void MulticastClientTransport::close()
     {
+        bringInNewTransports();
+
         Lock lock(mClientTransportsMutex);
+
+        for (std::size_t i = 0; i < mClientTransports.size(); ++i)
+        {
+            mClientTransports[i]->close();
+        }
         mClientTransports.clear();
+        mRoutingTablePtr.reset();
     }
 
     std::size_t MulticastClientTransport::getTransportCount()
     {
         Lock lock(mClientTransportsMutex);
-        return mClientTransports.size();
+
+        std::size_t transportCount = 0;
+        for (std::size_t i = 0; i < mClientTransports.size(); ++i)
+        {
+            if (!mClientTransports[i]->isClosed())
+            {
+                ++transportCount;
+            }
+        }
+        return transportCount;
     }
 
 } // namespace RCF
@@ -23,6 +23,12 @@
 #include <RCF/InitDeinit.hpp>
 #include <RCF/Tools.hpp>
 
+namespace SF {
+
+    void initTrackingTableCache(RCF::ObjectPool & objectPool);
+
+}
+
 namespace RCF {
 
     CbAllocatorBase::CbAllocatorBase(ObjectPool & objectPool) : 
@@ -43,28 +49,113 @@ namespace RCF {
         mObjectPool.putPcb(pcb);
     }
 
+    std::size_t getBufferSizeClass(std::size_t capacity)
+    {
+        std::size_t sizeClass = 0;
+        capacity >>= 11;
+        while (capacity && sizeClass < BufferSizeClassCount - 1)
+        {
+            capacity >>= 1;
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    // Smallest capacity held in the given size class.
+    static std::size_t getBufferSizeClassMin(std::size_t sizeClass)
+    {
+        return sizeClass == 0 ? 0 : std::size_t(1) << (sizeClass + 10);
+    }
+
+    // Largest capacity held in the given size class.
+    static std::size_t getBufferSizeClassMax(std::size_t sizeClass)
+    {
+        return sizeClass == BufferSizeClassCount - 1 ? std::size_t(-1) : (std::size_t(1) << (sizeClass + 11)) - 1;
+    }
+
+    // Per-thread magazines in front of the global buffer pools. Buffers are plain heap objects, not tied to any
+    // particular ObjectPool, so whatever is left in a magazine is simply deleted when the thread exits.
+    class ObjectPoolTlsCache : Noncopyable
+    {
+    public:
+        ~ObjectPoolTlsCache();
+
+        std::vector< MemOstream * >             mOsCache[BufferSizeClassCount];
+        std::vector< ReallocBuffer * >          mRbCache[BufferSizeClassCount];
+        std::vector< void * >                   mCbCache;
+    };
+
+    // Buffers may be released from other thread local destructors during thread exit, after the cache itself
+    // has been destroyed. The flag is trivially destructible and remains valid until the thread is gone.
+    thread_local bool gObjectPoolTlsCacheDestroyed = false;
+    thread_local ObjectPoolTlsCache gObjectPoolTlsCache;
+
+    ObjectPoolTlsCache::~ObjectPoolTlsCache()
+    {
+        gObjectPoolTlsCacheDestroyed = true;
+
+        for (std::size_t i=0; i<BufferSizeClassCount; ++i)
+        {
+            for (std::size_t j=0; j<mOsCache[i].size(); ++j)
+            {
+                delete mOsCache[i][j];
+            }
+            for (std::size_t j=0; j<mRbCache[i].size(); ++j)
+            {
+                delete mRbCache[i][j];
+            }
+        }
+
+        for (std::size_t i=0; i<mCbCache.size(); ++i)
+        {
+            delete [] (char *) mCbCache[i];
+        }
+    }
+
+    static ObjectPoolTlsCache * getObjectPoolTlsCache()
+    {
+        if (gObjectPoolTlsCacheDestroyed)
+        {
+            return NULL;
+        }
+        return &gObjectPoolTlsCache;
+    }
+
+    static std::vector<MemOstream *> * getTlsBufferCache(ObjectPoolTlsCache * pCache, MemOstream *)
+    {
+        return pCache ? pCache->mOsCache : NULL;
+    }
+
+    static std::vector<ReallocBuffer *> * getTlsBufferCache(ObjectPoolTlsCache * pCache, ReallocBuffer *)
+    {
+        return pCache ? pCache->mRbCache : NULL;
+    }
+
     ObjectPool::ObjectPool() : 
         mObjPoolMutex(),
         mBufferCountLimit(10) ,
-        mBufferSizeLimit(1024*1024*10)
+        mBufferSizeLimit(1024*1024*10),
+        mThreadCacheCountLimit(4),
+        mThreadCacheSizeLimit(1024*256)
     {
-        mOsPool.reserve(10);
         mCbPool.reserve(10);
-        mRbPool.reserve(10);
     }
 
     ObjectPool::~ObjectPool()
     {
-        for (std::size_t i=0; i<mOsPool.size(); ++i)
+        for (std::size_t i=0; i<BufferSizeClassCount; ++i)
         {
-            delete mOsPool[i];
-            mOsPool[i] = NULL;
-        }
+            for (std::size_t j=0; j<mOsPool[i].size(); ++j)
+            {
+                delete mOsPool[i][j];
+                mOsPool[i][j] = NULL;
+            }
 
-        for (std::size_t i=0; i<mRbPool.size(); ++i)
-        {
-            delete mRbPool[i];
-            mRbPool[i] = NULL;
+            for (std::size_t j=0; j<mRbPool[i].size(); ++j)
+            {
+                delete mRbPool[i][j];
+                mRbPool[i][j] = NULL;
+            }
         }
 
         for (std::size_t i=0; i<mCbPool.size(); ++i)
@@ -104,8 +195,36 @@ namespace RCF {
         return mBufferSizeLimit;
     }
 
+    void ObjectPool::setThreadCacheCountLimit(std::size_t threadCacheCountLimit)
+    {
+        mThreadCacheCountLimit = threadCacheCountLimit;
+    }
+
+    std::size_t ObjectPool::getThreadCacheCountLimit()
+    {
+        return mThreadCacheCountLimit;
+    }
+
+    void ObjectPool::setThreadCacheSizeLimit(std::size_t threadCacheSizeLimit)
+    {
+        mThreadCacheSizeLimit = threadCacheSizeLimit;
+    }
+
+    std::size_t ObjectPool::getThreadCacheSizeLimit()
+    {
+        return mThreadCacheSizeLimit;
+    }
+
     void * ObjectPool::getPcb()
     {
+        ObjectPoolTlsCache * pCache = mThreadCacheCountLimit ? getObjectPoolTlsCache() : NULL;
+        if (pCache && !pCache->mCbCache.empty())
+        {
+            void * pcb = pCache->mCbCache.back();
+            pCache->mCbCache.pop_back();
+            return pcb;
+        }
+
         void * pcb = NULL;
 
         Lock lock(mCbPoolMutex);
@@ -124,53 +243,213 @@ namespace RCF {
 
     void ObjectPool::putPcb(void * pcb)
     {
+        // Control blocks are small, so the thread local magazine holds a few more of them than of buffers.
+        const std::size_t tlsLimit = 4*mThreadCacheCountLimit;
+
+        ObjectPoolTlsCache * pCache = tlsLimit ? getObjectPoolTlsCache() : NULL;
+        if (pCache)
+        {
+            std::vector<void *> & cbCache = pCache->mCbCache;
+            if (cbCache.size() >= tlsLimit)
+            {
+                // Magazine is full - hand half of it back to the global pool.
+                Lock lock(mCbPoolMutex);
+                std::size_t keep = tlsLimit / 2;
+                mCbPool.insert(mCbPool.end(), cbCache.begin() + keep, cbCache.end());
+                cbCache.resize(keep);
+            }
+            cbCache.push_back(pcb);
+            return;
+        }
+
         Lock lock(mCbPoolMutex);
         mCbPool.push_back(pcb);
     }
 
-    MemOstreamPtr ObjectPool::getMemOstreamPtr()
+    template<typename T>
+    T * ObjectPool::getBuffer(
+        std::size_t             sizeHint,
+        std::vector<T *> *      tlsCache,
+        std::vector<T *> *      pool,
+        Mutex &                 poolMutex)
+    {
+        std::size_t startClass = getBufferSizeClass(sizeHint);
+        if (sizeHint > getBufferSizeClassMin(startClass) && startClass < BufferSizeClassCount - 1)
+        {
+            ++startClass;
+        }
+
+        if (!mThreadCacheCountLimit)
+        {
+            tlsCache = NULL;
+        }
+
+        // First look for a buffer that is big enough, then fall back to the largest smaller one. The thread
+        // local cache is checked before the global pool in both cases.
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            std::size_t classBegin  = pass == 0 ? startClass : 0;
+            std::size_t classEnd    = pass == 0 ? BufferSizeClassCount : startClass;
+            if (classBegin == classEnd)
+            {
+                break;
+            }
+
+            if (tlsCache)
+            {
+                for (std::size_t i = classBegin; i < classEnd; ++i)
+                {
+                    std::size_t sizeClass = pass == 0 ? i : classEnd - 1 - (i - classBegin);
+                    std::vector<T *> & cache = tlsCache[sizeClass];
+                    if (!cache.empty())
+                    {
+                        T * pt = cache.back();
+                        cache.pop_back();
+                        return pt;
+                    }
+                }
+            }
+
+            Lock lock(poolMutex);
+            for (std::size_t i = classBegin; i < classEnd; ++i)
+            {
+                std::size_t sizeClass = pass == 0 ? i : classEnd - 1 - (i - classBegin);
+                std::vector<T *> & vec = pool[sizeClass];
+                if (!vec.empty())
+                {
+                    T * pt = vec.back();
+                    vec.pop_back();
+
+                    // Refill half of the thread local magazine while we hold the lock. Only size classes that lie 
+                    // entirely within the thread cache size limit are refilled.
+                    if (tlsCache && getBufferSizeClassMax(sizeClass) <= mThreadCacheSizeLimit)
+                    {
+                        std::vector<T *> & cache = tlsCache[sizeClass];
+                        std::size_t count = RCF_MIN(vec.size(), mThreadCacheCountLimit / 2);
+                        cache.insert(cache.end(), vec.end() - count, vec.end());
+                        vec.resize(vec.size() - count);
+                    }
+
+                    return pt;
+                }
+            }
+        }
+
+        return new T();
+    }
+
+    template<typename T>
+    void ObjectPool::putBuffer(
+        T *                     pt,
+        std::size_t             bufferSize,
+        std::vector<T *> *      tlsCache,
+        std::vector<T *> *      pool,
+        Mutex &                 poolMutex)
     {
-        MemOstreamPtr osPtr;
-        MemOstream * pt = NULL;
-        getPtr(pt, osPtr, mOsPool, mOsPoolMutex, &ObjectPool::putMemOstream);
-        return osPtr;
+        std::unique_ptr<T> ptPtr(pt);
+
+        if (bufferSize > mBufferSizeLimit)
+        {
+            return;
+        }
+
+        std::size_t sizeClass = getBufferSizeClass(bufferSize);
+
+        if (tlsCache && mThreadCacheCountLimit && bufferSize <= mThreadCacheSizeLimit)
+        {
+            std::vector<T *> & cache = tlsCache[sizeClass];
+            if (cache.size() >= mThreadCacheCountLimit)
+            {
+                // Magazine is full - hand half of it back to the global pool.
+                std::size_t keep = mThreadCacheCountLimit / 2;
+                std::vector<T *> & vec = pool[sizeClass];
+
+                Lock lock(poolMutex);
+                while (cache.size() > keep)
+                {
+                    if (vec.size() < mBufferCountLimit)
+                    {
+                        vec.push_back(cache.back());
+                    }
+                    else
+                    {
+                        delete cache.back();
+                    }
+                    cache.pop_back();
+                }
+            }
+            cache.push_back(ptPtr.release());
+            return;
+        }
+
+        // Check buffer count limit.
+        Lock lock(poolMutex);
+        std::vector<T *> & vec = pool[sizeClass];
+        if (vec.size() < mBufferCountLimit)
+        {
+            vec.push_back(ptPtr.release());
+        }
     }
 
-    ReallocBufferPtr ObjectPool::getReallocBufferPtr()
+    MemOstreamPtr ObjectPool::getMemOstreamPtr(std::size_t sizeHint)
     {
-        ReallocBufferPtr rbPtr;
-        ReallocBuffer * pt = NULL;
-        getPtr(pt, rbPtr, mRbPool, mRbPoolMutex, &ObjectPool::putReallocBuffer);
-        return rbPtr;
+        ObjectPoolTlsCache * pCache = getObjectPoolTlsCache();
+
+        MemOstream * pt = getBuffer(
+            sizeHint, 
+            getTlsBufferCache(pCache, (MemOstream *) NULL), 
+            mOsPool, 
+            mOsPoolMutex);
+
+        // Use shared_ptr allocator to avoid all allocations when a buffer is requested.
+
+        return MemOstreamPtr( 
+            pt, 
+            std::bind(&ObjectPool::putMemOstream, this, std::placeholders::_1),
+            CbAllocator<void>(*this) );
+    }
+
+    ReallocBufferPtr ObjectPool::getReallocBufferPtr(std::size_t sizeHint)
+    {
+        ObjectPoolTlsCache * pCache = getObjectPoolTlsCache();
+
+        ReallocBuffer * pt = getBuffer(
+            sizeHint, 
+            getTlsBufferCache(pCache, (ReallocBuffer *) NULL), 
+            mRbPool, 
+            mRbPoolMutex);
+
+        return ReallocBufferPtr( 
+            pt, 
+            std::bind(&ObjectPool::putReallocBuffer, this, std::placeholders::_1),
+            CbAllocator<void>(*this) );
     }
 
     void ObjectPool::putMemOstream(MemOstream * pOs)
     {
-        std::unique_ptr<MemOstream> osPtr(pOs);
-        std::size_t bufferSize = osPtr->capacity();
+        std::size_t bufferSize = pOs->capacity();
         pOs->clear(); // freezing may have set error state
         pOs->rewind();
 
-        // Check buffer count limit and buffer size limit.
-        Lock lock(mOsPoolMutex);
-        if (mOsPool.size() < mBufferCountLimit && bufferSize <= mBufferSizeLimit)
-        {
-            mOsPool.push_back(osPtr.release());
-        }
+        putBuffer(
+            pOs, 
+            bufferSize, 
+            getTlsBufferCache(getObjectPoolTlsCache(), pOs), 
+            mOsPool, 
+            mOsPoolMutex);
     }
 
     void ObjectPool::putReallocBuffer(ReallocBuffer * pRb)
     {
-        std::unique_ptr<ReallocBuffer> rbPtr(pRb);
-        std::size_t bufferSize = rbPtr->capacity();
+        std::size_t bufferSize = pRb->capacity();
         pRb->resize(0);
 
-        // Check buffer count limit and buffer size limit.
-        Lock lock(mRbPoolMutex);
-        if (mRbPool.size() < mBufferCountLimit && bufferSize <= mBufferSizeLimit)
-        {
-            mRbPool.push_back(rbPtr.release());
-        }
+        putBuffer(
+            pRb, 
+            bufferSize, 
+            getTlsBufferCache(getObjectPoolTlsCache(), pRb), 
+            mRbPool, 
+            mRbPoolMutex);
     }
    
     void ObjectPool::enumerateWriteBuffers(std::vector<std::size_t> & bufferSizes)
@@ -184,9 +463,12 @@ namespace RCF {
 #pragma warning(disable:4267)
 #endif
 
-        for (std::size_t i=0; i<mOsPool.size(); ++i)
+        for (std::size_t i=0; i<BufferSizeClassCount; ++i)
         {
-            bufferSizes.push_back( mOsPool[i]->capacity() );
+            for (std::size_t j=0; j<mOsPool[i].size(); ++j)
+            {
+                bufferSizes.push_back( mOsPool[i][j]->capacity() );
+            }
         }
 
 #ifdef _MSC_VER
@@ -206,9 +488,12 @@ namespace RCF {
 #pragma warning(disable:4267)
 #endif
 
-        for (std::size_t i=0; i<mRbPool.size(); ++i)
+        for (std::size_t i=0; i<BufferSizeClassCount; ++i)
         {
-            bufferSizes.push_back( mRbPool[i]->capacity() );
+            for (std::size_t j=0; j<mRbPool[i].size(); ++j)
+            {
+                bufferSizes.push_back( mRbPool[i][j]->capacity() );
+            }
         }
 
 #ifdef _MSC_VER
@@ -222,6 +507,7 @@ namespace RCF {
     void initObjectPool()
     {
         gpObjectPool = new ObjectPool();
+        SF::initTrackingTableCache(*gpObjectPool);
     }
 
     void deinitObjectPool()
@@ -28,13 +28,19 @@
 #include <openssl/x509.h>
 #include <openssl/x509v3.h>
 
+#include <sys/stat.h>
+
+#include <list>
+
 #include <RCF/ClientStub.hpp>
 #include <RCF/DynamicLib.hpp>
 #include <RCF/Exception.hpp>
 #include <RCF/Globals.hpp>
 #include <RCF/InitDeinit.hpp>
+#include <RCF/ObjectPool.hpp>
 #include <RCF/RcfServer.hpp>
 #include <RCF/RecursionLimiter.hpp>
+#include <RCF/ThreadLibrary.hpp>
 #include <RCF/Tools.hpp>
 
 namespace RCF {
@@ -65,8 +71,15 @@ namespace RCF {
         typedef int                             (*Pfn_SSL_CTX_use_certificate_chain_file)(SSL_CTX *ctx, const char *file); /* PEM type */
         typedef int                             (*Pfn_SSL_CTX_load_verify_locations)(SSL_CTX *ctx, const char *CAfile, const char *CApath);
         typedef int                             (*Pfn_OPENSSL_init_ssl)(uint64_t opts, const OPENSSL_INIT_SETTINGS *settings);
+        typedef long                            (*Pfn_SSL_CTX_ctrl)(SSL_CTX *ctx, int cmd, long larg, void *parg);
+        typedef void                            (*Pfn_SSL_CTX_sess_set_new_cb)(SSL_CTX *ctx, int (*new_session_cb)(SSL *ssl, SSL_SESSION *sess));
+        typedef int                             (*Pfn_SSL_CTX_set_session_id_context)(SSL_CTX *ctx, const unsigned char *sid_ctx, unsigned int sid_ctx_len);
+        typedef int                             (*Pfn_SSL_set_session)(SSL *to, SSL_SESSION *session);
+        typedef void                            (*Pfn_SSL_SESSION_free)(SSL_SESSION *ses);
+        typedef SSL_SESSION *                   (*Pfn_SSL_SESSION_dup)(const SSL_SESSION *src);
+        typedef int                             (*Pfn_SSL_set_ex_data)(SSL *ssl, int idx, void *data);
+        typedef void *                          (*Pfn_SSL_get_ex_data)(const SSL *ssl, int idx);
 
-        
 
         Pfn_SSL_get_verify_result               pfn_SSL_get_verify_result;
         Pfn_SSL_get_peer_certificate            pfn_SSL_get_peer_certificate;
@@ -85,7 +98,14 @@ namespace RCF {
         Pfn_SSL_CTX_use_certificate_chain_file  pfn_SSL_CTX_use_certificate_chain_file;
         Pfn_SSL_CTX_load_verify_locations       pfn_SSL_CTX_load_verify_locations;
         Pfn_OPENSSL_init_ssl                    pfn_OPENSSL_init_ssl;
-        
+        Pfn_SSL_CTX_ctrl                        pfn_SSL_CTX_ctrl;
+        Pfn_SSL_CTX_sess_set_new_cb             pfn_SSL_CTX_sess_set_new_cb;
+        Pfn_SSL_CTX_set_session_id_context      pfn_SSL_CTX_set_session_id_context;
+        Pfn_SSL_set_session                     pfn_SSL_set_session;
+        Pfn_SSL_SESSION_free                    pfn_SSL_SESSION_free;
+        Pfn_SSL_SESSION_dup                     pfn_SSL_SESSION_dup;
+        Pfn_SSL_set_ex_data                     pfn_SSL_set_ex_data;
+        Pfn_SSL_get_ex_data                     pfn_SSL_get_ex_data;
     };
 
     class OpenSslCryptoDll
@@ -121,6 +141,9 @@ namespace RCF {
         typedef X509_NAME *                     (*Pfn_X509_get_issuer_name)(const X509 *a);
         typedef int                             (*Pfn_X509_NAME_print_ex)(BIO *out, const X509_NAME *nm, int indent, unsigned long flags);
         typedef int                             (*Pfn_OPENSSL_init_crypto)(uint64_t opts, const OPENSSL_INIT_SETTINGS *settings);
+        typedef int                             (*Pfn_CRYPTO_get_ex_new_index)(int class_index, long argl, void *argp, CRYPTO_EX_new *new_func, CRYPTO_EX_dup *dup_func, CRYPTO_EX_free *free_func);
+        typedef int                             (*Pfn_EVP_Digest)(const void *data, size_t count, unsigned char *md, unsigned int *size, const EVP_MD *type, ENGINE *impl);
+        typedef const EVP_MD *                  (*Pfn_EVP_sha256)(void);
 
         Pfn_BIO_ctrl_pending                    pfn_BIO_ctrl_pending;
         Pfn_BIO_write                           pfn_BIO_write;
@@ -146,6 +169,12 @@ namespace RCF {
         Pfn_X509_get_issuer_name                pfn_X509_get_issuer_name;
         Pfn_X509_NAME_print_ex                  pfn_X509_NAME_print_ex;
         Pfn_OPENSSL_init_crypto                 pfn_OPENSSL_init_crypto;
+        Pfn_CRYPTO_get_ex_new_index             pfn_CRYPTO_get_ex_new_index;
+        Pfn_EVP_Digest                          pfn_EVP_Digest;
+        Pfn_EVP_sha256                          pfn_EVP_sha256;
+
+        // Our index for attaching the filter to SSL objects. -1 if it could not be allocated.
+        int                                     mSslExDataIndex;
     };
 
     // OpenSslDll
@@ -187,7 +216,14 @@ namespace RCF {
 #endif
 
         RCF_OPENSSL_LOAD_FUNCTION(SSL_get_verify_result);
+
+#if !defined(RCF_OPENSSL_STATIC) && defined(OPENSSL_VERSION_MAJOR) && OPENSSL_VERSION_MAJOR >= 3
+        // Renamed to SSL_get1_peer_certificate() in OpenSSL 3.0.
+        mDynamicLibPtr->loadDllFunction<Pfn_SSL_get_peer_certificate>(pfn_SSL_get_peer_certificate, "SSL_get1_peer_certificate");
+#else
         RCF_OPENSSL_LOAD_FUNCTION(SSL_get_peer_certificate);
+#endif
+
         RCF_OPENSSL_LOAD_FUNCTION(SSL_get_state);
         RCF_OPENSSL_LOAD_FUNCTION(SSL_set_bio);
         RCF_OPENSSL_LOAD_FUNCTION(SSL_set_connect_state);
@@ -203,6 +239,14 @@ namespace RCF {
         RCF_OPENSSL_LOAD_FUNCTION(SSL_CTX_use_certificate_chain_file);
         RCF_OPENSSL_LOAD_FUNCTION(SSL_CTX_load_verify_locations);
         RCF_OPENSSL_LOAD_FUNCTION(OPENSSL_init_ssl);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_CTX_ctrl);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_CTX_sess_set_new_cb);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_CTX_set_session_id_context);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_set_session);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_SESSION_free);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_SESSION_dup);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_set_ex_data);
+        RCF_OPENSSL_LOAD_FUNCTION(SSL_get_ex_data);
     }
 
     // OpenSslCryptoDll
@@ -219,6 +263,9 @@ namespace RCF {
         // Initialize OpenSSL.
         pfn_OPENSSL_init_crypto(OPENSSL_INIT_LOAD_CRYPTO_STRINGS, NULL);
         pfn_OPENSSL_init_crypto(OPENSSL_INIT_ADD_ALL_CIPHERS | OPENSSL_INIT_ADD_ALL_DIGESTS, NULL);
+
+        // Equivalent to SSL_get_ex_new_index(), which is a macro. Index 0 is used by SSL_set_app_data().
+        mSslExDataIndex = pfn_CRYPTO_get_ex_new_index(CRYPTO_EX_INDEX_SSL, 0, NULL, NULL, NULL, NULL);
     }
 
     void OpenSslCryptoDll::loadFunctionPtrs()
@@ -253,6 +300,9 @@ namespace RCF {
         RCF_OPENSSL_LOAD_FUNCTION(X509_get_issuer_name);
         RCF_OPENSSL_LOAD_FUNCTION(X509_NAME_print_ex);
         RCF_OPENSSL_LOAD_FUNCTION(OPENSSL_init_crypto);
+        RCF_OPENSSL_LOAD_FUNCTION(CRYPTO_get_ex_new_index);
+        RCF_OPENSSL_LOAD_FUNCTION(EVP_Digest);
+        RCF_OPENSSL_LOAD_FUNCTION(EVP_sha256);
         
     }
 
@@ -278,8 +328,127 @@ namespace RCF {
         return *mpOpenSslCryptoDll;
     }
 
+    // Process-wide cache of OpenSSL contexts and client sessions, used for TLS session resumption.
+    //
+    // Filters with the same role and certificates share an SSL_CTX, so that on the server side, session tickets 
+    // and the server session cache outlive individual connections. On the client side, sessions issued by a 
+    // server are stored by server endpoint, and offered to the server again on the next connection.
+    //
+    // Each context is stored with the size and modification time of the certificate files it was loaded from, 
+    // and is replaced once those files change.
+    class OpenSslContextCache
+    {
+    public:
+
+        typedef std::shared_ptr<SSL_CTX>        SslCtxPtr;
+        typedef std::shared_ptr<SSL_SESSION>    SslSessionPtr;
+
+        // Returns the cached context for the key, or caches ctxPtr if there isn't one yet for these files.
+        SslCtxPtr addContext(const std::string & key, const std::string & fileStamp, SslCtxPtr ctxPtr)
+        {
+            Lock lock(mMutex);
+            CachedContext & cached = mContexts[key];
+            if (!cached.mCtxPtr || cached.mFileStamp != fileStamp)
+            {
+                cached.mFileStamp = fileStamp;
+                cached.mCtxPtr = ctxPtr;
+            }
+            return cached.mCtxPtr;
+        }
+
+        SslCtxPtr getContext(const std::string & key, const std::string & fileStamp)
+        {
+            Lock lock(mMutex);
+            std::map<std::string, CachedContext>::iterator iter = mContexts.find(key);
+            if (iter == mContexts.end() || iter->second.mFileStamp != fileStamp)
+            {
+                return SslCtxPtr();
+            }
+            return iter->second.mCtxPtr;
+        }
+
+        void setSession(const std::string & key, SslSessionPtr sessionPtr)
+        {
+            Lock lock(mMutex);
+            std::map<std::string, CachedSession>::iterator iter = mSessions.find(key);
+            if (iter != mSessions.end())
+            {
+                iter->second.mSessionPtr = sessionPtr;
+                mSessionLru.splice(mSessionLru.begin(), mSessionLru, iter->second.mLruIter);
+                return;
+            }
+
+            // Evict the least recently used session.
+            if (mSessions.size() >= MaxSessions)
+            {
+                mSessions.erase(mSessionLru.back());
+                mSessionLru.pop_back();
+            }
+
+            mSessionLru.push_front(key);
+            CachedSession & cached = mSessions[key];
+            cached.mSessionPtr = sessionPtr;
+            cached.mLruIter = mSessionLru.begin();
+        }
+
+        SslSessionPtr getSession(const std::string & key)
+        {
+            Lock lock(mMutex);
+            std::map<std::string, CachedSession>::iterator iter = mSessions.find(key);
+            if (iter == mSessions.end())
+            {
+                return SslSessionPtr();
+            }
+            mSessionLru.splice(mSessionLru.begin(), mSessionLru, iter->second.mLruIter);
+            return iter->second.mSessionPtr;
+        }
+
+    private:
+
+        static const std::size_t                MaxSessions = 1024;
+
+        struct CachedContext
+        {
+            std::string                         mFileStamp;
+            SslCtxPtr                           mCtxPtr;
+        };
+
+        struct CachedSession
+        {
+            SslSessionPtr                       mSessionPtr;
+            std::list<std::string>::iterator    mLruIter;
+        };
+
+        Mutex                                   mMutex;
+        std::map<std::string, CachedContext>    mContexts;
+        std::map<std::string, CachedSession>    mSessions;
+
+        // Session keys, most recently used first.
+        std::list<std::string>                  mSessionLru;
+    };
+
+    OpenSslContextCache & Globals::getOpenSslContextCache()
+    {
+        Lock lock(getRootMutex());
+
+        if (!mpOpenSslContextCache)
+        {
+            mpOpenSslContextCache = new OpenSslContextCache();
+        }
+        return *mpOpenSslContextCache;
+    }
+
 #if RCF_FEATURE_OPENSSL==1
 
+    void Globals::releaseOpenSslContextCache()
+    {
+        if (mpOpenSslContextCache)
+        {
+            delete mpOpenSslContextCache;
+            mpOpenSslContextCache = NULL;
+        }
+    }
+
     void Globals::releaseOpenSslDll()
     {
         if (mpOpenSslDll)
@@ -318,6 +487,14 @@ namespace RCF {
 #define RCF__SSL_CTX_use_PrivateKey                     mSslDll.pfn_SSL_CTX_use_PrivateKey
 #define RCF__SSL_CTX_use_certificate_chain_file         mSslDll.pfn_SSL_CTX_use_certificate_chain_file
 #define RCF__SSL_CTX_load_verify_locations              mSslDll.pfn_SSL_CTX_load_verify_locations
+#define RCF__SSL_CTX_ctrl                               mSslDll.pfn_SSL_CTX_ctrl
+#define RCF__SSL_CTX_sess_set_new_cb                    mSslDll.pfn_SSL_CTX_sess_set_new_cb
+#define RCF__SSL_CTX_set_session_id_context             mSslDll.pfn_SSL_CTX_set_session_id_context
+#define RCF__SSL_set_session                            mSslDll.pfn_SSL_set_session
+#define RCF__SSL_SESSION_free                           mSslDll.pfn_SSL_SESSION_free
+#define RCF__SSL_SESSION_dup                            mSslDll.pfn_SSL_SESSION_dup
+#define RCF__SSL_set_ex_data                            mSslDll.pfn_SSL_set_ex_data
+#define RCF__SSL_get_ex_data                            mSslDll.pfn_SSL_get_ex_data
 #define RCF__SSL_load_error_strings                     mSslDll.pfn_SSL_load_error_strings
 #define RCF__SSL_library_init                           mSslDll.pfn_SSL_library_init
 
@@ -344,6 +521,8 @@ namespace RCF {
 #define RCF__X509_get_subject_name                      mCryptoDll.pfn_X509_get_subject_name
 #define RCF__X509_get_issuer_name                       mCryptoDll.pfn_X509_get_issuer_name
 #define RCF__X509_NAME_print_ex                         mCryptoDll.pfn_X509_NAME_print_ex
+#define RCF__EVP_Digest                                 mCryptoDll.pfn_EVP_Digest
+#define RCF__EVP_sha256                                 mCryptoDll.pfn_EVP_sha256
 
 /*
     void printErrors(SSL * pSsl, int result)
@@ -554,7 +733,9 @@ namespace RCF {
             const std::string &             caCertificate,
             const std::string &             ciphers,
             CertificateValidationCallback   verifyFunctor,
-            unsigned int                    bioBufferSize);
+            unsigned int                    bioBufferSize,
+            bool                            enableSessionResumption,
+            const std::string &             peerName);
 
         void reset();
 
@@ -572,9 +753,15 @@ namespace RCF {
         SSL_CTX *   getCTX();
         X509 *      getPeerCertificate();
 
+        void        onNewSession(SSL_SESSION * pSession);
+
     private:
         void init();
 
+        std::string getDigest(const std::string & data);
+
+        std::shared_ptr<SSL_CTX> createContext();
+
         bool loadCertificate(
             std::shared_ptr<SSL_CTX>  ctx,
             const std::string &         file,
@@ -599,6 +786,7 @@ namespace RCF {
         std::vector<ByteBuffer>         mByteBuffers;
 
         ReallocBufferPtr                mVecPtr;
+        ReallocBufferPtr                mWriteVecPtr;
 
         enum IoState
         {
@@ -623,6 +811,11 @@ namespace RCF {
         CertificateValidationCallback   mVerifyFunctor;
         int                             mErr;
 
+        bool                            mEnableSessionResumption;
+        std::string                     mPeerName;
+        std::string                     mContextKey;
+        std::string                     mSessionKey;
+
         // OpenSSL members
         // NB: using shared_ptr instead of auto_ptr, since we need custom deleters
         std::shared_ptr<SSL_CTX>      mSslCtx;
@@ -654,7 +847,8 @@ namespace RCF {
         const std::string &ciphers,
         CertificateValidationCallback verifyFunctor,
         SslRole sslRole,
-        unsigned int bioBufferSize) :
+        unsigned int bioBufferSize,
+        bool enableSessionResumption) :
             mImplPtr( new OpenSslEncryptionFilterImpl(
                 *this,
                 sslRole,
@@ -663,7 +857,9 @@ namespace RCF {
                 caCertificate,
                 ciphers,
                 verifyFunctor,
-                bioBufferSize) )
+                bioBufferSize,
+                enableSessionResumption,
+                std::string()) )
     {}
 
     OpenSslEncryptionFilter::OpenSslEncryptionFilter(
@@ -693,6 +889,14 @@ namespace RCF {
         std::string ciphers = pClientStub->getOpenSslCipherSuite();
         CertificateValidationCallback certValidationCb = pClientStub->getCertificateValidationCallback();
 
+        // Sessions are resumed only with the endpoint they were established with.
+        std::string peerName;
+        EndpointPtr endpointPtr = pClientStub->getEndpoint();
+        if (endpointPtr)
+        {
+            peerName = endpointPtr->asString();
+        }
+
         mImplPtr.reset( new OpenSslEncryptionFilterImpl(
             *this,
             sslRole,
@@ -701,7 +905,9 @@ namespace RCF {
             caCertificate,
             ciphers,
             certValidationCb,
-            bioBufferSize) );
+            bioBufferSize,
+            pClientStub->getEnableSslSessionResumption(),
+            peerName) );
     }
 
 
@@ -783,7 +989,9 @@ namespace RCF {
         const std::string &caCertificate,
         const std::string &ciphers,
         CertificateValidationCallback verifyFunctor,
-        unsigned int bioBufferSize) :
+        unsigned int bioBufferSize,
+        bool enableSessionResumption,
+        const std::string & peerName) :
             mSslDll(globals().getOpenSslDll()),
             mCryptoDll(globals().getOpenSslCryptoDll()),
             mSslRole(sslRole),
@@ -801,6 +1009,8 @@ namespace RCF {
             mPostBufferRequested(),
             mVerifyFunctor(verifyFunctor),
             mErr(),
+            mEnableSessionResumption(enableSessionResumption),
+            mPeerName(peerName),
             mBioBufferSize(bioBufferSize),
             mOpenSslEncryptionFilter(openSslEncryptionFilter),
             mUseRecursionLimiter(sslRole == SslClient)
@@ -808,6 +1018,54 @@ namespace RCF {
         init();
     }
 
+    // Identifies the current contents of a file by its size and modification time. Empty if there is no such file.
+    static std::string getFileStamp(const std::string & path)
+    {
+        if (path.empty())
+        {
+            return std::string();
+        }
+
+#ifdef RCF_WINDOWS
+        struct _stat fileInfo = {};
+        int ret = _stat(path.c_str(), &fileInfo);
+#else
+        struct stat fileInfo = {};
+        int ret = stat(path.c_str(), &fileInfo);
+#endif
+
+        if (ret != 0)
+        {
+            return std::string();
+        }
+
+        std::ostringstream os;
+        os << std::uint64_t(fileInfo.st_size) << ":" << std::uint64_t(fileInfo.st_mtime);
+        return os.str();
+    }
+
+    // Hex encoded SHA-256 digest, so that certificate passwords are not kept in the context cache.
+    std::string OpenSslEncryptionFilterImpl::getDigest(const std::string & data)
+    {
+        unsigned char digest[EVP_MAX_MD_SIZE] = { 0 };
+        unsigned int digestLength = 0;
+        if (1 != RCF__EVP_Digest(data.data(), data.size(), digest, &digestLength, RCF__EVP_sha256(), NULL))
+        {
+            std::string opensslErrors = getOpenSslErrors();
+            Exception e( RcfError_OpenSslFilterInit, opensslErrors );
+            RCF_THROW(e);
+        }
+
+        static const char HexDigits[] = "0123456789abcdef";
+        std::string hex;
+        for (unsigned int i=0; i<digestLength; ++i)
+        {
+            hex += HexDigits[digest[i] >> 4];
+            hex += HexDigits[digest[i] & 0xF];
+        }
+        return hex;
+    }
+
     void OpenSslEncryptionFilterImpl::read(
         const ByteBuffer &byteBuffer,
         std::size_t bytesRequested)
@@ -836,9 +1094,10 @@ namespace RCF {
             mPreState = Reading;
             if (byteBuffer.getLength() == 0)
             {
-                if (mVecPtr.get() == NULL && !mVecPtr.unique())
+                // The previous buffer may still be held further up the filter chain.
+                if (mVecPtr.get() == NULL || !mVecPtr.unique())
                 {
-                    mVecPtr.reset(new ReallocBuffer(bytesRequested));
+                    mVecPtr = getObjectPool().getReallocBufferPtr(bytesRequested);
                 }
                 mVecPtr->resize(bytesRequested);
                 mPreByteBuffer = ByteBuffer(mVecPtr);
@@ -857,7 +1116,30 @@ namespace RCF {
     {
         RCF_ASSERT(mPreState == Ready);
         mPreState = Writing;
-        mPreByteBuffer = byteBuffers.front();
+
+        // Each BIO_write() produces at least one TLS record, and one write on the next filter. Rather than 
+        // sending a small leading buffer, such as a message header, on its own, gather it with what follows, 
+        // into a single record.
+        const std::size_t MaxRecordLength = 16*1024;
+        if (byteBuffers.size() > 1 && byteBuffers.front().getLength() < MaxRecordLength)
+        {
+            std::size_t bytesToGather = RCF_MIN(lengthByteBuffers(byteBuffers), MaxRecordLength);
+            if (mWriteVecPtr.get() == NULL || !mWriteVecPtr.unique())
+            {
+                mWriteVecPtr = getObjectPool().getReallocBufferPtr(bytesToGather);
+            }
+            mWriteVecPtr->resize(bytesToGather);
+
+            std::vector<ByteBuffer> slicedBuffers;
+            sliceByteBuffers(slicedBuffers, byteBuffers, 0, bytesToGather);
+            copyByteBuffers(slicedBuffers, mWriteVecPtr->getPtr());
+            mPreByteBuffer = ByteBuffer(mWriteVecPtr);
+        }
+        else
+        {
+            mPreByteBuffer = byteBuffers.front();
+        }
+
         readWrite();
     }
 
@@ -1132,26 +1414,59 @@ namespace RCF {
             RCF__BIO_new(RCF__BIO_f_ssl()),
             RCF__BIO_free);
 
-        mSslCtx = std::shared_ptr<SSL_CTX>(
-            RCF__SSL_CTX_new(RCF__TLS_method()),
-            RCF__SSL_CTX_free);
-
         RCF_ASSERT(mSslRole == SslServer || mSslRole == SslClient);
-        
-        if (!mCertificateFile.empty())
+
+        if (mEnableSessionResumption)
         {
-            loadCertificate(mSslCtx, mCertificateFile, mCertificateFilePassword);
-        }
+            if (mContextKey.empty())
+            {
+                std::ostringstream os;
+                os  << (mSslRole == SslServer ? "server" : "client") << "|" 
+                    << mCertificateFile << "|" << getDigest(mCertificateFilePassword) << "|" << mCaCertificate;
+                mContextKey = os.str();
+            }
 
-        if (!mCaCertificate.empty())
+            // Checked on every connection, so that a renewed certificate is picked up without restarting.
+            std::string fileStamp = getFileStamp(mCertificateFile) + "|" + getFileStamp(mCaCertificate);
+
+            // Sessions established under a previous CA certificate are not offered again.
+            if (mSslRole == SslClient && !mPeerName.empty())
+            {
+                mSessionKey = mContextKey + "|" + fileStamp + "|" + mPeerName;
+            }
+
+            // Shared with other connections, so certificates are only loaded once, and sessions can be resumed.
+            OpenSslContextCache & contextCache = globals().getOpenSslContextCache();
+            mSslCtx = contextCache.getContext(mContextKey, fileStamp);
+            if (!mSslCtx)
+            {
+                mSslCtx = contextCache.addContext(mContextKey, fileStamp, createContext());
+            }
+        }
+        else
         {
-            loadCaCertificate(mSslCtx, mCaCertificate);
+            mSslCtx = createContext();
         }
 
         mSsl = std::shared_ptr<SSL>(
             RCF__SSL_new(mSslCtx.get()),
             RCF__SSL_free);
 
+        if (mSsl && !mSessionKey.empty() && mCryptoDll.mSslExDataIndex >= 0)
+        {
+            // Offer the last session we have with this server. If the server doesn't accept it, OpenSSL falls 
+            // back to a full handshake.
+            RCF__SSL_set_ex_data(mSsl.get(), mCryptoDll.mSslExDataIndex, this);
+
+            OpenSslContextCache::SslSessionPtr sessionPtr = 
+                globals().getOpenSslContextCache().getSession(mSessionKey);
+
+            if (sessionPtr)
+            {
+                RCF__SSL_set_session(mSsl.get(), sessionPtr.get());
+            }
+        }
+
         bool requestClientCertificate = (mCaCertificate.size() > 0 || mVerifyFunctor);
         if (mSslRole == SslServer && requestClientCertificate)
         {
@@ -1190,6 +1505,88 @@ namespace RCF {
 
     }
 
+    // Called by OpenSSL when a client receives a new session from a server.
+    int onNewOpenSslSession(SSL * pSsl, SSL_SESSION * pSession)
+    {
+        OpenSslDll & sslDll = globals().getOpenSslDll();
+        OpenSslCryptoDll & cryptoDll = globals().getOpenSslCryptoDll();
+        if (cryptoDll.mSslExDataIndex < 0)
+        {
+            return 0;
+        }
+
+        OpenSslEncryptionFilterImpl * pImpl = 
+            static_cast<OpenSslEncryptionFilterImpl *>(sslDll.pfn_SSL_get_ex_data(pSsl, cryptoDll.mSslExDataIndex));
+
+        if (pImpl)
+        {
+            pImpl->onNewSession(pSession);
+        }
+
+        // OpenSSL keeps ownership of the session.
+        return 0;
+    }
+
+    void OpenSslEncryptionFilterImpl::onNewSession(SSL_SESSION * pSession)
+    {
+        // The session belongs to this connection, and OpenSSL marks it as not resumable if the connection is 
+        // freed without a SSL shutdown. So we cache a copy of it instead.
+        SSL_SESSION * pSessionCopy = RCF__SSL_SESSION_dup(pSession);
+        if (pSessionCopy)
+        {
+            OpenSslContextCache::SslSessionPtr sessionPtr(pSessionCopy, RCF__SSL_SESSION_free);
+            globals().getOpenSslContextCache().setSession(mSessionKey, sessionPtr);
+        }
+    }
+
+    std::shared_ptr<SSL_CTX> OpenSslEncryptionFilterImpl::createContext()
+    {
+        std::shared_ptr<SSL_CTX> sslCtx(
+            RCF__SSL_CTX_new(RCF__TLS_method()),
+            RCF__SSL_CTX_free);
+
+        if (!sslCtx)
+        {
+            std::string opensslErrors = getOpenSslErrors();
+            Exception e( RcfError_OpenSslFilterInit, opensslErrors );
+            RCF_THROW(e);
+        }
+
+        if (!mCertificateFile.empty())
+        {
+            loadCertificate(sslCtx, mCertificateFile, mCertificateFilePassword);
+        }
+
+        if (!mCaCertificate.empty())
+        {
+            loadCaCertificate(sslCtx, mCaCertificate);
+        }
+
+        if (mEnableSessionResumption)
+        {
+            if (mSslRole == SslServer)
+            {
+                // Required for resumption when client certificates are requested.
+                static const unsigned char SessionIdContext[] = "RCF";
+                RCF__SSL_CTX_set_session_id_context(sslCtx.get(), SessionIdContext, sizeof(SessionIdContext) - 1);
+            }
+            else
+            {
+                // Sessions are stored in our own cache, keyed by server endpoint.
+                // Equivalent to SSL_CTX_set_session_cache_mode(), which is a macro.
+                RCF__SSL_CTX_ctrl(
+                    sslCtx.get(), 
+                    SSL_CTRL_SET_SESS_CACHE_MODE, 
+                    SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE, 
+                    NULL);
+
+                RCF__SSL_CTX_sess_set_new_cb(sslCtx.get(), &onNewOpenSslSession);
+            }
+        }
+
+        return sslCtx;
+    }
+
     bool OpenSslEncryptionFilterImpl::loadCertificate(
         std::shared_ptr<SSL_CTX> ctx,
         const std::string &file,
@@ -1287,7 +1684,9 @@ namespace RCF {
             caCertificate,
             ciphers,
             certValidationCb,
-            mRole));
+            mRole,
+            17*1024,
+            server.getEnableSslSessionResumption()));
     }
 
     int OpenSslEncryptionFilterFactory::getFilterId()
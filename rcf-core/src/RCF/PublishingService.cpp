@@ -49,6 +49,26 @@ namespace RCF {
     {
         mOnSubscriberDisconnect = onSubscriberDisconnect;
     }
+
+    void PublisherParms::setSubscriberQueueLength(std::size_t queueLength)
+    {
+        mSubscriberQueueLength = queueLength;
+    }
+
+    std::size_t PublisherParms::getSubscriberQueueLength() const
+    {
+        return mSubscriberQueueLength;
+    }
+
+    void PublisherParms::setSlowSubscriberPolicy(SlowSubscriberPolicy policy)
+    {
+        mSlowSubscriberPolicy = policy;
+    }
+
+    SlowSubscriberPolicy PublisherParms::getSlowSubscriberPolicy() const
+    {
+        return mSlowSubscriberPolicy;
+    }
     
 #ifdef _MSC_VER
 #pragma warning( push )
@@ -96,6 +116,19 @@ namespace RCF {
         const std::string &subscriptionName,
         std::uint32_t subToPubPingIntervalMs,
         std::uint32_t & pubToSubPingIntervalMs)
+    {
+        return RequestSubscription(
+            subscriptionName,
+            subToPubPingIntervalMs,
+            pubToSubPingIntervalMs,
+            SubscriptionFilter());
+    }
+
+    std::int32_t PublishingService::RequestSubscription(
+        const std::string &subscriptionName,
+        std::uint32_t subToPubPingIntervalMs,
+        std::uint32_t & pubToSubPingIntervalMs,
+        const SubscriptionFilter & filter)
     {
         PublisherPtr publisherPtr;
         std::string publisherName = subscriptionName;
@@ -146,7 +179,8 @@ namespace RCF {
                 this,
                 std::placeholders::_1,
                 publisherName,
-                clientTransportUniquePtrPtr) );
+                clientTransportUniquePtrPtr,
+                filter) );
         }  
         pubToSubPingIntervalMs = mPingIntervalMs;
         return publisherPtr ? RcfError_Ok_Id : RcfError_UnknownPublisher_Id;
@@ -201,7 +235,8 @@ namespace RCF {
     void PublishingService::addSubscriberTransport(
         RcfSession &rcfSession,
         const std::string &publisherName,
-        ClientTransportUniquePtrPtr clientTransportUniquePtrPtr)
+        ClientTransportUniquePtrPtr clientTransportUniquePtrPtr,
+        const SubscriptionFilter &filter)
     {
         PublisherPtr publisherPtr;
 
@@ -238,7 +273,10 @@ namespace RCF {
                 static_cast<MulticastClientTransport &>(
                     publisherPtr->mRcfClientPtr->getClientStub().getTransport());
 
-            multicastClientTransport.addTransport(std::move(*clientTransportUniquePtrPtr));
+            multicastClientTransport.addTransport(
+                std::move(*clientTransportUniquePtrPtr), 
+                &networkSession.mIoService,
+                filter);
         }
     }
 
@@ -360,6 +398,30 @@ namespace RCF {
         return transportCount;
     }
 
+    void PublisherBase::prepareMessage(const std::string & conflationKey)
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multicastTransport = static_cast<MulticastClientTransport &>(transport);
+        multicastTransport.setConflationKey(conflationKey);
+        multicastTransport.clearRouting();
+    }
+
+    void PublisherBase::prepareMessage(std::uint64_t routingKey, const std::string & conflationKey)
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multicastTransport = static_cast<MulticastClientTransport &>(transport);
+        multicastTransport.setConflationKey(conflationKey);
+        multicastTransport.setRoutingKey(routingKey);
+    }
+
+    void PublisherBase::prepareTaggedMessage(const std::string & tag, const std::string & conflationKey)
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multicastTransport = static_cast<MulticastClientTransport &>(transport);
+        multicastTransport.setConflationKey(conflationKey);
+        multicastTransport.setRoutingTag(tag);
+    }
+
     void PublisherBase::close()
     {
         mPublishingService.closePublisher(mTopicName);
@@ -378,8 +440,11 @@ namespace RCF {
 
     void PublisherBase::init()
     {
+        MulticastClientTransport * pMulticastTransport = new MulticastClientTransport();
+        pMulticastTransport->setQueueLimits(mParms.mSubscriberQueueLength, mParms.mSlowSubscriberPolicy);
+
         mRcfClientPtr->getClientStub().setTransport(
-            ClientTransportUniquePtr(new MulticastClientTransport));
+            ClientTransportUniquePtr(pMulticastTransport));
 
         mRcfClientPtr->getClientStub().setRemoteCallMode(Oneway);
         mRcfClientPtr->getClientStub().setServerBindingName("");
@@ -23,6 +23,7 @@
 #include "AsioHandlerCache.cpp"
 #include "AsioServerTransport.cpp"
 #include "BsdClientTransport.cpp"
+#include "BufferAllocator.cpp"
 #include "ByteBuffer.cpp"
 #include "ByteOrdering.cpp"
 #include "Certificate.cpp"
@@ -36,6 +37,7 @@
 #include "Enums.cpp"
 #include "ErrorMsg.cpp"
 #include "Exception.cpp"
+#include "CompressionFilter.cpp"
 #include "Filter.cpp"
 #include "FilterService.cpp"
 #include "Future.cpp"
@@ -58,11 +60,13 @@
 #include "RemoteCallContext.cpp"
 #include "ReallocBuffer.cpp"
 #include "SerializationProtocol.cpp"
+#include "SerializationThreadPool.cpp"
 #include "ServerStub.cpp"
 #include "ServerTask.cpp"
 #include "ServerTransport.cpp"
 #include "Service.cpp"
 #include "SessionTimeoutService.cpp"
+#include "SubscriptionFilter.cpp"
 #include "Tchar.cpp"
 #include "ThreadLibrary.cpp"
 #include "ThreadLocalData.cpp"
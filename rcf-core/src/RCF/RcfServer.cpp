@@ -22,6 +22,7 @@
 #include <functional>
 
 #include <RCF/CallbackConnectionService.hpp>
+#include <RCF/CompressionFilter.hpp>
 #include <RCF/Config.hpp>
 #include <RCF/Filter.hpp>
 #include <RCF/CurrentSession.hpp>
@@ -175,6 +176,10 @@ namespace RCF {
 #if RCF_FEATURE_FILETRANSFER==1
         mFileUploadQuota = 0;
         mFileDownloadQuota = 0;
+        mFileDownloadMemoryMapping = false;
+        mFileIoThreadCount = 0;
+        mFileIoQueueDepth = 1;
+        mFileUploadIdleTimeoutS = 10*60;
 #endif
         
         mFilterServicePtr.reset( new FilterService() );
@@ -189,8 +194,13 @@ namespace RCF {
 #if RCF_FEATURE_ZLIB==1
         mFilterServicePtr->addFilterFactory( FilterFactoryPtr( new ZlibCompressionFilterFactory() ) );
         mFilterServicePtr->addFilterFactory( FilterFactoryPtr( new ZlibStatelessCompressionFilterFactory() ) );
+        mFilterServicePtr->addFilterFactory( FilterFactoryPtr( new CompressionFilterFactory(&createZlibCompressionCodec, true) ) );
+        mFilterServicePtr->addFilterFactory( FilterFactoryPtr( new CompressionFilterFactory(&createZlibCompressionCodec, false) ) );
 #endif
 
+        mFilterServicePtr->addFilterFactory( FilterFactoryPtr( new Lz4CompressionFilterFactory(true) ) );
+        mFilterServicePtr->addFilterFactory( FilterFactoryPtr( new Lz4CompressionFilterFactory(false) ) );
+
 #if RCF_FEATURE_OPENSSL==1
         mFilterServicePtr->addFilterFactory( FilterFactoryPtr( new OpenSslEncryptionFilterFactory() ));        
 #endif
@@ -548,7 +558,10 @@ namespace RCF {
                 mRequest.mSerializationProtocol, 
                 mRuntimeVersion, 
                 mArchiveVersion,
-                mRequest.mEnableSfPointerTracking);
+                mRequest.mEnableSfPointerTracking,
+                mRequest.mEnableSfSchemaFixed);
+
+            mIn.setParallelSerializationThreshold(mRequest.mParallelSerializationThreshold);
 
             messageBody.clear();
             
@@ -626,6 +639,8 @@ namespace RCF {
             }
         }
 
+        clearParameters();
+
         typedef std::vector<RcfSession::OnWriteCompletedCallback> OnWriteCompletedCallbacks;
         ThreadLocalCached< OnWriteCompletedCallbacks > tlcOwcc;
         OnWriteCompletedCallbacks &onWriteCompletedCallbacks = tlcOwcc.get();
@@ -766,10 +781,19 @@ namespace RCF {
                 buffer, 
                 mRuntimeVersion, 
                 mArchiveVersion,
-                mEnableSfPointerTracking);
+                mEnableSfPointerTracking,
+                mRequest.mEnableSfSchemaFixed);
+
+            mOut.setParallelSerializationThreshold(mRequest.mParallelSerializationThreshold);
 
             mpParameters->write(mOut);
-            clearParameters();
+
+            // If the response refers directly to memory held by the parameters, the 
+            // parameters are cleared once the write has completed.
+            if (!mOut.hasUserBuffers())
+            {
+                clearParameters();
+            }
         }
         catch(const std::exception &e)
         {
@@ -969,7 +993,8 @@ namespace RCF {
         rsMsg.mResponseError = mRcfServer.mPublishingServicePtr->RequestSubscription(
             rsMsg.mPublisherName,
             rsMsg.mSubToPubPingIntervalMs,
-            rsMsg.mPubToSubPingIntervalMs);
+            rsMsg.mPubToSubPingIntervalMs,
+            rsMsg.mFilter);
 
 #else
 
@@ -1164,6 +1189,7 @@ namespace RCF {
 
         WriteLock writeLock(mStubMapMutex);
         mStubMap[name] = rcfClientPtr;
+        ++mStubMapVersion;
         return rcfClientPtr->getServerStubPtr();
     }
 
@@ -1347,6 +1373,18 @@ namespace RCF {
         return mOpenSslCipherSuite;
     }
 
+    void RcfServer::setEnableSslSessionResumption(bool enable)
+    {
+        WriteLock lock(mPropertiesMutex);
+        mEnableSslSessionResumption = enable;
+    }
+
+    bool RcfServer::getEnableSslSessionResumption() const
+    {
+        ReadLock lock(mPropertiesMutex);
+        return mEnableSslSessionResumption;
+    }
+
 
 
     //--------------------------------------------------------------------------
@@ -1563,6 +1601,56 @@ namespace RCF {
         mFileDownloadQuotaCb = downloadQuotaCb;
     }
 
+    void RcfServer::setDownloadMemoryMapping(bool enable)
+    {
+        RCF_ASSERT(!mStarted);
+        mFileDownloadMemoryMapping = enable;
+    }
+
+    bool RcfServer::getDownloadMemoryMapping() const
+    {
+        return mFileDownloadMemoryMapping;
+    }
+
+    void RcfServer::setUploadBasisCallback(UploadBasisCallback uploadBasisCb)
+    {
+        RCF_ASSERT(!mStarted);
+        mFileUploadBasisCb = uploadBasisCb;
+    }
+
+    void RcfServer::setFileIoThreadCount(std::size_t threadCount)
+    {
+        RCF_ASSERT(!mStarted);
+        mFileIoThreadCount = threadCount;
+    }
+
+    std::size_t RcfServer::getFileIoThreadCount() const
+    {
+        return mFileIoThreadCount;
+    }
+
+    void RcfServer::setFileIoQueueDepth(std::size_t queueDepth)
+    {
+        RCF_ASSERT(!mStarted);
+        mFileIoQueueDepth = RCF_MAX(queueDepth, std::size_t(1));
+    }
+
+    std::size_t RcfServer::getFileIoQueueDepth() const
+    {
+        return mFileIoQueueDepth;
+    }
+
+    void RcfServer::setUploadIdleTimeoutS(std::uint32_t idleTimeoutS)
+    {
+        RCF_ASSERT(!mStarted);
+        mFileUploadIdleTimeoutS = idleTimeoutS;
+    }
+
+    std::uint32_t RcfServer::getUploadIdleTimeoutS() const
+    {
+        return mFileUploadIdleTimeoutS;
+    }
+
     Path RcfServer::getUploadPath(const std::string & uploadId)
     {
         namespace fs = RCF_FILESYSTEM_NS;
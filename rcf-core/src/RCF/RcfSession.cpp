@@ -64,6 +64,7 @@ namespace RCF {
         mpParameters(),
         mParmsVec(1+15), // return value + max 15 arguments
         mAutoSend(true),
+        mResolvedStubMapVersion(0),
         mpNetworkSession(NULL),
         mTransportProtocol(Tp_Clear),
         mEnableCompression(false),
@@ -222,6 +223,50 @@ namespace RCF {
         mCachedStubEntryPtr = stubEntryPtr;
     }
 
+    RcfClientPtr RcfSession::getResolvedStubEntryPtr(
+        const std::string &     name, 
+        std::uint32_t           stubMapVersion)
+    {
+        // Only one call at a time is dispatched on a session, so no locking needed here.
+        if (stubMapVersion != mResolvedStubMapVersion)
+        {
+            mResolvedStubEntries.clear();
+            mResolvedStubMapVersion = stubMapVersion;
+            return RcfClientPtr();
+        }
+
+        for (std::size_t i=0; i<mResolvedStubEntries.size(); ++i)
+        {
+            if (mResolvedStubEntries[i].first == name)
+            {
+                return mResolvedStubEntries[i].second;
+            }
+        }
+
+        return RcfClientPtr();
+    }
+
+    void RcfSession::addResolvedStubEntryPtr(
+        const std::string &     name, 
+        std::uint32_t           stubMapVersion, 
+        RcfClientPtr            stubEntryPtr)
+    {
+        const std::size_t MaxResolvedStubEntries = 16;
+
+        if (stubMapVersion != mResolvedStubMapVersion)
+        {
+            mResolvedStubEntries.clear();
+            mResolvedStubMapVersion = stubMapVersion;
+        }
+
+        if (mResolvedStubEntries.size() >= MaxResolvedStubEntries)
+        {
+            mResolvedStubEntries.clear();
+        }
+
+        mResolvedStubEntries.push_back( ResolvedStubEntry(name, stubEntryPtr) );
+    }
+
     void RcfSession::getMessageFilters(std::vector<FilterPtr> &filters) const
     {
         filters = mFilters;
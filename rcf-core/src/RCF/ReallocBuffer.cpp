@@ -18,10 +18,6 @@
 
 #include <RCF/ReallocBuffer.hpp>
 
-#if RCF_FEATURE_CUSTOM_ALLOCATOR==1
-#include <RCF/CustomAllocator.hpp>
-#endif
-
 namespace RCF {
 
     ReallocBuffer::ReallocBuffer() : mpch(NULL), mSize(0), mCapacity(0)
@@ -38,13 +34,11 @@ namespace RCF {
         resize(0);
     }
 
-#if RCF_FEATURE_CUSTOM_ALLOCATOR==1
-
     ReallocBuffer::~ReallocBuffer()
     {
         if (mpch)
         {
-            RCF_delete(mpch);
+            mAllocatorPtr->deallocate(mpch, mCapacity);
             mpch = NULL;
         }
     }
@@ -53,41 +47,17 @@ namespace RCF {
     {
         if (newSize > mCapacity)
         {
-            char * mpchNew = (char *) RCF_new(newSize);
+            std::size_t newCapacity = 0;
             if (mpch)
             {
-                memcpy(mpchNew, mpch, mSize);
-                RCF_delete(mpch);
+                mpch = mAllocatorPtr->reallocate(mpch, mCapacity, newSize, newCapacity);
             }
-            mpch = mpchNew;
-            mCapacity = newSize;
-
-            // TODO: zero initialization for debug builds?
-            // ...
-        }
-        mSize = newSize;
-    }
-
-#else
-
-    ReallocBuffer::~ReallocBuffer()
-    {
-        if (mpch)
-        {
-            mpch = (char *) realloc(mpch, 0);
-        }
-    }
-
-    void ReallocBuffer::resize(std::size_t newSize)
-    {
-        if (newSize > mCapacity)
-        {
-            mpch = (char *) realloc(mpch, newSize);
-            if (!mpch)
+            else
             {
-                throw std::bad_alloc();
+                mAllocatorPtr = getDefaultBufferAllocator();
+                mpch = mAllocatorPtr->allocate(newSize, newCapacity);
             }
-            mCapacity = newSize;
+            mCapacity = newCapacity;
 
             // TODO: zero initialization for debug builds?
             // ...
@@ -95,9 +65,6 @@ namespace RCF {
         mSize = newSize;
     }
 
-
-#endif
-
     std::size_t ReallocBuffer::size()
     {
         return mSize;
@@ -19,7 +19,9 @@
 #include <RCF/SerializationProtocol.hpp>
 
 #include <RCF/Config.hpp>
+#include <RCF/Globals.hpp>
 #include <RCF/ObjectPool.hpp>
+#include <RCF/SerializationThreadPool.hpp>
 #include <RCF/Version.hpp>
 
 namespace RCF {
@@ -69,7 +71,11 @@ namespace RCF {
     SerializationProtocolIn::SerializationProtocolIn() :
         mProtocol(DefaultSerializationProtocol),
         mRuntimeVersion( RCF::getRuntimeVersion() ),
-        mArchiveVersion( RCF::getArchiveVersion() )
+        mArchiveVersion( RCF::getArchiveVersion() ),
+        mEnableSfPointerTracking(false),
+        mEnableSfSchemaFixed(false),
+        mParallelSerializationThreshold(0),
+        mpParent(NULL)
     {
     }
 
@@ -95,14 +101,18 @@ namespace RCF {
 
     static const char chZero = 0;
 
-    void SerializationProtocolIn::reset(const ByteBuffer &data, int protocol, int runtimeVersion, int archiveVersion, bool enableSfPointerTracking)
+    void SerializationProtocolIn::reset(const ByteBuffer &data, int protocol, int runtimeVersion, int archiveVersion, bool enableSfPointerTracking, bool enableSfSchemaFixed)
     {
         mRuntimeVersion = runtimeVersion;
         mArchiveVersion = archiveVersion;
+        mEnableSfPointerTracking = enableSfPointerTracking;
+        mEnableSfSchemaFixed = enableSfSchemaFixed && protocol == Sp_SfBinary;
+        mParallelSerializationThreshold = 0;
 
         unbindProtocol();
 
         mByteBuffer = data;
+        mRetainedByteBuffers.clear();
 
         if (mByteBuffer)
         {
@@ -122,6 +132,7 @@ namespace RCF {
         if (protocol == Sp_SfBinary)
         {
             mInProtocol1.getIStream().setEnablePointerTracking(enableSfPointerTracking);
+            mInProtocol1.getIStream().setEnableSchemaFixed(mEnableSfSchemaFixed);
         }
 #endif
 
@@ -170,9 +181,15 @@ namespace RCF {
         }
     }
 
+    void SerializationProtocolIn::retainByteBuffer(const ByteBuffer &byteBuffer)
+    {
+        mRetainedByteBuffers.push_back(byteBuffer);
+    }
+
     void SerializationProtocolIn::clearByteBuffer()
     {
         mByteBuffer = ByteBuffer();
+        mRetainedByteBuffers.clear();
     }
 
     std::size_t SerializationProtocolIn::getArchiveLength()
@@ -198,11 +215,105 @@ namespace RCF {
         return mRuntimeVersion;
     }
 
+    bool SerializationProtocolIn::getEnableSfSchemaFixed() const
+    {
+        return mEnableSfSchemaFixed;
+    }
+
+    SerializationProtocolIn & SerializationProtocolIn::getRoot()
+    {
+        return mpParent ? mpParent->getRoot() : *this;
+    }
+
+    void SerializationProtocolIn::setParallelSerializationThreshold(std::uint32_t thresholdBytes)
+    {
+        mParallelSerializationThreshold = thresholdBytes;
+    }
+
+    std::uint32_t SerializationProtocolIn::getParallelSerializationThreshold() const
+    {
+        return mParallelSerializationThreshold;
+    }
+
+    void SerializationProtocolIn::readSegments(const std::vector<SegmentReader> & readers)
+    {
+        std::uint32_t segmentCount = 0;
+        read(segmentCount);
+
+        RCF_VERIFY(
+            segmentCount == readers.size(), 
+            Exception(RcfError_SfDataFormat));
+
+        std::vector<std::uint64_t> segmentLengths(segmentCount);
+        for (std::size_t i=0; i<segmentCount; ++i)
+        {
+            read(segmentLengths[i]);
+        }
+
+        std::vector<ByteBuffer> segments(segmentCount);
+        for (std::size_t i=0; i<segmentCount; ++i)
+        {
+            RCF_VERIFY(
+                segmentLengths[i] <= getRemainingArchiveLength(), 
+                Exception(RcfError_SfDataFormat));
+
+            extractSlice(segments[i], static_cast<std::size_t>(segmentLengths[i]));
+        }
+
+        std::vector< std::unique_ptr<SerializationProtocolIn> > segmentIns(segmentCount);
+        std::vector< std::function<void()> > parallelTasks;
+
+        for (std::size_t i=0; i<segmentCount; ++i)
+        {
+            segmentIns[i].reset( new SerializationProtocolIn() );
+            segmentIns[i]->mpParent = this;
+
+            SerializationProtocolIn & segmentIn = *segmentIns[i];
+            const ByteBuffer & segment = segments[i];
+            const SegmentReader & reader = readers[i];
+
+            auto readSegment = [this, &segmentIn, &segment, &reader]()
+            {
+                segmentIn.reset(
+                    segment, 
+                    mProtocol, 
+                    mRuntimeVersion, 
+                    mArchiveVersion, 
+                    mEnableSfPointerTracking, 
+                    mEnableSfSchemaFixed);
+
+                reader(segmentIn);
+            };
+
+            if (segment.getLength() >= mParallelSerializationThreshold)
+            {
+                parallelTasks.push_back(readSegment);
+            }
+            else
+            {
+                readSegment();
+            }
+        }
+
+        getSerializationThreadPool().runTasks(parallelTasks);
+
+        // Deserialized objects may refer to buffers retained by the segments.
+        for (std::size_t i=0; i<segmentCount; ++i)
+        {
+            std::vector<ByteBuffer> & retained = segmentIns[i]->mRetainedByteBuffers;
+            mRetainedByteBuffers.insert(mRetainedByteBuffers.end(), retained.begin(), retained.end());
+        }
+    }
+
     SerializationProtocolOut::SerializationProtocolOut() :
         mProtocol(DefaultSerializationProtocol),
         mMargin(),
+        mHasUserBuffers(false),
         mRuntimeVersion( RCF::getRuntimeVersion() ),
-        mArchiveVersion( RCF::getArchiveVersion() )
+        mArchiveVersion( RCF::getArchiveVersion() ),
+        mEnableSfPointerTracking(false),
+        mEnableSfSchemaFixed(false),
+        mParallelSerializationThreshold(0)
     {}
 
     void SerializationProtocolOut::setSerializationProtocol(int protocol)
@@ -221,11 +332,16 @@ namespace RCF {
         ByteBuffer byteBuffer,
         int runtimeVersion,
         int archiveVersion,
-        bool enableSfPointerTracking)
+        bool enableSfPointerTracking,
+        bool enableSfSchemaFixed)
     {
 
         mRuntimeVersion = runtimeVersion;
         mArchiveVersion = archiveVersion;
+        mEnableSfPointerTracking = enableSfPointerTracking;
+        mEnableSfSchemaFixed = enableSfSchemaFixed && protocol == Sp_SfBinary;
+        mParallelSerializationThreshold = 0;
+        mHasUserBuffers = false;
 
         unbindProtocol();
         if (!mOsPtr)
@@ -263,6 +379,7 @@ namespace RCF {
         if (protocol == Sp_SfBinary)
         {
             mOutProtocol1.getOStream().setEnablePointerTracking(enableSfPointerTracking);
+            mOutProtocol1.getOStream().setEnableSchemaFixed(mEnableSfSchemaFixed);
         }
 #endif
 
@@ -300,6 +417,37 @@ namespace RCF {
         mByteBuffers.push_back( std::make_pair(streamPos, byteBuffer));
     }
 
+    void SerializationProtocolOut::reserve(std::size_t sizeHint)
+    {
+        // Small messages grow quickly enough by doubling. The slack covers the archive metadata, node headers and 
+        // array counts around the hinted contents.
+        const std::size_t MinSizeHint = 64*1024;
+        const std::size_t Slack = 4*1024;
+
+        if (sizeHint >= MinSizeHint)
+        {
+            mOsPtr->reserve(sizeHint + Slack);
+        }
+    }
+
+    bool SerializationProtocolOut::insertUserBuffer(const char * pch, std::size_t len)
+    {
+        std::size_t threshold = globals().getZeroCopySendThreshold();
+        if (threshold == 0 || len < threshold)
+        {
+            return false;
+        }
+
+        insert( ByteBuffer(const_cast<char *>(pch), len, true) );
+        mHasUserBuffers = true;
+        return true;
+    }
+
+    bool SerializationProtocolOut::hasUserBuffers() const
+    {
+        return mHasUserBuffers;
+    }
+
     void SerializationProtocolOut::extractByteBuffers()
     {
         mByteBuffers.resize(0);
@@ -380,4 +528,85 @@ namespace RCF {
         return mRuntimeVersion;
     }
 
+    bool SerializationProtocolOut::getEnableSfSchemaFixed() const
+    {
+        return mEnableSfSchemaFixed;
+    }
+
+    void SerializationProtocolOut::setParallelSerializationThreshold(std::uint32_t thresholdBytes)
+    {
+        mParallelSerializationThreshold = thresholdBytes;
+    }
+
+    std::uint32_t SerializationProtocolOut::getParallelSerializationThreshold() const
+    {
+        return mParallelSerializationThreshold;
+    }
+
+    void SerializationProtocolOut::writeSegments(
+        const std::vector<SegmentWriter> &  writers, 
+        const std::vector<std::size_t> &    sizeHints)
+    {
+        RCF_ASSERT(writers.size() == sizeHints.size());
+
+        std::size_t segmentCount = writers.size();
+        std::vector< std::vector<ByteBuffer> > segmentBuffers(segmentCount);
+        std::vector<char> segmentHasUserBuffers(segmentCount);
+        std::vector< std::function<void()> > parallelTasks;
+
+        for (std::size_t i=0; i<segmentCount; ++i)
+        {
+            std::vector<ByteBuffer> & buffers = segmentBuffers[i];
+            char & hasUserBuffers = segmentHasUserBuffers[i];
+            const SegmentWriter & writer = writers[i];
+            std::size_t sizeHint = sizeHints[i];
+
+            auto writeSegment = [this, &buffers, &hasUserBuffers, &writer, sizeHint]()
+            {
+                SerializationProtocolOut segmentOut;
+
+                segmentOut.reset(
+                    mProtocol, 
+                    0, 
+                    ByteBuffer(), 
+                    mRuntimeVersion, 
+                    mArchiveVersion, 
+                    mEnableSfPointerTracking, 
+                    mEnableSfSchemaFixed);
+
+                segmentOut.reserve(sizeHint);
+                writer(segmentOut);
+                segmentOut.extractByteBuffers(buffers);
+                hasUserBuffers = segmentOut.hasUserBuffers();
+            };
+
+            if (sizeHint >= mParallelSerializationThreshold)
+            {
+                parallelTasks.push_back(writeSegment);
+            }
+            else
+            {
+                writeSegment();
+            }
+        }
+
+        getSerializationThreadPool().runTasks(parallelTasks);
+
+        // Segment count and lengths, followed by the segments themselves.
+        write( static_cast<std::uint32_t>(segmentCount) );
+        for (std::size_t i=0; i<segmentCount; ++i)
+        {
+            write( static_cast<std::uint64_t>(lengthByteBuffers(segmentBuffers[i])) );
+        }
+
+        for (std::size_t i=0; i<segmentCount; ++i)
+        {
+            for (std::size_t j=0; j<segmentBuffers[i].size(); ++j)
+            {
+                insert(segmentBuffers[i][j]);
+            }
+            mHasUserBuffers = mHasUserBuffers || segmentHasUserBuffers[i];
+        }
+    }
+
 } // namespace RCF
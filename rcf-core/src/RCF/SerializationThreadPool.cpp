@@ -0,0 +1,250 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#include <RCF/SerializationThreadPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+#include <RCF/ThreadLocalData.hpp>
+#include <RCF/Tools.hpp>
+
+namespace RCF {
+
+    // A set of tasks submitted by one runTasks() call. Tasks are claimed by index, by the submitting thread and by 
+    // any pool threads that pick up the batch.
+    //
+    // The batch holds its own copy of the tasks. A pool thread may pick up the batch just as the submitting thread 
+    // claims the last task and returns, and it then still looks at the task list, after the caller's vector is gone.
+    class SerializationThreadPool::TaskBatch
+    {
+    public:
+        TaskBatch(const std::vector< std::function<void()> > & tasks) : 
+            mTasks(tasks), 
+            mpRcfSession( getTlsRcfSessionPtr() ),
+            mpClientStub( getTlsClientStubPtr() ),
+            mNextTask(0), 
+            mCompletedTasks(0)
+        {
+        }
+
+        const std::vector< std::function<void()> >      mTasks;
+        RcfSession *                                    mpRcfSession;
+        ClientStub *                                    mpClientStub;
+
+        std::atomic<std::size_t>                        mNextTask;
+
+        RCF::Mutex                                      mMutex;
+        RCF::Condition                                  mCondition;
+        std::size_t                                     mCompletedTasks;
+        std::exception_ptr                              mError;
+    };
+
+    SerializationThreadPool::SerializationThreadPool() : 
+        mThreadPool(1, RCF_MAX(std::size_t(1), std::size_t(std::thread::hardware_concurrency())))
+    {
+        mThreadPool.setThreadName("RCF Serialization");
+        mThreadPool.setThreadIdleTimeoutMs(30*1000);
+        mThreadPool.setReserveLastThread(false);
+
+        mThreadPool.setTask( std::bind(
+            &SerializationThreadPool::task,
+            this));
+
+        mThreadPool.setStopFunctor( std::bind(
+            &SerializationThreadPool::stopTask,
+            this));
+    }
+
+    SerializationThreadPool::~SerializationThreadPool()
+    {
+        RCF_DTOR_BEGIN
+            mThreadPool.stop();
+        RCF_DTOR_END
+    }
+
+    void SerializationThreadPool::stop()
+    {
+        mThreadPool.stop();
+    }
+
+    void SerializationThreadPool::setThreadMaxCount(std::size_t threadMaxCount)
+    {
+        mThreadPool.setThreadMaxCount(threadMaxCount);
+    }
+
+    void SerializationThreadPool::runTasks(const std::vector< std::function<void()> > & tasks)
+    {
+        if (tasks.empty())
+        {
+            return;
+        }
+        else if (tasks.size() == 1)
+        {
+            tasks[0]();
+            return;
+        }
+
+        TaskBatchPtr batchPtr( new TaskBatch(tasks) );
+
+        {
+            RCF::Lock lock(mBatchesMutex);
+
+            // Lazy start of the thread pool.
+            if (!mThreadPool.isStarted())
+            {
+                mThreadPool.start();
+            }
+
+            mBatches.push_back(batchPtr);
+            mBatchesCondition.notify_all();
+        }
+
+        runBatchTasks(*batchPtr, false);
+
+        {
+            RCF::Lock lock(mBatchesMutex);
+            RCF::eraseRemove(mBatches, batchPtr);
+        }
+
+        {
+            RCF::Lock lock(batchPtr->mMutex);
+            while (batchPtr->mCompletedTasks < tasks.size())
+            {
+                batchPtr->mCondition.wait(lock);
+            }
+        }
+
+        if (batchPtr->mError)
+        {
+            std::rethrow_exception(batchPtr->mError);
+        }
+    }
+
+    void SerializationThreadPool::runBatchTasks(TaskBatch & batch, bool onPoolThread)
+    {
+        // Pool threads take on the context of the thread that submitted the batch.
+        if (onPoolThread && batch.mpRcfSession)
+        {
+            setTlsRcfSessionPtr(batch.mpRcfSession);
+        }
+        if (onPoolThread && batch.mpClientStub)
+        {
+            pushTlsClientStub(batch.mpClientStub);
+        }
+
+        std::size_t taskCount = batch.mTasks.size();
+        std::size_t taskIdx = 0;
+        while ((taskIdx = batch.mNextTask++) < taskCount)
+        {
+            std::exception_ptr error;
+            try
+            {
+                batch.mTasks[taskIdx]();
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+            }
+
+            RCF::Lock lock(batch.mMutex);
+            if (error && !batch.mError)
+            {
+                batch.mError = error;
+            }
+            ++batch.mCompletedTasks;
+            if (batch.mCompletedTasks == taskCount)
+            {
+                batch.mCondition.notify_all();
+            }
+        }
+
+        if (onPoolThread && batch.mpClientStub)
+        {
+            popTlsClientStub();
+        }
+        if (onPoolThread && batch.mpRcfSession)
+        {
+            setTlsRcfSessionPtr(NULL);
+        }
+    }
+
+    bool SerializationThreadPool::task()
+    {
+        TaskBatchPtr batchPtr;
+
+        {
+            RCF::Lock lock(mBatchesMutex);
+            while (mBatches.empty() && !mThreadPool.shouldStop())
+            {
+                using namespace std::chrono_literals;
+                mBatchesCondition.wait_for(lock, 1000ms);
+            }
+            if (mBatches.empty() || mThreadPool.shouldStop())
+            {
+                return false;
+            }
+            batchPtr = mBatches.front();
+
+            // Once every task in a batch has been claimed, there is nothing left for other threads to pick up.
+            if (batchPtr->mNextTask >= batchPtr->mTasks.size())
+            {
+                mBatches.pop_front();
+                return false;
+            }
+        }
+
+        RCF::ThreadInfoPtr threadInfoPtr = RCF::getTlsThreadInfoPtr();
+        if (threadInfoPtr)
+        {
+            threadInfoPtr->notifyBusy();
+        }
+
+        runBatchTasks(*batchPtr, true);
+
+        return false;
+    }
+
+    void SerializationThreadPool::stopTask()
+    {
+        RCF::Lock lock(mBatchesMutex);
+        mBatchesCondition.notify_all();
+    }
+
+    SerializationThreadPool * gpSerializationThreadPool = NULL;
+
+    void initSerializationThreadPool()
+    {
+        gpSerializationThreadPool = new SerializationThreadPool();
+    }
+
+    void deinitSerializationThreadPool()
+    {
+        delete gpSerializationThreadPool; 
+        gpSerializationThreadPool = NULL;
+    }
+
+    SerializationThreadPool & getSerializationThreadPool()
+    {
+        SerializationThreadPool * pSerializationThreadPool = gpSerializationThreadPool;
+        return *pSerializationThreadPool;
+    }
+
+} // namespace RCF
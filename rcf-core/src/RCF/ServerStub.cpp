@@ -36,6 +36,7 @@ namespace RCF {
     {
         Lock lock(mMutex);
         mCbAccessControl = cbAccessControl;
+        mHasAccessControl = cbAccessControl ? true : false;
     }
 
 
@@ -43,8 +44,9 @@ namespace RCF {
         int                         fnId,
         RcfSession &                session)
     {
-        // Check access control.
+        // Check access control. Only take the lock if an access control callback has been set.
 
+        if (mHasAccessControl)
         {
             Lock lock(mMutex);
             if (mCbAccessControl)
@@ -0,0 +1,58 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#include <RCF/SubscriptionFilter.hpp>
+
+#include <RCF/Tools.hpp>
+
+namespace RCF {
+
+    const std::size_t SubscriptionFilter::MaxEntries;
+
+    void SubscriptionFilter::addKey(std::uint64_t key)
+    {
+        mKeyRanges.push_back( KeyRange(key, key) );
+    }
+
+    void SubscriptionFilter::addKeyRange(std::uint64_t firstKey, std::uint64_t lastKey)
+    {
+        RCF_ASSERT(firstKey <= lastKey);
+        mKeyRanges.push_back( KeyRange(firstKey, lastKey) );
+    }
+
+    void SubscriptionFilter::addTag(const std::string & tag)
+    {
+        mTags.push_back(tag);
+    }
+
+    bool SubscriptionFilter::isEmpty() const
+    {
+        return mKeyRanges.empty() && mTags.empty();
+    }
+
+    const std::vector<SubscriptionFilter::KeyRange> & SubscriptionFilter::getKeyRanges() const
+    {
+        return mKeyRanges;
+    }
+
+    const std::vector<std::string> & SubscriptionFilter::getTags() const
+    {
+        return mTags;
+    }
+
+} // namespace RCF
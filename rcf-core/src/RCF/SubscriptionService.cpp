@@ -70,6 +70,16 @@ namespace RCF {
         mOnAsyncSubscribeCompleted = onAsyncSubscribeCompleted;
     }
 
+    void SubscriptionParms::setFilter(const SubscriptionFilter & filter)
+    {
+        mFilter = filter;
+    }
+
+    const SubscriptionFilter & SubscriptionParms::getFilter() const
+    {
+        return mFilter;
+    }
+
     Subscription::~Subscription()
     {
         RCF_DTOR_BEGIN
@@ -278,7 +288,8 @@ namespace RCF {
         const std::string &     publisherName,
         std::uint32_t subToPubPingIntervalMs, 
         std::uint32_t &       pubToSubPingIntervalMs,
-        bool &                  pingsEnabled)
+        bool &                  pingsEnabled,
+        const SubscriptionFilter & filter)
     {
         I_RcfClient client("", clientStubOrig);
         ClientStub & clientStub = client.getClientStub();
@@ -290,7 +301,8 @@ namespace RCF {
         OobRequestSubscription msg(
             clientStubOrig.getRuntimeVersion(), 
             publisherName, 
-            subToPubPingIntervalMs);
+            subToPubPingIntervalMs,
+            filter);
 
         ByteBuffer controlRequest;
         msg.encodeRequest(controlRequest);
@@ -350,6 +362,12 @@ namespace RCF {
         // First round trip, to do version negotiation with the server.
         clientStub.ping();
 
+        // Filters are evaluated by the publisher, so older publishers can't honor them.
+        if ( !parms.mFilter.isEmpty() && clientStub.getRuntimeVersion() < 20 )
+        {
+            RCF_THROW(Exception(RcfError_SubscriptionFilterNotSupported));
+        }
+
         if ( clientStub.getRuntimeVersion() <= 11 )
         {
             ret = doRequestSubscription_Legacy(
@@ -366,7 +384,8 @@ namespace RCF {
                 publisherName,
                 subToPubPingIntervalMs,
                 pubToSubPingIntervalMs,
-                pingsEnabled);
+                pingsEnabled,
+                parms.mFilter);
         }
 
         SubscriptionPtr subscriptionPtr = onRequestSubscriptionCompleted(
@@ -420,7 +439,8 @@ namespace RCF {
         const std::string &             publisherName,
         RcfClientPtr                    rcfClientPtr,
         OnSubscriptionDisconnect        onDisconnect,
-        OnAsyncSubscribeCompleted       onCompletion)
+        OnAsyncSubscribeCompleted       onCompletion,
+        bool                            hasFilter)
     {
         bool pingsEnabled = true;
 
@@ -428,6 +448,14 @@ namespace RCF {
         std::uint32_t pubToSubPingIntervalMs = 0;
 
         ExceptionPtr ePtr( fv.getAsyncException().release() );
+
+        // The request may have been downgraded to an older runtime version, in which case the publisher ignored the
+        // filter, and would send us every message.
+        if ( !ePtr && hasFilter && requestClientPtr->getClientStub().getRuntimeVersion() < 20 )
+        {
+            ePtr.reset( new Exception(RcfError_SubscriptionFilterNotSupported) );
+        }
+
         if (!ePtr)
         {
             // Get OOB response.
@@ -477,7 +505,8 @@ namespace RCF {
         OobRequestSubscription msg(
             clientStubOrig.getRuntimeVersion(), 
             publisherName, 
-            subToPubPingIntervalMs);
+            subToPubPingIntervalMs,
+            parms.mFilter);
 
         ByteBuffer controlRequest;
         msg.encodeRequest(controlRequest);
@@ -492,7 +521,8 @@ namespace RCF {
             publisherName,
             rcfClientPtr,
             parms.mOnDisconnect,
-            parms.mOnAsyncSubscribeCompleted )));
+            parms.mOnAsyncSubscribeCompleted,
+            !parms.mFilter.isEmpty() )));
     }
 
     void SubscriptionService::createSubscriptionImplBegin(
@@ -512,6 +542,13 @@ namespace RCF {
         
         RCF_ASSERT(onCompletion);
 
+        // Filters are evaluated by the publisher, so older publishers can't honor them. Version negotiation can still
+        // lower the runtime version, which is checked once the subscription request completes.
+        if ( !parms.mFilter.isEmpty() && clientStub.getRuntimeVersion() < 20 )
+        {
+            RCF_THROW(Exception(RcfError_SubscriptionFilterNotSupported));
+        }
+
         if ( clientStub.getRuntimeVersion() <= 11 )
         {
             doRequestSubscriptionAsync_Legacy(
@@ -19,6 +19,7 @@
 #include <RCF/TimedBsdSockets.hpp>
 
 #include <algorithm> //std::min/max
+#include <limits.h> // IOV_MAX
 
 #include <RCF/BsdClientTransport.hpp>
 #include <RCF/ClientStub.hpp>
@@ -207,6 +208,10 @@ namespace RCF {
                 msghdr hdr = {0};
                 hdr.msg_iov = &wsabufs[0];
                 hdr.msg_iovlen = wsabufs.size();
+#ifdef IOV_MAX
+                // Zero copy sends can produce many buffers. Send what we can, the remainder is sent on the next pass.
+                hdr.msg_iovlen = RCF_MIN(wsabufs.size(), static_cast<std::size_t>(IOV_MAX));
+#endif
                 count = sendmsg(fd, &hdr, 0);
                 myErr = Platform::OS::BsdSockets::GetLastError();
             }
@@ -26,11 +26,13 @@
 #include <RCF/Globals.hpp>
 #include <RCF/InitDeinit.hpp>
 #include <RCF/MemStream.hpp>
+#include <RCF/ObjectPool.hpp>
 #include <RCF/ReallocBuffer.hpp>
 #include <RCF/RecursionLimiter.hpp>
 #include <RCF/ThreadLibrary.hpp>
 #include <RCF/Tools.hpp>
 
+#include <math.h> // log2
 #include <string.h> // memset
 
 namespace RCF {
@@ -47,17 +49,27 @@ namespace RCF {
         typedef int         (*Pfn_deflateInit_)(z_streamp strm, int level, const char *version, int stream_size);
         typedef int         (*Pfn_deflate)(z_streamp strm, int flush);
         typedef int         (*Pfn_deflateEnd)(z_streamp strm);
+        typedef int         (*Pfn_deflateParams)(z_streamp strm, int level, int strategy);
+        typedef int         (*Pfn_deflateReset)(z_streamp strm);
+        typedef int         (*Pfn_deflateSetDictionary)(z_streamp strm, const Bytef *dictionary, uInt dictLength);
         typedef int         (*Pfn_inflateInit_)(z_streamp strm, const char *version, int stream_size);
         typedef int         (*Pfn_inflate)(z_streamp strm, int flush);
         typedef int         (*Pfn_inflateEnd)(z_streamp strm);
+        typedef int         (*Pfn_inflateReset)(z_streamp strm);
+        typedef int         (*Pfn_inflateSetDictionary)(z_streamp strm, const Bytef *dictionary, uInt dictLength);
 
         Pfn_deflateInit_    pfn_deflateInit_;
         Pfn_deflate         pfn_deflate;
         Pfn_deflateEnd      pfn_deflateEnd;
+        Pfn_deflateParams   pfn_deflateParams;
+        Pfn_deflateReset    pfn_deflateReset;
+        Pfn_deflateSetDictionary pfn_deflateSetDictionary;
 
         Pfn_inflateInit_    pfn_inflateInit_;
         Pfn_inflate         pfn_inflate;
         Pfn_inflateEnd      pfn_inflateEnd;
+        Pfn_inflateReset    pfn_inflateReset;
+        Pfn_inflateSetDictionary pfn_inflateSetDictionary;
 
         DynamicLibPtr       mDynamicLibPtr;
     };
@@ -99,10 +111,15 @@ namespace RCF {
         RCF_ZLIB_LOAD_FUNCTION(deflateInit_)
         RCF_ZLIB_LOAD_FUNCTION(deflate)
         RCF_ZLIB_LOAD_FUNCTION(deflateEnd)
+        RCF_ZLIB_LOAD_FUNCTION(deflateParams)
+        RCF_ZLIB_LOAD_FUNCTION(deflateReset)
+        RCF_ZLIB_LOAD_FUNCTION(deflateSetDictionary)
 
         RCF_ZLIB_LOAD_FUNCTION(inflateInit_)
         RCF_ZLIB_LOAD_FUNCTION(inflate)
         RCF_ZLIB_LOAD_FUNCTION(inflateEnd)
+        RCF_ZLIB_LOAD_FUNCTION(inflateReset)
+        RCF_ZLIB_LOAD_FUNCTION(inflateSetDictionary)
 
     }
 
@@ -190,8 +207,9 @@ namespace RCF {
         void onWriteCompleted(std::size_t bytesTransferred);
 
     private:
-        void resetCompressionState();
-        void compress();
+        void resetCompressionState(int level);
+        int chooseCompressionLevel();
+        void compress(int level);
 
         ZlibCompressionFilterBase & mFilter;
         z_stream                    mCstream;
@@ -200,6 +218,7 @@ namespace RCF {
         int                         mZerr;
         bool                        mCompressionStateInited;
         const bool                  mStateful;
+        int                         mCurrentLevel;
 
         std::vector<ByteBuffer>     mPostBuffers;
         std::vector<ByteBuffer>     mPreBuffers;
@@ -341,7 +360,7 @@ namespace RCF {
             {
                 if (mVecPtr.get() == NULL || !mVecPtr.unique())
                 {
-                    mVecPtr.reset( new ReallocBuffer());
+                    mVecPtr = getObjectPool().getReallocBufferPtr(mBytesRequested);
                 }
                 mVecPtr->resize(mBytesRequested);
                 mPreBuffer = ByteBuffer(mVecPtr);
@@ -404,7 +423,8 @@ namespace RCF {
             mTotalBytesOut(),
             mZerr(Z_OK),
             mCompressionStateInited(),
-            mStateful(stateful)
+            mStateful(stateful),
+            mCurrentLevel(Z_DEFAULT_COMPRESSION)
     {
         memset(&mCstream, 0, sizeof(mCstream));
     }
@@ -427,10 +447,10 @@ namespace RCF {
 
     void ZlibCompressionWriteFilter::reset()
     {
-        resetCompressionState();
+        resetCompressionState(mFilter.mCompressionLevel);
     }
 
-    void ZlibCompressionWriteFilter::resetCompressionState()
+    void ZlibCompressionWriteFilter::resetCompressionState(int level)
     {
         if (mCompressionStateInited)
         {
@@ -445,26 +465,92 @@ namespace RCF {
         mCstream.zalloc = NULL;
         mCstream.zfree = NULL;
         mCstream.opaque = NULL;
-        mZerr = mFilter.mZlibDll.pfn_deflateInit_(&mCstream, Z_DEFAULT_COMPRESSION, ZLIB_VERSION, sizeof(mCstream));
+        mZerr = mFilter.mZlibDll.pfn_deflateInit_(&mCstream, level, ZLIB_VERSION, sizeof(mCstream));
         
         RCF_VERIFY(
             mZerr == Z_OK,
             Exception(RcfError_Zlib, "deflateInit()", zlibError(mZerr)));
         
         mCompressionStateInited = true;
+        mCurrentLevel = level;
+    }
+
+    // Estimates the entropy of the data in bits per byte, from evenly spaced samples. Text and serialized structures 
+    // typically come in well under 6 bits per byte, while compressed, encrypted and random data come close to 8.
+    double estimateEntropy(const std::vector<ByteBuffer> & byteBuffers, std::size_t totalLength)
+    {
+        const std::size_t SampleCount = 16;
+        const std::size_t SampleLength = 256;
+
+        std::size_t counts[256] = { 0 };
+        std::size_t bytesSampled = 0;
+
+        std::size_t stride = RCF_MAX(totalLength / SampleCount, SampleLength);
+        std::size_t nextSample = 0;
+        std::size_t bufferStart = 0;
+        for (std::size_t i=0; i<byteBuffers.size(); ++i)
+        {
+            const ByteBuffer & buffer = byteBuffers[i];
+            const unsigned char * pch = (const unsigned char *) buffer.getPtr();
+            std::size_t bufferEnd = bufferStart + buffer.getLength();
+
+            while (nextSample < bufferEnd)
+            {
+                std::size_t begin = nextSample - bufferStart;
+                std::size_t end = RCF_MIN(begin + SampleLength, buffer.getLength());
+                for (std::size_t j=begin; j<end; ++j)
+                {
+                    ++counts[pch[j]];
+                }
+                bytesSampled += end - begin;
+                nextSample += stride;
+            }
+
+            bufferStart = bufferEnd;
+        }
+
+        double entropy = 0;
+        for (std::size_t i=0; i<256; ++i)
+        {
+            if (counts[i])
+            {
+                double p = double(counts[i]) / double(bytesSampled);
+                entropy -= p * log2(p);
+            }
+        }
+        return entropy;
+    }
+
+    int ZlibCompressionWriteFilter::chooseCompressionLevel()
+    {
+        const double IncompressibleEntropy = 7.5;
+
+        std::size_t length = lengthByteBuffers(mPreBuffers);
+        if (length < mFilter.mMinCompressionSize)
+        {
+            return Z_NO_COMPRESSION;
+        }
+
+        if (mFilter.mSkipIncompressible && estimateEntropy(mPreBuffers, length) > IncompressibleEntropy)
+        {
+            return Z_NO_COMPRESSION;
+        }
+
+        return mFilter.mCompressionLevel;
     }
 
     void ZlibCompressionWriteFilter::write(
         const std::vector<ByteBuffer> &byteBuffers)
     {
+        sliceByteBuffers(mPreBuffers, byteBuffers, 0, ZlibFilterBandwidthLimit);
+
+        int level = chooseCompressionLevel();
         if (mStateful == false || mCompressionStateInited == false)
         {
-            resetCompressionState();
+            resetCompressionState(level);
         }
 
-        sliceByteBuffers(mPreBuffers, byteBuffers, 0, ZlibFilterBandwidthLimit);
-
-        compress();
+        compress(level);
         mFilter.getPostFilter().write(mPostBuffers);
     }
 
@@ -493,7 +579,7 @@ namespace RCF {
         }
     }
 
-    void ZlibCompressionWriteFilter::compress()
+    void ZlibCompressionWriteFilter::compress(int level)
     {
         mPostBuffers.resize(0);
 
@@ -503,7 +589,7 @@ namespace RCF {
 
         if (mVecPtr.get() == NULL || !mVecPtr.unique())
         {
-            mVecPtr.reset( new ReallocBuffer());
+            mVecPtr = getObjectPool().getReallocBufferPtr(leftMargin + bufferSize);
         }
         mVecPtr->resize(leftMargin + bufferSize);
 
@@ -531,6 +617,33 @@ namespace RCF {
         mTotalBytesIn = 0;
         mTotalBytesOut = 0;
 
+        // Switching level on a stateful stream. The previous message was flushed, so there is nothing pending, and
+        // the stream keeps its history.
+        if (level != mCurrentLevel)
+        {
+            mCstream.next_in = NULL;
+            mCstream.avail_in = 0;
+            mCstream.next_out = (Bytef*) outBuffer.getPtr();
+            mCstream.avail_out = static_cast<uInt>(outRemaining);
+
+            mZerr = mFilter.mZlibDll.pfn_deflateParams(&mCstream, level, Z_DEFAULT_STRATEGY);
+
+            RCF_VERIFY(
+                mZerr == Z_OK || mZerr == Z_BUF_ERROR,
+                Exception(RcfError_Zlib, "deflateParams()", zlibError(mZerr)));
+
+            std::size_t bytesOut = outRemaining - mCstream.avail_out;
+            mTotalBytesOut += bytesOut;
+            outPos += bytesOut;
+            outRemaining -= bytesOut;
+
+            // On Z_BUF_ERROR zlib keeps the old level, and the change is retried with the next message.
+            if (mZerr == Z_OK)
+            {
+                mCurrentLevel = level;
+            }
+        }
+
         for (std::size_t i=0; i<mPreBuffers.size(); ++i)
         {
             RCF_ASSERT(outPos < outBuffer.getLength());
@@ -589,6 +702,9 @@ namespace RCF {
 
     ZlibCompressionFilterBase::ZlibCompressionFilterBase(bool stateful, bool serverSide) :
         mZlibDll(globals().getZlibDll()),
+        mCompressionLevel(Z_DEFAULT_COMPRESSION),
+        mMinCompressionSize(0),
+        mSkipIncompressible(true),
         mPreState(Ready),
         mReadFilter( new ZlibCompressionReadFilter(*this, serverSide) ),
         mWriteFilter( new ZlibCompressionWriteFilter(*this, stateful) )
@@ -608,6 +724,40 @@ namespace RCF {
         return RcfFilter_ZlibCompressionStateful;
     }
 
+    void ZlibCompressionFilterBase::setCompressionLevel(int compressionLevel)
+    {
+        RCF_VERIFY(
+            compressionLevel == Z_DEFAULT_COMPRESSION || (Z_BEST_SPEED <= compressionLevel && compressionLevel <= Z_BEST_COMPRESSION),
+            Exception(RcfError_Zlib, "setCompressionLevel()", zlibError(Z_STREAM_ERROR)));
+
+        mCompressionLevel = compressionLevel;
+    }
+
+    int ZlibCompressionFilterBase::getCompressionLevel() const
+    {
+        return mCompressionLevel;
+    }
+
+    void ZlibCompressionFilterBase::setMinCompressionSize(std::size_t minCompressionSize)
+    {
+        mMinCompressionSize = minCompressionSize;
+    }
+
+    std::size_t ZlibCompressionFilterBase::getMinCompressionSize() const
+    {
+        return mMinCompressionSize;
+    }
+
+    void ZlibCompressionFilterBase::setSkipIncompressible(bool skipIncompressible)
+    {
+        mSkipIncompressible = skipIncompressible;
+    }
+
+    bool ZlibCompressionFilterBase::getSkipIncompressible() const
+    {
+        return mSkipIncompressible;
+    }
+
     void ZlibCompressionFilterBase::resetState()
     {
         mPreState = Ready;
@@ -646,13 +796,21 @@ namespace RCF {
         mWriteFilter->onWriteCompleted(bytesTransferred);
     }
 
-    ZlibStatelessCompressionFilterFactory::ZlibStatelessCompressionFilterFactory()
+    ZlibStatelessCompressionFilterFactory::ZlibStatelessCompressionFilterFactory(
+        int             compressionLevel, 
+        std::size_t     minCompressionSize) :
+            mCompressionLevel(compressionLevel),
+            mMinCompressionSize(minCompressionSize)
     {}
 
     FilterPtr ZlibStatelessCompressionFilterFactory::createFilter(RcfServer &)
     {
-        return FilterPtr( new ZlibStatelessCompressionFilter(
+        std::shared_ptr<ZlibStatelessCompressionFilter> filterPtr( new ZlibStatelessCompressionFilter(
             (ServerSide *) NULL));
+
+        filterPtr->setCompressionLevel(mCompressionLevel);
+        filterPtr->setMinCompressionSize(mMinCompressionSize);
+        return filterPtr;
     }
 
     int ZlibStatelessCompressionFilterFactory::getFilterId()
@@ -660,13 +818,21 @@ namespace RCF {
         return RcfFilter_ZlibCompressionStateless;
     }
 
-    ZlibStatefulCompressionFilterFactory::ZlibStatefulCompressionFilterFactory()
+    ZlibStatefulCompressionFilterFactory::ZlibStatefulCompressionFilterFactory(
+        int             compressionLevel, 
+        std::size_t     minCompressionSize) :
+            mCompressionLevel(compressionLevel),
+            mMinCompressionSize(minCompressionSize)
     {}
 
     FilterPtr ZlibStatefulCompressionFilterFactory::createFilter(RcfServer &)
     {
-        return FilterPtr( new ZlibStatefulCompressionFilter( 
+        std::shared_ptr<ZlibStatefulCompressionFilter> filterPtr( new ZlibStatefulCompressionFilter( 
             (ServerSide *) NULL));
+
+        filterPtr->setCompressionLevel(mCompressionLevel);
+        filterPtr->setMinCompressionSize(mMinCompressionSize);
+        return filterPtr;
     }
 
     int ZlibStatefulCompressionFilterFactory::getFilterId()
@@ -696,4 +862,169 @@ namespace RCF {
     {
     }
 
+    class ZlibCodecStreams
+    {
+    public:
+        ZlibCodecStreams(ZlibDll & zlibDll) : 
+            mZlibDll(zlibDll), 
+            mCstream(), 
+            mDstream(), 
+            mCompressionStateInited(false), 
+            mDecompressionStateInited(false)
+        {
+            memset(&mCstream, 0, sizeof(mCstream));
+            memset(&mDstream, 0, sizeof(mDstream));
+        }
+
+        ~ZlibCodecStreams()
+        {
+            if (mCompressionStateInited)
+            {
+                mZlibDll.pfn_deflateEnd(&mCstream);
+            }
+            if (mDecompressionStateInited)
+            {
+                mZlibDll.pfn_inflateEnd(&mDstream);
+            }
+        }
+
+        ZlibDll &       mZlibDll;
+        z_stream        mCstream;
+        z_stream        mDstream;
+        bool            mCompressionStateInited;
+        bool            mDecompressionStateInited;
+    };
+
+    // zlib only makes use of the last 32 Kb of a preset dictionary.
+    static const std::size_t ZlibMaxDictionaryLength = 32*1024;
+
+    ZlibCompressionCodec::ZlibCompressionCodec(int compressionLevel) :
+        mZlibDll(globals().getZlibDll()),
+        mCompressionLevel(compressionLevel),
+        mStreamsPtr( new ZlibCodecStreams(mZlibDll) )
+    {
+    }
+
+    int ZlibCompressionCodec::getFilterId(bool stateful) const
+    {
+        return stateful ? RcfFilter_ZlibBlockCompressionStateful : RcfFilter_ZlibBlockCompressionStateless;
+    }
+
+    std::size_t ZlibCompressionCodec::getMaxCompressedLength(std::size_t srcLength)
+    {
+        // Output that doesn't fit is sent uncompressed, so this need not be a strict bound.
+        return srcLength + 64;
+    }
+
+    std::size_t ZlibCompressionCodec::compress(
+        const char *    pSrc,
+        std::size_t     srcLength,
+        std::size_t     historyLength,
+        char *          pDest,
+        std::size_t     destLength)
+    {
+        z_stream & cstream = mStreamsPtr->mCstream;
+        int zerr = Z_OK;
+
+        if (!mStreamsPtr->mCompressionStateInited)
+        {
+            zerr = mZlibDll.pfn_deflateInit_(&cstream, mCompressionLevel, ZLIB_VERSION, sizeof(cstream));
+
+            RCF_VERIFY(
+                zerr == Z_OK,
+                Exception(RcfError_Zlib, "deflateInit()", zlibError(zerr)));
+
+            mStreamsPtr->mCompressionStateInited = true;
+        }
+        else
+        {
+            zerr = mZlibDll.pfn_deflateReset(&cstream);
+
+            RCF_VERIFY(
+                zerr == Z_OK,
+                Exception(RcfError_Zlib, "deflateReset()", zlibError(zerr)));
+        }
+
+        std::size_t dictLength = RCF_MIN(historyLength, ZlibMaxDictionaryLength);
+        if (dictLength > 0)
+        {
+            zerr = mZlibDll.pfn_deflateSetDictionary(&cstream, (const Bytef *) pSrc - dictLength, static_cast<uInt>(dictLength));
+
+            RCF_VERIFY(
+                zerr == Z_OK,
+                Exception(RcfError_Zlib, "deflateSetDictionary()", zlibError(zerr)));
+        }
+
+        cstream.next_in = (Bytef *) pSrc;
+        cstream.avail_in = static_cast<uInt>(srcLength);
+        cstream.next_out = (Bytef *) pDest;
+        cstream.avail_out = static_cast<uInt>(destLength);
+
+        zerr = mZlibDll.pfn_deflate(&cstream, Z_FINISH);
+
+        RCF_VERIFY(
+            zerr == Z_OK || zerr == Z_STREAM_END || zerr == Z_BUF_ERROR,
+            Exception(RcfError_Zlib, "deflate()", zlibError(zerr)));
+
+        return zerr == Z_STREAM_END ? destLength - cstream.avail_out : 0;
+    }
+
+    void ZlibCompressionCodec::decompress(
+        const char *    pSrc,
+        std::size_t     srcLength,
+        char *          pDest,
+        std::size_t     destLength,
+        std::size_t     historyLength)
+    {
+        z_stream & dstream = mStreamsPtr->mDstream;
+        int zerr = Z_OK;
+
+        if (!mStreamsPtr->mDecompressionStateInited)
+        {
+            zerr = mZlibDll.pfn_inflateInit_(&dstream, ZLIB_VERSION, sizeof(dstream));
+
+            RCF_VERIFY(
+                zerr == Z_OK,
+                Exception(RcfError_Zlib, "inflateInit()", zlibError(zerr)));
+
+            mStreamsPtr->mDecompressionStateInited = true;
+        }
+        else
+        {
+            zerr = mZlibDll.pfn_inflateReset(&dstream);
+
+            RCF_VERIFY(
+                zerr == Z_OK,
+                Exception(RcfError_Zlib, "inflateReset()", zlibError(zerr)));
+        }
+
+        dstream.next_in = (Bytef *) pSrc;
+        dstream.avail_in = static_cast<uInt>(srcLength);
+        dstream.next_out = (Bytef *) pDest;
+        dstream.avail_out = static_cast<uInt>(destLength);
+
+        zerr = mZlibDll.pfn_inflate(&dstream, Z_FINISH);
+
+        std::size_t dictLength = RCF_MIN(historyLength, ZlibMaxDictionaryLength);
+        if (zerr == Z_NEED_DICT && dictLength > 0)
+        {
+            zerr = mZlibDll.pfn_inflateSetDictionary(&dstream, (const Bytef *) pDest - dictLength, static_cast<uInt>(dictLength));
+
+            RCF_VERIFY(
+                zerr == Z_OK,
+                Exception(RcfError_CompressedData, zlibError(zerr)));
+
+            zerr = mZlibDll.pfn_inflate(&dstream, Z_FINISH);
+        }
+
+        RCF_VERIFY(
+            zerr == Z_STREAM_END && dstream.avail_in == 0 && dstream.avail_out == 0,
+            Exception(RcfError_CompressedData, zlibError(zerr)));
+    }
+
+    CompressionCodecPtr createZlibCompressionCodec()
+    {
+        return CompressionCodecPtr( new ZlibCompressionCodec() );
+    }
+
 } // namespace RCF
@@ -222,7 +222,7 @@ namespace SF {
         {
             if (value.getLength() < len)
             {
-                value = RCF::ByteBuffer(len);
+                value = RCF::ByteBuffer::createUninitialized(len);
             }
             value = RCF::ByteBuffer(value, 0, len);
             memcpy(value.getPtr(), byteBuffer.getPtr()+pos, len);
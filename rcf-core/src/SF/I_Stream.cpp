@@ -276,8 +276,7 @@ namespace SF {
         RCF_ASSERT(nAlloc == nBufferSize);
         RCF_UNUSED_VARIABLE(nAlloc);
         T *buffer = reinterpret_cast<T *>(data.get());
-        memcpy(buffer, t, nBufferSize);
-        RCF::machineToNetworkOrder(buffer, sizeof(T), nCount);
+        RCF::machineToNetworkOrder(buffer, t, sizeof(T), nCount);
     }
 
     // Generic EncodingBinaryPortable::toObject().
@@ -22,6 +22,8 @@
 #include <RCF/MemStream.hpp>
 #include <SF/string.hpp>
 
+#include <cstdint>
+
 namespace SF {
 
     void initRegistrySingleton();
@@ -30,7 +32,21 @@ namespace SF {
 
     Registry::Registry() :
         mReadWriteMutex()
-    {}
+    {
+        for (std::size_t i=0; i<MaxTypeId; ++i)
+        {
+            mTypeIdToEntry[i] = NULL;
+        }
+        for (std::size_t i=0; i<TypeInfoSlots; ++i)
+        {
+            mTypeInfoToEntry[i] = NULL;
+        }
+    }
+
+    Registry::~Registry()
+    {
+        clear();
+    }
 
     Registry &Registry::getSingleton()
     {
@@ -96,12 +112,173 @@ namespace SF {
         }
     }
 
+    static std::size_t hashTypeInfo(const std::type_info & ti)
+    {
+        std::uint64_t n = reinterpret_cast<std::uintptr_t>(&ti);
+        n ^= n >> 33;
+        n *= 0xff51afd7ed558ccdULL;
+        n ^= n >> 33;
+        return static_cast<std::size_t>(n);
+    }
+
+    UInt32 Registry::getTypeId(const std::type_info &ti)
+    {
+        // Lookup is by type_info address. A type_info from a different module may have a different address,
+        // in which case the type is serialized by name instead.
+        std::size_t mask = TypeInfoSlots - 1;
+        for (std::size_t i = hashTypeInfo(ti) & mask; ; i = (i+1) & mask)
+        {
+            TypeIdEntry * pEntry = mTypeInfoToEntry[i].load(std::memory_order_acquire);
+            if (!pEntry)
+            {
+                return 0;
+            }
+            if (pEntry->mpTypeInfo == &ti)
+            {
+                return pEntry->mTypeId;
+            }
+        }
+    }
+
+    // Called with the registry write lock held.
+    void Registry::addTypeIdEntry(
+        const std::type_info &  ti, 
+        const std::string &     typeName, 
+        UInt32                  typeId)
+    {
+        RCF_VERIFY(
+            typeId != 0 && typeId < MaxTypeId,
+            RCF::Exception(RCF::RcfError_SfTypeId, typeId, typeName, MaxTypeId));
+
+        UInt32 currentTypeId = getTypeId(ti);
+        TypeIdEntry * pExisting = mTypeIdToEntry[typeId].load(std::memory_order_acquire);
+        if (currentTypeId == typeId && pExisting->mTypeName == typeName)
+        {
+            return;
+        }
+
+        RCF_VERIFY(
+            currentTypeId == 0 && pExisting == NULL,
+            RCF::Exception(RCF::RcfError_SfTypeId, typeId, typeName, MaxTypeId));
+
+        std::unique_ptr<TypeIdEntry> entryPtr( new TypeIdEntry() );
+        entryPtr->mpTypeInfo = &ti;
+        entryPtr->mTypeId = typeId;
+        entryPtr->mTypeName = typeName;
+        mTypeIdEntries.push_back(entryPtr.get());
+        TypeIdEntry * pEntry = entryPtr.release();
+
+        mTypeIdToEntry[typeId].store(pEntry, std::memory_order_release);
+
+        std::size_t mask = TypeInfoSlots - 1;
+        std::size_t i = hashTypeInfo(ti) & mask;
+        while (mTypeInfoToEntry[i].load(std::memory_order_relaxed))
+        {
+            i = (i+1) & mask;
+        }
+        mTypeInfoToEntry[i].store(pEntry, std::memory_order_release);
+
+        // Pick up any base classes registered before the type id was.
+        Rtti derivedRtti = ti.name();
+        RttiToSerializerPolymorphic::iterator iter;
+        for (
+            iter = mRttiToSerializerPolymorphic.begin(); 
+            iter != mRttiToSerializerPolymorphic.end(); 
+            ++iter)
+        {
+            if (iter->first.second == derivedRtti)
+            {
+                std::map<Rtti, const std::type_info *>::iterator baseIter = 
+                    mRttiToBaseTypeInfo.find(iter->first.first);
+
+                if (baseIter != mRttiToBaseTypeInfo.end())
+                {
+                    addTypeIdBase(ti, *baseIter->second, iter->second.get());
+                }
+            }
+        }
+    }
+
+    // Called with the registry write lock held.
+    void Registry::addTypeIdBase(
+        const std::type_info &  derivedTi, 
+        const std::type_info &  baseTi, 
+        I_SerializerPolymorphic * pSerializer)
+    {
+        UInt32 typeId = getTypeId(derivedTi);
+        if (typeId == 0)
+        {
+            return;
+        }
+
+        // Bases that don't fit in the entry are still found through the registry maps.
+        TypeIdEntry & entry = *mTypeIdToEntry[typeId].load(std::memory_order_relaxed);
+        std::size_t baseCount = entry.mBaseCount.load(std::memory_order_relaxed);
+        for (std::size_t i=0; i<baseCount; ++i)
+        {
+            if (entry.mBases[i] == &baseTi)
+            {
+                return;
+            }
+        }
+        if (baseCount < TypeIdEntry::MaxBases)
+        {
+            entry.mBases[baseCount] = &baseTi;
+            entry.mSerializers[baseCount] = pSerializer;
+            entry.mBaseCount.store(baseCount + 1, std::memory_order_release);
+        }
+    }
+
+    I_SerializerPolymorphic * Registry::getSerializerPolymorphic(
+        const std::type_info &  baseTi, 
+        UInt32                  derivedTypeId, 
+        std::string &           derivedTypeName)
+    {
+        TypeIdEntry * pEntry = derivedTypeId < MaxTypeId ? 
+            mTypeIdToEntry[derivedTypeId].load(std::memory_order_acquire) : 
+            NULL;
+
+        if (!pEntry)
+        {
+            RCF::Exception e(RCF::RcfError_SfTypeRegistration, derivedTypeId);
+            RCF_THROW(e);
+        }
+
+        std::size_t baseCount = pEntry->mBaseCount.load(std::memory_order_acquire);
+        for (std::size_t i=0; i<baseCount; ++i)
+        {
+            if (pEntry->mBases[i] == &baseTi || *pEntry->mBases[i] == baseTi)
+            {
+                return pEntry->mSerializers[i];
+            }
+        }
+
+        // Fall back to a lookup by name.
+        derivedTypeName = pEntry->mTypeName;
+        return NULL;
+    }
+
     void Registry::clear()
     {
         mTypenameToRtti.clear();
         mRttiToTypename.clear();
         mRttiToSerializerPolymorphic.clear();
         mRttiToSerializerAny.clear();
+
+        for (std::size_t i=0; i<MaxTypeId; ++i)
+        {
+            mTypeIdToEntry[i] = NULL;
+        }
+        for (std::size_t i=0; i<TypeInfoSlots; ++i)
+        {
+            mTypeInfoToEntry[i] = NULL;
+        }
+        for (std::size_t i=0; i<mTypeIdEntries.size(); ++i)
+        {
+            delete mTypeIdEntries[i];
+        }
+        mTypeIdEntries.clear();
+        mRttiToBaseTypeInfo.clear();
     }
 
     void initRegistrySingleton()
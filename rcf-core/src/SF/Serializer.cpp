@@ -49,7 +49,16 @@ namespace SF {
             if (    ar.isFlagSet(Archive::POINTER) 
                 ||  (!ar.isFlagSet(Archive::PARENT) && isDerived()))
             {
-                if (pNode->type.length() > 0)
+                if (pNode->typeId != 0)
+                {
+                    ar.setFlag(Archive::POLYMORPHIC, true );
+                    getSerializerPolymorphic(pNode->typeId);
+                    ar.getIstream()->getLocalStorage().setNode(pNode);
+                    ar.setFlag(Archive::NODE_ALREADY_READ);
+                    invokeSerializerPolymorphic(ar);
+                    return;
+                }
+                else if (pNode->type.length() > 0)
                 {
                     ar.setFlag(Archive::POLYMORPHIC, true );
                     std::string derivedTypeName = pNode->type.cpp_str();
@@ -116,11 +125,22 @@ namespace SF {
     {
         Node in("", "", 0, false);
 
+        // Types registered with a type id are identified by id rather than by name, from runtime version 15.
+        bool useTypeIds = ar.getRuntimeVersion() >= 15;
+
         // Detect polymorphism
         if (!ar.isFlagSet(Archive::PARENT) && isDerived())
         {
             ar.setFlag(Archive::POLYMORPHIC);
-            getSerializerPolymorphic(getDerivedTypeName());
+            UInt32 derivedTypeId = useTypeIds ? getDerivedTypeId() : 0;
+            if (derivedTypeId)
+            {
+                getSerializerPolymorphic(derivedTypeId);
+            }
+            else
+            {
+                getSerializerPolymorphic(getDerivedTypeName());
+            }
             invokeSerializerPolymorphic(ar);
             return;
         }
@@ -129,7 +149,11 @@ namespace SF {
 
         if (ar.isFlagSet(Archive::POLYMORPHIC))
         {
-            in.type.assign(getTypeName());
+            in.typeId = useTypeIds ? getTypeId() : 0;
+            if (in.typeId == 0)
+            {
+                in.type.assign(getTypeName());
+            }
         }
 
         bool bPointer = ar.isFlagSet(Archive::POINTER);
@@ -177,6 +201,41 @@ namespace SF {
     SerializerBase::~SerializerBase()
     {}
 
+    // In schema-fixed archives, a value is serialized without a node, unless it is accessed through a pointer, 
+    // is polymorphic, or may be the target of a tracked pointer. Both ends make the same decision from the
+    // static type being serialized, so the node can be left out without any loss of information.
+    bool SerializerBase::isSchemaFixedValue(Archive &ar)
+    {
+        bool schemaFixed = ar.isRead() ?
+            ar.getIstream()->getEnableSchemaFixed() :
+            ar.getOstream()->getEnableSchemaFixed();
+
+        if (    !schemaFixed
+            ||  ar.isFlagSet(Archive::POINTER) 
+            ||  ar.isFlagSet(Archive::POLYMORPHIC) 
+            ||  ar.isFlagSet(Archive::NODE_ALREADY_READ))
+        {
+            return false;
+        }
+
+        bool pointerTracking = ar.isRead() ?
+            ar.getIstream()->getEnablePointerTracking() :
+            ar.getOstream()->getEnablePointerTracking();
+
+        if (pointerTracking && isNonAtomic())
+        {
+            return false;
+        }
+
+        if (ar.isWrite() && !ar.isFlagSet(Archive::PARENT) && isDerived())
+        {
+            RCF::Exception e(RCF::RcfError_SfSchemaFixedPolymorphic, getDerivedTypeName());
+            RCF_THROW(e);
+        }
+
+        return true;
+    }
+
     void SerializerBase::invoke(Archive &ar)
     {
         if (ar.isFlagSet(Archive::NO_BEGIN_END))
@@ -184,6 +243,11 @@ namespace SF {
             ar.clearFlag(Archive::NO_BEGIN_END);
             serializeContents(ar);
         }
+        else if (isSchemaFixedValue(ar))
+        {
+            ar.clearState();
+            serializeContents(ar);
+        }
         else
         {
             RCF_ASSERT( ar.isRead() || ar.isWrite() );
@@ -19,6 +19,8 @@
 #include <SF/Stream.hpp>
 
 #include <RCF/ByteOrdering.hpp>
+#include <RCF/InitDeinit.hpp>
+#include <RCF/ObjectPool.hpp>
 #include <RCF/Version.hpp>
 
 #include <SF/DataPtr.hpp>
@@ -27,10 +29,262 @@
 #include <SF/Node.hpp>
 #include <RCF/Tools.hpp>
 
+#include <cstdint>
 #include <vector>
 
 namespace SF {
 
+    //--------------------------------------------------------------------------
+    // Pointer tracking tables
+
+    // Open addressing hash table with linear probing. Pointer tracking only ever adds entries, and then discards
+    // all of them at once, so individual entries cannot be erased.
+    template<typename Key, typename Value, typename KeyTraits>
+    class TrackingTable
+    {
+    public:
+
+        TrackingTable() : mSize(0)
+        {
+        }
+
+        Value * find(const Key & key)
+        {
+            if (mSize == 0)
+            {
+                return NULL;
+            }
+
+            std::size_t mask = mSlots.size() - 1;
+            for (std::size_t i = KeyTraits::hash(key) & mask; ; i = (i+1) & mask)
+            {
+                Slot & slot = mSlots[i];
+                if (!slot.mUsed)
+                {
+                    return NULL;
+                }
+                if (KeyTraits::equal(slot.mKey, key))
+                {
+                    return &slot.mValue;
+                }
+            }
+        }
+
+        // Returns the value for the given key, inserting a default constructed value if the key is not present.
+        Value & insert(const Key & key)
+        {
+            if (2*(mSize+1) > mSlots.size())
+            {
+                grow();
+            }
+
+            std::size_t mask = mSlots.size() - 1;
+            for (std::size_t i = KeyTraits::hash(key) & mask; ; i = (i+1) & mask)
+            {
+                Slot & slot = mSlots[i];
+                if (!slot.mUsed)
+                {
+                    slot.mUsed = true;
+                    slot.mKey = key;
+                    slot.mValue = Value();
+                    ++mSize;
+                    return slot.mValue;
+                }
+                if (KeyTraits::equal(slot.mKey, key))
+                {
+                    return slot.mValue;
+                }
+            }
+        }
+
+        // Tables that have grown beyond maxSlots release their storage, rather than holding on to it in the pool.
+        void clear(std::size_t maxSlots)
+        {
+            if (mSlots.size() > maxSlots)
+            {
+                std::vector<Slot>().swap(mSlots);
+            }
+            else if (mSize > 0)
+            {
+                for (std::size_t i=0; i<mSlots.size(); ++i)
+                {
+                    mSlots[i].mUsed = false;
+                }
+            }
+            mSize = 0;
+        }
+
+    private:
+
+        struct Slot
+        {
+            Slot() : mKey(), mValue(), mUsed(false)
+            {
+            }
+
+            Key         mKey;
+            Value       mValue;
+            bool        mUsed;
+        };
+
+        void grow()
+        {
+            std::vector<Slot> slots( RCF_MAX(std::size_t(16), 2*mSlots.size()) );
+            slots.swap(mSlots);
+
+            std::size_t mask = mSlots.size() - 1;
+            for (std::size_t i=0; i<slots.size(); ++i)
+            {
+                if (slots[i].mUsed)
+                {
+                    std::size_t j = KeyTraits::hash(slots[i].mKey) & mask;
+                    while (mSlots[j].mUsed)
+                    {
+                        j = (j+1) & mask;
+                    }
+                    mSlots[j] = slots[i];
+                }
+            }
+        }
+
+        std::vector<Slot>   mSlots;
+        std::size_t         mSize;
+    };
+
+    static std::size_t hashTrackingKey(std::uint64_t n)
+    {
+        n ^= n >> 33;
+        n *= 0xff51afd7ed558ccdULL;
+        n ^= n >> 33;
+        return static_cast<std::size_t>(n);
+    }
+
+    // Object id's written to an archive. Type identity is by type_info address, as it was when keyed by std::map.
+    struct ObjectIdTraits
+    {
+        static std::size_t hash(const ObjectId & id)
+        {
+            return hashTrackingKey(
+                    reinterpret_cast<std::uintptr_t>(id.first)
+                ^   (reinterpret_cast<std::uintptr_t>(id.second) << 1) );
+        }
+
+        static bool equal(const ObjectId & lhs, const ObjectId & rhs)
+        {
+            return lhs == rhs;
+        }
+    };
+
+    // Objects read from an archive. Types are compared by name, so that types from different modules still match.
+    struct ObjectTypeTraits
+    {
+        static std::size_t hash(const ObjectId & id)
+        {
+            return hashTrackingKey( reinterpret_cast<std::uintptr_t>(id.first) );
+        }
+
+        static bool equal(const ObjectId & lhs, const ObjectId & rhs)
+        {
+            return 
+                    lhs.first == rhs.first 
+                &&  (lhs.second == rhs.second || *lhs.second == *rhs.second);
+        }
+    };
+
+    static const std::size_t MaxPooledTrackingSlots = 64*1024;
+    static const std::size_t MaxPooledTrackingTables = 32;
+
+    class ContextReadTables
+    {
+    public:
+
+        ContextReadTables() : mTrackedCount(0)
+        {
+        }
+
+        // Nid's are allocated sequentially by the writer, one for each tracked object, so they are stored in a 
+        // vector indexed by nid. A nid far beyond the number of objects tracked so far can only come from a 
+        // malformed archive, and is rejected, so that the vector stays proportional to the archive.
+        void addNid(UInt32 nid, const ObjectId & id)
+        {
+            ++mTrackedCount;
+
+            RCF_VERIFY(
+                nid <= 2*mTrackedCount + 1024,
+                RCF::Exception(RCF::RcfError_Decoding));
+
+            if (nid >= mNidToId.size())
+            {
+                mNidToId.resize(nid+1, ObjectId(NULL, NULL));
+            }
+            mNidToId[nid] = id;
+        }
+
+        bool queryNid(UInt32 nid, ObjectId & id)
+        {
+            if (nid < mNidToId.size() && mNidToId[nid].second)
+            {
+                id = mNidToId[nid];
+                return true;
+            }
+            return false;
+        }
+
+        void clear()
+        {
+            if (mNidToId.capacity() > MaxPooledTrackingSlots)
+            {
+                std::vector<ObjectId>().swap(mNidToId);
+            }
+            else
+            {
+                mNidToId.clear();
+            }
+            mTrackedCount = 0;
+            mTypeToObj.clear(MaxPooledTrackingSlots);
+        }
+
+        std::size_t                                             mTrackedCount;
+        std::vector<ObjectId>                                   mNidToId;
+        TrackingTable<ObjectId, void *, ObjectTypeTraits>       mTypeToObj;
+    };
+
+    class ContextWriteTables
+    {
+    public:
+
+        void clear()
+        {
+            mIdToNid.clear(MaxPooledTrackingSlots);
+        }
+
+        TrackingTable<ObjectId, UInt32, ObjectIdTraits>         mIdToNid;
+    };
+
+    template<typename T>
+    static void getTrackingTables(std::shared_ptr<T> & tablesPtr)
+    {
+        if (RCF::getInitRefCount() > 0)
+        {
+            RCF::getObjectPool().getObj(tablesPtr);
+        }
+        else
+        {
+            tablesPtr.reset( new T() );
+        }
+    }
+
+    void initTrackingTableCache(RCF::ObjectPool & objectPool)
+    {
+        objectPool.enableCaching<ContextReadTables>(
+            MaxPooledTrackingTables, 
+            [](ContextReadTables * pTables) { pTables->clear(); });
+
+        objectPool.enableCaching<ContextWriteTables>(
+            MaxPooledTrackingTables, 
+            [](ContextWriteTables * pTables) { pTables->clear(); });
+    }
+
     // ContextRead
 
     ContextRead::ContextRead() : mEnabled(true)
@@ -52,62 +306,44 @@ namespace SF {
     void ContextRead::add(UInt32 nid, const ObjectId &id)
     {
         RCF_ASSERT(mEnabled);
-        if (mNidToIdMap.get() == NULL)
+        if (!mTablesPtr)
         {
-            mNidToIdMap.reset( new std::map<UInt32, ObjectId>());
+            getTrackingTables(mTablesPtr);
         }
-        (*mNidToIdMap)[nid] = id;
+        mTablesPtr->addNid(nid, id);
     }
 
     void ContextRead::add(void *ptr, const std::type_info &objType, void *pObj)
     {
         RCF_ASSERT(mEnabled);
-        if (mTypeToObjMap.get() == NULL)
+        if (!mTablesPtr)
         {
-            mTypeToObjMap.reset( new std::map<std::string, std::map< void *, void * > >() );
+            getTrackingTables(mTablesPtr);
         }
-        (*mTypeToObjMap)[ objType.name() ][ ptr ] = pObj;
+        mTablesPtr->mTypeToObj.insert( ObjectId(ptr, &objType) ) = pObj;
     }
 
     bool ContextRead::query(UInt32 nid, ObjectId &id)
     {
         RCF_ASSERT(mEnabled);
-        if (mNidToIdMap.get() && mNidToIdMap->find( nid ) != mNidToIdMap->end())
-        {
-            id = (*mNidToIdMap)[ nid ];
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+        return mTablesPtr && mTablesPtr->queryNid(nid, id);
     }
 
     bool ContextRead::query(void *ptr, const std::type_info &objType, void *&pObj)
     {
         RCF_ASSERT(mEnabled);
-        if (mTypeToObjMap.get() &&
-            (*mTypeToObjMap)[ objType.name() ].find(ptr) != (*mTypeToObjMap)[ objType.name() ].end() )
+        void ** ppObj = mTablesPtr ? mTablesPtr->mTypeToObj.find( ObjectId(ptr, &objType) ) : NULL;
+        if (ppObj)
         {
-            pObj = (*mTypeToObjMap)[ objType.name() ][ ptr ];
+            pObj = *ppObj;
             return true;
         }
-        else
-        {
-            return false;
-        }
+        return false;
     }
 
     void ContextRead::clear()
     {
-        if (mNidToIdMap.get())
-        {
-            mNidToIdMap->clear();
-        }
-        if (mTypeToObjMap.get())
-        {
-            mTypeToObjMap->clear();
-        }
+        mTablesPtr.reset();
     }
 
     // ContextWrite
@@ -123,10 +359,6 @@ namespace SF {
     void ContextWrite::setEnabled(bool enabled)
     {
         mEnabled = enabled;
-        if (mEnabled && mIdToNidMap.get() == NULL)
-        {
-            mIdToNidMap.reset( new std::map<ObjectId, UInt32>());
-        }
     }
 
     bool ContextWrite::getEnabled() const
@@ -138,21 +370,24 @@ namespace SF {
     {
         if (mEnabled)
         {
-            if (mIdToNidMap->find( id ) != mIdToNidMap->end())
+            if (!mTablesPtr)
             {
-                nid = (*mIdToNidMap)[ id ];
+                getTrackingTables(mTablesPtr);
             }
-            else
+            UInt32 & trackedNid = mTablesPtr->mIdToNid.insert(id);
+            if (trackedNid == 0)
             {
-                nid = (*mIdToNidMap)[ id ] = mCurrentId++;
+                trackedNid = mCurrentId++;
             }
+            nid = trackedNid;
         }
     }
     bool ContextWrite::query(const ObjectId &id, UInt32 &nid)
     {
-        if ( mEnabled && mIdToNidMap->find( id ) != mIdToNidMap->end() )
+        UInt32 * pNid = (mEnabled && mTablesPtr) ? mTablesPtr->mIdToNid.find(id) : NULL;
+        if (pNid)
         {
-            nid = (*mIdToNidMap)[ id ];
+            nid = *pNid;
             return true;
         }
         else
@@ -163,10 +398,7 @@ namespace SF {
 
     void ContextWrite::clear()
     {
-        if (mIdToNidMap.get())
-        {
-            mIdToNidMap->clear();
-        }
+        mTablesPtr.reset();
         mCurrentId = 1;
     }
 
@@ -206,6 +438,8 @@ namespace SF {
         mRuntimeVersion( RCF::getRuntimeVersion() ),
         mArchiveVersion( RCF::getArchiveVersion() ),
         mIgnoreVersionStamp(false),
+        mSchemaFixed(false),
+        mTextFormat(false),
         mpSerializationProtocolIn(NULL)
     {
     }
@@ -221,6 +455,8 @@ namespace SF {
             mRuntimeVersion( runtimeVersion ),
             mArchiveVersion( archiveVersion ),
             mIgnoreVersionStamp(false),
+            mSchemaFixed(false),
+            mTextFormat(false),
             mpSerializationProtocolIn(NULL)
     {
         setIs(is, archiveSize, runtimeVersion, archiveVersion);
@@ -237,6 +473,8 @@ namespace SF {
             mRuntimeVersion( runtimeVersion ),
             mArchiveVersion( archiveVersion ),
             mIgnoreVersionStamp(false),
+            mSchemaFixed(false),
+            mTextFormat(false),
             mpSerializationProtocolIn(NULL)
     {
         setIs(is, archiveSize, runtimeVersion, archiveVersion);
@@ -401,6 +639,13 @@ namespace SF {
                         read(node.label.get(), length);
                     }
 
+                    // type id
+                    attrSpec = attrSpec >> 1;
+                    if (attrSpec & 1)
+                    {
+                        read_int(node.typeId);
+                    }
+
                     return true;
                 }
 
@@ -433,6 +678,19 @@ namespace SF {
         }
     }
 
+    // Packed integers are written as a Data marker followed by a varint, with no length prefix.
+    void IStream::getPackedInt(std::uint64_t &n)
+    {
+        Byte8 byte;
+        read_byte( byte );
+        if (byte != Data)
+        {
+            RCF::Exception e(RCF::RcfError_SfDataFormat);
+            RCF_THROW(e);
+        }
+        read_varint(n);
+    }
+
     void IStream::end()
     {
         Byte8 byte;
@@ -452,6 +710,18 @@ namespace SF {
             RCF::networkToMachineOrder( &n, 4, 1);
             return bytesRead;
         }
+        else if (getUsePackedIntegers())
+        {
+            std::uint64_t n64 = 0;
+            UInt32 bytesRead = read_varint(n64);
+            if (n64 > 0xFFFFFFFF)
+            {
+                RCF::Exception e(RCF::RcfError_SfDataFormat);
+                RCF_THROW(e);
+            }
+            n = static_cast<UInt32>(n64);
+            return bytesRead;
+        }
         else
         {
             // Integers less than 128 are stored as a single byte.
@@ -473,6 +743,31 @@ namespace SF {
         }
     }
 
+    // LEB128 - 7 bits per byte, least significant group first, with the high bit set on all but the last byte.
+    UInt32 IStream::read_varint(std::uint64_t &n)
+    {
+        n = 0;
+        for (UInt32 i=0; i<10; ++i)
+        {
+            Byte8 byte = 0;
+            read_byte(byte);
+            std::uint64_t group = static_cast<std::uint8_t>(byte) & 0x7F;
+            if (i == 9 && group > 1)
+            {
+                break;
+            }
+            n |= group << (7*i);
+            if ((static_cast<std::uint8_t>(byte) & 0x80) == 0)
+            {
+                return i+1;
+            }
+        }
+
+        RCF::Exception e(RCF::RcfError_SfDataFormat);
+        RCF_THROW(e);
+        return 0;
+    }
+
     UInt32 IStream::read_byte(Byte8 &byte)
     {
         UInt32 bytesRead = read(&byte, 1);
@@ -567,14 +862,37 @@ namespace SF {
         return getTrackingContext().getEnabled();
     }
 
+    void IStream::setEnableSchemaFixed(bool enable)
+    {
+        mSchemaFixed = enable;
+    }
+
+    bool IStream::getEnableSchemaFixed() const
+    {
+        return mSchemaFixed;
+    }
+
+    bool IStream::getUsePackedIntegers() const
+    {
+        return mRuntimeVersion >= 16 && !mTextFormat;
+    }
+
+    void IStream::setTextFormat()
+    {
+        mTextFormat = true;
+    }
+
     // OStream
 
     OStream::OStream() : 
         mpOs(), 
+        mpMemOs(NULL),
         mRuntimeVersion( RCF::getRuntimeVersion() ), 
         mArchiveVersion( RCF::getArchiveVersion() ),
         mSuppressArchiveMetadata(false),
         mArchiveMetadataWritten(false),
+        mSchemaFixed(false),
+        mTextFormat(false),
         mpSerializationProtocolOut(NULL)
     {
     }
@@ -585,9 +903,12 @@ namespace SF {
         int             archiveVersion) : 
 
             mpOs(), 
+            mpMemOs(NULL),
             mRuntimeVersion(runtimeVersion),
             mSuppressArchiveMetadata(false),
             mArchiveMetadataWritten(false),
+            mSchemaFixed(false),
+            mTextFormat(false),
             mpSerializationProtocolOut(NULL)
     {
         setOs(os, runtimeVersion, archiveVersion);
@@ -599,9 +920,12 @@ namespace SF {
         int             archiveVersion) : 
 
             mpOs(), 
+            mpMemOs(NULL),
             mRuntimeVersion(runtimeVersion),
             mSuppressArchiveMetadata(false),
             mArchiveMetadataWritten(false),
+            mSchemaFixed(false),
+            mTextFormat(false),
             mpSerializationProtocolOut(NULL)
     {
         setOs(os, runtimeVersion, archiveVersion);
@@ -617,6 +941,7 @@ namespace SF {
         int             archiveVersion) 
     { 
         mpOs = &os; 
+        mpMemOs = dynamic_cast<RCF::MemOstream *>(&os);
 
         mRuntimeVersion = runtimeVersion;
         if (mRuntimeVersion == 0)
@@ -685,6 +1010,10 @@ namespace SF {
         {
             attrSpec |= 1<<3;
         }
+        if (node.typeId != 0)
+        {
+            attrSpec |= 1<<4;
+        }
 
         write_byte( attrSpec );
 
@@ -700,6 +1029,10 @@ namespace SF {
         {
             write(node.label.get(), node.label.length() );
         }
+        if (node.typeId != 0)
+        {
+            write_int(node.typeId);
+        }
     }
 
     void OStream::put(const DataPtr &value)
@@ -708,6 +1041,12 @@ namespace SF {
         write(value.get(), value.length());
     }
 
+    void OStream::putPackedInt(std::uint64_t n)
+    {
+        write_byte( (Byte8) Data );
+        write_varint(n);
+    }
+
     void OStream::end()
     {
         write_byte( (Byte8) End );
@@ -728,6 +1067,10 @@ namespace SF {
             }
             return 4;
         }
+        else if (getUsePackedIntegers())
+        {
+            return write_varint(n);
+        }
         else
         {
             // Integers less than 128 are stored as a single byte.
@@ -754,6 +1097,26 @@ namespace SF {
         }
     }
 
+    UInt32 OStream::write_varint(std::uint64_t n)
+    {
+        Byte8 buffer[10];
+        UInt32 count = 0;
+        while (n >= 0x80)
+        {
+            buffer[count++] = static_cast<Byte8>( (n & 0x7F) | 0x80 );
+            n >>= 7;
+        }
+        buffer[count++] = static_cast<Byte8>(n);
+
+        mpOs->write(buffer, count);
+        if (mpOs->fail())
+        {
+            RCF::Exception e(RCF::RcfError_SfWriteFailure);
+            RCF_THROW(e);
+        }
+        return count;
+    }
+
     UInt32 OStream::write_byte(Byte8 byte)
     {
         mpOs->write(&byte, 1);
@@ -790,6 +1153,15 @@ namespace SF {
         return nLength;
     }
 
+    Byte8 * OStream::reserveRaw(UInt32 nLength)
+    {
+        if (!mpMemOs)
+        {
+            return NULL;
+        }
+        return mpMemOs->reserveWrite(nLength);
+    }
+
     int OStream::getRuntimeVersion()
     {
         return mRuntimeVersion;
@@ -852,4 +1224,24 @@ namespace SF {
         return getTrackingContext().getEnabled();
     }
 
+    void OStream::setEnableSchemaFixed(bool enable)
+    {
+        mSchemaFixed = enable;
+    }
+
+    bool OStream::getEnableSchemaFixed() const
+    {
+        return mSchemaFixed;
+    }
+
+    bool OStream::getUsePackedIntegers() const
+    {
+        return mRuntimeVersion >= 16 && !mTextFormat;
+    }
+
+    void OStream::setTextFormat()
+    {
+        mTextFormat = true;
+    }
+
 } // namespace SF
@@ -22,6 +22,9 @@
 
 #include <RCF/Export.hpp>
 #include <RCF/MemStream.hpp>
+#include <RCF/RcfSession.hpp>
+#include <RCF/SerializationProtocol.hpp>
+#include <RCF/ThreadLocalData.hpp>
 #include <SF/Stream.hpp>
 #include <RCF/Tools.hpp>
 #include <SF/bitset.hpp>
@@ -30,124 +33,416 @@
 
 namespace SF {
 
+    // Raw reads and writes on SF streams are limited to 32 bit lengths, so large arrays are transferred in chunks.
+    static const std::uint64_t MaxRawChunkSize = 1024*1024*1024;
+
+    static std::size_t toSizeT(std::uint64_t n)
+    {
+        RCF_VERIFY(
+            n <= std::uint64_t( std::size_t(-1) ),
+            RCF::Exception(RCF::RcfError_SfDataFormat));
+
+        return static_cast<std::size_t>(n);
+    }
+
+    void writeArrayCount(
+        SF::Archive &           ar,
+        std::uint64_t           count)
+    {
+        // From runtime version 14, counts that don't fit in 32 bits are written
+        // as a 32 bit marker followed by a 64 bit count.
+        const std::uint64_t LargeCountMarker = 0xFFFFFFFF;
+
+        if (count < LargeCountMarker)
+        {
+            std::uint32_t count32 = static_cast<std::uint32_t>(count);
+            ar & count32;
+        }
+        else if (ar.getRuntimeVersion() >= 14)
+        {
+            std::uint32_t marker = static_cast<std::uint32_t>(LargeCountMarker);
+            ar & marker & count;
+        }
+        else if (count == LargeCountMarker)
+        {
+            std::uint32_t count32 = static_cast<std::uint32_t>(count);
+            ar & count32;
+        }
+        else
+        {
+            RCF::Exception e(RCF::RcfError_SfArrayTooLarge, count, ar.getRuntimeVersion());
+            RCF_THROW(e);
+        }
+    }
+
+    std::uint64_t readArrayCount(
+        SF::Archive &           ar)
+    {
+        std::uint32_t count32 = 0;
+        ar & count32;
+
+        std::uint64_t count = count32;
+        if (count32 == 0xFFFFFFFF && ar.getRuntimeVersion() >= 14)
+        {
+            ar & count;
+        }
+        return count;
+    }
+
+    void readArrayBytes(
+        SF::Archive &           ar,
+        char *                  pch,
+        std::uint64_t           bytesToRead)
+    {
+        SF::IStream &is = *ar.getIstream();
+        while (bytesToRead)
+        {
+            std::uint32_t bytesToReadNow = static_cast<std::uint32_t>( RCF_MIN(bytesToRead, MaxRawChunkSize) );
+            std::uint32_t bytesRead = is.read(pch, bytesToReadNow);
+
+            RCF_VERIFY(
+                bytesRead == bytesToReadNow,
+                RCF::Exception(RCF::RcfError_SfReadFailure));
+
+            pch += bytesRead;
+            bytesToRead -= bytesRead;
+        }
+    }
+
+    void writeArrayBytes(
+        SF::Archive &           ar,
+        const char *            pch,
+        std::uint64_t           bytesToWrite)
+    {
+        while (bytesToWrite)
+        {
+            std::uint32_t bytesToWriteNow = static_cast<std::uint32_t>( RCF_MIN(bytesToWrite, MaxRawChunkSize) );
+            ar.getOstream()->writeRaw(pch, bytesToWriteNow);
+            pch += bytesToWriteNow;
+            bytesToWrite -= bytesToWriteNow;
+        }
+    }
+
+    // Large arrays are sent directly from application memory, if the zero copy send threshold allows it.
+    void writeRawOrInsert(
+        SF::Archive &           ar,
+        const char *            pch,
+        std::uint64_t           bytesToWrite)
+    {
+        RCF::SerializationProtocolOut *pOut = ar.getOstream()->getRemoteCallContext();
+        if (!pOut || !pOut->insertUserBuffer(pch, toSizeT(bytesToWrite)))
+        {
+            writeArrayBytes(ar, pch, bytesToWrite);
+        }
+    }
+
+    // Writes an array in network byte order. Elements are converted directly into the output buffer where the 
+    // stream allows it, and otherwise through a temporary buffer.
+    static void writeArrayBytesReordered(
+        SF::Archive &           ar,
+        const char *            pch,
+        std::size_t             sizeofElement,
+        std::size_t             count)
+    {
+        const std::size_t ChunkSize = 1024*1024;
+        const std::size_t ElementsMax = RCF_MAX(std::size_t(1), ChunkSize / sizeofElement);
+
+        SF::OStream & os = *ar.getOstream();
+        std::vector<char> buffer;
+
+        while (count)
+        {
+            std::size_t elementsToWrite = RCF_MIN(ElementsMax, count);
+            std::uint32_t bytesToWrite = static_cast<std::uint32_t>(elementsToWrite*sizeofElement);
+
+            char * pDest = os.reserveRaw(bytesToWrite);
+            if (pDest)
+            {
+                RCF::machineToNetworkOrder(pDest, pch, static_cast<int>(sizeofElement), static_cast<int>(elementsToWrite));
+            }
+            else
+            {
+                buffer.resize(bytesToWrite);
+                RCF::machineToNetworkOrder(&buffer[0], pch, static_cast<int>(sizeofElement), static_cast<int>(elementsToWrite));
+                os.writeRaw(&buffer[0], bytesToWrite);
+            }
+
+            pch += bytesToWrite;
+            count -= elementsToWrite;
+        }
+    }
+
     void serializeVectorFastImpl(
         SF::Archive &           ar,
         I_VecWrapper &          vec)
     {
         if (ar.isRead())
         {
-            std::uint32_t count = 0;
-            ar & count;
+            std::size_t count = toSizeT( readArrayCount(ar) );
 
             if (count)
             {
-                SF::IStream &is = *ar.getIstream();
-
                 vec.resize(0);
 
-                std::size_t minSerializedLength = vec.sizeofElement();
-                if (ar.verifyAgainstArchiveSize(count*minSerializedLength))
+                std::size_t sizeofElement = vec.sizeofElement();
+                RCF_VERIFY(
+                    count <= std::size_t(-1) / sizeofElement,
+                    RCF::Exception(RCF::RcfError_SfDataFormat));
+
+                if (ar.verifyAgainstArchiveSize(count*sizeofElement))
                 {
                     // Size field is verified, so read everything in one go.
                     vec.resize(count);
-
-                    std::uint32_t bytesToRead = count * vec.sizeofElement();
-
-                    std::uint32_t bytesActuallyRead = is.read( 
-                        vec.addressOfElement(0),
-                        bytesToRead);
-
-                    RCF_VERIFY(
-                        bytesActuallyRead == bytesToRead,
-                        RCF::Exception(RCF::RcfError_SfReadFailure));
-
-                    // Byte ordering.
-                    if (ar.getRuntimeVersion() >= 8)
-                    {
-                        RCF::networkToMachineOrder(
-                            vec.addressOfElement(0), 
-                            static_cast<int>(vec.sizeofElement()), 
-                            static_cast<int>(vec.size()));
-                    }
+                    readArrayBytes(ar, vec.addressOfElement(0), std::uint64_t(count)*sizeofElement);
                 }
                 else
                 {
                     // Size field not verified, so read in chunks.
-                    std::uint32_t elementsRemaining = count;
+                    std::size_t elementsRemaining = count;
                     
                     while (elementsRemaining)
                     {
-                        const std::uint32_t ElementsMax = 50*1024;
-                        std::uint32_t elementsRead = count - elementsRemaining;
-                        std::uint32_t elementsToRead = RCF_MIN(ElementsMax, elementsRemaining);
-                        std::uint32_t bytesToRead = elementsToRead*vec.sizeofElement();
+                        const std::size_t ElementsMax = 50*1024;
+                        std::size_t elementsRead = count - elementsRemaining;
+                        std::size_t elementsToRead = RCF_MIN(ElementsMax, elementsRemaining);
                         vec.resize( vec.size() + elementsToRead);
-
-                        std::uint32_t bytesRead = is.read( 
-                            vec.addressOfElement(elementsRead), 
-                            bytesToRead);
-
-                        RCF_VERIFY(
-                            bytesRead == bytesToRead,
-                            RCF::Exception(RCF::RcfError_SfReadFailure));
-
+                        readArrayBytes(ar, vec.addressOfElement(elementsRead), std::uint64_t(elementsToRead)*sizeofElement);
                         elementsRemaining -= elementsToRead;
                     }
+                }
 
-                    // Byte ordering.
-                    if (ar.getRuntimeVersion() >= 8)
-                    {
-                        RCF::networkToMachineOrder(
-                            vec.addressOfElement(0), 
-                            static_cast<int>(vec.sizeofElement()), 
-                            static_cast<int>(vec.size()));
-                    }
+                // Byte ordering.
+                if (ar.getRuntimeVersion() >= 8)
+                {
+                    RCF::networkToMachineOrderLarge(
+                        vec.addressOfElement(0), 
+                        sizeofElement, 
+                        vec.size());
                 }
             }
         }
         else if (ar.isWrite())
         {
-            std::uint32_t count = static_cast<std::uint32_t>(vec.size());
-            ar & count;
+            std::size_t count = vec.size();
+            writeArrayCount(ar, count);
             if (count)
             {
-                std::uint32_t totalBytesToWrite = count * vec.sizeofElement();
+                std::uint64_t totalBytesToWrite = std::uint64_t(count) * vec.sizeofElement();
 
                 if (RCF::machineOrderEqualsNetworkOrder())
                 {
                     // Don't need reordering, so write everything in one go.
-                    ar.getOstream()->writeRaw(vec.addressOfElement(0), totalBytesToWrite);
+                    writeRawOrInsert(ar, vec.addressOfElement(0), totalBytesToWrite);
                 }
                 else if (ar.getRuntimeVersion() < 8)
                 {
                     // Don't need reordering, so write everything in one go.
-                    ar.getOstream()->writeRaw(vec.addressOfElement(0), totalBytesToWrite);
+                    writeRawOrInsert(ar, vec.addressOfElement(0), totalBytesToWrite);
                 }
                 else
                 {
-                    // Reordering needed, so we go through a temporary buffer.
-                    std::uint32_t elementsRemaining = count;
-                    const std::uint32_t BufferSize = 100*1024;
+                    writeArrayBytesReordered(ar, vec.addressOfElement(0), vec.sizeofElement(), count);
+                }
+            }
+        }
+    }
+
+    // FNV-1a hash of the size, alignment, byte order and layout version of a trivially copyable type. The type name 
+    // is left out, so that the same type declared under different spellings (qualified or not) still matches.
+    static std::uint32_t getPodLayoutChecksum(
+        std::uint32_t           layoutVersion,
+        std::size_t             sizeofElement,
+        std::size_t             alignofElement)
+    {
+        std::uint32_t hash = 2166136261u;
+        auto hashByte = [&](unsigned char ch) { hash = (hash ^ ch) * 16777619u; };
+
+        std::uint32_t layout[4] = {
+            static_cast<std::uint32_t>(sizeofElement),
+            static_cast<std::uint32_t>(alignofElement),
+            RCF::machineOrderEqualsNetworkOrder() ? 1u : 0u,
+            layoutVersion };
 
-                    const std::uint32_t ElementsMax = BufferSize / vec.sizeofElement();
+        for (std::size_t i=0; i<4; ++i)
+        {
+            for (std::size_t j=0; j<4; ++j)
+            {
+                hashByte( static_cast<unsigned char>((layout[i] >> (8*j)) & 0xFF) );
+            }
+        }
+
+        return hash;
+    }
+
+    void serializeVectorPodImpl(
+        SF::Archive &           ar,
+        I_VecWrapper &          vec,
+        const PodLayoutInfo &   layoutInfo,
+        std::size_t             alignofElement)
+    {
+        std::uint32_t layoutChecksum = getPodLayoutChecksum(layoutInfo.mLayoutVersion, vec.sizeofElement(), alignofElement);
+
+        if (ar.isRead())
+        {
+            std::size_t count = toSizeT( readArrayCount(ar) );
+            std::uint32_t remoteLayoutChecksum = 0;
+            ar & remoteLayoutChecksum;
+
+            if (remoteLayoutChecksum != layoutChecksum)
+            {
+                RCF::Exception e(RCF::RcfError_SfPodLayoutMismatch, layoutInfo.mTypeName, layoutChecksum, remoteLayoutChecksum);
+                RCF_THROW(e);
+            }
+
+            vec.resize(0);
+            if (count)
+            {
+                std::size_t sizeofElement = vec.sizeofElement();
+                RCF_VERIFY(
+                    count <= std::size_t(-1) / sizeofElement,
+                    RCF::Exception(RCF::RcfError_SfDataFormat));
+
+                if (ar.verifyAgainstArchiveSize(count*sizeofElement))
+                {
+                    // Size field is verified, so read everything in one go.
+                    vec.resize(count);
+                    readArrayBytes(ar, vec.addressOfElement(0), std::uint64_t(count)*sizeofElement);
+                }
+                else
+                {
+                    // Size field not verified, so read in chunks.
+                    std::size_t elementsRemaining = count;
+                    const std::size_t ChunkSize = 1024*1024;
+                    const std::size_t ElementsMax = RCF_MAX(ChunkSize / sizeofElement, std::size_t(1));
 
-                    char Buffer[BufferSize];
                     while (elementsRemaining)
                     {
-                        std::uint32_t elementsWritten = count - elementsRemaining;
-                        std::uint32_t elementsToWrite = RCF_MIN(ElementsMax, elementsRemaining);
-                        std::uint32_t bytesToWrite = elementsToWrite*vec.sizeofElement();
-                        
-                        memcpy( (char *) &Buffer[0], vec.addressOfElement(elementsWritten), bytesToWrite);
-                        RCF::machineToNetworkOrder( &Buffer[0], vec.sizeofElement(), elementsToWrite);
-                        ar.getOstream()->writeRaw( (char *) &Buffer[0], bytesToWrite);
-                        elementsRemaining -= elementsToWrite;
+                        std::size_t elementsRead = count - elementsRemaining;
+                        std::size_t elementsToRead = RCF_MIN(ElementsMax, elementsRemaining);
+                        vec.resize( vec.size() + elementsToRead);
+                        readArrayBytes(ar, vec.addressOfElement(elementsRead), std::uint64_t(elementsToRead)*sizeofElement);
+                        elementsRemaining -= elementsToRead;
                     }
                 }
             }
         }
+        else if (ar.isWrite())
+        {
+            // No byte reordering, as the layout checksum includes the byte order.
+            std::size_t count = vec.size();
+            writeArrayCount(ar, count);
+            ar & layoutChecksum;
+            if (count)
+            {
+                writeRawOrInsert(ar, vec.addressOfElement(0), std::uint64_t(count) * vec.sizeofElement());
+            }
+        }
     }
 
+    const char * readArrayInPlace(
+        SF::Archive &           ar,
+        std::uint64_t           count,
+        std::size_t             sizeofElement,
+        std::size_t             alignofElement)
+    {
+        // Only request parameters on the server have a well defined lifetime. A client discards the response buffer 
+        // as soon as the response has been deserialized.
+        RCF::SerializationProtocolIn * pIn = ar.getIstream()->getRemoteCallContext();
+        RCF::RcfSession * pRcfSession = RCF::getTlsRcfSessionPtr();
+        if (!pIn || !pRcfSession || &pIn->getRoot() != &pRcfSession->getSpIn())
+        {
+            RCF::Exception e(RCF::RcfError_SfInPlaceRead);
+            RCF_THROW(e);
+        }
+
+        RCF_VERIFY(
+            count <= std::uint64_t( std::size_t(-1) / sizeofElement ), 
+            RCF::Exception(RCF::RcfError_SfDataFormat));
+
+        std::size_t bytesToRead = static_cast<std::size_t>(count) * sizeofElement;
+        if (bytesToRead == 0)
+        {
+            return NULL;
+        }
+
+        RCF_VERIFY(
+            bytesToRead <= pIn->getRemainingArchiveLength(), 
+            RCF::Exception(RCF::RcfError_SfDataFormat));
+
+        RCF::ByteBuffer byteBuffer;
+        pIn->extractSlice(byteBuffer, bytesToRead);
+
+        bool isAligned = reinterpret_cast<std::uintptr_t>(byteBuffer.getPtr()) % alignofElement == 0;
+        bool needsReordering = 
+                sizeofElement > 1 
+            &&  !RCF::machineOrderEqualsNetworkOrder() 
+            &&  ar.getRuntimeVersion() >= 8;
+
+        if (!isAligned || (needsReordering && byteBuffer.getReadOnly()))
+        {
+            RCF::ByteBuffer alignedBuffer = RCF::ByteBuffer::createUninitialized(bytesToRead);
+            memcpy(alignedBuffer.getPtr(), byteBuffer.getPtr(), bytesToRead);
+            byteBuffer = alignedBuffer;
+            pIn->retainByteBuffer(byteBuffer);
+        }
+
+        if (needsReordering)
+        {
+            RCF::networkToMachineOrderLarge(byteBuffer.getPtr(), sizeofElement, static_cast<std::size_t>(count));
+        }
+
+        return byteBuffer.getPtr();
+    }
+
+    void serializeSpanImpl(
+        SF::Archive &           ar,
+        char *                  pch,
+        std::size_t             count,
+        std::size_t             sizeofElement,
+        bool                    readOnly)
+    {
+        if (ar.isRead())
+        {
+            std::uint64_t countIn = readArrayCount(ar);
+
+            RCF_VERIFY(!readOnly, RCF::Exception(RCF::RcfError_SfReadFailure));
+
+            if (countIn != count)
+            {
+                RCF::Exception e(RCF::RcfError_ArraySizeMismatch, count, countIn);
+                RCF_THROW(e);
+            }
+
+            if (count)
+            {
+                readArrayBytes(ar, pch, std::uint64_t(count)*sizeofElement);
+
+                // Byte ordering.
+                if (ar.getRuntimeVersion() >= 8)
+                {
+                    RCF::networkToMachineOrderLarge(pch, sizeofElement, count);
+                }
+            }
+        }
+        else if (ar.isWrite())
+        {
+            // Same wire format as std::vector<>.
+            writeArrayCount(ar, count);
+            if (count)
+            {
+                std::uint64_t totalBytesToWrite = std::uint64_t(count)*sizeofElement;
+
+                if (RCF::machineOrderEqualsNetworkOrder() || ar.getRuntimeVersion() < 8)
+                {
+                    writeRawOrInsert(ar, pch, totalBytesToWrite);
+                }
+                else
+                {
+                    writeArrayBytesReordered(ar, pch, sizeofElement, count);
+                }
+            }
+        }
+    }
 
     class VectorBoolWrapper : public I_BitsetWrapper
     {